@@ -0,0 +1,107 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw1_static_perf.cpp
+// DATE: Fall 2021
+// DESC: Performance driver comparing the compile-time sorting networks
+//       of static_sort.h against insertion sort on small fixed-size
+//       arrays. To run from the command line use:
+//          ./hw1_static_perf
+//       which sorts many random arrays of each size from 3 to 32 with
+//       both sorts. To save this data to a file, run the command:
+//          ./hw1_static_perf > output_static.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <utility>
+#include "simple_sorts.h"
+#include "static_sort.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// test parameters
+const int min_n = 3;
+const int max_n = 32;
+const int arrays = 200000;
+const int runs = 3;
+
+// the random values sorted, arrays * max_n of them
+int* pool = nullptr;
+
+template<size_t N> void time_size();
+template<size_t... I> void time_sizes(index_sequence<I...>);
+void check_sorted(int array[], int size);
+
+
+int main(int argc, char* argv[])
+{
+  // configure output
+  cout << fixed << showpoint;
+  cout << setprecision(2);
+
+  pool = new int[arrays * max_n];
+  mt19937 gen(223);
+  for (int i = 0; i < arrays * max_n; ++i)
+    pool[i] = gen() % 1000;
+
+  // output data header
+  cout << "# All times in nanoseconds (nsec) per array" << endl;
+  cout << "# Column 1 = array size N" << endl;
+  cout << "# Column 2 = avg time insertion sort" << endl;
+  cout << "# Column 3 = avg time static_sort<N>" << endl;
+  cout << "# Column 4 = comparators in the static_sort<N> network" << endl;
+
+  time_sizes(make_index_sequence<max_n - min_n + 1>{});
+  delete [] pool;
+}
+
+
+template<size_t... I>
+void time_sizes(index_sequence<I...>)
+{
+  (time_size<min_n + I>(), ...);
+}
+
+
+template<size_t N>
+void time_size()
+{
+  double insertion = 0;
+  double network = 0;
+  int array[N];
+  for (int r = 0; r < runs; ++r) {
+    auto t0 = high_resolution_clock::now();
+    for (int a = 0; a < arrays; ++a) {
+      copy(pool + a * N, pool + (a + 1) * N, array);
+      insertion_sort(array, N);
+    }
+    auto t1 = high_resolution_clock::now();
+    check_sorted(array, N);
+    for (int a = 0; a < arrays; ++a) {
+      copy(pool + a * N, pool + (a + 1) * N, array);
+      static_sort<N>(array);
+    }
+    auto t2 = high_resolution_clock::now();
+    check_sorted(array, N);
+    insertion += duration_cast<nanoseconds>(t1 - t0).count();
+    network += duration_cast<nanoseconds>(t2 - t1).count();
+  }
+  cout << N << " " << insertion / (runs * arrays) << " "
+       << network / (runs * arrays) << " " << StaticNetwork<N>::size << endl;
+}
+
+
+void check_sorted(int array[], int size)
+{
+  for (int i = 0; i < size - 1; ++i) {
+    if (array[i] > array[i+1]) {
+      std::cerr << "Error: Array not sorted: array[" << i << "] = "
+                << array[i] << " > " << "array[" << (i + 1) << "] = "
+                << array[i+1] << endl;
+      std::terminate();
+    }
+  }
+}
@@ -10,8 +10,12 @@
 
 #include <iostream>
 #include <string>
+#include <array>
+#include <utility>
 #include <gtest/gtest.h>
 #include "simple_sorts.h"
+#include "sortnet.h"
+#include "static_sort.h"
 
 //---------------------------------------------------------------------------
 // Bubble Sort Tests
@@ -193,12 +197,158 @@ TEST(BasicSelectionSortTest, MyNewTestCase)
    // ASSERT_EQ(false, true);
 }
 
+//---------------------------------------------------------------------------
+// Network Sort Tests
+//---------------------------------------------------------------------------
+
+// Test 16
+TEST(BasicNetworkSortTest, EmptyAndSingleArrays)
+{
+   int array[]{7};
+   network_sort(array, 0);
+   network_sort(array, 1);
+   ASSERT_EQ(7, array[0]);
+}
+
+// Test 17
+TEST(BasicNetworkSortTest, EveryBlockSize)
+{
+   // covers the padded 8, 16, 32, and 64 element networks
+   for (int n = 2; n <= 64; ++n)
+   {
+      int array[64];
+      for (int i = 0; i < n; ++i)
+         array[i] = (i * 37 + 11) % 23 - 11;
+      network_sort(array, n);
+      for (int i = 0; i < n - 1; ++i)
+         ASSERT_LE(array[i], array[i + 1]);
+   }
+}
+
+// Test 18
+TEST(BasicNetworkSortTest, ExtremeValuesAndDuplicates)
+{
+   int array[]{0, 2147483647, -2147483647 - 1, 5, 5, 2147483647, -1, 5, 0};
+   network_sort(array, 9);
+   int expected[]{-2147483647 - 1, -1, 0, 0, 5, 5, 5, 2147483647, 2147483647};
+   for (int i = 0; i < 9; ++i)
+      ASSERT_EQ(expected[i], array[i]);
+}
+
+// Test 19
+TEST(BasicNetworkSortTest, LargeArrayFallsBack)
+{
+   int array[100];
+   for (int i = 0; i < 100; ++i)
+      array[i] = 100 - i;
+   network_sort(array, 100);
+   for (int i = 0; i < 100; ++i)
+      ASSERT_EQ(i + 1, array[i]);
+}
+
+// Test 20
+TEST(BasicNetworkSortTest, LanesMatchBuild)
+{
+   // the hw1_test_avx2 and hw1_test_sse41 builds check the vector
+   // lanes, the default build the scalar ones
+#if defined(__AVX2__)
+   ASSERT_EQ(8, int(NetIntLanes::width));
+#elif defined(__SSE4_1__)
+   ASSERT_EQ(4, int(NetIntLanes::width));
+#else
+   ASSERT_EQ(1, int(NetIntLanes::width));
+#endif
+   int array[64];
+   for (int i = 0; i < 64; ++i)
+      array[i] = (i * 7919) % 64;
+   network_sort(array, 64);
+   for (int i = 0; i < 64; ++i)
+      ASSERT_EQ(i, array[i]);
+}
+
+//---------------------------------------------------------------------------
+// Static Sort Tests
+//---------------------------------------------------------------------------
+
+// sorts a copy of the given array at compile time
+template <std::size_t N>
+constexpr std::array<int, N> static_sorted(std::array<int, N> array)
+{
+   static_sort<N>(array.data());
+   return array;
+}
+
+// sorts each pattern of N elements with static_sort and insertion
+// sort and checks that they agree
+template <std::size_t N>
+void check_static_sort()
+{
+   for (int pattern = 0; pattern < 50; ++pattern)
+   {
+      int expected[N];
+      int actual[N];
+      for (std::size_t i = 0; i < N; ++i)
+         expected[i] = actual[i] = (int(i) * 7919 + pattern * 104729) % (pattern + 5);
+      insertion_sort(expected, N);
+      static_sort<N>(actual);
+      for (std::size_t i = 0; i < N; ++i)
+         ASSERT_EQ(expected[i], actual[i]);
+   }
+}
+
+template <std::size_t... I>
+void check_static_sorts(std::index_sequence<I...>)
+{
+   (check_static_sort<I + 3>(), ...);
+}
+
+// Test 21
+TEST(BasicStaticSortTest, ConstantExpression)
+{
+   constexpr std::array<int, 5> sorted = static_sorted<5>({5, 1, 4, 2, 3});
+   static_assert(sorted[0] == 1 && sorted[1] == 2 && sorted[2] == 3 &&
+                 sorted[3] == 4 && sorted[4] == 5);
+   constexpr std::array<int, 3> dups = static_sorted<3>({2, -1, 2});
+   static_assert(dups[0] == -1 && dups[1] == 2 && dups[2] == 2);
+   ASSERT_EQ(1, sorted[0]);
+}
+
+// Test 22
+TEST(BasicStaticSortTest, OptimalSizesUpToEight)
+{
+   static_assert(StaticNetwork<3>::size == 3 && StaticNetwork<4>::size == 5 &&
+                 StaticNetwork<5>::size == 9 && StaticNetwork<6>::size == 12 &&
+                 StaticNetwork<7>::size == 16 && StaticNetwork<8>::size == 19);
+   static_assert(static_network_sorts_zero_one<16>());
+   ASSERT_EQ(0u, StaticNetwork<1>::size);
+}
+
+// Test 23
+TEST(BasicStaticSortTest, MatchesInsertionSort)
+{
+   check_static_sorts(std::make_index_sequence<30>{});
+}
+
 //---------------------------------------------------------------------------
 // Main
 //----------------------------------------------------------------------
 
 int main(int argc, char *argv[])
 {
+   // a vector build can only run where the CPU has the instructions
+#if defined(__AVX2__)
+   if (!__builtin_cpu_supports("avx2"))
+   {
+      std::cout << "AVX2 not supported, skipping tests" << std::endl;
+      return 0;
+   }
+#elif defined(__SSE4_1__)
+   if (!__builtin_cpu_supports("sse4.1"))
+   {
+      std::cout << "SSE4.1 not supported, skipping tests" << std::endl;
+      return 0;
+   }
+#endif
    testing::InitGoogleTest(&argc, argv);
    return RUN_ALL_TESTS();
 }
@@ -8,10 +8,12 @@
 //            Bubble Sort
 //            Insertion Sort
 //            Selection Sort
+//            Network Sort (small arrays)
 //---------------------------------------------------------------------------
 
 #include <iostream>
 #include "simple_sorts.h"
+#include "sortnet.h"
 
 void swap(int &x, int &y)
 {
@@ -79,3 +81,15 @@ void selection_sort(int array[], int n)
         swap(array[currentMinPos], array[i]); // swap the current min position with the current value at index i
     }
 }
+
+void network_sort(int array[], int n)
+{
+    if (n <= SORTNET_MAX)
+    {
+        sorting_network(array, n);
+    }
+    else
+    {
+        insertion_sort(array, n);
+    }
+}
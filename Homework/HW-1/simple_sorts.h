@@ -66,4 +66,21 @@ void insertion_sort(int array[], int n);
 void selection_sort(int array[], int n);
 
 
+//----------------------------------------------------------------------
+// Sorts the given array with a bitonic sorting network (see
+// sortnet.h) when it has at most 64 elements, which avoids the
+// data-dependent branches of the simple sorts on tiny arrays. Larger
+// arrays fall back to insertion sort. Assumes the array is at least
+// of length n.
+//
+// Inputs:
+//   array -- the array to sort
+//   n     -- the length of the array (elements of array to sort)
+//
+// Outputs:
+//   array -- elements 0 to n-1 are in sorted order
+//----------------------------------------------------------------------
+void network_sort(int array[], int n);
+
+
 #endif
@@ -0,0 +1,344 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: sortnet.h
+// DATE: Fall 2021
+// DESC: Bitonic sorting networks for small int and float blocks (up to
+//       64 elements), used as the base case of the quick and merge
+//       sorts. A block is padded to 8, 16, 32, or 64 elements and
+//       held as an array of vectors. Compare-exchanges between
+//       vectors are plain min/max, and the ones inside a vector use a
+//       lane permute and blend. The vector width is picked at compile
+//       time: AVX2 (8 lanes) if __AVX2__ is defined, else SSE4.1 (4
+//       lanes), else a scalar version with one element per "vector".
+//       NaN floats are not supported.
+//---------------------------------------------------------------------------
+
+#ifndef SORTNET_H
+#define SORTNET_H
+
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+// largest block the networks sort
+const int SORTNET_MAX = 64;
+
+// true for the element types that have a sorting network
+template <typename T>
+struct has_sorting_network
+    : std::integral_constant<bool, std::is_same<T, int>::value ||
+                                       std::is_same<T, float>::value>
+{
+};
+
+// one element per vector, used when no vector instructions are
+// available
+template <typename T>
+struct ScalarLanes
+{
+    typedef T vec;
+    static const int width = 1;
+    static vec load(const T *p) { return *p; }
+    static void store(T *p, vec v) { *p = v; }
+    static vec min(vec a, vec b) { return b < a ? b : a; }
+    static vec max(vec a, vec b) { return a < b ? b : a; }
+    // lane i of the result is lane i ^ m of v
+    static vec permute_xor(vec v, int) { return v; }
+    // lanes with the given index bit set come from hi, others from lo
+    static vec blend_bit(vec lo, vec, int) { return lo; }
+    static vec reverse(vec v) { return v; }
+};
+
+#if defined(__AVX2__)
+
+// lane indexes i ^ m for m = 0..7
+alignas(32) static const int sortnet_xor_index[8][8] = {
+    {0, 1, 2, 3, 4, 5, 6, 7}, {1, 0, 3, 2, 5, 4, 7, 6},
+    {2, 3, 0, 1, 6, 7, 4, 5}, {3, 2, 1, 0, 7, 6, 5, 4},
+    {4, 5, 6, 7, 0, 1, 2, 3}, {5, 4, 7, 6, 1, 0, 3, 2},
+    {6, 7, 4, 5, 2, 3, 0, 1}, {7, 6, 5, 4, 3, 2, 1, 0}};
+
+// blend masks selecting the lanes with index bit 1, 2, or 4 set
+alignas(32) static const int sortnet_bit_mask[5][8] = {
+    {0, 0, 0, 0, 0, 0, 0, 0}, {0, -1, 0, -1, 0, -1, 0, -1},
+    {0, 0, -1, -1, 0, 0, -1, -1}, {0, 0, 0, 0, 0, 0, 0, 0},
+    {0, 0, 0, 0, -1, -1, -1, -1}};
+
+// eight 32-bit ints per vector
+struct NetIntLanes
+{
+    typedef __m256i vec;
+    static const int width = 8;
+    static vec load(const int *p)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    }
+    static void store(int *p, vec v)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+    }
+    static vec min(vec a, vec b) { return _mm256_min_epi32(a, b); }
+    static vec max(vec a, vec b) { return _mm256_max_epi32(a, b); }
+    static vec permute_xor(vec v, int m)
+    {
+        return _mm256_permutevar8x32_epi32(v, load(sortnet_xor_index[m]));
+    }
+    static vec blend_bit(vec lo, vec hi, int bit)
+    {
+        return _mm256_blendv_epi8(lo, hi, load(sortnet_bit_mask[bit]));
+    }
+    static vec reverse(vec v) { return permute_xor(v, 7); }
+};
+
+// eight floats per vector
+struct NetFloatLanes
+{
+    typedef __m256 vec;
+    static const int width = 8;
+    static vec load(const float *p) { return _mm256_loadu_ps(p); }
+    static void store(float *p, vec v) { _mm256_storeu_ps(p, v); }
+    static vec min(vec a, vec b) { return _mm256_min_ps(a, b); }
+    static vec max(vec a, vec b) { return _mm256_max_ps(a, b); }
+    static vec permute_xor(vec v, int m)
+    {
+        return _mm256_permutevar8x32_ps(v, NetIntLanes::load(sortnet_xor_index[m]));
+    }
+    static vec blend_bit(vec lo, vec hi, int bit)
+    {
+        return _mm256_blendv_ps(
+            lo, hi, _mm256_castsi256_ps(NetIntLanes::load(sortnet_bit_mask[bit])));
+    }
+    static vec reverse(vec v) { return permute_xor(v, 7); }
+};
+
+#elif defined(__SSE4_1__)
+
+// four 32-bit ints per vector (shuffle and blend masks must be
+// immediates, hence the switches)
+struct NetIntLanes
+{
+    typedef __m128i vec;
+    static const int width = 4;
+    static vec load(const int *p)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    }
+    static void store(int *p, vec v)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+    }
+    static vec min(vec a, vec b) { return _mm_min_epi32(a, b); }
+    static vec max(vec a, vec b) { return _mm_max_epi32(a, b); }
+    static vec permute_xor(vec v, int m)
+    {
+        switch (m)
+        {
+        case 1:
+            return _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+        case 2:
+            return _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+        case 3:
+            return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+        }
+        return v;
+    }
+    static vec blend_bit(vec lo, vec hi, int bit)
+    {
+        // 16-bit lanes 2,3,6,7 are int lanes 1,3; 4-7 are int lanes 2,3
+        return bit == 1 ? _mm_blend_epi16(lo, hi, 0xCC)
+                        : _mm_blend_epi16(lo, hi, 0xF0);
+    }
+    static vec reverse(vec v) { return permute_xor(v, 3); }
+};
+
+// four floats per vector
+struct NetFloatLanes
+{
+    typedef __m128 vec;
+    static const int width = 4;
+    static vec load(const float *p) { return _mm_loadu_ps(p); }
+    static void store(float *p, vec v) { _mm_storeu_ps(p, v); }
+    static vec min(vec a, vec b) { return _mm_min_ps(a, b); }
+    static vec max(vec a, vec b) { return _mm_max_ps(a, b); }
+    static vec permute_xor(vec v, int m)
+    {
+        switch (m)
+        {
+        case 1:
+            return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+        case 2:
+            return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2));
+        case 3:
+            return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3));
+        }
+        return v;
+    }
+    static vec blend_bit(vec lo, vec hi, int bit)
+    {
+        return bit == 1 ? _mm_blend_ps(lo, hi, 0xA) : _mm_blend_ps(lo, hi, 0xC);
+    }
+    static vec reverse(vec v) { return permute_xor(v, 3); }
+};
+
+#else
+
+typedef ScalarLanes<int> NetIntLanes;
+typedef ScalarLanes<float> NetFloatLanes;
+
+#endif
+
+// Merges each block of k elements of the count vectors in v, whose
+// two halves are sorted, into ascending order. Uses the bitonic
+// merger whose first step compares offset t with k - 1 - t, so every
+// compare-exchange puts the minimum at the lower index.
+template <typename L>
+void bitonic_merge_vecs(typename L::vec v[], int count, int k)
+{
+    typedef typename L::vec vec;
+    const int w = L::width;
+    // first step: t against k - 1 - t
+    if (k <= w)
+    {
+        for (int r = 0; r < count; ++r)
+        {
+            vec p = L::permute_xor(v[r], k - 1);
+            v[r] = L::blend_bit(L::min(v[r], p), L::max(v[r], p), k / 2);
+        }
+    }
+    else
+    {
+        int kv = k / w;
+        for (int b = 0; b < count; b += kv)
+        {
+            for (int r = 0; r < kv / 2; ++r)
+            {
+                vec &lo = v[b + r];
+                vec &hi = v[b + kv - 1 - r];
+                vec p = L::reverse(hi);
+                vec hi_vals = L::max(lo, p);
+                lo = L::min(lo, p);
+                hi = L::reverse(hi_vals);
+            }
+        }
+    }
+    // remaining steps: t against t + j
+    for (int j = k / 4; j >= 1; j /= 2)
+    {
+        if (j >= w)
+        {
+            int jv = j / w;
+            for (int r = 0; r < count; ++r)
+            {
+                if ((r & jv) == 0)
+                {
+                    vec lo = L::min(v[r], v[r + jv]);
+                    v[r + jv] = L::max(v[r], v[r + jv]);
+                    v[r] = lo;
+                }
+            }
+        }
+        else
+        {
+            for (int r = 0; r < count; ++r)
+            {
+                vec p = L::permute_xor(v[r], j);
+                v[r] = L::blend_bit(L::min(v[r], p), L::max(v[r], p), j);
+            }
+        }
+    }
+}
+
+// runs the network on a[0..n), padded with the largest value up to
+// the next block size
+template <typename L, typename T>
+void sorting_network_lanes(T a[], int n, bool merge_only)
+{
+    typedef typename L::vec vec;
+    int size = 8;
+    while (size < n)
+    {
+        size *= 2;
+    }
+    T block[SORTNET_MAX];
+    const T pad = std::numeric_limits<T>::has_infinity
+                      ? std::numeric_limits<T>::infinity()
+                      : std::numeric_limits<T>::max();
+    for (int i = 0; i < size; ++i)
+    {
+        block[i] = i < n ? a[i] : pad;
+    }
+    vec v[SORTNET_MAX / L::width];
+    int count = size / L::width;
+    for (int r = 0; r < count; ++r)
+    {
+        v[r] = L::load(block + r * L::width);
+    }
+    for (int k = merge_only ? size : 2; k <= size; k *= 2)
+    {
+        bitonic_merge_vecs<L>(v, count, k);
+    }
+    for (int r = 0; r < count; ++r)
+    {
+        L::store(block + r * L::width, v[r]);
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        a[i] = block[i];
+    }
+}
+
+// Sorts a[0..n) with a bitonic sorting network. Throws
+// invalid_argument if n is larger than SORTNET_MAX.
+inline void sorting_network(int a[], int n)
+{
+    if (n > SORTNET_MAX)
+    {
+        throw std::invalid_argument("sorting network block too large");
+    }
+    if (n > 1)
+    {
+        sorting_network_lanes<NetIntLanes>(a, n, false);
+    }
+}
+
+// Sorts a[0..n) with a bitonic sorting network. Throws
+// invalid_argument if n is larger than SORTNET_MAX.
+inline void sorting_network(float a[], int n)
+{
+    if (n > SORTNET_MAX)
+    {
+        throw std::invalid_argument("sorting network block too large");
+    }
+    if (n > 1)
+    {
+        sorting_network_lanes<NetFloatLanes>(a, n, false);
+    }
+}
+
+// Merges the sorted halves a[0..n/2) and a[n/2..n) with a bitonic
+// merger. Throws invalid_argument unless n is 8, 16, 32, or 64.
+inline void bitonic_merge(int a[], int n)
+{
+    if (n < 8 || n > SORTNET_MAX || (n & (n - 1)) != 0)
+    {
+        throw std::invalid_argument("bitonic merge needs 8, 16, 32, or 64 elements");
+    }
+    sorting_network_lanes<NetIntLanes>(a, n, true);
+}
+
+// Merges the sorted halves a[0..n/2) and a[n/2..n) with a bitonic
+// merger. Throws invalid_argument unless n is 8, 16, 32, or 64.
+inline void bitonic_merge(float a[], int n)
+{
+    if (n < 8 || n > SORTNET_MAX || (n & (n - 1)) != 0)
+    {
+        throw std::invalid_argument("bitonic merge needs 8, 16, 32, or 64 elements");
+    }
+    sorting_network_lanes<NetFloatLanes>(a, n, true);
+}
+
+#endif
@@ -0,0 +1,251 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: static_sort.h
+// DATE: Fall 2021
+// DESC: Compile-time sorting networks for fixed-size arrays. The
+//       comparators for N elements come from Batcher's merge exchange
+//       (Knuth, TAOCP vol. 3, Algorithm 5.2.2M), which is optimal for
+//       N <= 8 and at most 7 comparators above the best known
+//       networks up to 32. They are computed by constexpr code and
+//       applied through an index_sequence fold, so static_sort<N>
+//       has no loops or data-dependent branches and can be used in
+//       constant expressions. Each network is checked with a
+//       static_assert when static_sort<N> is instantiated.
+//---------------------------------------------------------------------------
+
+#ifndef STATIC_SORT_H
+#define STATIC_SORT_H
+
+#include <cstddef>
+#include <utility>
+
+//----------------------------------------------------------------------
+// Returns the number of comparators in the merge exchange network for
+// n elements.
+//----------------------------------------------------------------------
+constexpr std::size_t static_network_size(std::size_t n)
+{
+    std::size_t count = 0;
+    std::size_t t = 0;
+    while ((std::size_t(1) << t) < n)
+    {
+        ++t;
+    }
+    for (std::size_t p = t > 0 ? std::size_t(1) << (t - 1) : 0; p > 0; p /= 2)
+    {
+        std::size_t q = std::size_t(1) << (t - 1);
+        std::size_t r = 0;
+        std::size_t d = p;
+        while (d > 0)
+        {
+            for (std::size_t i = 0; i + d < n; ++i)
+            {
+                if ((i & p) == r)
+                {
+                    ++count;
+                }
+            }
+            d = q - p;
+            q /= 2;
+            r = p;
+        }
+    }
+    return count;
+}
+
+//----------------------------------------------------------------------
+// The comparators of the merge exchange network for N elements, in
+// the order they are applied. Comparator i puts the smaller of
+// array[lo[i]] and array[hi[i]] at lo[i].
+//----------------------------------------------------------------------
+template <std::size_t N>
+struct StaticNetwork
+{
+    static constexpr std::size_t size = static_network_size(N);
+
+    // one extra entry so N < 2 does not declare empty arrays
+    std::size_t lo[size + 1];
+    std::size_t hi[size + 1];
+
+    constexpr StaticNetwork() : lo(), hi()
+    {
+        std::size_t count = 0;
+        std::size_t t = 0;
+        while ((std::size_t(1) << t) < N)
+        {
+            ++t;
+        }
+        for (std::size_t p = t > 0 ? std::size_t(1) << (t - 1) : 0; p > 0; p /= 2)
+        {
+            std::size_t q = std::size_t(1) << (t - 1);
+            std::size_t r = 0;
+            std::size_t d = p;
+            while (d > 0)
+            {
+                for (std::size_t i = 0; i + d < N; ++i)
+                {
+                    if ((i & p) == r)
+                    {
+                        lo[count] = i;
+                        hi[count] = i + d;
+                        ++count;
+                    }
+                }
+                d = q - p;
+                q /= 2;
+                r = p;
+            }
+        }
+    }
+};
+
+template <std::size_t N>
+inline constexpr StaticNetwork<N> static_network{};
+
+// largest N whose network is checked against every 0-1 input (the
+// constexpr evaluation limits rule out much larger ones)
+const std::size_t STATIC_SORT_EXHAUSTIVE_MAX = 16;
+
+//----------------------------------------------------------------------
+// Returns true if the network for N elements sorts every sequence of
+// 0s and 1s, which by the 0-1 principle means it sorts every input.
+// The inputs are bit-sliced 64 at a time: bit k of wire[i] is element
+// i of input 64 * batch + k, so a comparator is an and plus an or.
+//----------------------------------------------------------------------
+template <std::size_t N>
+constexpr bool static_network_sorts_zero_one()
+{
+    const StaticNetwork<N> &net = static_network<N>;
+    // bit k of lane_bits[i] is bit i of k
+    const unsigned long long lane_bits[6] = {
+        0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL};
+    const unsigned long long batches = N > 6 ? 1ULL << (N - 6) : 1;
+    for (unsigned long long batch = 0; batch < batches; ++batch)
+    {
+        unsigned long long wire[N + 1] = {};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            wire[i] = i < 6 ? lane_bits[i]
+                            : ((batch >> (i - 6)) & 1) != 0 ? ~0ULL : 0;
+        }
+        for (std::size_t i = 0; i < net.size; ++i)
+        {
+            unsigned long long lo = wire[net.lo[i]];
+            unsigned long long hi = wire[net.hi[i]];
+            wire[net.lo[i]] = lo & hi;
+            wire[net.hi[i]] = lo | hi;
+        }
+        // sorted means no 1 sits below a 0
+        for (std::size_t i = 0; i + 1 < N; ++i)
+        {
+            if ((wire[i] & ~wire[i + 1]) != 0)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Returns true if the network for N elements sorts the reversed
+// sequence and a fixed set of pseudo-random permutations. Used for
+// the networks too large to check exhaustively.
+//----------------------------------------------------------------------
+template <std::size_t N>
+constexpr bool static_network_sorts_samples()
+{
+    const StaticNetwork<N> &net = static_network<N>;
+    unsigned int seed = 12345;
+    for (int sample = 0; sample < 64; ++sample)
+    {
+        int array[N] = {};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            array[i] = int(N - i);
+        }
+        // Fisher-Yates shuffle with a small LCG (sample 0 stays reversed)
+        for (std::size_t i = N - 1; sample > 0 && i > 0; --i)
+        {
+            seed = seed * 1103515245u + 12345u;
+            std::size_t j = (seed >> 16) % (i + 1);
+            int tmp = array[i];
+            array[i] = array[j];
+            array[j] = tmp;
+        }
+        for (std::size_t i = 0; i < net.size; ++i)
+        {
+            if (array[net.hi[i]] < array[net.lo[i]])
+            {
+                int tmp = array[net.lo[i]];
+                array[net.lo[i]] = array[net.hi[i]];
+                array[net.hi[i]] = tmp;
+            }
+        }
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            if (array[i] != int(i + 1))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// exhaustive check when affordable, sampled otherwise
+template <std::size_t N>
+constexpr bool static_network_verified()
+{
+    if constexpr (N <= STATIC_SORT_EXHAUSTIVE_MAX)
+    {
+        return static_network_sorts_zero_one<N>();
+    }
+    else
+    {
+        return static_network_sorts_samples<N>();
+    }
+}
+
+// puts the smaller of a and b in a, without branching on the values
+template <typename T>
+constexpr void static_compare_exchange(T &a, T &b)
+{
+    bool out_of_order = b < a;
+    T lo = out_of_order ? b : a;
+    T hi = out_of_order ? a : b;
+    a = lo;
+    b = hi;
+}
+
+// applies each comparator of the network, fully unrolled
+template <std::size_t N, typename T, std::size_t... I>
+constexpr void apply_static_network(T array[], std::index_sequence<I...>)
+{
+    (static_compare_exchange(array[static_network<N>.lo[I]],
+                             array[static_network<N>.hi[I]]),
+     ...);
+}
+
+//----------------------------------------------------------------------
+// Sorts the first N elements of the given array with a sorting
+// network unrolled at compile time. Can be used in constant
+// expressions. Fails to compile if the network for N does not pass
+// its static_assert check.
+//
+// Inputs:
+//   array -- the array to sort, of at least N elements
+//
+// Outputs:
+//   array -- elements 0 to N-1 are in sorted order
+//----------------------------------------------------------------------
+template <std::size_t N, typename T>
+constexpr void static_sort(T array[])
+{
+    static_assert(static_network_verified<N>(),
+                  "static_sort network does not sort");
+    apply_static_network<N>(array, std::make_index_sequence<StaticNetwork<N>::size>{});
+}
+
+#endif
@@ -467,6 +467,74 @@ TEST(CustomTests2, FourElementQuickLinkedSeq)
     ASSERT_EQ(0, seq[0]);
 }
 
+//----------------------------------------------------------------------
+// LinkedSeq Natural Merge Sort Tests
+//----------------------------------------------------------------------
+
+TEST(NaturalMergeSortTests, RunsMergeSortLinkedSeq)
+{
+    // a mix of ascending runs, descending runs (with duplicates at
+    // the boundaries), and scattered values
+    LinkedSeq<int> seq;
+    for (int r = 0; r < 20; ++r)
+        for (int i = 0; i < 13 * r + 1; ++i)
+            seq.insert(r % 2 == 0 ? i : 50 - i, seq.size());
+    for (int i = 0; i < 500; ++i)
+        seq.insert((i * 7919) % 503, seq.size());
+    int n = seq.size();
+    seq.merge_sort();
+    ASSERT_EQ(n, seq.size());
+    for (int i = 0; i < n - 1; ++i)
+        ASSERT_LE(seq[i], seq[i + 1]);
+}
+
+TEST(NaturalMergeSortTests, SortedAndReversedMergeSortLinkedSeq)
+{
+    LinkedSeq<int> sorted, reversed;
+    for (int i = 0; i < 2000; ++i)
+    {
+        sorted.insert(i, sorted.size());
+        reversed.insert(i, 0);
+    }
+    sorted.merge_sort();
+    reversed.merge_sort();
+    for (int i = 0; i < 2000; ++i)
+    {
+        ASSERT_EQ(i, sorted[i]);
+        ASSERT_EQ(i, reversed[i]);
+    }
+}
+
+TEST(NaturalMergeSortTests, TailAfterMergeSortLinkedSeq)
+{
+    LinkedSeq<int> seq;
+    seq.insert(30, 0);
+    seq.insert(10, 1);
+    seq.insert(20, 2);
+    seq.insert(5, 3);
+    seq.merge_sort();
+    // appending uses the tail, which must be the largest node
+    seq.insert(40, seq.size());
+    ASSERT_EQ(5, seq.size());
+    ASSERT_EQ(5, seq[0]);
+    ASSERT_EQ(30, seq[3]);
+    ASSERT_EQ(40, seq[4]);
+}
+
+TEST(NaturalMergeSortTests, LargeMergeSortLinkedSeq)
+{
+    LinkedSeq<int> seq;
+    const int n = 1000000;
+    for (int i = 0; i < n; ++i)
+        seq.insert((int)((i * 7919L) % n), seq.size());
+    seq.merge_sort();
+    seq.insert(n, seq.size());
+    ASSERT_EQ(n + 1, seq.size());
+    ASSERT_EQ(0, seq[0]);
+    ASSERT_EQ(n - 1, seq[n - 1]);
+    ASSERT_EQ(n, seq[n]);
+}
+
 //----------------------------------------------------------------------
 // Main
 //----------------------------------------------------------------------
@@ -74,7 +74,9 @@ public:
     void sort() override;
 
     // MORE
-    // implements merge sort over current sequence
+    // implements merge sort over current sequence (bottom-up natural
+    // merge sort: no recursion, and linear time on sorted or reverse
+    // sorted input)
     void merge_sort();
     // implements quick sort over current sequence
     void quick_sort();
@@ -102,7 +104,18 @@ private:
 
     // MORE
     // helper functions for merge and quick sort
-    static Node *merge_sort(Node *left, int len);
+
+    // cuts the next run (non-decreasing, or strictly decreasing and
+    // then reversed) off the front of the list rest, returning the
+    // run and its last node (via the run_last output parameter)
+    static Node *next_run(Node *&rest, Node *&run_last);
+
+    // merges the sorted, nullptr-terminated lists left (ending at
+    // left_end) and right (ending at right_end), returning the merged
+    // list and its last node (via the merged_tail output parameter)
+    static Node *merge(Node *left, Node *left_end, Node *right,
+                       Node *right_end, Node *&merged_tail);
+
     static Node *quick_sort(Node *start, int len);
 };
 
@@ -414,16 +427,52 @@ void LinkedSeq<T>::merge_sort()
     {
         return;
     }
-    head = merge_sort(head, node_count);
-
-    Node *temp = head;
-    int i = 0;
-    while (i < node_count - 1)
+    // bin i is empty or holds a sorted list merged from 2^i runs.
+    // Each new run is carried up through the full bins (like adding 1
+    // to a binary counter), so every node takes part in about lg(runs)
+    // merges. Bins hold runs from earlier in the list than the new
+    // run, so they are always the left side of a merge (keeping the
+    // sort stable).
+    const int max_bins = 32;
+    Node *bin_head[max_bins] = {};
+    Node *bin_tail[max_bins] = {};
+    Node *rest = head;
+    while (rest != nullptr)
+    {
+        Node *run_last = nullptr;
+        Node *run = next_run(rest, run_last);
+        int i = 0;
+        while (i < max_bins - 1 && bin_head[i] != nullptr)
+        {
+            run = merge(bin_head[i], bin_tail[i], run, run_last, run_last);
+            bin_head[i] = nullptr;
+            ++i;
+        }
+        if (bin_head[i] != nullptr)
+        {
+            run = merge(bin_head[i], bin_tail[i], run, run_last, run_last);
+        }
+        bin_head[i] = run;
+        bin_tail[i] = run_last;
+    }
+    // merge the bins, where higher bins hold earlier runs
+    head = nullptr;
+    for (int i = 0; i < max_bins; ++i)
     {
-        temp = temp->next;
-        i++;
+        if (bin_head[i] == nullptr)
+        {
+            continue;
+        }
+        if (head == nullptr)
+        {
+            head = bin_head[i];
+            tail = bin_tail[i];
+        }
+        else
+        {
+            head = merge(bin_head[i], bin_tail[i], head, tail, tail);
+        }
     }
-    tail = temp;
 }
 
 // implements quick sort over current sequence
@@ -444,79 +493,77 @@ void LinkedSeq<T>::quick_sort()
     }
 }
 
+// cuts the next run off the front of the list
 template <typename T>
-typename LinkedSeq<T>::Node *LinkedSeq<T>::merge_sort(Node *left, int len)
+typename LinkedSeq<T>::Node *LinkedSeq<T>::next_run(Node *&rest,
+                                                    Node *&run_last)
 {
-    if (len <= 1)
-    {
-        return left;
-    }
-    int mid = (len + 1) / 2;
-
-    Node *last_left = left;
-    for (int i = 1; i < mid; ++i) // we know that the left side will have a len of at least 1
-    {
-        last_left = last_left->next;
-    }
-
-    Node *right = last_left->next;
-    last_left->next = nullptr;
-
-    left = merge_sort(left, mid);
-    right = merge_sort(right, len - mid);
-
-    Node *new_left = nullptr;
-
-    if (left == nullptr)
-    {
-        return right;
-    }
-    if (right == nullptr)
-    {
-        return left;
-    }
-
-    Node *cur_left = left;
-    Node *cur_right = right;
-
-    if (cur_left->value <= cur_right->value)
-    {
-        new_left = left;
-        cur_left = cur_left->next;
+    Node *start = rest;
+    if (start->next != nullptr && start->next->value < start->value)
+    {
+        // strictly decreasing (so reversing it keeps the sort stable),
+        // reverse the links while walking it
+        Node *reversed = start;
+        Node *curr = start->next;
+        start->next = nullptr;
+        while (curr != nullptr && curr->value < reversed->value)
+        {
+            Node *next = curr->next;
+            curr->next = reversed;
+            reversed = curr;
+            curr = next;
+        }
+        rest = curr;
+        run_last = start;
+        return reversed;
     }
-    else
+    Node *last = start;
+    while (last->next != nullptr && last->value <= last->next->value)
     {
-        new_left = right;
-        cur_right = cur_right->next;
+        last = last->next;
     }
+    rest = last->next;
+    last->next = nullptr;
+    run_last = last;
+    return start;
+}
 
-    Node *cur_new_left = new_left;
-
-    while (cur_left != NULL && cur_right != NULL)
+// merges two sorted lists (taking from the left list on ties, so the
+// sort is stable)
+template <typename T>
+typename LinkedSeq<T>::Node *LinkedSeq<T>::merge(Node *left, Node *left_end,
+                                                 Node *right, Node *right_end,
+                                                 Node *&merged_tail)
+{
+    Node *merged = nullptr;
+    Node **link = &merged;
+    while (left != nullptr && right != nullptr)
     {
-        if (cur_left->value <= cur_right->value)
+        if (left->value <= right->value)
         {
-            cur_new_left->next = cur_left;
-            cur_left = cur_left->next;
-            cur_new_left = cur_new_left->next;
+            *link = left;
+            link = &left->next;
+            left = left->next;
         }
         else
         {
-            cur_new_left->next = cur_right;
-            cur_right = cur_right->next;
-            cur_new_left = cur_new_left->next;
+            *link = right;
+            link = &right->next;
+            right = right->next;
         }
     }
-
-    if (cur_left == NULL)
+    // the rest of one list is already linked, and its end is the tail
+    if (left != nullptr)
     {
-        cur_new_left->next = cur_right;
+        *link = left;
+        merged_tail = left_end;
     }
     else
     {
-        cur_new_left->next = cur_left;
+        *link = right;
+        merged_tail = right_end;
     }
-    return new_left;
+    return merged;
 }
 
 template <typename T>
@@ -0,0 +1,521 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: adaptivemap.h
+// DATE: Fall 2021
+// DESC: A map that changes its representation to suit its size and
+//       use. It starts as an ArrayMap, whose linear scan needs no
+//       table and beats hashing up to about 16 pairs, and becomes a
+//       HashMap once it holds more than array_max pairs. A hash table answers
+//       find_keys and sorted_keys by scanning every bucket, so after
+//       tree_after_ranges such calls it becomes an AVLMap (built from
+//       the sorted keys in linear time), which answers them in time
+//       proportional to the result. A map that shrinks below half of
+//       array_max goes back to an array. Switching copies every pair,
+//       and operator[] references are invalidated by any switch. Like
+//       SplayMap, the const range queries may restructure the map.
+//---------------------------------------------------------------------------
+
+#ifndef ADAPTIVEMAP_H
+#define ADAPTIVEMAP_H
+
+#include <stdexcept>
+#include <utility>
+#include "map.h"
+#include "arrayseq.h"
+#include "arraymap.h"
+#include "hashmap.h"
+#include "avlmap.h"
+
+template <typename K, typename V>
+class AdaptiveMap : public Map<K, V>
+{
+public:
+    // the representations an AdaptiveMap can use
+    enum Layout
+    {
+        ARRAY_LAYOUT,
+        HASH_LAYOUT,
+        TREE_LAYOUT
+    };
+
+    // Returns the number of key-value pairs in the map
+    int size() const;
+
+    // Tests if the map is empty
+    bool empty() const;
+
+    // Allows values associated with a key to be updated. Throws
+    // out_of_range if the given key is not in the collection.
+    V &operator[](const K &key);
+
+    // Returns the value for a given key. Throws out_of_range if the
+    // given key is not in the collection.
+    const V &operator[](const K &key) const;
+
+    // Returns a pointer to the value for a given key, or nullptr if
+    // the key is not in the collection.
+    V *find(const K &key);
+    const V *find(const K &key) const;
+
+    // Extends the collection by adding the given key-value
+    // pair. Assumes the key being added is not present in the
+    // collection. Insert does not check if the key is present.
+    void insert(const K &key, const V &value);
+
+    // Same as insert, but moves the key and value into the
+    // collection instead of copying them.
+    void insert(K &&key, V &&value);
+
+    // Extends the collection by adding the key with a value
+    // constructed in place from args. Like insert, assumes the key is
+    // not present in the collection.
+    template <typename KK, typename... Args>
+    void emplace(KK &&key, Args &&...args);
+
+    // Adds the key with a value constructed in place from args if the
+    // key is not in the collection. Returns true if it was added; if
+    // not, the key and args are left untouched.
+    template <typename KK, typename... Args>
+    bool try_emplace(KK &&key, Args &&...args);
+
+    // Adds the key-value pair if the key is not in the collection, and
+    // otherwise assigns value to the key's value. Returns true if the
+    // pair was added.
+    bool insert_or_assign(const K &key, const V &value);
+
+    // Returns the value for a given key, first adding the key with a
+    // default-constructed value if it is not in the collection.
+    V &get_or_insert_default(const K &key);
+
+    // Shrinks the collection by removing the key-value pair with the
+    // given key. Throws out_of_range if the given key is not in the
+    // collection.
+    void erase(const K &key);
+
+    // Same as erase, but returns false instead of throwing if the key
+    // is not in the collection, and true if the pair was removed.
+    bool try_erase(const K &key);
+
+    // Returns true if the key is in the collection, and false otherwise.
+    bool contains(const K &key) const;
+
+    // Heterogeneous lookup: operator[] and contains for a key of a
+    // transparent type Q (see is_transparent_key in map.h), such as
+    // std::string_view for std::string keys, without building a K.
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    V &operator[](const Q &key);
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    const V &operator[](const Q &key) const;
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    bool contains(const Q &key) const;
+
+    // Returns the keys k in the collection such that k1 <= k <= k2
+    ArraySeq<K> find_keys(const K &k1, const K &k2) const;
+
+    // Returns the keys in the collection in ascending sorted order
+    ArraySeq<K> sorted_keys() const;
+
+    // Returns the representation in use
+    Layout layout() const;
+
+    // Sets the largest size kept as an array (default 16, where
+    // HashMap lookups overtake ArrayMap ones in hw8_adaptive_perf
+    // built with -O2). Throws invalid_argument if n is negative.
+    void set_array_max(int n);
+
+    // Sets the number of range queries (find_keys or sorted_keys) on
+    // a hash table that turn it into a tree (default 1; 0 never
+    // builds a tree). Throws invalid_argument if n is negative.
+    void set_tree_after_ranges(int n);
+
+private:
+    // the representations (only the one in use holds pairs); mutable
+    // so range queries can switch to the tree
+    mutable ArrayMap<K, V> array_map;
+    mutable HashMap<K, V> hash_map;
+    mutable AVLMap<K, V> tree_map;
+    mutable Layout current = ARRAY_LAYOUT;
+
+    // range queries seen since becoming a hash table
+    mutable int range_queries = 0;
+
+    int array_max = 16;
+    int tree_after_ranges = 1;
+
+    // the map in use
+    Map<K, V> &active();
+    const Map<K, V> &active() const;
+
+    // calls f on the map in use as its own type, which (unlike
+    // active) reaches the templated members such as emplace
+    template <typename F>
+    decltype(auto) visit(F f);
+    template <typename F>
+    decltype(auto) visit(F f) const;
+
+    // switches representation if the size calls for it
+    void adapt_to_size();
+
+    // counts a range query, switching to the tree if due
+    void note_range_query() const;
+
+    // moves every pair to the target representation
+    void move_to(Layout target) const;
+};
+
+// Returns the number of key-value pairs in the map
+template <typename K, typename V>
+int AdaptiveMap<K, V>::size() const
+{
+    return active().size();
+}
+
+// Tests if the map is empty
+template <typename K, typename V>
+bool AdaptiveMap<K, V>::empty() const
+{
+    return active().empty();
+}
+
+// Allows values associated with a key to be updated
+template <typename K, typename V>
+V &AdaptiveMap<K, V>::operator[](const K &key)
+{
+    return active()[key];
+}
+
+// Returns the value for a given key
+template <typename K, typename V>
+const V &AdaptiveMap<K, V>::operator[](const K &key) const
+{
+    return active()[key];
+}
+
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V>
+V *AdaptiveMap<K, V>::find(const K &key)
+{
+    return active().find(key);
+}
+
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V>
+const V *AdaptiveMap<K, V>::find(const K &key) const
+{
+    return active().find(key);
+}
+
+// Allows values associated with a key of type Q to be updated
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+V &AdaptiveMap<K, V>::operator[](const Q &key)
+{
+    return visit([&](auto &map) -> V & { return map[key]; });
+}
+
+// Returns the value for a key of type Q
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+const V &AdaptiveMap<K, V>::operator[](const Q &key) const
+{
+    return visit([&](const auto &map) -> const V & { return map[key]; });
+}
+
+// Extends the collection by adding the given key-value pair
+template <typename K, typename V>
+void AdaptiveMap<K, V>::insert(const K &key, const V &value)
+{
+    active().insert(key, value);
+    adapt_to_size();
+}
+
+// Extends the collection by moving in the given key-value pair
+template <typename K, typename V>
+void AdaptiveMap<K, V>::insert(K &&key, V &&value)
+{
+    active().insert(std::move(key), std::move(value));
+    adapt_to_size();
+}
+
+// Extends the collection by adding the key with a value constructed
+// from args
+template <typename K, typename V>
+template <typename KK, typename... Args>
+void AdaptiveMap<K, V>::emplace(KK &&key, Args &&...args)
+{
+    visit([&](auto &map) {
+        map.emplace(std::forward<KK>(key), std::forward<Args>(args)...);
+    });
+    adapt_to_size();
+}
+
+// Adds the key with a value constructed from args if the key is not
+// in the collection
+template <typename K, typename V>
+template <typename KK, typename... Args>
+bool AdaptiveMap<K, V>::try_emplace(KK &&key, Args &&...args)
+{
+    bool added = visit([&](auto &map) {
+        return map.try_emplace(std::forward<KK>(key), std::forward<Args>(args)...);
+    });
+    if (added)
+    {
+        adapt_to_size();
+    }
+    return added;
+}
+
+// Adds the key-value pair, or assigns the value if the key is present
+template <typename K, typename V>
+bool AdaptiveMap<K, V>::insert_or_assign(const K &key, const V &value)
+{
+    bool added = active().insert_or_assign(key, value);
+    if (added)
+    {
+        adapt_to_size();
+    }
+    return added;
+}
+
+// Returns the value for a given key, adding a default value if needed
+template <typename K, typename V>
+V &AdaptiveMap<K, V>::get_or_insert_default(const K &key)
+{
+    int before = size();
+    V *value = &active().get_or_insert_default(key);
+    if (size() > before)
+    {
+        // a switch moves every pair, so look the value up again
+        Layout was = current;
+        adapt_to_size();
+        if (current != was)
+        {
+            value = active().find(key);
+        }
+    }
+    return *value;
+}
+
+// Shrinks the collection by removing the key-value pair with the key
+template <typename K, typename V>
+void AdaptiveMap<K, V>::erase(const K &key)
+{
+    active().erase(key);
+    adapt_to_size();
+}
+
+// Removes the key-value pair if present, returning whether it was
+template <typename K, typename V>
+bool AdaptiveMap<K, V>::try_erase(const K &key)
+{
+    bool removed = active().try_erase(key);
+    if (removed)
+    {
+        adapt_to_size();
+    }
+    return removed;
+}
+
+// Returns true if the key is in the collection
+template <typename K, typename V>
+bool AdaptiveMap<K, V>::contains(const K &key) const
+{
+    return active().contains(key);
+}
+
+// Returns true if a key of type Q is in the collection
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+bool AdaptiveMap<K, V>::contains(const Q &key) const
+{
+    return visit([&](const auto &map) { return map.contains(key); });
+}
+
+// Returns the keys k in the collection such that k1 <= k <= k2
+template <typename K, typename V>
+ArraySeq<K> AdaptiveMap<K, V>::find_keys(const K &k1, const K &k2) const
+{
+    note_range_query();
+    return active().find_keys(k1, k2);
+}
+
+// Returns the keys in the collection in ascending sorted order
+template <typename K, typename V>
+ArraySeq<K> AdaptiveMap<K, V>::sorted_keys() const
+{
+    note_range_query();
+    return active().sorted_keys();
+}
+
+// Returns the representation in use
+template <typename K, typename V>
+typename AdaptiveMap<K, V>::Layout AdaptiveMap<K, V>::layout() const
+{
+    return current;
+}
+
+// Sets the largest size kept as an array
+template <typename K, typename V>
+void AdaptiveMap<K, V>::set_array_max(int n)
+{
+    if (n < 0)
+    {
+        throw std::invalid_argument("AdaptiveMap<K, V>::set_array_max(n)");
+    }
+    array_max = n;
+    adapt_to_size();
+}
+
+// Sets the number of range queries that turn a hash table into a tree
+template <typename K, typename V>
+void AdaptiveMap<K, V>::set_tree_after_ranges(int n)
+{
+    if (n < 0)
+    {
+        throw std::invalid_argument("AdaptiveMap<K, V>::set_tree_after_ranges(n)");
+    }
+    tree_after_ranges = n;
+}
+
+// the map in use
+template <typename K, typename V>
+Map<K, V> &AdaptiveMap<K, V>::active()
+{
+    if (current == ARRAY_LAYOUT)
+    {
+        return array_map;
+    }
+    if (current == HASH_LAYOUT)
+    {
+        return hash_map;
+    }
+    return tree_map;
+}
+
+// the map in use
+template <typename K, typename V>
+const Map<K, V> &AdaptiveMap<K, V>::active() const
+{
+    if (current == ARRAY_LAYOUT)
+    {
+        return array_map;
+    }
+    if (current == HASH_LAYOUT)
+    {
+        return hash_map;
+    }
+    return tree_map;
+}
+
+// calls f on the map in use as its own type
+template <typename K, typename V>
+template <typename F>
+decltype(auto) AdaptiveMap<K, V>::visit(F f)
+{
+    if (current == ARRAY_LAYOUT)
+    {
+        return f(array_map);
+    }
+    if (current == HASH_LAYOUT)
+    {
+        return f(hash_map);
+    }
+    return f(tree_map);
+}
+
+// calls f on the map in use as its own type
+template <typename K, typename V>
+template <typename F>
+decltype(auto) AdaptiveMap<K, V>::visit(F f) const
+{
+    if (current == ARRAY_LAYOUT)
+    {
+        return f(static_cast<const ArrayMap<K, V> &>(array_map));
+    }
+    if (current == HASH_LAYOUT)
+    {
+        return f(static_cast<const HashMap<K, V> &>(hash_map));
+    }
+    return f(static_cast<const AVLMap<K, V> &>(tree_map));
+}
+
+// switches representation if the size calls for it
+template <typename K, typename V>
+void AdaptiveMap<K, V>::adapt_to_size()
+{
+    int n = active().size();
+    if (current == ARRAY_LAYOUT && n > array_max)
+    {
+        move_to(HASH_LAYOUT);
+    }
+    else if (current != ARRAY_LAYOUT && n < array_max / 2)
+    {
+        // the gap between the thresholds keeps a map near array_max
+        // from switching back and forth
+        move_to(ARRAY_LAYOUT);
+    }
+}
+
+// counts a range query, switching to the tree if due
+template <typename K, typename V>
+void AdaptiveMap<K, V>::note_range_query() const
+{
+    if (current != HASH_LAYOUT || tree_after_ranges == 0)
+    {
+        return;
+    }
+    if (++range_queries >= tree_after_ranges)
+    {
+        move_to(TREE_LAYOUT);
+    }
+}
+
+// moves every pair to the target representation
+template <typename K, typename V>
+void AdaptiveMap<K, V>::move_to(Layout target) const
+{
+    // the old representation is released below, so its values are
+    // moved rather than copied
+    Map<K, V> &from = current == ARRAY_LAYOUT ? static_cast<Map<K, V> &>(array_map)
+                      : current == HASH_LAYOUT ? static_cast<Map<K, V> &>(hash_map)
+                                               : static_cast<Map<K, V> &>(tree_map);
+    ArraySeq<K> keys = from.sorted_keys();
+    int n = keys.size();
+    if (target == TREE_LAYOUT)
+    {
+        V *values = new V[n];
+        for (int i = 0; i < n; ++i)
+        {
+            values[i] = std::move(from[keys[i]]);
+        }
+        tree_map.build_from_sorted(keys.data(), values, n);
+        delete[] values;
+    }
+    else
+    {
+        Map<K, V> &to = target == ARRAY_LAYOUT ? static_cast<Map<K, V> &>(array_map)
+                                               : static_cast<Map<K, V> &>(hash_map);
+        for (int i = 0; i < n; ++i)
+        {
+            V &value = from[keys[i]];
+            to.insert(std::move(keys[i]), std::move(value));
+        }
+    }
+    // release the old representation's storage
+    if (current == ARRAY_LAYOUT)
+    {
+        array_map = ArrayMap<K, V>();
+    }
+    else if (current == HASH_LAYOUT)
+    {
+        hash_map = HashMap<K, V>();
+    }
+    else
+    {
+        tree_map = AVLMap<K, V>();
+    }
+    current = target;
+    range_queries = 0;
+}
+
+#endif
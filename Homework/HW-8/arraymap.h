@@ -0,0 +1,356 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: arraymap.h
+// DATE: Fall 2021
+// DESC: A map stored as an unsorted array of key-value pairs and
+//       searched linearly. Inserts append and erases close the gap,
+//       so pairs stay in insertion order. With no table or tree to
+//       maintain it is the fastest map for a handful of pairs, which
+//       is why AdaptiveMap starts as one.
+//---------------------------------------------------------------------------
+
+#ifndef ARRAYMAP_H
+#define ARRAYMAP_H
+
+#include "map.h"
+#include "arrayseq.h"
+#include "kvstore.h"
+
+// An unsorted array map searched linearly. Store picks the memory
+// layout (PairStore or ColumnStore, see kvstore.h).
+template <typename K, typename V,
+          template <typename, typename> class Store = PairStore>
+class ArrayMap : public Map<K, V>
+{
+public:
+    // Returns the number of key-value pairs in the map
+    int size() const;
+
+    // Tests if the map is empty
+    bool empty() const;
+
+    // Allows values associated with a key to be updated. Throws
+    // out_of_range if the given key is not in the collection.
+    V &operator[](const K &key);
+
+    // Returns the value for a given key. Throws out_of_range if the
+    // given key is not in the collection.
+    const V &operator[](const K &key) const;
+
+    // Returns a pointer to the value for a given key, or nullptr if
+    // the key is not in the collection.
+    V *find(const K &key);
+    const V *find(const K &key) const;
+
+    // Extends the collection by adding the given key-value
+    // pair. Assumes the key being added is not present in the
+    // collection. Insert does not check if the key is present.
+    void insert(const K &key, const V &value);
+
+    // Same as insert, but moves the key and value into the
+    // collection instead of copying them.
+    void insert(K &&key, V &&value);
+
+    // Extends the collection by adding the key with a value
+    // constructed in place from args. Like insert, assumes the key is
+    // not present in the collection.
+    template <typename KK, typename... Args>
+    void emplace(KK &&key, Args &&...args);
+
+    // Adds the key with a value constructed in place from args if the
+    // key is not in the collection. Returns true if it was added; if
+    // not, the key and args are left untouched.
+    template <typename KK, typename... Args>
+    bool try_emplace(KK &&key, Args &&...args);
+
+    // Adds the key-value pair if the key is not in the collection, and
+    // otherwise assigns value to the key's value. Returns true if the
+    // pair was added.
+    bool insert_or_assign(const K &key, const V &value);
+
+    // Returns the value for a given key, first adding the key with a
+    // default-constructed value if it is not in the collection.
+    V &get_or_insert_default(const K &key);
+
+    // Shrinks the collection by removing the key-value pair with the
+    // given key. Does not modify the collection if the collection does
+    // not contain the key. Throws out_of_range if the given key is not
+    // in the collection.
+    void erase(const K &key);
+
+    // Same as erase, but returns false instead of throwing if the key
+    // is not in the collection, and true if the pair was removed.
+    bool try_erase(const K &key);
+
+    // Returns true if the key is in the collection, and false
+    // otherwise.
+    bool contains(const K &key) const;
+
+    // Heterogeneous lookup: operator[] and contains for a key of a
+    // transparent type Q (see is_transparent_key in map.h), such as
+    // std::string_view for std::string keys, without building a K.
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    V &operator[](const Q &key);
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    const V &operator[](const Q &key) const;
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    bool contains(const Q &key) const;
+
+    // Returns the keys k in the collection such that k1 <= k <= k2
+    ArraySeq<K> find_keys(const K &k1, const K &k2) const;
+
+    // Returns the keys in the collection in ascending sorted order.
+    ArraySeq<K> sorted_keys() const;
+
+private:
+    // the key-value pairs in insertion order, laid out by the Store
+    // policy
+    Store<K, V> seq;
+
+    // returns the index of the key, or -1 if it is not present (Q is
+    // K or any type the keys compare with)
+    template <typename Q>
+    int index_of(const Q &key) const;
+};
+
+// Returns the number of key-value pairs in the map
+template <typename K, typename V, template <typename, typename> class Store>
+int ArrayMap<K, V, Store>::size() const
+{
+    return seq.size();
+}
+
+// Tests if the map is empty
+template <typename K, typename V, template <typename, typename> class Store>
+bool ArrayMap<K, V, Store>::empty() const
+{
+    return seq.empty();
+}
+
+// Allows values associated with a key to be updated. Throws
+// out_of_range if the given key is not in the collection.
+template <typename K, typename V, template <typename, typename> class Store>
+V &ArrayMap<K, V, Store>::operator[](const K &key)
+{
+    int index = index_of(key);
+    if (index < 0)
+    {
+        throw std::out_of_range("Out of range in the [] nonconst");
+    }
+    return seq.value(index);
+}
+
+// Returns the value for a given key. Throws out_of_range if the
+// given key is not in the collection.
+template <typename K, typename V, template <typename, typename> class Store>
+const V &ArrayMap<K, V, Store>::operator[](const K &key) const
+{
+    int index = index_of(key);
+    if (index < 0)
+    {
+        throw std::out_of_range("Out of range in the [] nonconst");
+    }
+    return seq.value(index);
+}
+
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V, template <typename, typename> class Store>
+V *ArrayMap<K, V, Store>::find(const K &key)
+{
+    int index = index_of(key);
+    return index >= 0 ? &seq.value(index) : nullptr;
+}
+
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V, template <typename, typename> class Store>
+const V *ArrayMap<K, V, Store>::find(const K &key) const
+{
+    int index = index_of(key);
+    return index >= 0 ? &seq.value(index) : nullptr;
+}
+
+// Allows values associated with a key of type Q to be updated
+template <typename K, typename V, template <typename, typename> class Store>
+template <typename Q, enable_if_transparent<K, Q>>
+V &ArrayMap<K, V, Store>::operator[](const Q &key)
+{
+    int index = index_of(key);
+    if (index < 0)
+    {
+        throw std::out_of_range("Out of range in the [] nonconst");
+    }
+    return seq.value(index);
+}
+
+// Returns the value for a key of type Q
+template <typename K, typename V, template <typename, typename> class Store>
+template <typename Q, enable_if_transparent<K, Q>>
+const V &ArrayMap<K, V, Store>::operator[](const Q &key) const
+{
+    int index = index_of(key);
+    if (index < 0)
+    {
+        throw std::out_of_range("Out of range in the [] nonconst");
+    }
+    return seq.value(index);
+}
+
+// Extends the collection by adding the given key-value
+// pair. Assumes the key being added is not present in the
+// collection. Insert does not check if the key is present.
+template <typename K, typename V, template <typename, typename> class Store>
+void ArrayMap<K, V, Store>::insert(const K &key, const V &value)
+{
+    seq.insert(key, value, seq.size());
+}
+
+// Extends the collection by moving in the given key-value pair
+template <typename K, typename V, template <typename, typename> class Store>
+void ArrayMap<K, V, Store>::insert(K &&key, V &&value)
+{
+    seq.emplace(seq.size(), std::move(key), std::move(value));
+}
+
+// Extends the collection by adding the key with a value constructed
+// from args
+template <typename K, typename V, template <typename, typename> class Store>
+template <typename KK, typename... Args>
+void ArrayMap<K, V, Store>::emplace(KK &&key, Args &&...args)
+{
+    seq.emplace(seq.size(), std::forward<KK>(key), std::forward<Args>(args)...);
+}
+
+// Adds the key with a value constructed from args if the key is not
+// in the collection
+template <typename K, typename V, template <typename, typename> class Store>
+template <typename KK, typename... Args>
+bool ArrayMap<K, V, Store>::try_emplace(KK &&key, Args &&...args)
+{
+    if (index_of(key) >= 0)
+    {
+        return false;
+    }
+    seq.emplace(seq.size(), std::forward<KK>(key), std::forward<Args>(args)...);
+    return true;
+}
+
+// Adds the key-value pair, or assigns the value if the key is present
+template <typename K, typename V, template <typename, typename> class Store>
+bool ArrayMap<K, V, Store>::insert_or_assign(const K &key, const V &value)
+{
+    int index = index_of(key);
+    if (index >= 0)
+    {
+        seq.value(index) = value;
+        return false;
+    }
+    seq.insert(key, value, seq.size());
+    return true;
+}
+
+// Returns the value for a given key, adding a default value if needed
+template <typename K, typename V, template <typename, typename> class Store>
+V &ArrayMap<K, V, Store>::get_or_insert_default(const K &key)
+{
+    int index = index_of(key);
+    if (index < 0)
+    {
+        index = seq.size();
+        seq.emplace(index, key);
+    }
+    return seq.value(index);
+}
+
+// Shrinks the collection by removing the key-value pair with the
+// given key. Does not modify the collection if the collection does
+// not contain the key. Throws out_of_range if the given key is not
+// in the collection.
+template <typename K, typename V, template <typename, typename> class Store>
+void ArrayMap<K, V, Store>::erase(const K &key)
+{
+    int index = index_of(key);
+    if (index < 0)
+    {
+        throw std::out_of_range("Out of range in the [] nonconst");
+    }
+    seq.erase(index);
+}
+
+// Removes the key-value pair if present, returning whether it was
+template <typename K, typename V, template <typename, typename> class Store>
+bool ArrayMap<K, V, Store>::try_erase(const K &key)
+{
+    int index = index_of(key);
+    if (index < 0)
+    {
+        return false;
+    }
+    seq.erase(index);
+    return true;
+}
+
+// Returns true if the key is in the collection, and false
+// otherwise.
+template <typename K, typename V, template <typename, typename> class Store>
+bool ArrayMap<K, V, Store>::contains(const K &key) const
+{
+    return index_of(key) >= 0;
+}
+
+// Returns true if a key of type Q is in the collection
+template <typename K, typename V, template <typename, typename> class Store>
+template <typename Q, enable_if_transparent<K, Q>>
+bool ArrayMap<K, V, Store>::contains(const Q &key) const
+{
+    return index_of(key) >= 0;
+}
+
+// Returns the keys k in the collection such that k1 <= k <= k2
+template <typename K, typename V, template <typename, typename> class Store>
+ArraySeq<K> ArrayMap<K, V, Store>::find_keys(const K &k1, const K &k2) const
+{
+    ArraySeq<K> new_seq;
+    ArraySeq<K> keys = sorted_keys();
+    for (int i = 0; i < keys.size(); ++i)
+    {
+        if (keys[i] >= k1 && keys[i] <= k2)
+        {
+            new_seq.insert(keys[i], new_seq.size());
+        }
+    }
+    return new_seq;
+}
+
+// Returns the keys in the collection in ascending sorted order.
+template <typename K, typename V, template <typename, typename> class Store>
+ArraySeq<K> ArrayMap<K, V, Store>::sorted_keys() const
+{
+    ArraySeq<K> new_seq;
+    for (int i = 0; i < seq.size(); ++i)
+    {
+        new_seq.insert(seq.key(i), new_seq.size());
+    }
+    new_seq.merge_sort();
+    return new_seq;
+}
+
+// returns the index of the key, or -1 if it is not present
+template <typename K, typename V, template <typename, typename> class Store>
+template <typename Q>
+int ArrayMap<K, V, Store>::index_of(const Q &key) const
+{
+    // scan the raw items, which are only keys in a ColumnStore
+    typename Store<K, V>::KeyOf key_of;
+    const typename Store<K, V>::Item *items = seq.items();
+    int n = seq.size();
+    for (int i = 0; i < n; ++i)
+    {
+        if (key_of(items[i]) == key)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+#endif
@@ -13,7 +13,10 @@
 #include <ostream>
 #include <iostream>
 #include <random>
+#include <string>
+#include <utility>
 #include "sequence.h"
+#include "snapshot.h"
 
 template <typename T>
 class ArraySeq : public Sequence<T>
@@ -55,6 +58,9 @@ public:
     // index. Throws out_of_range if the index is invalid.
     virtual void insert(const T &elem, int index);
 
+    // Same as insert, but moves the element into the sequence
+    void insert(T &&elem, int index);
+
     // Shrinks the sequence by removing the element at the index in the
     // sequence. Throws out_of_range if index is invalid.
     virtual void erase(int index);
@@ -73,6 +79,24 @@ public:
     // implements quick sort over current sequence
     virtual void quick_sort();
 
+    // Grows the capacity of the sequence to hold at least n elements
+    // without resizing
+    void reserve(int n);
+
+    // Returns the underlying array for read-only bulk access. The
+    // pointer is invalidated by any insert or erase.
+    const T *data() const;
+
+    // Writes the sequence to a binary snapshot file. Requires a
+    // trivially copyable element type. Throws runtime_error if the
+    // file cannot be written.
+    void save(const std::string &path) const;
+
+    // Replaces the contents of the sequence with those of a snapshot
+    // file written by save. Throws runtime_error if the file cannot
+    // be read or holds a different element type.
+    void load(const std::string &path);
+
 private:
     // resizable array
     T *array = nullptr;
@@ -91,8 +115,9 @@ private:
     void make_empty();
 
     // MORE
-    // helper functions for merge and quick sort
-    void merge_sort(int start, int end);
+    // helper functions for merge and quick sort (temp is scratch space
+    // for merging, at least as large as the sequence)
+    void merge_sort(int start, int end, T temp[]);
 
     void quick_sort(int start, int end);
 };
@@ -148,6 +173,7 @@ ArraySeq<T> &ArraySeq<T>::operator=(ArraySeq<T> &&rhs)
     {
         // do the assignment
         make_empty();
+        delete[] array;
 
         count = rhs.count;
 
@@ -218,6 +244,29 @@ const T &ArraySeq<T>::operator[](int index) const
 
 template <typename T>
 void ArraySeq<T>::insert(const T &elem, int index)
+{
+    // check the index
+    if (index > size() || index < 0)
+    {
+        throw std::out_of_range("Out of range in the [] nonconst");
+    }
+    // copy first, since elem may be one of our own elements
+    T temp = elem;
+    if (size() + 1 > capacity)
+    {
+        resize();
+    }
+    for (int i = count; i > index; --i)
+    {
+        array[i] = std::move(array[i - 1]);
+    }
+    array[index] = std::move(temp);
+    count++;
+}
+
+// Extends the sequence by moving the element in at the given index
+template <typename T>
+void ArraySeq<T>::insert(T &&elem, int index)
 {
     // check the index
     if (index > size() || index < 0)
@@ -228,14 +277,11 @@ void ArraySeq<T>::insert(const T &elem, int index)
     {
         resize();
     }
-    T temp1 = array[index];
-    for (int i = index; i < count; ++i)
+    for (int i = count; i > index; --i)
     {
-        T temp2 = array[i + 1];
-        array[i + 1] = temp1;
-        temp1 = temp2;
+        array[i] = std::move(array[i - 1]);
     }
-    array[index] = elem;
+    array[index] = std::move(elem);
     count++;
 }
 
@@ -286,7 +332,7 @@ void ArraySeq<T>::resize()
     T *new_array = new T[capacity];
     for (int i = 0; i < capacity / 2; ++i)
     {
-        new_array[i] = array[i];
+        new_array[i] = std::move(array[i]);
     }
     delete[] array;
     array = new_array;
@@ -331,7 +377,10 @@ std::ostream &operator<<(std::ostream &stream, const ArraySeq<T> &array)
 template <typename T>
 void ArraySeq<T>::merge_sort()
 {
-    merge_sort(0, count - 1);
+    // one scratch array for every merge, instead of one per call
+    T *temp = new T[count > 0 ? count : 1];
+    merge_sort(0, count - 1, temp);
+    delete[] temp;
 }
 
 // implements quick sort over current sequence
@@ -343,20 +392,19 @@ void ArraySeq<T>::quick_sort()
 
 // helper functions for merge and quick sort
 template <typename T>
-void ArraySeq<T>::merge_sort(int start, int end)
+void ArraySeq<T>::merge_sort(int start, int end, T temp[])
 {
     int mid = (start + end) / 2;
     if (start < end)
     {
-        merge_sort(start, mid);
-        merge_sort(mid + 1, end);
+        merge_sort(start, mid, temp);
+        merge_sort(mid + 1, end, temp);
     }
     else
     {
         return;
     }
 
-    T temp[(end - start) + 1];
     int first1 = start;
     int first2 = mid + 1;
     int i = 0;
@@ -409,4 +457,68 @@ void ArraySeq<T>::quick_sort(int start, int end)
         quick_sort(end_p1 + 1, end);
     }
 }
+
+// Grows the capacity of the sequence to hold at least n elements
+template <typename T>
+void ArraySeq<T>::reserve(int n)
+{
+    if (n <= capacity)
+    {
+        return;
+    }
+    T *new_array = new T[n];
+    for (int i = 0; i < count; ++i)
+    {
+        new_array[i] = std::move(array[i]);
+    }
+    delete[] array;
+    array = new_array;
+    capacity = n;
+}
+
+// Returns the underlying array for read-only bulk access
+template <typename T>
+const T *ArraySeq<T>::data() const
+{
+    return array;
+}
+
+// Writes the sequence to a binary snapshot file
+template <typename T>
+void ArraySeq<T>::save(const std::string &path) const
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "snapshots require a trivially copyable element type");
+    std::ofstream out;
+    write_snapshot_header(out, path, ARRAYSEQ_SNAPSHOT, sizeof(T), 0, count);
+    out.write(reinterpret_cast<const char *>(array), sizeof(T) * count);
+    if (!out)
+    {
+        throw std::runtime_error("snapshot write failed: " + path);
+    }
+}
+
+// Replaces the contents of the sequence with a snapshot file
+template <typename T>
+void ArraySeq<T>::load(const std::string &path)
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "snapshots require a trivially copyable element type");
+    std::ifstream in;
+    int n = snapshot_count_as_int(read_snapshot_header(in, path, ARRAYSEQ_SNAPSHOT,
+                                                       sizeof(T), 0),
+                                  path);
+    // read into a fresh array so a failed load leaves this unchanged
+    T *new_array = new T[n > 0 ? n : 1];
+    if (!in.read(reinterpret_cast<char *>(new_array), sizeof(T) * n))
+    {
+        delete[] new_array;
+        throw std::runtime_error("snapshot is truncated: " + path);
+    }
+    delete[] array;
+    array = new_array;
+    count = n;
+    capacity = n > 0 ? n : 1;
+}
+
 #endif
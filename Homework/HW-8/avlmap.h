@@ -7,8 +7,11 @@
 #ifndef AVLMAP_H
 #define AVLMAP_H
 
+#include <exception>
+#include <thread>
 #include "map.h"
 #include "arrayseq.h"
+#include "snapshot.h"
 
 template <typename K, typename V>
 class AVLMap : public Map<K, V>
@@ -46,29 +49,102 @@ public:
     // given key is not in the collection.
     const V &operator[](const K &key) const;
 
+    // Returns a pointer to the value for a given key, or nullptr if
+    // the key is not in the collection.
+    V *find(const K &key);
+    const V *find(const K &key) const;
+
     // Extends the collection by adding the given key-value
     // pair. Assumes the key being added is not present in the
     // collection. Insert does not check if the key is present.
     void insert(const K &key, const V &value);
 
+    // Same as insert, but moves the key and value into the
+    // collection instead of copying them.
+    void insert(K &&key, V &&value);
+
+    // Extends the collection by adding the key with a value
+    // constructed in place from args. Like insert, assumes the key is
+    // not present in the collection.
+    template <typename KK, typename... Args>
+    void emplace(KK &&key, Args &&...args);
+
+    // Adds the key with a value constructed in place from args if the
+    // key is not in the collection. Returns true if it was added; if
+    // not, the key and args are left untouched.
+    template <typename KK, typename... Args>
+    bool try_emplace(KK &&key, Args &&...args);
+
+    // Adds the key-value pair if the key is not in the collection, and
+    // otherwise assigns value to the key's value. Returns true if the
+    // pair was added.
+    bool insert_or_assign(const K &key, const V &value);
+
+    // Returns the value for a given key, first adding the key with a
+    // default-constructed value if it is not in the collection.
+    V &get_or_insert_default(const K &key);
+
     // Shrinks the collection by removing the key-value pair with the
     // given key. Does not modify the collection if the collection does
     // not contain the key. Throws out_of_range if the given key is not
     // in the collection.
     void erase(const K &key);
 
+    // Same as erase, but returns false instead of throwing if the key
+    // is not in the collection, and true if the pair was removed.
+    bool try_erase(const K &key);
+
     // Returns true if the key is in the collection, and false otherwise.
     bool contains(const K &key) const;
 
+    // Heterogeneous lookup: operator[] and contains for a key of a
+    // transparent type Q (see is_transparent_key in map.h), such as
+    // std::string_view for std::string keys, without building a K.
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    V &operator[](const Q &key);
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    const V &operator[](const Q &key) const;
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    bool contains(const Q &key) const;
+
     // Returns the keys k in the collection such that k1 <= k <= k2
     ArraySeq<K> find_keys(const K &k1, const K &k2) const;
 
+    // Appends the keys k in the collection such that k1 <= k <= k2 to
+    // keys, which may be any sequence (such as a SmallArraySeq that
+    // holds small results without allocating)
+    template <typename Seq>
+    void find_keys(const K &k1, const K &k2, Seq &keys) const;
+
     // Returns the keys in the collection in ascending sorted order
     ArraySeq<K> sorted_keys() const;
 
     // Returns the height of the binary search tree
     int height() const;
 
+    // Writes the key-value pairs, in sorted order, to a binary
+    // snapshot file. Throws runtime_error if the file cannot be
+    // written.
+    void save(const std::string &path) const;
+
+    // Replaces the contents of the map with those of a snapshot file
+    // written by save. The tree is built balanced directly from the
+    // sorted records instead of by repeated insert. Throws
+    // runtime_error if the file cannot be read or holds different key
+    // or value types.
+    void load(const std::string &path);
+
+    // Replaces the contents of the map with the n given keys and
+    // values, whose keys must be in strictly ascending order. The tree
+    // is built balanced from the midpoints, with the subtrees of large
+    // ranges built on their own threads (see set_threads). Throws
+    // invalid_argument if the keys are out of order.
+    void build_from_sorted(const K keys[], const V values[], int n);
+
+    // Sets the maximum number of threads used by build_from_sorted and
+    // load (0, the default, uses the hardware concurrency)
+    void set_threads(int n);
+
     // helper to print the tree for debugging
     void print() const;
 
@@ -95,19 +171,55 @@ private:
     // copy assignment helper
     Node *copy(const Node *rhs_st_root) const;
 
-    // erase helper
+    // erase helper, decrements count if it removes the key's node
     Node *erase(const K &key, Node *st_root);
 
-    // insert helper
-    Node *insert(const K &key, const V &value, Node *st_root);
+    // insert helper, links the new node into the subtree
+    Node *insert(Node *node, Node *st_root);
+
+    // find-or-insert helper: walks the subtree once, setting found to
+    // the node with the key if there is one, and otherwise to a node
+    // from make() linked in where the key belongs (the subtree is
+    // rebalanced on the way back up, as in insert)
+    template <typename Q, typename Make>
+    Node *find_or_insert(const Q &key, Node *st_root, Node *&found, Make make);
+
+    // sets the node's height from its children's
+    static void update_height(Node *st_root);
+
+    // returns the node with the given key, or nullptr
+    template <typename Q>
+    Node *find_node(const Q &key) const;
 
     // find_keys helper
+    template <typename Seq>
     void find_keys(const K &k1, const K &k2, const Node *st_root,
-                   ArraySeq<K> &keys) const;
+                   Seq &keys) const;
 
     // sorted_keys helper
     void sorted_keys(const Node *st_root, ArraySeq<K> &keys) const;
 
+    // save helper, writes the subtree in sorted order
+    void save(const Node *st_root, SnapshotWriter<K, V> &out) const;
+
+    // builds a balanced subtree from the sorted keys and values in
+    // the index range [start, end]
+    Node *build(const K keys[], const V values[], int start, int end);
+
+    // max threads for build_from_sorted and load (0 = hardware)
+    int threads = 0;
+
+    // smallest range worth handing half of to a new thread
+    static const int min_build_per_thread = 65536;
+
+    // number of threads to build with
+    int build_threads() const;
+
+    // builds the subtree for [start, end] with up to n threads: the
+    // left subtree goes to a new thread with half of them, and the
+    // right subtree stays on this one with the rest
+    Node *build(const K keys[], const V values[], int start, int end, int n);
+
     // rotations
     Node *right_rotate(Node *k2);
     Node *left_rotate(Node *k2);
@@ -229,23 +341,12 @@ bool AVLMap<K, V>::empty() const
 template <typename K, typename V>
 V &AVLMap<K, V>::operator[](const K &key)
 {
-    Node *st_root = root;
-    while (st_root)
+    Node *st_root = find_node(key);
+    if (st_root == nullptr)
     {
-        if (key == st_root->key)
-        {
-            return st_root->value;
-        }
-        else if (key < st_root->key)
-        {
-            st_root = st_root->left;
-        }
-        else
-        {
-            st_root = st_root->right;
-        }
+        throw std::out_of_range("key not found");
     }
-    throw std::out_of_range("key not found");
+    return st_root->value;
 }
 
 // Returns the value for a given key. Throws out_of_range if the
@@ -253,23 +354,54 @@ V &AVLMap<K, V>::operator[](const K &key)
 template <typename K, typename V>
 const V &AVLMap<K, V>::operator[](const K &key) const
 {
-    Node *st_root = root;
-    while (st_root)
+    Node *st_root = find_node(key);
+    if (st_root == nullptr)
     {
-        if (key == st_root->key)
-        {
-            return st_root->value;
-        }
-        else if (key < st_root->key)
-        {
-            st_root = st_root->left;
-        }
-        else
-        {
-            st_root = st_root->right;
-        }
+        throw std::out_of_range("key not found");
     }
-    throw std::out_of_range("key not found");
+    return st_root->value;
+}
+
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V>
+V *AVLMap<K, V>::find(const K &key)
+{
+    Node *curr = find_node(key);
+    return curr != nullptr ? &curr->value : nullptr;
+}
+
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V>
+const V *AVLMap<K, V>::find(const K &key) const
+{
+    Node *curr = find_node(key);
+    return curr != nullptr ? &curr->value : nullptr;
+}
+
+// Allows values associated with a key of type Q to be updated
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+V &AVLMap<K, V>::operator[](const Q &key)
+{
+    Node *st_root = find_node(key);
+    if (st_root == nullptr)
+    {
+        throw std::out_of_range("key not found");
+    }
+    return st_root->value;
+}
+
+// Returns the value for a key of type Q
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+const V &AVLMap<K, V>::operator[](const Q &key) const
+{
+    Node *st_root = find_node(key);
+    if (st_root == nullptr)
+    {
+        throw std::out_of_range("key not found");
+    }
+    return st_root->value;
 }
 
 // Extends the collection by adding the given key-value
@@ -278,10 +410,70 @@ const V &AVLMap<K, V>::operator[](const K &key) const
 template <typename K, typename V>
 void AVLMap<K, V>::insert(const K &key, const V &value)
 {
-    root = insert(key, value, root);
+    emplace(key, value);
+}
+
+// Extends the collection by moving in the given key-value pair
+template <typename K, typename V>
+void AVLMap<K, V>::insert(K &&key, V &&value)
+{
+    emplace(std::move(key), std::move(value));
+}
+
+// Extends the collection by adding the key with a value constructed
+// from args
+template <typename K, typename V>
+template <typename KK, typename... Args>
+void AVLMap<K, V>::emplace(KK &&key, Args &&...args)
+{
+    // the key and value are built directly in the node
+    Node *node = new Node{K(std::forward<KK>(key)),
+                          V(std::forward<Args>(args)...), nullptr, nullptr, 1};
+    root = insert(node, root);
     count++;
 }
 
+// Adds the key with a value constructed from args if the key is not
+// in the collection
+template <typename K, typename V>
+template <typename KK, typename... Args>
+bool AVLMap<K, V>::try_emplace(KK &&key, Args &&...args)
+{
+    int before = count;
+    Node *found = nullptr;
+    root = find_or_insert(key, root, found, [&]()
+                          { return new Node{K(std::forward<KK>(key)),
+                                            V(std::forward<Args>(args)...),
+                                            nullptr, nullptr, 1}; });
+    return count > before;
+}
+
+// Adds the key-value pair, or assigns the value if the key is present
+template <typename K, typename V>
+bool AVLMap<K, V>::insert_or_assign(const K &key, const V &value)
+{
+    int before = count;
+    Node *found = nullptr;
+    root = find_or_insert(key, root, found, [&]()
+                          { return new Node{key, value, nullptr, nullptr, 1}; });
+    if (count == before)
+    {
+        found->value = value;
+        return false;
+    }
+    return true;
+}
+
+// Returns the value for a given key, adding a default value if needed
+template <typename K, typename V>
+V &AVLMap<K, V>::get_or_insert_default(const K &key)
+{
+    Node *found = nullptr;
+    root = find_or_insert(key, root, found, [&]()
+                          { return new Node{key, V(), nullptr, nullptr, 1}; });
+    return found->value;
+}
+
 // Shrinks the collection by removing the key-value pair with the
 // given key. Does not modify the collection if the collection does
 // not contain the key. Throws out_of_range if the given key is not
@@ -289,38 +481,36 @@ void AVLMap<K, V>::insert(const K &key, const V &value)
 template <typename K, typename V>
 void AVLMap<K, V>::erase(const K &key)
 {
-    if (contains(key))
-    {
-        root = erase(key, root);
-        count--;
-    }
-    else
+    if (!try_erase(key))
     {
         throw std::out_of_range("Key is not in the tree");
     }
 }
 
+// Removes the key-value pair if present, returning whether it was
+template <typename K, typename V>
+bool AVLMap<K, V>::try_erase(const K &key)
+{
+    // the erase helper stops at an empty subtree, so no contains
+    // walk is needed first
+    int before = count;
+    root = erase(key, root);
+    return count < before;
+}
+
 // Returns true if the key is in the collection, and false otherwise.
 template <typename K, typename V>
 bool AVLMap<K, V>::contains(const K &key) const
 {
-    Node *curr = root;
-    while (curr != nullptr)
-    {
-        if (curr->key == key)
-        {
-            return true;
-        }
-        else if (curr->key < key)
-        {
-            curr = curr->right;
-        }
-        else
-        {
-            curr = curr->left;
-        }
-    }
-    return false;
+    return find_node(key) != nullptr;
+}
+
+// Returns true if a key of type Q is in the collection
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+bool AVLMap<K, V>::contains(const Q &key) const
+{
+    return find_node(key) != nullptr;
 }
 
 // Returns the keys k in the collection such that k1 <= k <= k2
@@ -332,6 +522,14 @@ ArraySeq<K> AVLMap<K, V>::find_keys(const K &k1, const K &k2) const
     return foundKeys;
 }
 
+// Appends the keys k in the collection such that k1 <= k <= k2
+template <typename K, typename V>
+template <typename Seq>
+void AVLMap<K, V>::find_keys(const K &k1, const K &k2, Seq &keys) const
+{
+    find_keys(k1, k2, root, keys);
+}
+
 // Returns the keys in the collection in ascending sorted order
 template <typename K, typename V>
 ArraySeq<K> AVLMap<K, V>::sorted_keys() const
@@ -365,7 +563,7 @@ void AVLMap<K, V>::make_empty(Node *st_root)
     {
         make_empty(st_root->left);
         make_empty(st_root->right);
-        st_root = nullptr;
+        delete st_root;
     }
 }
 
@@ -390,6 +588,11 @@ typename AVLMap<K, V>::Node *AVLMap<K, V>::copy(const Node *rhs_st_root) const
 template <typename K, typename V>
 typename AVLMap<K, V>::Node *AVLMap<K, V>::erase(const K &key, Node *st_root)
 {
+    if (st_root == nullptr)
+    {
+        // the key is not in the tree
+        return st_root;
+    }
     if (key < st_root->key)
     {
         st_root->left = erase(key, st_root->left);
@@ -406,6 +609,7 @@ typename AVLMap<K, V>::Node *AVLMap<K, V>::erase(const K &key, Node *st_root)
             Node *tmp = st_root;
             st_root = st_root->right;
             delete tmp;
+            count--;
         }
         else if (!st_root->right)
         {
@@ -413,30 +617,21 @@ typename AVLMap<K, V>::Node *AVLMap<K, V>::erase(const K &key, Node *st_root)
             Node *tmp = st_root;
             st_root = st_root->left;
             delete tmp;
+            count--;
         }
         else
         {
             //find in-order successor
             Node *succ = st_root->right;
-            Node *prev = st_root;
             while (succ->left)
             {
-                prev = succ;
                 succ = succ->left;
             }
-            //copy into st_root
+            //copy into st_root, then remove the successor (which also
+            //deletes it) from the right subtree
             st_root->key = succ->key;
             st_root->value = succ->value;
-
-            st_root->right = erase(succ->key, st_root->right);
-            if (prev != st_root)
-            {
-                prev->left = succ->right;
-            }
-            else
-            {
-                prev->right = succ->right;
-            }
+            st_root->right = erase(st_root->key, st_root->right);
         }
     }
 
@@ -464,27 +659,21 @@ typename AVLMap<K, V>::Node *AVLMap<K, V>::erase(const K &key, Node *st_root)
 
 // insert helper
 template <typename K, typename V>
-typename AVLMap<K, V>::Node *AVLMap<K, V>::insert(const K &key, const V &value, Node *st_root)
+typename AVLMap<K, V>::Node *AVLMap<K, V>::insert(Node *node, Node *st_root)
 {
     if (st_root == nullptr)
     {
-        Node *ptr = new Node;
-        ptr->key = key;
-        ptr->value = value;
-        ptr->left = nullptr;
-        ptr->right = nullptr;
-        ptr->height = 1;
-        return ptr;
+        return node;
     }
     else
     {
-        if (key < st_root->key)
+        if (node->key < st_root->key)
         {
-            st_root->left = insert(key, value, st_root->left);
+            st_root->left = insert(node, st_root->left);
         }
         else
         {
-            st_root->right = insert(key, value, st_root->right);
+            st_root->right = insert(node, st_root->right);
         }
         //backtrack: update height
         if (st_root->left and st_root->right)
@@ -503,9 +692,78 @@ typename AVLMap<K, V>::Node *AVLMap<K, V>::insert(const K &key, const V &value,
     return rebalance(st_root);
 }
 
+// find-or-insert helper
+template <typename K, typename V>
+template <typename Q, typename Make>
+typename AVLMap<K, V>::Node *AVLMap<K, V>::find_or_insert(const Q &key, Node *st_root,
+                                                          Node *&found, Make make)
+{
+    if (st_root == nullptr)
+    {
+        found = make();
+        count++;
+        return found;
+    }
+    if (st_root->key == key)
+    {
+        found = st_root;
+        return st_root;
+    }
+    int before = count;
+    if (st_root->key < key)
+    {
+        st_root->right = find_or_insert(key, st_root->right, found, make);
+    }
+    else
+    {
+        st_root->left = find_or_insert(key, st_root->left, found, make);
+    }
+    if (count == before)
+    {
+        // found below, so the path back up is unchanged
+        return st_root;
+    }
+    update_height(st_root);
+    return rebalance(st_root);
+}
+
+// sets the node's height from its children's
+template <typename K, typename V>
+void AVLMap<K, V>::update_height(Node *st_root)
+{
+    int l_height = st_root->left ? st_root->left->height : 0;
+    int r_height = st_root->right ? st_root->right->height : 0;
+    st_root->height = 1 + std::max(l_height, r_height);
+}
+
+// returns the node with the given key, or nullptr
+template <typename K, typename V>
+template <typename Q>
+typename AVLMap<K, V>::Node *AVLMap<K, V>::find_node(const Q &key) const
+{
+    Node *curr = root;
+    while (curr != nullptr)
+    {
+        if (curr->key == key)
+        {
+            return curr;
+        }
+        else if (curr->key < key)
+        {
+            curr = curr->right;
+        }
+        else
+        {
+            curr = curr->left;
+        }
+    }
+    return nullptr;
+}
+
 // find_keys helper
 template <typename K, typename V>
-void AVLMap<K, V>::find_keys(const K &k1, const K &k2, const Node *st_root, ArraySeq<K> &keys) const
+template <typename Seq>
+void AVLMap<K, V>::find_keys(const K &k1, const K &k2, const Node *st_root, Seq &keys) const
 {
     if (st_root == nullptr)
     {
@@ -704,4 +962,187 @@ typename AVLMap<K, V>::Node *AVLMap<K, V>::rebalance(Node *st_root)
     return st_root;
 }
 
+// Writes the key-value pairs, in sorted order, to a snapshot file
+template <typename K, typename V>
+void AVLMap<K, V>::save(const std::string &path) const
+{
+    SnapshotWriter<K, V> out(path, AVLMAP_SNAPSHOT, count);
+    save(root, out);
+    out.flush();
+}
+
+// Replaces the contents of the map with those of a snapshot file
+template <typename K, typename V>
+void AVLMap<K, V>::load(const std::string &path)
+{
+    SnapshotReader<K, V> in(path, AVLMAP_SNAPSHOT);
+    int n = snapshot_count_as_int(in.count(), path);
+    K *keys = new K[n];
+    V *values = nullptr;
+    Node *new_root = nullptr;
+    try
+    {
+        values = new V[n];
+        for (int i = 0; i < n; ++i)
+        {
+            in.read(keys[i], values[i]);
+            // as in build_from_sorted, unsorted keys would not make a
+            // search tree
+            if (i > 0 && !(keys[i - 1] < keys[i]))
+            {
+                throw std::runtime_error("snapshot keys are out of order: " + path);
+            }
+        }
+        // build before freeing the old tree, so a failed load leaves
+        // the map unchanged
+        new_root = build(keys, values, 0, n - 1, build_threads());
+    }
+    catch (...)
+    {
+        delete[] keys;
+        delete[] values;
+        throw;
+    }
+    delete[] keys;
+    delete[] values;
+    make_empty(root);
+    root = new_root;
+    count = n;
+}
+
+// Replaces the contents of the map with the sorted keys and values
+template <typename K, typename V>
+void AVLMap<K, V>::build_from_sorted(const K keys[], const V values[], int n)
+{
+    for (int i = 1; i < n; ++i)
+    {
+        if (!(keys[i - 1] < keys[i]))
+        {
+            throw std::invalid_argument("AVLMap<K, V>::build_from_sorted(keys)");
+        }
+    }
+    // build before freeing the old tree, so a failed build leaves the
+    // map unchanged
+    Node *new_root = build(keys, values, 0, n - 1, build_threads());
+    make_empty(root);
+    root = new_root;
+    count = n;
+}
+
+// Sets the maximum number of threads used by build_from_sorted and load
+template <typename K, typename V>
+void AVLMap<K, V>::set_threads(int n)
+{
+    threads = n < 0 ? 0 : n;
+}
+
+// save helper
+template <typename K, typename V>
+void AVLMap<K, V>::save(const Node *st_root, SnapshotWriter<K, V> &out) const
+{
+    if (st_root != nullptr)
+    {
+        save(st_root->left, out);
+        out.write(st_root->key, st_root->value);
+        save(st_root->right, out);
+    }
+}
+
+// builds a balanced subtree from sorted keys and values
+template <typename K, typename V>
+typename AVLMap<K, V>::Node *AVLMap<K, V>::build(const K keys[], const V values[], int start, int end)
+{
+    if (start > end)
+    {
+        return nullptr;
+    }
+    int mid = (start + end) / 2;
+    Node *st_root = new Node;
+    st_root->left = nullptr;
+    st_root->right = nullptr;
+    try
+    {
+        st_root->key = keys[mid];
+        st_root->value = values[mid];
+        st_root->left = build(keys, values, start, mid - 1);
+        st_root->right = build(keys, values, mid + 1, end);
+    }
+    catch (...)
+    {
+        // free the partly built subtree
+        make_empty(st_root);
+        throw;
+    }
+    int l_height = st_root->left ? st_root->left->height : 0;
+    int r_height = st_root->right ? st_root->right->height : 0;
+    st_root->height = 1 + std::max(l_height, r_height);
+    return st_root;
+}
+
+// number of threads to build with
+template <typename K, typename V>
+int AVLMap<K, V>::build_threads() const
+{
+    int n = threads;
+    if (n == 0)
+    {
+        n = std::thread::hardware_concurrency();
+    }
+    return n < 1 ? 1 : n;
+}
+
+// builds a balanced subtree, building the left subtree on a new thread
+template <typename K, typename V>
+typename AVLMap<K, V>::Node *AVLMap<K, V>::build(const K keys[], const V values[], int start, int end, int n)
+{
+    if (n < 2 || end - start + 1 < 2 * min_build_per_thread)
+    {
+        return build(keys, values, start, end);
+    }
+    int mid = (start + end) / 2;
+    Node *st_root = new Node;
+    st_root->left = nullptr;
+    st_root->right = nullptr;
+    // an exception on the left builder's thread is passed back here
+    std::exception_ptr left_error;
+    std::thread left_builder;
+    try
+    {
+        st_root->key = keys[mid];
+        st_root->value = values[mid];
+        left_builder = std::thread([&]()
+                                   {
+                                       try
+                                       {
+                                           st_root->left = build(keys, values, start, mid - 1, n / 2);
+                                       }
+                                       catch (...)
+                                       {
+                                           left_error = std::current_exception();
+                                       }
+                                   });
+        st_root->right = build(keys, values, mid + 1, end, n - n / 2);
+    }
+    catch (...)
+    {
+        // the left builder must finish before its subtree is freed
+        if (left_builder.joinable())
+        {
+            left_builder.join();
+        }
+        make_empty(st_root);
+        throw;
+    }
+    left_builder.join();
+    if (left_error)
+    {
+        make_empty(st_root);
+        std::rethrow_exception(left_error);
+    }
+    int l_height = st_root->left ? st_root->left->height : 0;
+    int r_height = st_root->right ? st_root->right->height : 0;
+    st_root->height = 1 + std::max(l_height, r_height);
+    return st_root;
+}
+
 #endif
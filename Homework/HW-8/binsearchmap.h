@@ -7,10 +7,125 @@
 #ifndef BINSEARCHMAP_H
 #define BINSEARCHMAP_H
 
+#include <type_traits>
 #include "map.h"
 #include "arrayseq.h"
+#include "kvstore.h"
+#include "snapshot.h"
 
-template <typename K, typename V>
+//----------------------------------------------------------------------
+// Search policies for BinSearchMap. Each provides
+//   static int lower_bound(const T items[], int n, const K &key,
+//                          KeyOf key_of)
+// returning the index of the first item whose key is not less than
+// key (n if there is none), over items sorted by key, where
+// key_of(item) is the item's key (see kvstore.h).
+//----------------------------------------------------------------------
+
+// Classic branchy binary search (the default)
+struct ClassicSearch
+{
+    template <typename T, typename K, typename KeyOf>
+    static int lower_bound(const T items[], int n, const K &key, KeyOf key_of)
+    {
+        int start = 0;
+        int end = n - 1;
+        while (start <= end)
+        {
+            int mid = (start + end) / 2;
+            if (key_of(items[mid]) < key)
+            {
+                start = mid + 1;
+            }
+            else
+            {
+                end = mid - 1;
+            }
+        }
+        return start;
+    }
+};
+
+// Branchless binary search: the loop runs a fixed log2(n) steps and
+// the compare selects the next base with a conditional move instead of
+// a branch. Both possible next midpoints are prefetched so the load
+// for the next step is in flight while this one compares.
+struct BranchlessSearch
+{
+    template <typename T, typename K, typename KeyOf>
+    static int lower_bound(const T items[], int n, const K &key, KeyOf key_of)
+    {
+        if (n == 0)
+        {
+            return 0;
+        }
+        const T *base = items;
+        int len = n;
+        while (len > 1)
+        {
+            int half = len / 2;
+            int next_half = (len - half) / 2;
+            __builtin_prefetch(base + next_half);
+            __builtin_prefetch(base + half + next_half);
+            base = (key_of(base[half]) < key) ? base + half : base;
+            len -= half;
+        }
+        return (base - items) + (key_of(*base) < key);
+    }
+};
+
+// Interpolation search for arithmetic keys: guesses the position from
+// the key's value relative to the range ends, which takes O(log log n)
+// probes on evenly spaced keys. Falls back to binary search on the
+// remaining range if the keys are skewed and the guesses stop paying.
+struct InterpolationSearch
+{
+    template <typename T, typename K, typename KeyOf>
+    static int lower_bound(const T items[], int n, const K &key, KeyOf key_of)
+    {
+        static_assert(std::is_arithmetic<K>::value,
+                      "InterpolationSearch requires arithmetic keys");
+        int lo = 0;
+        int hi = n - 1;
+        // items[0, lo) are less than key and items(hi, n) are greater
+        int probes = 0;
+        while (lo <= hi && key_of(items[lo]) < key && key < key_of(items[hi]))
+        {
+            if (++probes > 8)
+            {
+                return lo + ClassicSearch::lower_bound(items + lo, hi - lo + 1,
+                                                       key, key_of);
+            }
+            double lo_key = (double)key_of(items[lo]);
+            double span = (double)key_of(items[hi]) - lo_key;
+            int pos = lo + (int)(((double)key - lo_key) / span * (hi - lo));
+            if (key_of(items[pos]) < key)
+            {
+                lo = pos + 1;
+            }
+            else if (key < key_of(items[pos]))
+            {
+                hi = pos - 1;
+            }
+            else
+            {
+                return pos;
+            }
+        }
+        if (lo > hi || !(key_of(items[lo]) < key))
+        {
+            return lo;
+        }
+        // key is not less than items[hi]
+        return (key_of(items[hi]) < key) ? hi + 1 : hi;
+    }
+};
+
+// A map kept as an array sorted by key. Search picks the search
+// kernel and Store the memory layout (PairStore or ColumnStore, see
+// kvstore.h).
+template <typename K, typename V, typename Search = ClassicSearch,
+          template <typename, typename> class Store = PairStore>
 class BinSearchMap : public Map<K, V>
 {
 public:
@@ -28,62 +143,128 @@ public:
     // given key is not in the collection.
     const V &operator[](const K &key) const;
 
+    // Returns a pointer to the value for a given key, or nullptr if
+    // the key is not in the collection.
+    V *find(const K &key);
+    const V *find(const K &key) const;
+
     // Extends the collection by adding the given key-value
     // pair. Assumes the key being added is not present in the
     // collection. Insert does not check if the key is present.
     void insert(const K &key, const V &value);
 
+    // Same as insert, but moves the key and value into the
+    // collection instead of copying them.
+    void insert(K &&key, V &&value);
+
+    // Extends the collection by adding the key with a value
+    // constructed in place from args. Like insert, assumes the key is
+    // not present in the collection.
+    template <typename KK, typename... Args>
+    void emplace(KK &&key, Args &&...args);
+
+    // Adds the key with a value constructed in place from args if the
+    // key is not in the collection. Returns true if it was added; if
+    // not, the key and args are left untouched.
+    template <typename KK, typename... Args>
+    bool try_emplace(KK &&key, Args &&...args);
+
+    // Adds the key-value pair if the key is not in the collection, and
+    // otherwise assigns value to the key's value. Returns true if the
+    // pair was added.
+    bool insert_or_assign(const K &key, const V &value);
+
+    // Returns the value for a given key, first adding the key with a
+    // default-constructed value if it is not in the collection.
+    V &get_or_insert_default(const K &key);
+
     // Shrinks the collection by removing the key-value pair with the
     // given key. Does not modify the collection if the collection does
     // not contain the key. Throws out_of_range if the given key is not
     // in the collection.
     void erase(const K &key);
 
+    // Same as erase, but returns false instead of throwing if the key
+    // is not in the collection, and true if the pair was removed.
+    bool try_erase(const K &key);
+
     // Returns true if the key is in the collection, and false
     // otherwise.
     bool contains(const K &key) const;
 
+    // Heterogeneous lookup: operator[] and contains for a key of a
+    // transparent type Q (see is_transparent_key in map.h), such as
+    // std::string_view for std::string keys, without building a K.
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    V &operator[](const Q &key);
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    const V &operator[](const Q &key) const;
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    bool contains(const Q &key) const;
+
     // Returns the keys k in the collection such that k1 <= k <= k2
     ArraySeq<K> find_keys(const K &k1, const K &k2) const;
 
     // Returns the keys in the collection in ascending sorted order.
     ArraySeq<K> sorted_keys() const;
 
+    // Bulk loading from sorted input: appends a key-value pair whose
+    // key is greater than every key in the collection, without a
+    // search. Throws invalid_argument if the key is out of order.
+    void append_sorted(const K &key, const V &value);
+
+    // Writes the key-value pairs, in sorted order, to a binary
+    // snapshot file. Throws runtime_error if the file cannot be
+    // written.
+    void save(const std::string &path) const;
+
+    // Replaces the contents of the map with those of a snapshot file
+    // written by save. Throws runtime_error if the file cannot be
+    // read or holds different key or value types.
+    void load(const std::string &path);
+
 private:
     // If the key is in the collection, bin_search returns true and
     // provides the key's index within the array sequence (via the index
     // output parameter). If the key is not in the collection,
-    // bin_search returns false and provides the last index checked by
-    // the binary search algorithm.
-    bool bin_search(const K &key, int &index) const;
+    // bin_search returns false and provides the index where the key
+    // would be inserted to keep the sequence sorted. The search
+    // kernel is chosen by the Search policy. Q is K or any type the
+    // keys compare with.
+    template <typename Q>
+    bool bin_search(const Q &key, int &index) const;
 
-    // implemented as a resizable array of (key-value) pairs
-    ArraySeq<std::pair<K, V> > seq;
+    // the key-value pairs in key order, laid out by the Store policy
+    // (pairs or parallel key and value arrays, see kvstore.h)
+    Store<K, V> seq;
 };
 
 // Returns the number of key-value pairs in the map
-template <typename K, typename V>
-int BinSearchMap<K, V>::size() const
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+int BinSearchMap<K, V, Search, Store>::size() const
 {
     return seq.size();
 }
 
 // Tests if the map is empty
-template <typename K, typename V>
-bool BinSearchMap<K, V>::empty() const
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+bool BinSearchMap<K, V, Search, Store>::empty() const
 {
     return seq.empty();
 }
 
 // Allows values associated with a key to be updated. Throws
 // out_of_range if the given key is not in the collection.
-template <typename K, typename V>
-V &BinSearchMap<K, V>::operator[](const K &key)
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+V &BinSearchMap<K, V, Search, Store>::operator[](const K &key)
 {
     int idx = 0;
     if (bin_search(key, idx))
     {
-        return seq[idx].second;
+        return seq.value(idx);
     }
     else
     {
@@ -93,13 +274,14 @@ V &BinSearchMap<K, V>::operator[](const K &key)
 
 // Returns the value for a given key. Throws out_of_range if the
 // given key is not in the collection.
-template <typename K, typename V>
-const V &BinSearchMap<K, V>::operator[](const K &key) const
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+const V &BinSearchMap<K, V, Search, Store>::operator[](const K &key) const
 {
     int idx = 0;
     if (bin_search(key, idx))
     {
-        return seq[idx].second;
+        return seq.value(idx);
     }
     else
     {
@@ -107,27 +289,139 @@ const V &BinSearchMap<K, V>::operator[](const K &key) const
     }
 }
 
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+V *BinSearchMap<K, V, Search, Store>::find(const K &key)
+{
+    int idx = 0;
+    return bin_search(key, idx) ? &seq.value(idx) : nullptr;
+}
+
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+const V *BinSearchMap<K, V, Search, Store>::find(const K &key) const
+{
+    int idx = 0;
+    return bin_search(key, idx) ? &seq.value(idx) : nullptr;
+}
+
+// Allows values associated with a key of type Q to be updated
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+template <typename Q, enable_if_transparent<K, Q>>
+V &BinSearchMap<K, V, Search, Store>::operator[](const Q &key)
+{
+    int idx = 0;
+    if (!bin_search(key, idx))
+    {
+        throw std::out_of_range("BinSearchMap<K, V>::operator[](key)");
+    }
+    return seq.value(idx);
+}
+
+// Returns the value for a key of type Q
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+template <typename Q, enable_if_transparent<K, Q>>
+const V &BinSearchMap<K, V, Search, Store>::operator[](const Q &key) const
+{
+    int idx = 0;
+    if (!bin_search(key, idx))
+    {
+        throw std::out_of_range("BinSearchMap<K, V>::operator[](key)");
+    }
+    return seq.value(idx);
+}
+
 // Extends the collection by adding the given key-value
 // pair. Assumes the key being added is not present in the
 // collection. Insert does not check if the key is present.
-template <typename K, typename V>
-void BinSearchMap<K, V>::insert(const K &key, const V &value)
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+void BinSearchMap<K, V, Search, Store>::insert(const K &key, const V &value)
+{
+    int idx = 0;
+    bin_search(key, idx);
+    seq.insert(key, value, idx);
+}
+
+// Extends the collection by moving in the given key-value pair
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+void BinSearchMap<K, V, Search, Store>::insert(K &&key, V &&value)
 {
-    /*
-	int idx = 0;
-	if(!bin_search(key, idx)) {
-		seq.insert({key, value}, seq.size());
-	}
-	*/
-    seq.insert({key, value}, seq.size());
+    int idx = 0;
+    bin_search(key, idx);
+    seq.emplace(idx, std::move(key), std::move(value));
+}
+
+// Extends the collection by adding the key with a value constructed
+// from args
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+template <typename KK, typename... Args>
+void BinSearchMap<K, V, Search, Store>::emplace(KK &&key, Args &&...args)
+{
+    K new_key(std::forward<KK>(key));
+    int idx = 0;
+    bin_search(new_key, idx);
+    seq.emplace(idx, std::move(new_key), std::forward<Args>(args)...);
+}
+
+// Adds the key with a value constructed from args if the key is not
+// in the collection
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+template <typename KK, typename... Args>
+bool BinSearchMap<K, V, Search, Store>::try_emplace(KK &&key, Args &&...args)
+{
+    // the failed search already found the insertion point
+    int idx = 0;
+    if (bin_search(key, idx))
+    {
+        return false;
+    }
+    seq.emplace(idx, std::forward<KK>(key), std::forward<Args>(args)...);
+    return true;
+}
+
+// Adds the key-value pair, or assigns the value if the key is present
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+bool BinSearchMap<K, V, Search, Store>::insert_or_assign(const K &key, const V &value)
+{
+    int idx = 0;
+    if (bin_search(key, idx))
+    {
+        seq.value(idx) = value;
+        return false;
+    }
+    seq.insert(key, value, idx);
+    return true;
+}
+
+// Returns the value for a given key, adding a default value if needed
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+V &BinSearchMap<K, V, Search, Store>::get_or_insert_default(const K &key)
+{
+    int idx = 0;
+    if (!bin_search(key, idx))
+    {
+        seq.emplace(idx, key);
+    }
+    return seq.value(idx);
 }
 
 // Shrinks the collection by removing the key-value pair with the
 // given key. Does not modify the collection if the collection does
 // not contain the key. Throws out_of_range if the given key is not
 // in the collection.
-template <typename K, typename V>
-void BinSearchMap<K, V>::erase(const K &key)
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+void BinSearchMap<K, V, Search, Store>::erase(const K &key)
 {
     int idx = 0;
     if (bin_search(key, idx))
@@ -140,10 +434,25 @@ void BinSearchMap<K, V>::erase(const K &key)
     }
 }
 
+// Removes the key-value pair if present, returning whether it was
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+bool BinSearchMap<K, V, Search, Store>::try_erase(const K &key)
+{
+    int idx = 0;
+    if (!bin_search(key, idx))
+    {
+        return false;
+    }
+    seq.erase(idx);
+    return true;
+}
+
 // Returns true if the key is in the collection, and false
 // otherwise.
-template <typename K, typename V>
-bool BinSearchMap<K, V>::contains(const K &key) const
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+bool BinSearchMap<K, V, Search, Store>::contains(const K &key) const
 {
     int idx = 0;
     if (bin_search(key, idx))
@@ -156,82 +465,107 @@ bool BinSearchMap<K, V>::contains(const K &key) const
     }
 }
 
+// Returns true if a key of type Q is in the collection
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+template <typename Q, enable_if_transparent<K, Q>>
+bool BinSearchMap<K, V, Search, Store>::contains(const Q &key) const
+{
+    int idx = 0;
+    return bin_search(key, idx);
+}
+
 // Returns the keys k in the collection such that k1 <= k <= k2
-template <typename K, typename V>
-ArraySeq<K> BinSearchMap<K, V>::find_keys(const K &k1, const K &k2) const
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+ArraySeq<K> BinSearchMap<K, V, Search, Store>::find_keys(const K &k1, const K &k2) const
 {
     ArraySeq<K> seq_tmp;
-    ArraySeq<K> keys = sorted_keys();
-    for (int i = 0; i < keys.size(); ++i)
+    int idx = 0;
+    bin_search(k1, idx);
+    for (int i = idx; i < seq.size() && seq.key(i) <= k2; ++i)
     {
-        if (k1 <= keys[i] && keys[i] <= k2)
-        {
-            seq_tmp.insert(keys[i], seq_tmp.size());
-        }
+        seq_tmp.insert(seq.key(i), seq_tmp.size());
     }
     return seq_tmp;
 }
 
 // Returns the keys in the collection in ascending sorted order.
-template <typename K, typename V>
-ArraySeq<K> BinSearchMap<K, V>::sorted_keys() const
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+ArraySeq<K> BinSearchMap<K, V, Search, Store>::sorted_keys() const
 {
     ArraySeq<K> seq_tmp;
+    seq_tmp.reserve(seq.size());
     for (int i = 0; i < seq.size(); ++i)
     {
-        seq_tmp.insert(seq[i].first, seq_tmp.size());
+        seq_tmp.insert(seq.key(i), seq_tmp.size());
     }
-    seq_tmp.merge_sort();
     return seq_tmp;
 }
 
-// If the key is in the collection, bin_search returns true and
-// provides the key's index within the array sequence (via the index
-// output parameter). If the key is not in the collection,
-// bin_search returns false and provides the last index checked by
-// the binary search algorithm.
-template <typename K, typename V>
-bool BinSearchMap<K, V>::bin_search(const K &key, int &index) const
+// Appends a key-value pair whose key is greater than every key
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+void BinSearchMap<K, V, Search, Store>::append_sorted(const K &key, const V &value)
 {
-    if (seq.empty())
-    { //Check that seq is not empty
-        return false;
-    }
-    //Sort array and set start and end values
-    ArraySeq<K> seq_tmp = sorted_keys();
-    int start = 0;
-    int end = seq_tmp.size() - 1;
-    //Search
-    while (start <= end)
+    if (!seq.empty() && !(seq.key(seq.size() - 1) < key))
     {
-        index = (start + end) / 2;
+        throw std::invalid_argument("BinSearchMap<K, V>::append_sorted(key)");
+    }
+    seq.insert(key, value, seq.size());
+}
 
-        if (seq_tmp[index] == key)
-        {
-            return true;
-        }
-        else if (seq_tmp[index] > key)
-        {
-            end = index - 1;
-        }
-        else
-        {
-            start = index + 1;
-        }
+// Writes the key-value pairs, in sorted order, to a snapshot file
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+void BinSearchMap<K, V, Search, Store>::save(const std::string &path) const
+{
+    SnapshotWriter<K, V> out(path, BINSEARCHMAP_SNAPSHOT, seq.size());
+    for (int i = 0; i < seq.size(); ++i)
+    {
+        out.write(seq.key(i), seq.value(i));
     }
-    //Even if key is not in collecion, update the index to the last checked
-    if (seq_tmp.size() == 1)
+    out.flush();
+}
+
+// Replaces the contents of the map with those of a snapshot file
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+void BinSearchMap<K, V, Search, Store>::load(const std::string &path)
+{
+    SnapshotReader<K, V> in(path, BINSEARCHMAP_SNAPSHOT);
+    int n = snapshot_count_as_int(in.count(), path);
+    // records are already sorted, so append them in one pass
+    Store<K, V> loaded;
+    loaded.reserve(n);
+    K key;
+    V value;
+    for (int i = 0; i < n; ++i)
     {
-        if (seq_tmp[0] > key)
+        in.read(key, value);
+        if (i > 0 && !(loaded.key(i - 1) < key))
         {
-            index = 0;
-        }
-        else
-        {
-            index = 1;
+            throw std::runtime_error("snapshot keys are out of order: " + path);
         }
+        loaded.insert(key, value, i);
     }
-    return false;
+    seq = std::move(loaded);
+}
+
+// If the key is in the collection, bin_search returns true and
+// provides the key's index within the array sequence (via the index
+// output parameter). If the key is not in the collection,
+// bin_search returns false and provides the index where the key
+// would be inserted to keep the sequence sorted.
+template <typename K, typename V, typename Search,
+          template <typename, typename> class Store>
+template <typename Q>
+bool BinSearchMap<K, V, Search, Store>::bin_search(const Q &key, int &index) const
+{
+    typename Store<K, V>::KeyOf key_of;
+    index = Search::lower_bound(seq.items(), seq.size(), key, key_of);
+    return index < seq.size() && !(key < key_of(seq.items()[index]));
 }
 
 #endif
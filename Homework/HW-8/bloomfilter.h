@@ -0,0 +1,314 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: bloomfilter.h
+// DATE: Fall 2021
+// DESC: A blocked Bloom filter. Each key is hashed to a single
+//       cache-line-sized block and all of its probe bits are set (and
+//       tested) within that block, so a lookup touches at most one
+//       cache line. The filter can report false positives but never
+//       false negatives, and keys cannot be removed (see clear).
+//---------------------------------------------------------------------------
+
+#ifndef BLOOMFILTER_H
+#define BLOOMFILTER_H
+
+#include <cstdint>
+#include <cmath>
+#include <functional>
+#include "map.h"
+
+template <typename K>
+class BloomFilter
+{
+public:
+    // Creates a filter sized for the expected number of keys using
+    // the given number of bits per key
+    BloomFilter(int expected_keys = 0, int bits_per_key = 10);
+
+    // copy constructor
+    BloomFilter(const BloomFilter &rhs);
+
+    // move constructor
+    BloomFilter(BloomFilter &&rhs);
+
+    // copy assignment
+    BloomFilter &operator=(const BloomFilter &rhs);
+
+    // move assignment
+    BloomFilter &operator=(BloomFilter &&rhs);
+
+    // destructor
+    ~BloomFilter();
+
+    // Adds the key to the filter
+    void insert(const K &key);
+
+    // Returns false if the key was definitely never inserted, and
+    // true if it may have been
+    bool might_contain(const K &key) const;
+
+    // Same as might_contain for a key of a transparent type Q (see
+    // is_transparent_key in map.h), which must hash like K
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    bool might_contain(const Q &key) const;
+
+    // Removes all keys and resizes the filter for the expected number
+    // of keys
+    void clear(int expected_keys);
+
+    // Returns the number of keys the filter was sized for
+    int capacity() const;
+
+    // Returns the number of bits used by the filter
+    long bits() const;
+
+private:
+    // one cache line of filter bits
+    struct alignas(64) Block
+    {
+        std::uint64_t words[8];
+    };
+
+    // number of bits per block, and the shift that leaves the top
+    // log2(block_bits) bits of a 64-bit word
+    static const int block_bits = 512;
+    static const int block_shift = 55;
+
+    // the blocks of the filter
+    Block *blocks = nullptr;
+
+    // number of blocks
+    int block_count = 0;
+
+    // number of keys the filter was sized for
+    int expected = 0;
+
+    // number of bits per key used to size the filter
+    int bits_per_key = 10;
+
+    // number of probe bits set per key
+    int probes = 1;
+
+    // allocate zeroed blocks for the expected number of keys
+    void init(int expected_keys);
+
+    // tests the key's probe bits (Q is K or a transparent key type)
+    template <typename Q>
+    bool probe(const Q &key) const;
+
+    // 64-bit hash of the key (std::hash mixed so that identity hashes
+    // of integer keys spread over all bits)
+    template <typename Q>
+    std::uint64_t hash(const Q &key) const;
+
+    // start of a key's probe sequence, remixed from its hash so that
+    // it does not repeat the high bits that pick the block
+    static std::uint64_t probe_seed(std::uint64_t h);
+
+    // advances the probe sequence and returns the next probe bit
+    static int next_probe(std::uint64_t &x);
+};
+
+// Creates a filter sized for the expected number of keys
+template <typename K>
+BloomFilter<K>::BloomFilter(int expected_keys, int bits_per_key)
+    : bits_per_key(bits_per_key < 1 ? 1 : bits_per_key)
+{
+    // optimal number of probes is bits per key * ln 2
+    probes = (int)std::round(this->bits_per_key * 0.693);
+    if (probes < 1)
+    {
+        probes = 1;
+    }
+    else if (probes > 16)
+    {
+        probes = 16;
+    }
+    init(expected_keys);
+}
+
+// copy constructor
+template <typename K>
+BloomFilter<K>::BloomFilter(const BloomFilter &rhs)
+{
+    *this = rhs;
+}
+
+// move constructor
+template <typename K>
+BloomFilter<K>::BloomFilter(BloomFilter &&rhs)
+{
+    *this = std::move(rhs);
+}
+
+// copy assignment
+template <typename K>
+BloomFilter<K> &BloomFilter<K>::operator=(const BloomFilter &rhs)
+{
+    if (this != &rhs)
+    {
+        bits_per_key = rhs.bits_per_key;
+        probes = rhs.probes;
+        init(rhs.expected);
+        for (int i = 0; i < block_count; ++i)
+        {
+            blocks[i] = rhs.blocks[i];
+        }
+    }
+    return *this;
+}
+
+// move assignment
+template <typename K>
+BloomFilter<K> &BloomFilter<K>::operator=(BloomFilter &&rhs)
+{
+    if (this != &rhs)
+    {
+        delete[] blocks;
+        blocks = rhs.blocks;
+        block_count = rhs.block_count;
+        expected = rhs.expected;
+        bits_per_key = rhs.bits_per_key;
+        probes = rhs.probes;
+        rhs.blocks = nullptr;
+        rhs.init(0);
+    }
+    return *this;
+}
+
+// destructor
+template <typename K>
+BloomFilter<K>::~BloomFilter()
+{
+    delete[] blocks;
+}
+
+// Adds the key to the filter
+template <typename K>
+void BloomFilter<K>::insert(const K &key)
+{
+    std::uint64_t h = hash(key);
+    Block &block = blocks[((h >> 32) * block_count) >> 32];
+    std::uint64_t x = probe_seed(h);
+    for (int i = 0; i < probes; ++i)
+    {
+        int bit = next_probe(x);
+        block.words[bit / 64] |= (std::uint64_t)1 << (bit % 64);
+    }
+}
+
+// Returns false if the key was definitely never inserted
+template <typename K>
+bool BloomFilter<K>::might_contain(const K &key) const
+{
+    return probe(key);
+}
+
+// Returns false if a key of type Q was definitely never inserted
+template <typename K>
+template <typename Q, enable_if_transparent<K, Q>>
+bool BloomFilter<K>::might_contain(const Q &key) const
+{
+    return probe(key);
+}
+
+// tests the key's probe bits
+template <typename K>
+template <typename Q>
+bool BloomFilter<K>::probe(const Q &key) const
+{
+    std::uint64_t h = hash(key);
+    const Block &block = blocks[((h >> 32) * block_count) >> 32];
+    std::uint64_t x = probe_seed(h);
+    for (int i = 0; i < probes; ++i)
+    {
+        int bit = next_probe(x);
+        if ((block.words[bit / 64] & ((std::uint64_t)1 << (bit % 64))) == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Removes all keys and resizes the filter
+template <typename K>
+void BloomFilter<K>::clear(int expected_keys)
+{
+    init(expected_keys);
+}
+
+// Returns the number of keys the filter was sized for
+template <typename K>
+int BloomFilter<K>::capacity() const
+{
+    return expected;
+}
+
+// Returns the number of bits used by the filter
+template <typename K>
+long BloomFilter<K>::bits() const
+{
+    return (long)block_count * block_bits;
+}
+
+// allocate zeroed blocks for the expected number of keys
+template <typename K>
+void BloomFilter<K>::init(int expected_keys)
+{
+    delete[] blocks;
+    expected = expected_keys < 0 ? 0 : expected_keys;
+    long total_bits = (long)expected * bits_per_key;
+    block_count = (int)((total_bits + block_bits - 1) / block_bits);
+    if (block_count < 1)
+    {
+        block_count = 1;
+    }
+    blocks = new Block[block_count];
+    for (int i = 0; i < block_count; ++i)
+    {
+        for (int j = 0; j < 8; ++j)
+        {
+            blocks[i].words[j] = 0;
+        }
+    }
+}
+
+// 64-bit hash of the key
+template <typename K>
+template <typename Q>
+std::uint64_t BloomFilter<K>::hash(const Q &key) const
+{
+    // splitmix64 finalizer
+    std::uint64_t h = std::hash<Q>()(key);
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+// start of a key's probe sequence
+template <typename K>
+std::uint64_t BloomFilter<K>::probe_seed(std::uint64_t h)
+{
+    // murmur3 finalizer step; odd, so the sequence never reaches zero
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h | 1;
+}
+
+// advances the probe sequence and returns the next probe bit
+template <typename K>
+int BloomFilter<K>::next_probe(std::uint64_t &x)
+{
+    // the top bits of successive multiples spread evenly over the
+    // block, unlike h1 + i * h2 mod 512, which only has 9 bits of
+    // each hash to work with
+    x *= 0x9e3779b97f4a7c15ULL;
+    return (int)(x >> block_shift);
+}
+
+#endif
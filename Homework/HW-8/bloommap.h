@@ -0,0 +1,393 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: bloommap.h
+// DATE: Fall 2021
+// DESC: A Map that wraps another Map (e.g., BSTMap or AVLMap) with a
+//       blocked Bloom filter over its keys. Lookups of keys that are
+//       definitely not in the map are answered by the filter without
+//       touching the wrapped map. Since keys cannot be removed from a
+//       Bloom filter, the filter is rebuilt from the wrapped map once
+//       more keys have been erased than remain, and it is resized
+//       when the map outgrows it.
+//---------------------------------------------------------------------------
+
+#ifndef BLOOMMAP_H
+#define BLOOMMAP_H
+
+#include <stdexcept>
+#include <utility>
+#include "map.h"
+#include "arrayseq.h"
+#include "bloomfilter.h"
+
+template <typename K, typename V, typename M>
+class BloomMap : public Map<K, V>
+{
+public:
+    // Creates an empty map whose filter uses the given number of bits
+    // per key
+    BloomMap(int bits_per_key = 10);
+
+    // Returns the number of key-value pairs in the map
+    int size() const;
+
+    // Tests if the map is empty
+    bool empty() const;
+
+    // Allows values associated with a key to be updated. Throws
+    // out_of_range if the given key is not in the collection.
+    V &operator[](const K &key);
+
+    // Returns the value for a given key. Throws out_of_range if the
+    // given key is not in the collection.
+    const V &operator[](const K &key) const;
+
+    // Returns a pointer to the value for a given key, or nullptr if
+    // the key is not in the collection.
+    V *find(const K &key);
+    const V *find(const K &key) const;
+
+    // Extends the collection by adding the given key-value
+    // pair. Assumes the key being added is not present in the
+    // collection. Insert does not check if the key is present.
+    void insert(const K &key, const V &value);
+
+    // Same as insert, but moves the key and value into the
+    // collection instead of copying them.
+    void insert(K &&key, V &&value);
+
+    // Extends the collection by adding the key with a value
+    // constructed in place from args. Like insert, assumes the key is
+    // not present in the collection.
+    template <typename KK, typename... Args>
+    void emplace(KK &&key, Args &&...args);
+
+    // Adds the key with a value constructed in place from args if the
+    // key is not in the collection. Returns true if it was added; if
+    // not, the key and args are left untouched.
+    template <typename KK, typename... Args>
+    bool try_emplace(KK &&key, Args &&...args);
+
+    // Adds the key-value pair if the key is not in the collection, and
+    // otherwise assigns value to the key's value. Returns true if the
+    // pair was added.
+    bool insert_or_assign(const K &key, const V &value);
+
+    // Returns the value for a given key, first adding the key with a
+    // default-constructed value if it is not in the collection.
+    V &get_or_insert_default(const K &key);
+
+    // Shrinks the collection by removing the key-value pair with the
+    // given key. Does not modify the collection if the collection does
+    // not contain the key. Throws out_of_range if the given key is not
+    // in the collection.
+    void erase(const K &key);
+
+    // Same as erase, but returns false instead of throwing if the key
+    // is not in the collection, and true if the pair was removed.
+    bool try_erase(const K &key);
+
+    // Returns true if the key is in the collection, and false otherwise.
+    bool contains(const K &key) const;
+
+    // Heterogeneous lookup: operator[] and contains for a key of a
+    // transparent type Q (see is_transparent_key in map.h), such as
+    // std::string_view for std::string keys, without building a K.
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    V &operator[](const Q &key);
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    const V &operator[](const Q &key) const;
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    bool contains(const Q &key) const;
+
+    // Returns the keys k in the collection such that k1 <= k <= k2
+    ArraySeq<K> find_keys(const K &k1, const K &k2) const;
+
+    // Returns the keys in the collection in ascending sorted order
+    ArraySeq<K> sorted_keys() const;
+
+    // Returns the wrapped map
+    const M &wrapped() const;
+
+    // Returns the filter over the wrapped map's keys
+    const BloomFilter<K> &filter() const;
+
+    // Rebuilds the filter from the keys in the wrapped map
+    void rebuild();
+
+private:
+    // the wrapped map
+    M map;
+
+    // filter over the keys in map (may contain erased keys)
+    BloomFilter<K> bloom;
+
+    // number of bits per key for the filter
+    int bits_per_key = 10;
+
+    // number of keys erased since the filter was last rebuilt
+    int erased = 0;
+
+    // adds a key just inserted into the wrapped map to the filter,
+    // rebuilding the filter instead if the map has outgrown it
+    void add_key(const K &key);
+};
+
+// Creates an empty map
+template <typename K, typename V, typename M>
+BloomMap<K, V, M>::BloomMap(int bits_per_key)
+    : bloom(16, bits_per_key), bits_per_key(bits_per_key)
+{
+}
+
+// Returns the number of key-value pairs in the map
+template <typename K, typename V, typename M>
+int BloomMap<K, V, M>::size() const
+{
+    return map.size();
+}
+
+// Tests if the map is empty
+template <typename K, typename V, typename M>
+bool BloomMap<K, V, M>::empty() const
+{
+    return map.empty();
+}
+
+// Allows values associated with a key to be updated
+template <typename K, typename V, typename M>
+V &BloomMap<K, V, M>::operator[](const K &key)
+{
+    if (!bloom.might_contain(key))
+    {
+        throw std::out_of_range("BloomMap<K, V, M>::operator[](key)");
+    }
+    return map[key];
+}
+
+// Returns the value for a given key
+template <typename K, typename V, typename M>
+const V &BloomMap<K, V, M>::operator[](const K &key) const
+{
+    if (!bloom.might_contain(key))
+    {
+        throw std::out_of_range("BloomMap<K, V, M>::operator[](key)");
+    }
+    return map[key];
+}
+
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V, typename M>
+V *BloomMap<K, V, M>::find(const K &key)
+{
+    return bloom.might_contain(key) ? map.find(key) : nullptr;
+}
+
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V, typename M>
+const V *BloomMap<K, V, M>::find(const K &key) const
+{
+    return bloom.might_contain(key) ? map.find(key) : nullptr;
+}
+
+// Allows values associated with a key of type Q to be updated
+template <typename K, typename V, typename M>
+template <typename Q, enable_if_transparent<K, Q>>
+V &BloomMap<K, V, M>::operator[](const Q &key)
+{
+    if (!bloom.might_contain(key))
+    {
+        throw std::out_of_range("BloomMap<K, V, M>::operator[](key)");
+    }
+    return map[key];
+}
+
+// Returns the value for a key of type Q
+template <typename K, typename V, typename M>
+template <typename Q, enable_if_transparent<K, Q>>
+const V &BloomMap<K, V, M>::operator[](const Q &key) const
+{
+    if (!bloom.might_contain(key))
+    {
+        throw std::out_of_range("BloomMap<K, V, M>::operator[](key)");
+    }
+    return map[key];
+}
+
+// Extends the collection by adding the given key-value pair
+template <typename K, typename V, typename M>
+void BloomMap<K, V, M>::insert(const K &key, const V &value)
+{
+    map.insert(key, value);
+    add_key(key);
+}
+
+// Extends the collection by moving in the given key-value pair
+template <typename K, typename V, typename M>
+void BloomMap<K, V, M>::insert(K &&key, V &&value)
+{
+    emplace(std::move(key), std::move(value));
+}
+
+// Extends the collection by adding the key with a value constructed
+// from args
+template <typename K, typename V, typename M>
+template <typename KK, typename... Args>
+void BloomMap<K, V, M>::emplace(KK &&key, Args &&...args)
+{
+    // the key is moved into the wrapped map, so add it to the filter
+    // first (a failed emplace only leaves a false positive behind)
+    K new_key(std::forward<KK>(key));
+    bool resize = map.size() + 1 > bloom.capacity();
+    if (!resize)
+    {
+        bloom.insert(new_key);
+    }
+    map.emplace(std::move(new_key), std::forward<Args>(args)...);
+    if (resize)
+    {
+        rebuild();
+    }
+}
+
+// Adds the key with a value constructed from args if the key is not
+// in the collection
+template <typename K, typename V, typename M>
+template <typename KK, typename... Args>
+bool BloomMap<K, V, M>::try_emplace(KK &&key, Args &&...args)
+{
+    if (contains(key))
+    {
+        return false;
+    }
+    emplace(std::forward<KK>(key), std::forward<Args>(args)...);
+    return true;
+}
+
+// Adds the key-value pair, or assigns the value if the key is present
+template <typename K, typename V, typename M>
+bool BloomMap<K, V, M>::insert_or_assign(const K &key, const V &value)
+{
+    // the wrapped map does the single search; the filter only needs
+    // to hear about new keys
+    bool added = map.insert_or_assign(key, value);
+    if (added)
+    {
+        add_key(key);
+    }
+    return added;
+}
+
+// Returns the value for a given key, adding a default value if needed
+template <typename K, typename V, typename M>
+V &BloomMap<K, V, M>::get_or_insert_default(const K &key)
+{
+    int before = map.size();
+    V &value = map.get_or_insert_default(key);
+    if (map.size() > before)
+    {
+        add_key(key);
+    }
+    return value;
+}
+
+// Shrinks the collection by removing the key-value pair with the
+// given key
+template <typename K, typename V, typename M>
+void BloomMap<K, V, M>::erase(const K &key)
+{
+    if (!try_erase(key))
+    {
+        throw std::out_of_range("BloomMap<K, V, M>::erase(key)");
+    }
+}
+
+// Removes the key-value pair if present, returning whether it was
+template <typename K, typename V, typename M>
+bool BloomMap<K, V, M>::try_erase(const K &key)
+{
+    if (!bloom.might_contain(key) || !map.try_erase(key))
+    {
+        return false;
+    }
+    ++erased;
+    // once most of the filter's keys are stale, rebuild it
+    if (erased > map.size())
+    {
+        rebuild();
+    }
+    return true;
+}
+
+// Returns true if the key is in the collection, and false otherwise.
+template <typename K, typename V, typename M>
+bool BloomMap<K, V, M>::contains(const K &key) const
+{
+    return bloom.might_contain(key) && map.contains(key);
+}
+
+// Returns true if a key of type Q is in the collection
+template <typename K, typename V, typename M>
+template <typename Q, enable_if_transparent<K, Q>>
+bool BloomMap<K, V, M>::contains(const Q &key) const
+{
+    return bloom.might_contain(key) && map.contains(key);
+}
+
+// Returns the keys k in the collection such that k1 <= k <= k2
+template <typename K, typename V, typename M>
+ArraySeq<K> BloomMap<K, V, M>::find_keys(const K &k1, const K &k2) const
+{
+    return map.find_keys(k1, k2);
+}
+
+// Returns the keys in the collection in ascending sorted order
+template <typename K, typename V, typename M>
+ArraySeq<K> BloomMap<K, V, M>::sorted_keys() const
+{
+    return map.sorted_keys();
+}
+
+// Returns the wrapped map
+template <typename K, typename V, typename M>
+const M &BloomMap<K, V, M>::wrapped() const
+{
+    return map;
+}
+
+// Returns the filter over the wrapped map's keys
+template <typename K, typename V, typename M>
+const BloomFilter<K> &BloomMap<K, V, M>::filter() const
+{
+    return bloom;
+}
+
+// Rebuilds the filter from the keys in the wrapped map
+template <typename K, typename V, typename M>
+void BloomMap<K, V, M>::rebuild()
+{
+    ArraySeq<K> keys = map.sorted_keys();
+    bloom.clear(2 * (keys.size() < 8 ? 8 : keys.size()));
+    for (int i = 0; i < keys.size(); ++i)
+    {
+        bloom.insert(keys[i]);
+    }
+    erased = 0;
+}
+
+// adds a newly inserted key to the filter
+template <typename K, typename V, typename M>
+void BloomMap<K, V, M>::add_key(const K &key)
+{
+    if (map.size() > bloom.capacity())
+    {
+        // resize (doubling) to keep the false positive rate steady
+        rebuild();
+    }
+    else
+    {
+        bloom.insert(key);
+    }
+}
+
+#endif
@@ -7,8 +7,11 @@
 #ifndef BSTMAP_H
 #define BSTMAP_H
 
+#include <exception>
+#include <thread>
 #include "map.h"
 #include "arrayseq.h"
+#include "snapshot.h"
 
 template <typename K, typename V>
 class BSTMap : public Map<K, V>
@@ -46,29 +49,102 @@ public:
     // given key is not in the collection.
     const V &operator[](const K &key) const;
 
+    // Returns a pointer to the value for a given key, or nullptr if
+    // the key is not in the collection.
+    V *find(const K &key);
+    const V *find(const K &key) const;
+
     // Extends the collection by adding the given key-value
     // pair. Assumes the key being added is not present in the
     // collection. Insert does not check if the key is present.
     void insert(const K &key, const V &value);
 
+    // Same as insert, but moves the key and value into the
+    // collection instead of copying them.
+    void insert(K &&key, V &&value);
+
+    // Extends the collection by adding the key with a value
+    // constructed in place from args. Like insert, assumes the key is
+    // not present in the collection.
+    template <typename KK, typename... Args>
+    void emplace(KK &&key, Args &&...args);
+
+    // Adds the key with a value constructed in place from args if the
+    // key is not in the collection. Returns true if it was added; if
+    // not, the key and args are left untouched.
+    template <typename KK, typename... Args>
+    bool try_emplace(KK &&key, Args &&...args);
+
+    // Adds the key-value pair if the key is not in the collection, and
+    // otherwise assigns value to the key's value. Returns true if the
+    // pair was added.
+    bool insert_or_assign(const K &key, const V &value);
+
+    // Returns the value for a given key, first adding the key with a
+    // default-constructed value if it is not in the collection.
+    V &get_or_insert_default(const K &key);
+
     // Shrinks the collection by removing the key-value pair with the
     // given key. Does not modify the collection if the collection does
     // not contain the key. Throws out_of_range if the given key is not
     // in the collection.
     void erase(const K &key);
 
+    // Same as erase, but returns false instead of throwing if the key
+    // is not in the collection, and true if the pair was removed.
+    bool try_erase(const K &key);
+
     // Returns true if the key is in the collection, and false otherwise.
     bool contains(const K &key) const;
 
+    // Heterogeneous lookup: operator[] and contains for a key of a
+    // transparent type Q (see is_transparent_key in map.h), such as
+    // std::string_view for std::string keys, without building a K.
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    V &operator[](const Q &key);
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    const V &operator[](const Q &key) const;
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    bool contains(const Q &key) const;
+
     // Returns the keys k in the collection such that k1 <= k <= k2
     ArraySeq<K> find_keys(const K &k1, const K &k2) const;
 
+    // Appends the keys k in the collection such that k1 <= k <= k2 to
+    // keys, which may be any sequence (such as a SmallArraySeq that
+    // holds small results without allocating)
+    template <typename Seq>
+    void find_keys(const K &k1, const K &k2, Seq &keys) const;
+
     // Returns the keys in the collection in ascending sorted order
     ArraySeq<K> sorted_keys() const;
 
     // Returns the height of the binary search tree
     int height() const;
 
+    // Writes the key-value pairs, in sorted order, to a binary
+    // snapshot file. Throws runtime_error if the file cannot be
+    // written.
+    void save(const std::string &path) const;
+
+    // Replaces the contents of the map with those of a snapshot file
+    // written by save. The tree is built balanced directly from the
+    // sorted records instead of by repeated insert. Throws
+    // runtime_error if the file cannot be read or holds different key
+    // or value types.
+    void load(const std::string &path);
+
+    // Replaces the contents of the map with the n given keys and
+    // values, whose keys must be in strictly ascending order. The tree
+    // is built balanced from the midpoints, with the subtrees of large
+    // ranges built on their own threads (see set_threads). Throws
+    // invalid_argument if the keys are out of order.
+    void build_from_sorted(const K keys[], const V values[], int n);
+
+    // Sets the maximum number of threads used by build_from_sorted and
+    // load (0, the default, uses the hardware concurrency)
+    void set_threads(int n);
+
 private:
     // node for linked-list separate chaining
     struct Node
@@ -91,16 +167,47 @@ private:
     // copy assignment helper
     Node *copy(const Node *rhs_st_root) const;
 
-    // erase helper
-    Node *erase(const K &key, Node *st_root);
+    // returns the node with the given key, or nullptr
+    template <typename Q>
+    Node *find_node(const Q &key) const;
+
+    // returns the link (root or child pointer) that points to the
+    // node with the given key, or the null link where the key belongs
+    template <typename Q>
+    Node **find_link(const Q &key);
+
+    // links the new node in at a null link from find_link
+    void add_node(Node **link, Node *node);
 
     // find_keys helper
+    template <typename Seq>
     void find_keys(const K &k1, const K &k2, const Node *st_root,
-                   ArraySeq<K> &keys) const;
+                   Seq &keys) const;
 
     // sorted_keys helper
     void sorted_keys(const Node *st_root, ArraySeq<K> &keys) const;
 
+    // save helper, writes the subtree in sorted order
+    void save(const Node *st_root, SnapshotWriter<K, V> &out) const;
+
+    // builds a balanced subtree from the sorted keys and values in
+    // the index range [start, end]
+    Node *build(const K keys[], const V values[], int start, int end);
+
+    // max threads for build_from_sorted and load (0 = hardware)
+    int threads = 0;
+
+    // smallest range worth handing half of to a new thread
+    static const int min_build_per_thread = 65536;
+
+    // number of threads to build with
+    int build_threads() const;
+
+    // builds the subtree for [start, end] with up to n threads: the
+    // left subtree goes to a new thread with half of them, and the
+    // right subtree stays on this one with the rest
+    Node *build(const K keys[], const V values[], int start, int end, int n);
+
     // height helper
     int height(const Node *st_root) const;
 };
@@ -193,29 +300,12 @@ bool BSTMap<K, V>::empty() const
 template <typename K, typename V>
 V &BSTMap<K, V>::operator[](const K &key)
 {
-    if (contains(key))
-    {
-        Node *curr = root;
-        while (curr != nullptr)
-        {
-            if (curr->key == key) // eventually want to get to this
-            {
-                return curr->value;
-            }
-            else if (curr->key < key)
-            {
-                curr = curr->right;
-            }
-            else
-            {
-                curr = curr->left;
-            }
-        }
-    }
-    else
+    Node *curr = find_node(key);
+    if (curr == nullptr)
     {
         throw std::out_of_range("Key not found");
     }
+    return curr->value;
 }
 
 // Returns the value for a given key. Throws out_of_range if the
@@ -223,30 +313,54 @@ V &BSTMap<K, V>::operator[](const K &key)
 template <typename K, typename V>
 const V &BSTMap<K, V>::operator[](const K &key) const
 {
-    if (contains(key))
+    Node *curr = find_node(key);
+    if (curr == nullptr)
     {
-        Node *curr = root;
-        while (curr != nullptr)
-        {
-            if (curr->key == key) // eventually want to get to this
-            {
-                return curr->value;
-            }
-            else if (curr->key < key)
-            {
-                curr = curr->right;
-            }
-            else
-            {
-                curr = curr->left;
-            }
-        }
+        throw std::out_of_range("Key not found");
     }
-    else
+    return curr->value;
+}
+
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V>
+V *BSTMap<K, V>::find(const K &key)
+{
+    Node *curr = find_node(key);
+    return curr != nullptr ? &curr->value : nullptr;
+}
+
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V>
+const V *BSTMap<K, V>::find(const K &key) const
+{
+    Node *curr = find_node(key);
+    return curr != nullptr ? &curr->value : nullptr;
+}
+
+// Allows values associated with a key of type Q to be updated
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+V &BSTMap<K, V>::operator[](const Q &key)
+{
+    Node *curr = find_node(key);
+    if (curr == nullptr)
     {
+        throw std::out_of_range("Key not found");
+    }
+    return curr->value;
+}
 
+// Returns the value for a key of type Q
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+const V &BSTMap<K, V>::operator[](const Q &key) const
+{
+    Node *curr = find_node(key);
+    if (curr == nullptr)
+    {
         throw std::out_of_range("Key not found");
     }
+    return curr->value;
 }
 
 // Extends the collection by adding the given key-value
@@ -255,20 +369,33 @@ const V &BSTMap<K, V>::operator[](const K &key) const
 template <typename K, typename V>
 void BSTMap<K, V>::insert(const K &key, const V &value)
 {
-    // Create and initialize the new node
-    Node *new_node = new Node;
+    emplace(key, value);
+}
+
+// Extends the collection by moving in the given key-value pair
+template <typename K, typename V>
+void BSTMap<K, V>::insert(K &&key, V &&value)
+{
+    emplace(std::move(key), std::move(value));
+}
 
-    new_node->left = nullptr;
-    new_node->right = nullptr;
-    new_node->key = key;
-    new_node->value = value;
+// Extends the collection by adding the key with a value constructed
+// from args
+template <typename K, typename V>
+template <typename KK, typename... Args>
+void BSTMap<K, V>::emplace(KK &&key, Args &&...args)
+{
+    // Create the new node, building the key and value in place
+    Node *new_node = new Node{K(std::forward<KK>(key)),
+                              V(std::forward<Args>(args)...), nullptr, nullptr};
+    const K &new_key = new_node->key;
 
     Node *curr = root;
     Node *prev = nullptr;
     while (curr != nullptr)
     {
         prev = curr;
-        if (curr->key < key)
+        if (curr->key < new_key)
         {
             curr = curr->right;
         }
@@ -282,7 +409,7 @@ void BSTMap<K, V>::insert(const K &key, const V &value)
     {
         root = new_node;
     }
-    else if (prev->key < key)
+    else if (prev->key < new_key)
     {
         prev->right = new_node;
     }
@@ -293,6 +420,48 @@ void BSTMap<K, V>::insert(const K &key, const V &value)
     count++;
 }
 
+// Adds the key with a value constructed from args if the key is not
+// in the collection
+template <typename K, typename V>
+template <typename KK, typename... Args>
+bool BSTMap<K, V>::try_emplace(KK &&key, Args &&...args)
+{
+    Node **link = find_link(key);
+    if (*link != nullptr)
+    {
+        return false;
+    }
+    add_node(link, new Node{K(std::forward<KK>(key)),
+                            V(std::forward<Args>(args)...), nullptr, nullptr});
+    return true;
+}
+
+// Adds the key-value pair, or assigns the value if the key is present
+template <typename K, typename V>
+bool BSTMap<K, V>::insert_or_assign(const K &key, const V &value)
+{
+    Node **link = find_link(key);
+    if (*link != nullptr)
+    {
+        (*link)->value = value;
+        return false;
+    }
+    add_node(link, new Node{key, value, nullptr, nullptr});
+    return true;
+}
+
+// Returns the value for a given key, adding a default value if needed
+template <typename K, typename V>
+V &BSTMap<K, V>::get_or_insert_default(const K &key)
+{
+    Node **link = find_link(key);
+    if (*link == nullptr)
+    {
+        add_node(link, new Node{key, V(), nullptr, nullptr});
+    }
+    return (*link)->value;
+}
+
 // Shrinks the collection by removing the key-value pair with the
 // given key. Does not modify the collection if the collection does
 // not contain the key. Throws out_of_range if the given key is not
@@ -300,37 +469,63 @@ void BSTMap<K, V>::insert(const K &key, const V &value)
 template <typename K, typename V>
 void BSTMap<K, V>::erase(const K &key)
 {
-    if (contains(key))
-    {
-        root = erase(key, root);
-    }
-    else
+    if (!try_erase(key))
     {
         throw std::out_of_range("Key not found");
     }
 }
 
-// Returns true if the key is in the collection, and false otherwise.
+// Removes the key-value pair if present, returning whether it was
 template <typename K, typename V>
-bool BSTMap<K, V>::contains(const K &key) const
+bool BSTMap<K, V>::try_erase(const K &key)
 {
-    Node *curr = root;
-    while (curr != nullptr)
+    Node **link = find_link(key);
+    Node *node = *link;
+    if (node == nullptr)
     {
-        if (curr->key == key)
-        {
-            return true;
-        }
-        else if (curr->key < key)
-        {
-            curr = curr->right;
-        }
-        else
+        return false;
+    }
+    if (node->right == nullptr)
+    {
+        *link = node->left;
+    }
+    else if (node->left == nullptr)
+    {
+        *link = node->right;
+    }
+    else
+    {
+        // relink the in-order successor in the node's place (instead
+        // of copying its key and value over the node's)
+        Node **succ_link = &node->right;
+        while ((*succ_link)->left != nullptr)
         {
-            curr = curr->left;
+            succ_link = &(*succ_link)->left;
         }
+        Node *succ = *succ_link;
+        *succ_link = succ->right;
+        succ->left = node->left;
+        succ->right = node->right;
+        *link = succ;
     }
-    return false;
+    delete node;
+    count--;
+    return true;
+}
+
+// Returns true if the key is in the collection, and false otherwise.
+template <typename K, typename V>
+bool BSTMap<K, V>::contains(const K &key) const
+{
+    return find_node(key) != nullptr;
+}
+
+// Returns true if a key of type Q is in the collection
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+bool BSTMap<K, V>::contains(const Q &key) const
+{
+    return find_node(key) != nullptr;
 }
 
 // Returns the height of the binary search tree
@@ -347,10 +542,34 @@ void BSTMap<K, V>::make_empty(Node *st_root)
     {
         make_empty(st_root->left);
         make_empty(st_root->right);
-        st_root = nullptr;
+        delete st_root;
     }
 }
 
+// returns the node with the given key, or nullptr
+template <typename K, typename V>
+template <typename Q>
+typename BSTMap<K, V>::Node *BSTMap<K, V>::find_node(const Q &key) const
+{
+    Node *curr = root;
+    while (curr != nullptr)
+    {
+        if (curr->key == key)
+        {
+            return curr;
+        }
+        else if (curr->key < key)
+        {
+            curr = curr->right;
+        }
+        else
+        {
+            curr = curr->left;
+        }
+    }
+    return nullptr;
+}
+
 // copy assignment helper
 template <typename K, typename V>
 typename BSTMap<K, V>::Node *
@@ -368,57 +587,33 @@ BSTMap<K, V>::copy(const Node *rhs_st_root) const
     return new_node;
 }
 
-// erase helper
+// returns the link to the node with the given key, or the null link
+// where the key belongs
 template <typename K, typename V>
-typename BSTMap<K, V>::Node *
-BSTMap<K, V>::erase(const K &key, Node *st_root)
+template <typename Q>
+typename BSTMap<K, V>::Node **BSTMap<K, V>::find_link(const Q &key)
 {
-    if (st_root == nullptr)
-    {
-        return st_root;
-    }
-    if (st_root->key == key)
+    Node **link = &root;
+    while (*link != nullptr && !((*link)->key == key))
     {
-        Node *temp = st_root;
-        if (st_root->right == nullptr)
-        {
-            st_root = st_root->left;
-        }
-        else if (st_root->left == nullptr)
+        if ((*link)->key < key)
         {
-            st_root = st_root->right;
+            link = &(*link)->right;
         }
         else
         {
-            Node *curr = st_root->right;
-            Node *prev = st_root;
-            while (curr->left != nullptr)
-            {
-                prev = curr;
-                curr = curr->left;
-            }
-            temp->key = curr->key;
-            temp->value = curr->value;
-            if (prev == st_root)
-            {
-                prev->right = curr->right;
-            }
-            else
-            {
-                prev->left = curr->right;
-            }
+            link = &(*link)->left;
         }
-        count--;
-    }
-    else if (st_root->key < key)
-    {
-        st_root->right = erase(key, st_root->right);
     }
-    else
-    {
-        st_root->left = erase(key, st_root->left);
-    }
-    return st_root;
+    return link;
+}
+
+// links the new node in at a null link
+template <typename K, typename V>
+void BSTMap<K, V>::add_node(Node **link, Node *node)
+{
+    *link = node;
+    count++;
 }
 
 // Returns the keys k in the collection such that k1 <= k <= k2
@@ -430,6 +625,14 @@ ArraySeq<K> BSTMap<K, V>::find_keys(const K &k1, const K &k2) const
     return foundKeys;
 }
 
+// Appends the keys k in the collection such that k1 <= k <= k2
+template <typename K, typename V>
+template <typename Seq>
+void BSTMap<K, V>::find_keys(const K &k1, const K &k2, Seq &keys) const
+{
+    find_keys(k1, k2, root, keys);
+}
+
 // Returns the keys in the collection in ascending sorted order
 template <typename K, typename V>
 ArraySeq<K> BSTMap<K, V>::sorted_keys() const
@@ -442,7 +645,8 @@ ArraySeq<K> BSTMap<K, V>::sorted_keys() const
 
 // find_keys helper
 template <typename K, typename V>
-void BSTMap<K, V>::find_keys(const K &k1, const K &k2, const Node *st_root, ArraySeq<K> &keys) const
+template <typename Seq>
+void BSTMap<K, V>::find_keys(const K &k1, const K &k2, const Node *st_root, Seq &keys) const
 {
     if (st_root == nullptr)
     {
@@ -504,4 +708,181 @@ int BSTMap<K, V>::height(const Node *st_root) const
     }
 }
 
+// Writes the key-value pairs, in sorted order, to a snapshot file
+template <typename K, typename V>
+void BSTMap<K, V>::save(const std::string &path) const
+{
+    SnapshotWriter<K, V> out(path, BSTMAP_SNAPSHOT, count);
+    save(root, out);
+    out.flush();
+}
+
+// Replaces the contents of the map with those of a snapshot file
+template <typename K, typename V>
+void BSTMap<K, V>::load(const std::string &path)
+{
+    SnapshotReader<K, V> in(path, BSTMAP_SNAPSHOT);
+    int n = snapshot_count_as_int(in.count(), path);
+    K *keys = new K[n];
+    V *values = nullptr;
+    Node *new_root = nullptr;
+    try
+    {
+        values = new V[n];
+        for (int i = 0; i < n; ++i)
+        {
+            in.read(keys[i], values[i]);
+            // as in build_from_sorted, unsorted keys would not make a
+            // search tree
+            if (i > 0 && !(keys[i - 1] < keys[i]))
+            {
+                throw std::runtime_error("snapshot keys are out of order: " + path);
+            }
+        }
+        // build before freeing the old tree, so a failed load leaves
+        // the map unchanged
+        new_root = build(keys, values, 0, n - 1, build_threads());
+    }
+    catch (...)
+    {
+        delete[] keys;
+        delete[] values;
+        throw;
+    }
+    delete[] keys;
+    delete[] values;
+    make_empty(root);
+    root = new_root;
+    count = n;
+}
+
+// Replaces the contents of the map with the sorted keys and values
+template <typename K, typename V>
+void BSTMap<K, V>::build_from_sorted(const K keys[], const V values[], int n)
+{
+    for (int i = 1; i < n; ++i)
+    {
+        if (!(keys[i - 1] < keys[i]))
+        {
+            throw std::invalid_argument("BSTMap<K, V>::build_from_sorted(keys)");
+        }
+    }
+    // build before freeing the old tree, so a failed build leaves the
+    // map unchanged
+    Node *new_root = build(keys, values, 0, n - 1, build_threads());
+    make_empty(root);
+    root = new_root;
+    count = n;
+}
+
+// Sets the maximum number of threads used by build_from_sorted and load
+template <typename K, typename V>
+void BSTMap<K, V>::set_threads(int n)
+{
+    threads = n < 0 ? 0 : n;
+}
+
+// save helper
+template <typename K, typename V>
+void BSTMap<K, V>::save(const Node *st_root, SnapshotWriter<K, V> &out) const
+{
+    if (st_root != nullptr)
+    {
+        save(st_root->left, out);
+        out.write(st_root->key, st_root->value);
+        save(st_root->right, out);
+    }
+}
+
+// builds a balanced subtree from sorted keys and values
+template <typename K, typename V>
+typename BSTMap<K, V>::Node *BSTMap<K, V>::build(const K keys[], const V values[], int start, int end)
+{
+    if (start > end)
+    {
+        return nullptr;
+    }
+    int mid = (start + end) / 2;
+    Node *st_root = new Node;
+    st_root->left = nullptr;
+    st_root->right = nullptr;
+    try
+    {
+        st_root->key = keys[mid];
+        st_root->value = values[mid];
+        st_root->left = build(keys, values, start, mid - 1);
+        st_root->right = build(keys, values, mid + 1, end);
+    }
+    catch (...)
+    {
+        // free the partly built subtree
+        make_empty(st_root);
+        throw;
+    }
+    return st_root;
+}
+
+// number of threads to build with
+template <typename K, typename V>
+int BSTMap<K, V>::build_threads() const
+{
+    int n = threads;
+    if (n == 0)
+    {
+        n = std::thread::hardware_concurrency();
+    }
+    return n < 1 ? 1 : n;
+}
+
+// builds a balanced subtree, building the left subtree on a new thread
+template <typename K, typename V>
+typename BSTMap<K, V>::Node *BSTMap<K, V>::build(const K keys[], const V values[], int start, int end, int n)
+{
+    if (n < 2 || end - start + 1 < 2 * min_build_per_thread)
+    {
+        return build(keys, values, start, end);
+    }
+    int mid = (start + end) / 2;
+    Node *st_root = new Node;
+    st_root->left = nullptr;
+    st_root->right = nullptr;
+    // an exception on the left builder's thread is passed back here
+    std::exception_ptr left_error;
+    std::thread left_builder;
+    try
+    {
+        st_root->key = keys[mid];
+        st_root->value = values[mid];
+        left_builder = std::thread([&]()
+                                   {
+                                       try
+                                       {
+                                           st_root->left = build(keys, values, start, mid - 1, n / 2);
+                                       }
+                                       catch (...)
+                                       {
+                                           left_error = std::current_exception();
+                                       }
+                                   });
+        st_root->right = build(keys, values, mid + 1, end, n - n / 2);
+    }
+    catch (...)
+    {
+        // the left builder must finish before its subtree is freed
+        if (left_builder.joinable())
+        {
+            left_builder.join();
+        }
+        make_empty(st_root);
+        throw;
+    }
+    left_builder.join();
+    if (left_error)
+    {
+        make_empty(st_root);
+        std::rethrow_exception(left_error);
+    }
+    return st_root;
+}
+
 #endif
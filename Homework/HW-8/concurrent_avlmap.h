@@ -0,0 +1,527 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: concurrent_avlmap.h
+// DATE: Fall 2021
+// DESC: An AVL tree map whose readers never lock. Published nodes are
+//       never modified: insert and erase copy the nodes on the path
+//       they change (and any node a rotation touches), build the new
+//       version of the tree off to the side, and publish it with one
+//       atomic store of the root. Readers load the root and search an
+//       immutable snapshot, so contains, operator[], and find_keys
+//       see either the old or the new tree, never a mix. Replaced
+//       nodes are retired to an EpochManager (see epoch.h) and freed
+//       once no reader can still hold them. Writers are serialized by
+//       a mutex. Values are returned by copy, since a reference could
+//       outlive its node.
+//---------------------------------------------------------------------------
+
+#ifndef CONCURRENT_AVLMAP_H
+#define CONCURRENT_AVLMAP_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include "arrayseq.h"
+#include "epoch.h"
+
+template <typename K, typename V>
+class ConcurrentAVLMap
+{
+public:
+    // default constructor
+    ConcurrentAVLMap();
+
+    // destructor (assumes no readers or writers are active)
+    ~ConcurrentAVLMap();
+
+    ConcurrentAVLMap(const ConcurrentAVLMap &) = delete;
+    ConcurrentAVLMap &operator=(const ConcurrentAVLMap &) = delete;
+
+    // Returns the number of key-value pairs in the map
+    int size() const;
+
+    // Tests if the map is empty
+    bool empty() const;
+
+    // Returns a copy of the value for a given key. Throws out_of_range
+    // if the given key is not in the collection. Never blocks.
+    V operator[](const K &key) const;
+
+    // Extends the collection by adding the given key-value
+    // pair. Assumes the key being added is not present in the
+    // collection. Insert does not check if the key is present.
+    void insert(const K &key, const V &value);
+
+    // Replaces the value of the given key. Throws out_of_range if the
+    // given key is not in the collection.
+    void update(const K &key, const V &value);
+
+    // Shrinks the collection by removing the key-value pair with the
+    // given key. Throws out_of_range if the given key is not in the
+    // collection.
+    void erase(const K &key);
+
+    // Returns true if the key is in the collection, and false
+    // otherwise. Never blocks.
+    bool contains(const K &key) const;
+
+    // Returns the keys k in the collection such that k1 <= k <= k2,
+    // from a single version of the tree. Never blocks.
+    ArraySeq<K> find_keys(const K &k1, const K &k2) const;
+
+    // Returns the keys in the collection in ascending sorted order,
+    // from a single version of the tree. Never blocks.
+    ArraySeq<K> sorted_keys() const;
+
+    // Returns the height of the tree
+    int height() const;
+
+    // Returns the number of replaced nodes waiting to be freed
+    int pending_frees() const;
+
+private:
+    // node for avl tree (immutable once published)
+    struct Node
+    {
+        K key;
+        V value;
+        Node *left;
+        Node *right;
+        int height;
+        // the write that created the node (a write may modify its
+        // own nodes in place)
+        std::uint64_t version;
+    };
+
+    // number of nodes
+    std::atomic<int> count{0};
+
+    // root of the published tree
+    std::atomic<Node *> root{nullptr};
+
+    // serializes writers
+    std::mutex write_lock;
+
+    // version of the write in progress
+    std::uint64_t version = 0;
+
+    // reclaims replaced nodes (mutable so const readers can pin)
+    mutable EpochManager epochs;
+
+    // frees the subtree
+    void make_empty(Node *st_root);
+
+    // returns a node this write may modify: st_root itself if this
+    // write created it, otherwise a copy (retiring st_root)
+    Node *own(Node *st_root);
+
+    // insert helper, returns the new subtree root
+    Node *insert(const K &key, const V &value, Node *st_root);
+
+    // update helper, returns the new subtree root
+    Node *update(const K &key, const V &value, Node *st_root);
+
+    // erase helper, returns the new subtree root
+    Node *erase(const K &key, Node *st_root);
+
+    // find_keys helper
+    void find_keys(const K &k1, const K &k2, const Node *st_root,
+                   ArraySeq<K> &keys) const;
+
+    // sorted_keys helper
+    void sorted_keys(const Node *st_root, ArraySeq<K> &keys) const;
+
+    // height of a possibly empty subtree
+    static int height(const Node *st_root);
+
+    // recomputes an owned node's height
+    static void fix_height(Node *st_root);
+
+    // rotations of an owned node
+    Node *right_rotate(Node *k2);
+    Node *left_rotate(Node *k2);
+
+    // rebalances an owned node
+    Node *rebalance(Node *st_root);
+};
+
+// default constructor
+template <typename K, typename V>
+ConcurrentAVLMap<K, V>::ConcurrentAVLMap()
+{
+}
+
+// destructor
+template <typename K, typename V>
+ConcurrentAVLMap<K, V>::~ConcurrentAVLMap()
+{
+    make_empty(root.load());
+}
+
+// Returns the number of key-value pairs in the map
+template <typename K, typename V>
+int ConcurrentAVLMap<K, V>::size() const
+{
+    return count.load();
+}
+
+// Tests if the map is empty
+template <typename K, typename V>
+bool ConcurrentAVLMap<K, V>::empty() const
+{
+    return count.load() == 0;
+}
+
+// Returns a copy of the value for a given key
+template <typename K, typename V>
+V ConcurrentAVLMap<K, V>::operator[](const K &key) const
+{
+    EpochManager::Guard guard(epochs);
+    const Node *temp = root.load();
+    while (temp != nullptr)
+    {
+        if (key < temp->key)
+        {
+            temp = temp->left;
+        }
+        else if (temp->key < key)
+        {
+            temp = temp->right;
+        }
+        else
+        {
+            return temp->value;
+        }
+    }
+    throw std::out_of_range("ConcurrentAVLMap<K, V>::operator[](key)");
+}
+
+// Extends the collection by adding the given key-value pair
+template <typename K, typename V>
+void ConcurrentAVLMap<K, V>::insert(const K &key, const V &value)
+{
+    std::lock_guard<std::mutex> lock(write_lock);
+    ++version;
+    // retiring before the new root is stored is safe: the epoch only
+    // advances in collect, after the store
+    root.store(insert(key, value, root.load()));
+    ++count;
+    epochs.collect();
+}
+
+// Replaces the value of the given key
+template <typename K, typename V>
+void ConcurrentAVLMap<K, V>::update(const K &key, const V &value)
+{
+    std::lock_guard<std::mutex> lock(write_lock);
+    ++version;
+    root.store(update(key, value, root.load()));
+    epochs.collect();
+}
+
+// Shrinks the collection by removing the key-value pair with the key
+template <typename K, typename V>
+void ConcurrentAVLMap<K, V>::erase(const K &key)
+{
+    std::lock_guard<std::mutex> lock(write_lock);
+    ++version;
+    root.store(erase(key, root.load()));
+    --count;
+    epochs.collect();
+}
+
+// Returns true if the key is in the collection
+template <typename K, typename V>
+bool ConcurrentAVLMap<K, V>::contains(const K &key) const
+{
+    EpochManager::Guard guard(epochs);
+    const Node *temp = root.load();
+    while (temp != nullptr)
+    {
+        if (key < temp->key)
+        {
+            temp = temp->left;
+        }
+        else if (temp->key < key)
+        {
+            temp = temp->right;
+        }
+        else
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns the keys k in the collection such that k1 <= k <= k2
+template <typename K, typename V>
+ArraySeq<K> ConcurrentAVLMap<K, V>::find_keys(const K &k1, const K &k2) const
+{
+    EpochManager::Guard guard(epochs);
+    ArraySeq<K> keys;
+    find_keys(k1, k2, root.load(), keys);
+    return keys;
+}
+
+// Returns the keys in the collection in ascending sorted order
+template <typename K, typename V>
+ArraySeq<K> ConcurrentAVLMap<K, V>::sorted_keys() const
+{
+    EpochManager::Guard guard(epochs);
+    ArraySeq<K> keys;
+    sorted_keys(root.load(), keys);
+    return keys;
+}
+
+// Returns the height of the tree
+template <typename K, typename V>
+int ConcurrentAVLMap<K, V>::height() const
+{
+    EpochManager::Guard guard(epochs);
+    return height(root.load());
+}
+
+// Returns the number of replaced nodes waiting to be freed
+template <typename K, typename V>
+int ConcurrentAVLMap<K, V>::pending_frees() const
+{
+    return epochs.pending();
+}
+
+// frees the subtree
+template <typename K, typename V>
+void ConcurrentAVLMap<K, V>::make_empty(Node *st_root)
+{
+    if (st_root != nullptr)
+    {
+        make_empty(st_root->left);
+        make_empty(st_root->right);
+        delete st_root;
+    }
+}
+
+// returns a node this write may modify
+template <typename K, typename V>
+typename ConcurrentAVLMap<K, V>::Node *ConcurrentAVLMap<K, V>::own(Node *st_root)
+{
+    if (st_root->version == version)
+    {
+        return st_root;
+    }
+    Node *copy = new Node(*st_root);
+    copy->version = version;
+    epochs.retire(st_root);
+    return copy;
+}
+
+// insert helper
+template <typename K, typename V>
+typename ConcurrentAVLMap<K, V>::Node *ConcurrentAVLMap<K, V>::insert(const K &key, const V &value, Node *st_root)
+{
+    if (st_root == nullptr)
+    {
+        return new Node{key, value, nullptr, nullptr, 1, version};
+    }
+    st_root = own(st_root);
+    if (key < st_root->key)
+    {
+        st_root->left = insert(key, value, st_root->left);
+    }
+    else
+    {
+        st_root->right = insert(key, value, st_root->right);
+    }
+    return rebalance(st_root);
+}
+
+// update helper
+template <typename K, typename V>
+typename ConcurrentAVLMap<K, V>::Node *ConcurrentAVLMap<K, V>::update(const K &key, const V &value, Node *st_root)
+{
+    if (st_root == nullptr)
+    {
+        throw std::out_of_range("ConcurrentAVLMap<K, V>::update(key, value)");
+    }
+    // search first so a missing key leaves the tree untouched
+    Node *child = nullptr;
+    if (key < st_root->key)
+    {
+        child = update(key, value, st_root->left);
+    }
+    else if (st_root->key < key)
+    {
+        child = update(key, value, st_root->right);
+    }
+    st_root = own(st_root);
+    if (key < st_root->key)
+    {
+        st_root->left = child;
+    }
+    else if (st_root->key < key)
+    {
+        st_root->right = child;
+    }
+    else
+    {
+        st_root->value = value;
+    }
+    return st_root;
+}
+
+// erase helper
+template <typename K, typename V>
+typename ConcurrentAVLMap<K, V>::Node *ConcurrentAVLMap<K, V>::erase(const K &key, Node *st_root)
+{
+    if (st_root == nullptr)
+    {
+        throw std::out_of_range("ConcurrentAVLMap<K, V>::erase(key)");
+    }
+    if (key < st_root->key)
+    {
+        Node *child = erase(key, st_root->left);
+        st_root = own(st_root);
+        st_root->left = child;
+    }
+    else if (st_root->key < key)
+    {
+        Node *child = erase(key, st_root->right);
+        st_root = own(st_root);
+        st_root->right = child;
+    }
+    else if (st_root->left == nullptr || st_root->right == nullptr)
+    {
+        Node *child = st_root->left ? st_root->left : st_root->right;
+        if (st_root->version == version)
+        {
+            delete st_root;
+        }
+        else
+        {
+            epochs.retire(st_root);
+        }
+        return child;
+    }
+    else
+    {
+        // replace with the inorder successor, then erase it from the
+        // right subtree
+        const Node *succ = st_root->right;
+        while (succ->left != nullptr)
+        {
+            succ = succ->left;
+        }
+        K succ_key = succ->key;
+        V succ_value = succ->value;
+        Node *child = erase(succ_key, st_root->right);
+        st_root = own(st_root);
+        st_root->key = succ_key;
+        st_root->value = succ_value;
+        st_root->right = child;
+    }
+    return rebalance(st_root);
+}
+
+// find_keys helper
+template <typename K, typename V>
+void ConcurrentAVLMap<K, V>::find_keys(const K &k1, const K &k2, const Node *st_root,
+                                       ArraySeq<K> &keys) const
+{
+    if (st_root == nullptr)
+    {
+        return;
+    }
+    if (k1 < st_root->key)
+    {
+        find_keys(k1, k2, st_root->left, keys);
+    }
+    if (!(st_root->key < k1) && !(k2 < st_root->key))
+    {
+        keys.insert(st_root->key, keys.size());
+    }
+    if (st_root->key < k2)
+    {
+        find_keys(k1, k2, st_root->right, keys);
+    }
+}
+
+// sorted_keys helper
+template <typename K, typename V>
+void ConcurrentAVLMap<K, V>::sorted_keys(const Node *st_root, ArraySeq<K> &keys) const
+{
+    if (st_root != nullptr)
+    {
+        sorted_keys(st_root->left, keys);
+        keys.insert(st_root->key, keys.size());
+        sorted_keys(st_root->right, keys);
+    }
+}
+
+// height of a possibly empty subtree
+template <typename K, typename V>
+int ConcurrentAVLMap<K, V>::height(const Node *st_root)
+{
+    return st_root ? st_root->height : 0;
+}
+
+// recomputes an owned node's height
+template <typename K, typename V>
+void ConcurrentAVLMap<K, V>::fix_height(Node *st_root)
+{
+    st_root->height = 1 + std::max(height(st_root->left), height(st_root->right));
+}
+
+// right rotation (the left child is copied if it is published)
+template <typename K, typename V>
+typename ConcurrentAVLMap<K, V>::Node *ConcurrentAVLMap<K, V>::right_rotate(Node *k2)
+{
+    Node *k1 = own(k2->left);
+    k2->left = k1->right;
+    k1->right = k2;
+    fix_height(k2);
+    fix_height(k1);
+    return k1;
+}
+
+// left rotation (the right child is copied if it is published)
+template <typename K, typename V>
+typename ConcurrentAVLMap<K, V>::Node *ConcurrentAVLMap<K, V>::left_rotate(Node *k2)
+{
+    Node *k1 = own(k2->right);
+    k2->right = k1->left;
+    k1->left = k2;
+    fix_height(k2);
+    fix_height(k1);
+    return k1;
+}
+
+// rebalances an owned node
+template <typename K, typename V>
+typename ConcurrentAVLMap<K, V>::Node *ConcurrentAVLMap<K, V>::rebalance(Node *st_root)
+{
+    fix_height(st_root);
+    int bal_factor = height(st_root->left) - height(st_root->right);
+    if (bal_factor > 1)
+    {
+        Node *left = st_root->left;
+        if (height(left->right) > height(left->left))
+        {
+            st_root->left = left_rotate(own(left));
+        }
+        return right_rotate(st_root);
+    }
+    if (bal_factor < -1)
+    {
+        Node *right = st_root->right;
+        if (height(right->left) > height(right->right))
+        {
+            st_root->right = right_rotate(own(right));
+        }
+        return left_rotate(st_root);
+    }
+    return st_root;
+}
+
+#endif
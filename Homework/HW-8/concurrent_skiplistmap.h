@@ -0,0 +1,505 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: concurrent_skiplistmap.h
+// DATE: Fall 2021
+// DESC: A lock-free skip list map that any number of threads may read
+//       and write at once. Each node has a tower of next pointers
+//       whose low bit marks the node as deleted at that level. Insert
+//       links a new node at level 0 with a compare-and-swap (which
+//       makes it present) and then links the levels above. Erase
+//       marks the tower top down and then level 0 (the thread whose
+//       mark lands at level 0 owns the erase), after which any
+//       traversal that meets the node unlinks it. Unlinked nodes and
+//       replaced values are retired to an EpochManager (see epoch.h).
+//       Lookups see each key as present or not at some point during
+//       the call; find_keys and sorted_keys are weakly consistent,
+//       that is, they see every key present for the whole call and
+//       may or may not see keys inserted or erased during it. Values
+//       are returned by copy, since a reference could outlive its
+//       node.
+//---------------------------------------------------------------------------
+
+#ifndef CONCURRENT_SKIPLISTMAP_H
+#define CONCURRENT_SKIPLISTMAP_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include "arrayseq.h"
+#include "epoch.h"
+
+template <typename K, typename V>
+class ConcurrentSkipListMap
+{
+public:
+    // default constructor
+    ConcurrentSkipListMap();
+
+    // destructor (assumes no other thread is using the map)
+    ~ConcurrentSkipListMap();
+
+    ConcurrentSkipListMap(const ConcurrentSkipListMap &) = delete;
+    ConcurrentSkipListMap &operator=(const ConcurrentSkipListMap &) = delete;
+
+    // Returns the number of key-value pairs in the map
+    int size() const;
+
+    // Tests if the map is empty
+    bool empty() const;
+
+    // Returns a copy of the value for a given key. Throws out_of_range
+    // if the given key is not in the collection.
+    V operator[](const K &key) const;
+
+    // Extends the collection by adding the given key-value pair. If
+    // the key is already present (for instance, inserted by another
+    // thread) the collection is not changed.
+    void insert(const K &key, const V &value);
+
+    // Replaces the value of the given key. Throws out_of_range if the
+    // given key is not in the collection.
+    void update(const K &key, const V &value);
+
+    // Shrinks the collection by removing the key-value pair with the
+    // given key. Throws out_of_range if the given key is not in the
+    // collection (or another thread erased it first).
+    void erase(const K &key);
+
+    // Returns true if the key is in the collection, and false
+    // otherwise. Never unlinks or writes shared memory.
+    bool contains(const K &key) const;
+
+    // Returns the keys k in the collection such that k1 <= k <= k2
+    // (weakly consistent)
+    ArraySeq<K> find_keys(const K &k1, const K &k2) const;
+
+    // Returns the keys in the collection in ascending sorted order
+    // (weakly consistent)
+    ArraySeq<K> sorted_keys() const;
+
+    // Returns the number of unlinked nodes and values waiting to be
+    // freed
+    int pending_frees() const;
+
+private:
+    // tallest tower; each level holds about a quarter of the nodes
+    // below it, so 16 levels cover 4^16 keys
+    static const int max_level = 16;
+
+    // done flags: the inserter has stopped linking the tower, and the
+    // eraser has unlinked it; whoever sets the second frees the node
+    static const int insert_done = 1;
+    static const int erase_done = 2;
+
+    // skip list node; next[i] is a Node pointer whose low bit marks
+    // the node as erased at level i
+    struct Node
+    {
+        K key;
+        std::atomic<V *> value;
+        int levels;
+        std::atomic<std::uintptr_t> *next;
+        std::atomic<int> done{0};
+
+        Node(const K &key, V *value, int levels)
+            : key(key), value(value), levels(levels),
+              next(new std::atomic<std::uintptr_t>[levels])
+        {
+            for (int i = 0; i < levels; ++i)
+            {
+                next[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        ~Node()
+        {
+            delete value.load();
+            delete[] next;
+        }
+    };
+
+    // sentinel before the first node (its key is never compared)
+    Node *head;
+
+    // number of nodes present
+    std::atomic<int> count{0};
+
+    // erases since the last collect
+    std::atomic<int> erase_count{0};
+
+    // reclaims unlinked nodes (mutable so const readers can pin)
+    mutable EpochManager epochs;
+
+    // helpers for the marked next pointers
+    static Node *ptr(std::uintptr_t link);
+    static bool marked(std::uintptr_t link);
+    static std::uintptr_t pack(Node *node, bool mark);
+
+    // returns a random tower height
+    static int random_level();
+
+    // Finds the last node before key and the first node at or after
+    // key on each level, unlinking any marked nodes on the way.
+    // Returns true if succs[0] has the key. The caller must be
+    // pinned.
+    bool find(const K &key, Node *preds[], Node *succs[]);
+
+    // returns the first unmarked node at or after key on level 0,
+    // without unlinking (the caller must be pinned)
+    Node *lower_bound(const K &key) const;
+
+    // records that the inserter or eraser of node is finished and, if
+    // both are, unlinks what is left of the tower and retires it
+    void finish(Node *node, int flag);
+};
+
+// default constructor
+template <typename K, typename V>
+ConcurrentSkipListMap<K, V>::ConcurrentSkipListMap()
+    : head(new Node(K(), nullptr, max_level))
+{
+}
+
+// destructor
+template <typename K, typename V>
+ConcurrentSkipListMap<K, V>::~ConcurrentSkipListMap()
+{
+    // every node still on level 0, erased or not, is freed here;
+    // retired nodes are already off level 0 and freed by epochs
+    Node *node = head;
+    while (node != nullptr)
+    {
+        Node *next = ptr(node->next[0].load());
+        delete node;
+        node = next;
+    }
+}
+
+// Returns the number of key-value pairs in the map
+template <typename K, typename V>
+int ConcurrentSkipListMap<K, V>::size() const
+{
+    return count.load();
+}
+
+// Tests if the map is empty
+template <typename K, typename V>
+bool ConcurrentSkipListMap<K, V>::empty() const
+{
+    return count.load() == 0;
+}
+
+// Returns a copy of the value for a given key
+template <typename K, typename V>
+V ConcurrentSkipListMap<K, V>::operator[](const K &key) const
+{
+    EpochManager::Guard guard(epochs);
+    Node *node = lower_bound(key);
+    if (node == nullptr || key < node->key)
+    {
+        throw std::out_of_range("ConcurrentSkipListMap<K, V>::operator[](key)");
+    }
+    return *node->value.load();
+}
+
+// Extends the collection by adding the given key-value pair
+template <typename K, typename V>
+void ConcurrentSkipListMap<K, V>::insert(const K &key, const V &value)
+{
+    EpochManager::Guard guard(epochs);
+    Node *preds[max_level];
+    Node *succs[max_level];
+    Node *node = nullptr;
+    // link level 0, which makes the key present
+    while (true)
+    {
+        if (find(key, preds, succs))
+        {
+            delete node;
+            return;
+        }
+        if (node == nullptr)
+        {
+            node = new Node(key, new V(value), random_level());
+        }
+        for (int i = 0; i < node->levels; ++i)
+        {
+            node->next[i].store(pack(succs[i], false), std::memory_order_relaxed);
+        }
+        std::uintptr_t expected = pack(succs[0], false);
+        if (preds[0]->next[0].compare_exchange_strong(expected, pack(node, false)))
+        {
+            break;
+        }
+    }
+    ++count;
+    // link the levels above, giving up once the node is being erased
+    for (int level = 1; level < node->levels; ++level)
+    {
+        while (true)
+        {
+            std::uintptr_t expected = pack(succs[level], false);
+            if (preds[level]->next[level].compare_exchange_strong(expected, pack(node, false)))
+            {
+                break;
+            }
+            find(key, preds, succs);
+            std::uintptr_t link = node->next[level].load();
+            if (marked(node->next[0].load()) || marked(link) ||
+                !node->next[level].compare_exchange_strong(link, pack(succs[level], false)))
+            {
+                finish(node, insert_done);
+                return;
+            }
+        }
+        if (marked(node->next[0].load()))
+        {
+            break;
+        }
+    }
+    finish(node, insert_done);
+}
+
+// Replaces the value of the given key
+template <typename K, typename V>
+void ConcurrentSkipListMap<K, V>::update(const K &key, const V &value)
+{
+    {
+        EpochManager::Guard guard(epochs);
+        Node *node = lower_bound(key);
+        if (node == nullptr || key < node->key)
+        {
+            throw std::out_of_range("ConcurrentSkipListMap<K, V>::update(key, value)");
+        }
+        // readers may still be copying the old value
+        epochs.retire(node->value.exchange(new V(value)));
+    }
+    epochs.collect();
+}
+
+// Shrinks the collection by removing the key-value pair with the key
+template <typename K, typename V>
+void ConcurrentSkipListMap<K, V>::erase(const K &key)
+{
+    {
+        EpochManager::Guard guard(epochs);
+        Node *preds[max_level];
+        Node *succs[max_level];
+        if (!find(key, preds, succs))
+        {
+            throw std::out_of_range("ConcurrentSkipListMap<K, V>::erase(key)");
+        }
+        Node *victim = succs[0];
+        // mark the upper levels top down, so searches stop using the
+        // tower before the key disappears
+        for (int level = victim->levels - 1; level >= 1; --level)
+        {
+            std::uintptr_t link = victim->next[level].load();
+            while (!marked(link) &&
+                   !victim->next[level].compare_exchange_weak(link, link | 1))
+            {
+            }
+        }
+        // marking level 0 is the erase; only one thread can do it
+        std::uintptr_t link = victim->next[0].load();
+        while (true)
+        {
+            if (marked(link))
+            {
+                throw std::out_of_range("ConcurrentSkipListMap<K, V>::erase(key)");
+            }
+            if (victim->next[0].compare_exchange_weak(link, link | 1))
+            {
+                break;
+            }
+        }
+        --count;
+        find(key, preds, succs);
+        finish(victim, erase_done);
+    }
+    if (++erase_count % 32 == 0)
+    {
+        epochs.collect();
+    }
+}
+
+// Returns true if the key is in the collection
+template <typename K, typename V>
+bool ConcurrentSkipListMap<K, V>::contains(const K &key) const
+{
+    EpochManager::Guard guard(epochs);
+    Node *node = lower_bound(key);
+    return node != nullptr && !(key < node->key);
+}
+
+// Returns the keys k in the collection such that k1 <= k <= k2
+template <typename K, typename V>
+ArraySeq<K> ConcurrentSkipListMap<K, V>::find_keys(const K &k1, const K &k2) const
+{
+    EpochManager::Guard guard(epochs);
+    ArraySeq<K> keys;
+    Node *node = lower_bound(k1);
+    while (node != nullptr && !(k2 < node->key))
+    {
+        std::uintptr_t link = node->next[0].load();
+        if (!marked(link))
+        {
+            keys.insert(node->key, keys.size());
+        }
+        node = ptr(link);
+    }
+    return keys;
+}
+
+// Returns the keys in the collection in ascending sorted order
+template <typename K, typename V>
+ArraySeq<K> ConcurrentSkipListMap<K, V>::sorted_keys() const
+{
+    EpochManager::Guard guard(epochs);
+    ArraySeq<K> keys;
+    Node *node = ptr(head->next[0].load());
+    while (node != nullptr)
+    {
+        std::uintptr_t link = node->next[0].load();
+        if (!marked(link))
+        {
+            keys.insert(node->key, keys.size());
+        }
+        node = ptr(link);
+    }
+    return keys;
+}
+
+// Returns the number of nodes and values waiting to be freed
+template <typename K, typename V>
+int ConcurrentSkipListMap<K, V>::pending_frees() const
+{
+    return epochs.pending();
+}
+
+// the node a link points to
+template <typename K, typename V>
+typename ConcurrentSkipListMap<K, V>::Node *ConcurrentSkipListMap<K, V>::ptr(std::uintptr_t link)
+{
+    return reinterpret_cast<Node *>(link & ~std::uintptr_t(1));
+}
+
+// true if the link's node is erased at this level
+template <typename K, typename V>
+bool ConcurrentSkipListMap<K, V>::marked(std::uintptr_t link)
+{
+    return (link & 1) != 0;
+}
+
+// builds a link from a node and a mark
+template <typename K, typename V>
+std::uintptr_t ConcurrentSkipListMap<K, V>::pack(Node *node, bool mark)
+{
+    return reinterpret_cast<std::uintptr_t>(node) | (mark ? 1 : 0);
+}
+
+// returns a random tower height (level i + 1 with probability 4^-i)
+template <typename K, typename V>
+int ConcurrentSkipListMap<K, V>::random_level()
+{
+    thread_local std::mt19937 gen(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    int levels = 1;
+    std::uint32_t bits = gen();
+    while (levels < max_level && (bits & 3) == 0)
+    {
+        ++levels;
+        bits >>= 2;
+    }
+    return levels;
+}
+
+// finds the neighbors of key on each level, unlinking marked nodes
+template <typename K, typename V>
+bool ConcurrentSkipListMap<K, V>::find(const K &key, Node *preds[], Node *succs[])
+{
+retry:
+    Node *pred = head;
+    for (int level = max_level - 1; level >= 0; --level)
+    {
+        Node *curr = ptr(pred->next[level].load());
+        while (curr != nullptr)
+        {
+            std::uintptr_t link = curr->next[level].load();
+            if (marked(link))
+            {
+                // unlink curr; if pred changed under us, start over
+                std::uintptr_t expected = pack(curr, false);
+                if (!pred->next[level].compare_exchange_strong(expected, pack(ptr(link), false)))
+                {
+                    goto retry;
+                }
+                curr = ptr(link);
+            }
+            else if (curr->key < key)
+            {
+                pred = curr;
+                curr = ptr(link);
+            }
+            else
+            {
+                break;
+            }
+        }
+        preds[level] = pred;
+        succs[level] = curr;
+    }
+    return succs[0] != nullptr && !(key < succs[0]->key);
+}
+
+// first unmarked node at or after key on level 0
+template <typename K, typename V>
+typename ConcurrentSkipListMap<K, V>::Node *ConcurrentSkipListMap<K, V>::lower_bound(const K &key) const
+{
+    Node *pred = head;
+    Node *curr = nullptr;
+    for (int level = max_level - 1; level >= 0; --level)
+    {
+        curr = ptr(pred->next[level].load());
+        while (curr != nullptr)
+        {
+            std::uintptr_t link = curr->next[level].load();
+            if (marked(link) || curr->key < key)
+            {
+                // an erased node's links still lead forward, and its
+                // key is below any unmarked node after it
+                if (!marked(link))
+                {
+                    pred = curr;
+                }
+                curr = ptr(link);
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+    return curr;
+}
+
+// frees the node once both its inserter and its eraser are done
+template <typename K, typename V>
+void ConcurrentSkipListMap<K, V>::finish(Node *node, int flag)
+{
+    int other = flag == insert_done ? erase_done : insert_done;
+    if ((node->done.fetch_or(flag) & other) == 0)
+    {
+        return;
+    }
+    // the inserter may have linked an upper level after the eraser's
+    // last pass, so unlink once more now that nobody will relink it
+    Node *preds[max_level];
+    Node *succs[max_level];
+    find(node->key, preds, succs);
+    epochs.retire(node);
+}
+
+#endif
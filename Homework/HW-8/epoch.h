@@ -0,0 +1,254 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: epoch.h
+// DATE: Fall 2021
+// DESC: Epoch-based reclamation for structures whose readers do not
+//       lock. A reader pins the current global epoch in a slot for
+//       the length of its operation (see EpochManager::Guard). The
+//       writer retires unlinked objects instead of deleting them, and
+//       collect advances the global epoch once every pinned reader
+//       has seen it. An object retired in epoch e is deleted once the
+//       epoch reaches e + 2, when no reader that could have reached it
+//       is still pinned. Pinning and unpinning never block on the
+//       writer. Several threads may retire at once as long as each is
+//       pinned while it does (a single retiring thread need not be),
+//       and collect skips its work if another thread is collecting.
+//---------------------------------------------------------------------------
+
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class EpochManager
+{
+public:
+    // Pins the current epoch for the lifetime of the guard. Objects
+    // reachable when the guard is created stay allocated until it is
+    // destroyed.
+    class Guard
+    {
+    public:
+        Guard(EpochManager &manager);
+        ~Guard();
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+
+    private:
+        std::atomic<std::uint64_t> *slot;
+    };
+
+    EpochManager();
+
+    // Deletes every retired object. Assumes no reader is pinned.
+    ~EpochManager();
+
+    EpochManager(const EpochManager &) = delete;
+    EpochManager &operator=(const EpochManager &) = delete;
+
+    // Schedules ptr to be deleted once no pinned reader can reach it.
+    // The object may still be reachable until the writer's change is
+    // published, so retire never advances the epoch itself.
+    template <typename T>
+    void retire(T *ptr);
+
+    // Advances the epoch if every pinned reader has seen the current
+    // one, then deletes the objects that are old enough. Call only
+    // after the objects retired so far have been unlinked.
+    void collect();
+
+    // Returns the number of retired objects not yet deleted
+    int pending() const;
+
+private:
+    // a retired object
+    struct Retired
+    {
+        void *ptr;
+        void (*destroy)(void *);
+        std::uint64_t epoch;
+        Retired *next;
+    };
+
+    // a reader's pinned epoch (0 = free), one per cache line
+    struct alignas(64) Slot
+    {
+        std::atomic<std::uint64_t> epoch{0};
+    };
+
+    // number of reader slots (more concurrent readers wait for one)
+    static const int slot_count = 128;
+
+    // the global epoch (starts at 2 so 0 can mean free)
+    std::atomic<std::uint64_t> global{2};
+
+    Slot slots[slot_count];
+
+    // objects retired in epoch e wait in limbo[e % 3]: collect frees
+    // through the epoch before last, so at most three epochs are ever
+    // waiting (and pinned retirers are at most one epoch apart)
+    std::atomic<Retired *> limbo[3] = {{nullptr}, {nullptr}, {nullptr}};
+
+    // the latest epoch retired into each limbo list
+    std::atomic<std::uint64_t> limbo_epoch[3] = {{0}, {0}, {0}};
+
+    std::atomic<int> retired_count{0};
+
+    // held by the thread running collect
+    std::mutex collecting;
+
+    // pushes the chain first..last onto limbo list b
+    void push(int b, Retired *first, Retired *last);
+
+    template <typename T>
+    static void destroy(void *ptr);
+
+    // deletes the retired objects from epoch max_epoch and older
+    void free_through(std::uint64_t max_epoch);
+};
+
+// pins the current epoch in a free slot
+inline EpochManager::Guard::Guard(EpochManager &manager)
+{
+    // start the search at a per-thread position to spread the slots
+    int start = std::hash<std::thread::id>()(std::this_thread::get_id()) %
+                slot_count;
+    while (true)
+    {
+        for (int i = 0; i < slot_count; ++i)
+        {
+            std::atomic<std::uint64_t> &s =
+                manager.slots[(start + i) % slot_count].epoch;
+            std::uint64_t expected = 0;
+            if (s.load(std::memory_order_relaxed) == 0 &&
+                s.compare_exchange_strong(expected, manager.global.load()))
+            {
+                slot = &s;
+                return;
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+// unpins the epoch
+inline EpochManager::Guard::~Guard()
+{
+    slot->store(0);
+}
+
+inline EpochManager::EpochManager()
+{
+}
+
+// deletes every retired object
+inline EpochManager::~EpochManager()
+{
+    free_through(UINT64_MAX);
+}
+
+// schedules ptr to be deleted
+template <typename T>
+void EpochManager::retire(T *ptr)
+{
+    std::uint64_t epoch = global.load();
+    int b = epoch % 3;
+    // tag the list before pushing, so collect never frees it on the
+    // strength of an older tag (it also checks each object's epoch)
+    limbo_epoch[b].store(epoch);
+    Retired *node = new Retired{ptr, destroy<T>, epoch, nullptr};
+    push(b, node, node);
+    ++retired_count;
+}
+
+// advances the epoch if possible and deletes old objects
+inline void EpochManager::collect()
+{
+    std::unique_lock<std::mutex> lock(collecting, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        return;
+    }
+    std::uint64_t current = global.load();
+    for (int i = 0; i < slot_count; ++i)
+    {
+        std::uint64_t pinned = slots[i].epoch.load();
+        if (pinned != 0 && pinned != current)
+        {
+            // a reader is still in the previous epoch
+            free_through(current - 2);
+            return;
+        }
+    }
+    global.store(current + 1);
+    free_through(current - 1);
+}
+
+// number of retired objects not yet deleted
+inline int EpochManager::pending() const
+{
+    return retired_count.load();
+}
+
+// pushes the chain first..last onto limbo list b
+inline void EpochManager::push(int b, Retired *first, Retired *last)
+{
+    Retired *head = limbo[b].load();
+    do
+    {
+        last->next = head;
+    } while (!limbo[b].compare_exchange_weak(head, first));
+}
+
+template <typename T>
+void EpochManager::destroy(void *ptr)
+{
+    delete static_cast<T *>(ptr);
+}
+
+// deletes the retired objects from max_epoch and older
+inline void EpochManager::free_through(std::uint64_t max_epoch)
+{
+    for (int b = 0; b < 3; ++b)
+    {
+        if (limbo_epoch[b].load() > max_epoch)
+        {
+            continue;
+        }
+        // objects pushed since the tag was read may be too new; they
+        // go back on the list
+        Retired *node = limbo[b].exchange(nullptr);
+        Retired *keep_first = nullptr;
+        Retired *keep_last = nullptr;
+        while (node != nullptr)
+        {
+            Retired *next = node->next;
+            if (node->epoch <= max_epoch)
+            {
+                node->destroy(node->ptr);
+                delete node;
+                --retired_count;
+            }
+            else
+            {
+                node->next = keep_first;
+                keep_first = node;
+                if (keep_last == nullptr)
+                {
+                    keep_last = node;
+                }
+            }
+            node = next;
+        }
+        if (keep_first != nullptr)
+        {
+            push(b, keep_first, keep_last);
+        }
+    }
+}
+
+#endif
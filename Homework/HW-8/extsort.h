@@ -0,0 +1,477 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: extsort.h
+// DATE: Fall 2021
+// DESC: External merge sort for sequences larger than memory. Input
+//       and output files use the ArraySeq snapshot format (see
+//       snapshot.h). The input is read in chunks that fit in the
+//       memory budget, and each chunk is sorted with
+//       ArraySeq::merge_sort and spilled to a temporary run file. The
+//       runs are then merged with a loser tree, using large buffered
+//       reads and writes. Each run being merged and the output get an
+//       equal share of the budget, but a share is never below 1024
+//       elements, so at most budget / (1024 * sizeof(T)) - 1 runs are
+//       merged at once; past that the oldest runs are first merged
+//       into new runs (a multi-pass merge). Memory use therefore stays
+//       within the budget, except that a budget below 3 * 1024
+//       elements is treated as that size. Run files are named by the
+//       process id and a per-sorter number, and are removed even if a
+//       sort fails. The merged output can go to a file or to a
+//       callback, e.g. to bulk load a BinSearchMap with append_sorted.
+//---------------------------------------------------------------------------
+
+#ifndef EXTSORT_H
+#define EXTSORT_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unistd.h>
+#include "arrayseq.h"
+#include "snapshot.h"
+
+template <typename T>
+class ExternalSorter
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "ExternalSorter requires a trivially copyable type");
+
+public:
+    // Creates a sorter that uses about memory_budget bytes, placing
+    // its temporary run files in temp_dir
+    ExternalSorter(std::size_t memory_budget, const std::string &temp_dir = ".");
+
+    // Removes any run files left by a failed sort
+    ~ExternalSorter();
+
+    ExternalSorter(const ExternalSorter &rhs) = delete;
+    ExternalSorter &operator=(const ExternalSorter &rhs) = delete;
+
+    // Sorts the sequence snapshot in_path into the snapshot
+    // out_path. Throws runtime_error on file errors.
+    void sort(const std::string &in_path, const std::string &out_path);
+
+    // Sorts the sequence snapshot in_path, calling visit(elem) for
+    // each element in ascending order. Throws runtime_error on file
+    // errors.
+    template <typename Visit>
+    void sort_into(const std::string &in_path, Visit visit);
+
+    // Returns the number of runs created by the last sort
+    int runs() const;
+
+    // Returns the number of merges done by the last sort (1 when all
+    // the runs could be merged at once)
+    int merges() const;
+
+private:
+    // smallest buffer, in elements, for a chunk or a merged run
+    static const int min_buffer_elems = 1024;
+
+    // most runs merged at once, to stay under the open file limit
+    static const int max_open_runs = 512;
+
+    // a sorted run being merged
+    struct Run
+    {
+        std::ifstream in;
+        T *buffer = nullptr;
+        std::uint64_t remaining = 0;
+        int next = 0;
+        int available = 0;
+    };
+
+    // approximate memory to use
+    std::size_t budget;
+
+    // directory for run files
+    std::string dir;
+
+    // distinguishes the run files of sorters in the same process
+    int instance;
+
+    // number of runs and merges from the last sort
+    int run_count = 0;
+    int merge_count = 0;
+
+    // the run files on disk are first_run to next_run - 1
+    int first_run = 0;
+    int next_run = 0;
+
+    // path of the i-th run file
+    std::string run_path(int i) const;
+
+    // phase 1: sorts memory-sized chunks of the input into run files
+    void make_runs(const std::string &in_path);
+
+    // the most runs one merge can read within the budget
+    int max_fan_in() const;
+
+    // elements per buffer when merging k runs
+    int merge_buffer_elems(int k) const;
+
+    // phase 2: merges the oldest runs into new runs until at most
+    // max_fan_in remain
+    void reduce_runs();
+
+    // merges the oldest k runs into a sequence snapshot at path
+    void merge_to_file(int k, const std::string &path);
+
+    // merges the oldest k runs, calling visit(elem) for each element,
+    // then removes them
+    template <typename Visit>
+    void merge_runs(int k, Visit visit);
+
+    // removes the run files still on disk
+    void remove_runs();
+
+    // refills the run's buffer, returns false if the run is exhausted
+    bool fill(Run &run, int buffer_elems);
+};
+
+// Creates a sorter that uses about memory_budget bytes
+template <typename T>
+ExternalSorter<T>::ExternalSorter(std::size_t memory_budget,
+                                  const std::string &temp_dir)
+    : budget(memory_budget), dir(temp_dir)
+{
+    static std::atomic<int> next_instance(0);
+    instance = next_instance++;
+}
+
+// Removes any run files left by a failed sort
+template <typename T>
+ExternalSorter<T>::~ExternalSorter()
+{
+    remove_runs();
+}
+
+// Sorts the sequence snapshot in_path into the snapshot out_path
+template <typename T>
+void ExternalSorter<T>::sort(const std::string &in_path,
+                             const std::string &out_path)
+{
+    try
+    {
+        make_runs(in_path);
+        reduce_runs();
+        merge_to_file(next_run - first_run, out_path);
+    }
+    catch (...)
+    {
+        remove_runs();
+        throw;
+    }
+}
+
+// Sorts the sequence snapshot in_path into the callback
+template <typename T>
+template <typename Visit>
+void ExternalSorter<T>::sort_into(const std::string &in_path, Visit visit)
+{
+    try
+    {
+        make_runs(in_path);
+        reduce_runs();
+        merge_runs(next_run - first_run, visit);
+    }
+    catch (...)
+    {
+        remove_runs();
+        throw;
+    }
+}
+
+// Returns the number of runs created by the last sort
+template <typename T>
+int ExternalSorter<T>::runs() const
+{
+    return run_count;
+}
+
+// Returns the number of merges done by the last sort
+template <typename T>
+int ExternalSorter<T>::merges() const
+{
+    return merge_count;
+}
+
+// path of the i-th run file
+template <typename T>
+std::string ExternalSorter<T>::run_path(int i) const
+{
+    return dir + "/extsort_" + std::to_string(getpid()) + "_" +
+           std::to_string(instance) + "_" + std::to_string(i) + ".run";
+}
+
+// phase 1: sort memory-sized chunks into run files
+template <typename T>
+void ExternalSorter<T>::make_runs(const std::string &in_path)
+{
+    std::ifstream in;
+    std::uint64_t n = read_snapshot_header(in, in_path, ARRAYSEQ_SNAPSHOT,
+                                           sizeof(T), 0);
+    // the chunk, merge_sort's scratch array, and the read buffer
+    // each take a third of the budget
+    int chunk_elems = budget / (3 * sizeof(T));
+    if (chunk_elems < min_buffer_elems)
+    {
+        chunk_elems = min_buffer_elems;
+    }
+    T *buffer = new T[chunk_elems];
+    run_count = 0;
+    merge_count = 0;
+    first_run = 0;
+    next_run = 0;
+    try
+    {
+        std::uint64_t left = n;
+        while (left > 0)
+        {
+            int len = left < (std::uint64_t)chunk_elems ? (int)left : chunk_elems;
+            if (!in.read(reinterpret_cast<char *>(buffer), sizeof(T) * len))
+            {
+                throw std::runtime_error("snapshot is truncated: " + in_path);
+            }
+            ArraySeq<T> chunk;
+            chunk.reserve(len);
+            for (int i = 0; i < len; ++i)
+            {
+                chunk.insert(buffer[i], i);
+            }
+            chunk.merge_sort();
+            // counted before saving, so a partial file is removed too
+            ++run_count;
+            chunk.save(run_path(next_run++));
+            left -= len;
+        }
+    }
+    catch (...)
+    {
+        delete[] buffer;
+        throw;
+    }
+    delete[] buffer;
+}
+
+// the most runs one merge can read within the budget
+template <typename T>
+int ExternalSorter<T>::max_fan_in() const
+{
+    // one buffer per run plus one for the output
+    std::size_t buffers = budget / (min_buffer_elems * sizeof(T));
+    if (buffers < 3)
+    {
+        return 2;
+    }
+    return buffers - 1 < (std::size_t)max_open_runs ? (int)(buffers - 1)
+                                                     : max_open_runs;
+}
+
+// elements per buffer when merging k runs
+template <typename T>
+int ExternalSorter<T>::merge_buffer_elems(int k) const
+{
+    // each run and the output get an equal share of the budget
+    int buffer_elems = budget / ((k + 1) * sizeof(T));
+    if (buffer_elems < min_buffer_elems)
+    {
+        buffer_elems = min_buffer_elems;
+    }
+    return buffer_elems;
+}
+
+// phase 2: merge the oldest runs into new runs until few enough remain
+template <typename T>
+void ExternalSorter<T>::reduce_runs()
+{
+    int fan_in = max_fan_in();
+    while (next_run - first_run > fan_in)
+    {
+        // the new run is counted first, so a partial file is removed
+        int merged = next_run++;
+        merge_to_file(fan_in, run_path(merged));
+    }
+}
+
+// merges the oldest k runs into a sequence snapshot at path
+template <typename T>
+void ExternalSorter<T>::merge_to_file(int k, const std::string &path)
+{
+    std::ofstream out;
+    // the count is written again once the merge is done
+    write_snapshot_header(out, path, ARRAYSEQ_SNAPSHOT, sizeof(T), 0, 0);
+    // the output buffer is the share merge_runs leaves for it
+    int buffer_elems = merge_buffer_elems(k);
+    T *buffer = new T[buffer_elems];
+    int used = 0;
+    std::uint64_t written = 0;
+    try
+    {
+        merge_runs(k, [&](const T &elem)
+                   {
+                       buffer[used++] = elem;
+                       if (used == buffer_elems)
+                       {
+                           out.write(reinterpret_cast<const char *>(buffer),
+                                     sizeof(T) * used);
+                           written += used;
+                           used = 0;
+                       }
+                   });
+    }
+    catch (...)
+    {
+        delete[] buffer;
+        throw;
+    }
+    out.write(reinterpret_cast<const char *>(buffer), sizeof(T) * used);
+    written += used;
+    delete[] buffer;
+    SnapshotHeader header = make_snapshot_header(ARRAYSEQ_SNAPSHOT, sizeof(T),
+                                                 0, written);
+    out.seekp(0);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.close();
+    if (!out)
+    {
+        throw std::runtime_error("external sort write failed: " + path);
+    }
+}
+
+// k-way merge of the oldest k run files with a loser tree
+template <typename T>
+template <typename Visit>
+void ExternalSorter<T>::merge_runs(int k, Visit visit)
+{
+    if (k == 0)
+    {
+        return;
+    }
+    ++merge_count;
+    int buffer_elems = merge_buffer_elems(k);
+    Run *run = new Run[k];
+    int *tree = nullptr;
+    try
+    {
+        for (int i = 0; i < k; ++i)
+        {
+            run[i].remaining = read_snapshot_header(run[i].in,
+                                                    run_path(first_run + i),
+                                                    ARRAYSEQ_SNAPSHOT, sizeof(T), 0);
+            run[i].buffer = new T[buffer_elems];
+            fill(run[i], buffer_elems);
+        }
+
+        // true if run a's current element goes before run b's (exhausted
+        // runs go last)
+        auto before = [&](int a, int b)
+        {
+            if (run[a].next == run[a].available)
+            {
+                return false;
+            }
+            if (run[b].next == run[b].available)
+            {
+                return true;
+            }
+            return run[a].buffer[run[a].next] < run[b].buffer[run[b].next];
+        };
+
+        // tree[1..k-1] hold the loser at each internal node and tree[0]
+        // the overall winner; leaf i is node k + i
+        tree = new int[k];
+        std::function<int(int)> build = [&](int node)
+        {
+            if (node >= k)
+            {
+                return node - k;
+            }
+            int left = build(2 * node);
+            int right = build(2 * node + 1);
+            if (before(left, right))
+            {
+                tree[node] = right;
+                return left;
+            }
+            tree[node] = left;
+            return right;
+        };
+        tree[0] = build(1);
+
+        while (run[tree[0]].next < run[tree[0]].available)
+        {
+            int winner = tree[0];
+            visit(run[winner].buffer[run[winner].next]);
+            if (++run[winner].next == run[winner].available)
+            {
+                fill(run[winner], buffer_elems);
+            }
+            // replay the winner's path to the root
+            for (int node = (winner + k) / 2; node >= 1; node /= 2)
+            {
+                if (before(tree[node], winner))
+                {
+                    std::swap(tree[node], winner);
+                }
+            }
+            tree[0] = winner;
+        }
+    }
+    catch (...)
+    {
+        // the run files are left for remove_runs
+        delete[] tree;
+        for (int i = 0; i < k; ++i)
+        {
+            delete[] run[i].buffer;
+        }
+        delete[] run;
+        throw;
+    }
+
+    delete[] tree;
+    for (int i = 0; i < k; ++i)
+    {
+        delete[] run[i].buffer;
+        run[i].in.close();
+        std::remove(run_path(first_run + i).c_str());
+    }
+    delete[] run;
+    first_run += k;
+}
+
+// removes the run files still on disk
+template <typename T>
+void ExternalSorter<T>::remove_runs()
+{
+    for (int i = first_run; i < next_run; ++i)
+    {
+        std::remove(run_path(i).c_str());
+    }
+    first_run = next_run;
+}
+
+// refills the run's buffer
+template <typename T>
+bool ExternalSorter<T>::fill(Run &run, int buffer_elems)
+{
+    int len = run.remaining < (std::uint64_t)buffer_elems ? (int)run.remaining
+                                                          : buffer_elems;
+    if (len > 0 && !run.in.read(reinterpret_cast<char *>(run.buffer),
+                                sizeof(T) * len))
+    {
+        throw std::runtime_error("external sort run is truncated");
+    }
+    run.remaining -= len;
+    run.next = 0;
+    run.available = len;
+    return len > 0;
+}
+
+#endif
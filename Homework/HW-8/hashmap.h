@@ -8,8 +8,11 @@
 #define HASHMAP_H
 
 #include <functional>
+#include <algorithm>
+#include <thread>
 #include "map.h"
 #include "arrayseq.h"
+#include "snapshot.h"
 
 template <typename K, typename V>
 class HashMap : public Map<K, V>
@@ -47,26 +50,103 @@ public:
     // given key is not in the collection.
     const V &operator[](const K &key) const;
 
+    // Returns a pointer to the value for a given key, or nullptr if
+    // the key is not in the collection.
+    V *find(const K &key);
+    const V *find(const K &key) const;
+
     // Extends the collection by adding the given key-value
     // pair. Assumes the key being added is not present in the
     // collection. Insert does not check if the key is present.
     void insert(const K &key, const V &value);
 
+    // Same as insert, but moves the key and value into the
+    // collection instead of copying them.
+    void insert(K &&key, V &&value);
+
+    // Extends the collection by adding the key with a value
+    // constructed in place from args. Like insert, assumes the key is
+    // not present in the collection.
+    template <typename KK, typename... Args>
+    void emplace(KK &&key, Args &&...args);
+
+    // Adds the key with a value constructed in place from args if the
+    // key is not in the collection. Returns true if it was added; if
+    // not, the key and args are left untouched.
+    template <typename KK, typename... Args>
+    bool try_emplace(KK &&key, Args &&...args);
+
+    // Adds the key-value pair if the key is not in the collection, and
+    // otherwise assigns value to the key's value. Returns true if the
+    // pair was added.
+    bool insert_or_assign(const K &key, const V &value);
+
+    // Returns the value for a given key, first adding the key with a
+    // default-constructed value if it is not in the collection.
+    V &get_or_insert_default(const K &key);
+
     // Shrinks the collection by removing the key-value pair with the
     // given key. Does not modify the collection if the collection does
     // not contain the key. Throws out_of_range if the given key is not
     // in the collection.
     void erase(const K &key);
 
+    // Same as erase, but returns false instead of throwing if the key
+    // is not in the collection, and true if the pair was removed.
+    bool try_erase(const K &key);
+
     // Returns true if the key is in the collection, and false otherwise.
     bool contains(const K &key) const;
 
-    // Returns the keys k in the collection such that k1 <= k <= k2
+    // Heterogeneous lookup: operator[] and contains for a key of a
+    // transparent type Q (see is_transparent_key in map.h), such as
+    // std::string_view for std::string keys, without building a K.
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    V &operator[](const Q &key);
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    const V &operator[](const Q &key) const;
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    bool contains(const Q &key) const;
+
+    // Returns the keys k in the collection such that k1 <= k <= k2.
+    // Large tables are scanned in parallel (see set_threads).
     ArraySeq<K> find_keys(const K &k1, const K &k2) const;
 
-    // Returns the keys in the collection in ascending sorted order
+    // Returns the keys in the collection in ascending sorted order.
+    // Large tables are collected, sorted, and merged in parallel (see
+    // set_threads).
     ArraySeq<K> sorted_keys() const;
 
+    // Sets the maximum number of threads used by find_keys and
+    // sorted_keys (0, the default, uses the hardware concurrency)
+    void set_threads(int n);
+
+    // Batched lookup of the n given keys. Sets found[i] to true if
+    // keys[i] is in the collection, and false otherwise. Keys are
+    // resolved group_size at a time: each group is hashed and its
+    // bucket heads and first chain nodes are prefetched before any
+    // of its chains are walked.
+    void contains_many(const K keys[], int n, bool found[],
+                       int group_size = 32) const;
+
+    // Batched lookup of the n given keys. Sets values[i] to the
+    // address of the value associated with keys[i], or to nullptr if
+    // keys[i] is not in the collection. Uses the same grouped
+    // prefetching as contains_many.
+    void find_many(const K keys[], int n, const V *values[],
+                   int group_size = 32) const;
+
+    // Writes the key-value pairs, in bucket order, to a binary
+    // snapshot file. Throws runtime_error if the file cannot be
+    // written.
+    void save(const std::string &path) const;
+
+    // Replaces the contents of the map with those of a snapshot file
+    // written by save. The table is sized for the snapshot up front,
+    // so no rehashing is done. Throws runtime_error if the file cannot
+    // be read or holds different key or value types.
+    void load(const std::string &path);
+
     // statistics functions for the hash table implementation
     int min_chain_length() const;
     int max_chain_length() const;
@@ -91,10 +171,26 @@ private:
     const double load_factor_threshold = 0.75;
 
     // array of linked lists
-    Node **table = new Node *[capacity];
+    Node **table = nullptr;
 
-    // the hash function
-    int hash(const K &key) const;
+    // the hash function, which is never negative (Q is K or a
+    // transparent key type)
+    template <typename Q>
+    int hash(const Q &key) const;
+
+    // returns the node with the given key, or nullptr
+    template <typename Q>
+    Node *find_node(const Q &key) const;
+
+    // returns the link (bucket head or next pointer) that points to
+    // the node with the given key, or the null link ending the key's
+    // chain, so the node can be unlinked or a new one linked there
+    template <typename Q>
+    Node **find_link(const Q &key) const;
+
+    // links the new node in at a null link from find_link, then
+    // resizes and rehashes if the table is due
+    void add_node(Node **link, Node *node);
 
     // resize and rehash the table
     void resize_and_rehash();
@@ -104,6 +200,31 @@ private:
 
     // clean up the table and reset member variables
     void make_empty();
+
+    // max threads for find_keys and sorted_keys (0 = hardware)
+    int threads = 0;
+
+    // fewest keys per thread worth starting a thread for
+    static const int min_keys_per_thread = 16384;
+
+    // number of threads to use for a full table scan
+    int scan_threads() const;
+
+    // splits the table into contiguous bucket ranges, one per thread,
+    // and appends the keys for which keep(key) is true to the
+    // thread's part. If sorted, each part is then sorted in place.
+    template <typename Keep>
+    void collect_keys(ArraySeq<K> parts[], int n, Keep keep, bool sorted) const;
+
+    // merges the sorted sequences lhs and rhs into out
+    static void merge_keys(const ArraySeq<K> &lhs, const ArraySeq<K> &rhs,
+                           ArraySeq<K> &out);
+
+    // batched lookup helper, calls visit(i, node) for each key where
+    // node is the matching node or nullptr
+    template <typename Visit>
+    void batch_lookup(const K keys[], int n, int group_size,
+                      Visit visit) const;
 };
 
 // TODO: implement the public and private HashMap functions below.
@@ -135,6 +256,7 @@ HashMap<K, V>::HashMap(const HashMap<K, V> &rhs)
 template <typename K, typename V>
 HashMap<K, V>::HashMap(HashMap<K, V> &&rhs)
 {
+    init_table();
     *this = std::move(rhs);
 }
 
@@ -155,10 +277,7 @@ HashMap<K, V> &HashMap<K, V>::operator=(const HashMap<K, V> &rhs)
             Node *temp = rhs.table[i];
             while (temp != nullptr)
             {
-                Node *newNode = new Node();
-                newNode->key = temp->key;
-                newNode->value = temp->value;
-                newNode->next = temp->next;
+                Node *newNode = new Node{temp->key, temp->value, nullptr};
 
                 if (newTable[i] == nullptr)
                 {
@@ -172,10 +291,13 @@ HashMap<K, V> &HashMap<K, V>::operator=(const HashMap<K, V> &rhs)
                 temp = temp->next;
             }
         }
+        make_empty();
+        delete[] table;
         capacity = rhs.capacity;
         count = rhs.count;
         table = newTable;
     }
+    return *this;
 }
 
 // move assignment
@@ -186,18 +308,18 @@ HashMap<K, V> &HashMap<K, V>::operator=(HashMap<K, V> &&rhs)
     {
         // do the assignment
         make_empty();
+        delete[] table;
 
         count = rhs.count;
 
         capacity = rhs.capacity;
 
-        for (int i = 0; i < capacity; ++i)
-        {
-            table[i] = std::move(rhs.table[i]);
-        }
-        rhs.make_empty();
+        table = rhs.table;
+
+        // leave rhs as an empty table
         rhs.count = 0;
         rhs.capacity = 16;
+        rhs.init_table();
     }
     return *this;
 }
@@ -207,6 +329,7 @@ template <typename K, typename V>
 HashMap<K, V>::~HashMap()
 {
     make_empty();
+    delete[] table;
     count = 0;
     capacity = 0;
 }
@@ -230,20 +353,11 @@ bool HashMap<K, V>::empty() const
 template <typename K, typename V>
 V &HashMap<K, V>::operator[](const K &key)
 {
-    if (contains(key) != true)
+    Node *temp = find_node(key);
+    if (temp == nullptr)
     {
         throw std::out_of_range("Out of range in the [] nonconst");
     }
-
-    int tempValue = hash(key);
-    int index = tempValue % capacity;
-
-    Node *temp = table[index];
-
-    while (temp != nullptr && temp->key != key) // The nullptr should never cause this loop to exit
-    {
-        temp = temp->next;
-    }
     return temp->value;
 }
 
@@ -252,19 +366,52 @@ V &HashMap<K, V>::operator[](const K &key)
 template <typename K, typename V>
 const V &HashMap<K, V>::operator[](const K &key) const
 {
-    if (contains(key) != true)
+    Node *temp = find_node(key);
+    if (temp == nullptr)
     {
         throw std::out_of_range("Out of range in the [] nonconst");
     }
+    return temp->value;
+}
 
-    int tempValue = hash(key);
-    int index = tempValue % capacity;
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V>
+V *HashMap<K, V>::find(const K &key)
+{
+    Node *temp = find_node(key);
+    return temp != nullptr ? &temp->value : nullptr;
+}
 
-    Node *temp = table[index];
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V>
+const V *HashMap<K, V>::find(const K &key) const
+{
+    Node *temp = find_node(key);
+    return temp != nullptr ? &temp->value : nullptr;
+}
 
-    while (temp != nullptr && temp->key != key) // The nullptr should never cause this loop to exit
+// Allows values associated with a key of type Q to be updated
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+V &HashMap<K, V>::operator[](const Q &key)
+{
+    Node *temp = find_node(key);
+    if (temp == nullptr)
     {
-        temp = temp->next;
+        throw std::out_of_range("Out of range in the [] nonconst");
+    }
+    return temp->value;
+}
+
+// Returns the value for a key of type Q
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+const V &HashMap<K, V>::operator[](const Q &key) const
+{
+    Node *temp = find_node(key);
+    if (temp == nullptr)
+    {
+        throw std::out_of_range("Out of range in the [] nonconst");
     }
     return temp->value;
 }
@@ -275,32 +422,89 @@ const V &HashMap<K, V>::operator[](const K &key) const
 template <typename K, typename V>
 void HashMap<K, V>::insert(const K &key, const V &value)
 {
+    emplace(key, value);
+}
 
-    if (count / capacity > load_factor_threshold)
+// Extends the collection by moving in the given key-value pair
+template <typename K, typename V>
+void HashMap<K, V>::insert(K &&key, V &&value)
+{
+    emplace(std::move(key), std::move(value));
+}
+
+// Extends the collection by adding the key with a value constructed
+// from args
+template <typename K, typename V>
+template <typename KK, typename... Args>
+void HashMap<K, V>::emplace(KK &&key, Args &&...args)
+{
+    if ((double)count / capacity > load_factor_threshold)
     {
-        //std::cout << max_chain_length() << std::endl;
         resize_and_rehash();
     }
     count++;
 
-    int tempValue = hash(key);
-    int index = tempValue % capacity;
-    //std::cout << "index is " << index << ", count is " << count << " and capacity is " << capacity << " and max chain length is " << max_chain_length() << std::endl;
-    Node *newKey = new Node();
-    newKey->key = key;
-    newKey->value = value;
+    // the key and value are built directly in the node
+    Node *newKey = new Node{K(std::forward<KK>(key)),
+                            V(std::forward<Args>(args)...), nullptr};
+    int index = hash(newKey->key) % capacity;
+    newKey->next = table[index];
+    table[index] = newKey;
+}
 
-    if (table[index] == nullptr)
+// Adds the key with a value constructed from args if the key is not
+// in the collection
+template <typename K, typename V>
+template <typename KK, typename... Args>
+bool HashMap<K, V>::try_emplace(KK &&key, Args &&...args)
+{
+    using Q = typename std::decay<KK>::type;
+    if constexpr (std::is_same<Q, K>::value || is_transparent_key<K, Q>::value)
     {
-        table[index] = newKey;
-        newKey->next = nullptr;
+        Node **link = find_link(key);
+        if (*link != nullptr)
+        {
+            return false;
+        }
+        add_node(link, new Node{K(std::forward<KK>(key)),
+                                V(std::forward<Args>(args)...), nullptr});
+        return true;
     }
     else
     {
-        Node *temp = table[index];
-        newKey->next = temp;
-        table[index] = newKey;
+        // any other type (e.g. a const char * for std::string keys)
+        // would not hash or compare like the stored keys, so build the
+        // key first
+        return try_emplace(K(std::forward<KK>(key)), std::forward<Args>(args)...);
+    }
+}
+
+// Adds the key-value pair, or assigns the value if the key is present
+template <typename K, typename V>
+bool HashMap<K, V>::insert_or_assign(const K &key, const V &value)
+{
+    Node **link = find_link(key);
+    if (*link != nullptr)
+    {
+        (*link)->value = value;
+        return false;
     }
+    add_node(link, new Node{key, value, nullptr});
+    return true;
+}
+
+// Returns the value for a given key, adding a default value if needed
+template <typename K, typename V>
+V &HashMap<K, V>::get_or_insert_default(const K &key)
+{
+    Node **link = find_link(key);
+    if (*link != nullptr)
+    {
+        return (*link)->value;
+    }
+    Node *newKey = new Node{key, V(), nullptr};
+    add_node(link, newKey);
+    return newKey->value;
 }
 
 // Shrinks the collection by removing the key-value pair with the
@@ -310,78 +514,69 @@ void HashMap<K, V>::insert(const K &key, const V &value)
 template <typename K, typename V>
 void HashMap<K, V>::erase(const K &key)
 {
-    if (contains(key) != true)
+    if (!try_erase(key))
     {
         throw std::out_of_range("Out of range in the [] nonconst");
     }
-    int tempValue = hash(key);
-    int index = tempValue % capacity;
+}
 
-    if (table[index] != nullptr)
+// Removes the key-value pair if present, returning whether it was
+template <typename K, typename V>
+bool HashMap<K, V>::try_erase(const K &key)
+{
+    // one walk of the chain finds the link to unlink from
+    Node **link = find_link(key);
+    Node *temp = *link;
+    if (temp == nullptr)
     {
-        if (table[index]->key == key)
-        {
-            Node *temp = table[index];
-            table[index] = temp->next;
-            delete temp;
-            count--;
-        }
-        else
-        {
-            Node *temp = table[index];
-            Node *prev = nullptr;
-            while (temp != nullptr)
-            {
-                if (temp->key == key)
-                {
-                    prev->next = temp->next;
-                    delete temp;
-                    count--;
-                    break;
-                }
-                prev = temp;
-                temp = temp->next;
-            }
-        }
+        return false;
     }
+    *link = temp->next;
+    delete temp;
+    count--;
+    return true;
 }
 
 // Returns true if the key is in the collection, and false otherwise.
 template <typename K, typename V>
 bool HashMap<K, V>::contains(const K &key) const
 {
-    int tempValue = hash(key);
-    int index = tempValue % capacity;
-    Node *temp = table[index];
-    while (temp != nullptr)
-    {
-        if (temp->key == key)
-        {
-            return true;
-        }
-        temp = temp->next;
-    }
-    return false;
+    return find_node(key) != nullptr;
+}
+
+// Returns true if a key of type Q is in the collection
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+bool HashMap<K, V>::contains(const Q &key) const
+{
+    return find_node(key) != nullptr;
 }
 
 // Returns the keys k in the collection such that k1 <= k <= k2
 template <typename K, typename V>
 ArraySeq<K> HashMap<K, V>::find_keys(const K &k1, const K &k2) const
 {
+    int n = scan_threads();
+    ArraySeq<K> *parts = new ArraySeq<K>[n];
+    collect_keys(parts, n, [&](const K &key)
+                 { return k1 <= key && key <= k2; },
+                 false);
+    // concatenate the per-thread parts
+    int total = 0;
+    for (int t = 0; t < n; ++t)
+    {
+        total += parts[t].size();
+    }
     ArraySeq<K> keys;
-    for (int i = 0; i < capacity; ++i)
+    keys.reserve(total);
+    for (int t = 0; t < n; ++t)
     {
-        Node *temp = table[i];
-        while (temp != nullptr)
+        for (int i = 0; i < parts[t].size(); ++i)
         {
-            if (temp->key <= k2 && temp->key >= k1)
-            {
-                K key = temp->key;
-                keys.insert(key, 0);
-            }
-            temp = temp->next;
+            keys.insert(parts[t][i], keys.size());
         }
     }
+    delete[] parts;
     return keys;
 }
 
@@ -389,19 +584,127 @@ ArraySeq<K> HashMap<K, V>::find_keys(const K &k1, const K &k2) const
 template <typename K, typename V>
 ArraySeq<K> HashMap<K, V>::sorted_keys() const
 {
-    ArraySeq<K> allKeys;
+    int n = scan_threads();
+    ArraySeq<K> *parts = new ArraySeq<K>[n];
+    collect_keys(parts, n, [](const K &)
+                 { return true; },
+                 true);
+    // merge pairs of sorted parts in parallel rounds until one is left
+    for (int width = 1; width < n; width *= 2)
+    {
+        std::thread *workers = new std::thread[n];
+        int started = 0;
+        for (int t = 0; t + width < n; t += 2 * width)
+        {
+            workers[started++] = std::thread([&, t]()
+                                             {
+                                                 ArraySeq<K> merged;
+                                                 merge_keys(parts[t], parts[t + width],
+                                                            merged);
+                                                 parts[t] = std::move(merged);
+                                                 parts[t + width] = ArraySeq<K>();
+                                             });
+        }
+        for (int i = 0; i < started; ++i)
+        {
+            workers[i].join();
+        }
+        delete[] workers;
+    }
+    ArraySeq<K> keys = std::move(parts[0]);
+    delete[] parts;
+    return keys;
+}
+
+// Sets the maximum number of threads used by find_keys and sorted_keys
+template <typename K, typename V>
+void HashMap<K, V>::set_threads(int n)
+{
+    threads = n < 0 ? 0 : n;
+}
 
+// Batched lookup of the n given keys
+template <typename K, typename V>
+void HashMap<K, V>::contains_many(const K keys[], int n, bool found[],
+                                  int group_size) const
+{
+    batch_lookup(keys, n, group_size, [&](int i, const Node *node)
+                 { found[i] = (node != nullptr); });
+}
+
+// Batched lookup of the n given keys, returning value addresses
+template <typename K, typename V>
+void HashMap<K, V>::find_many(const K keys[], int n, const V *values[],
+                              int group_size) const
+{
+    batch_lookup(keys, n, group_size, [&](int i, const Node *node)
+                 { values[i] = (node != nullptr) ? &node->value : nullptr; });
+}
+
+// Writes the key-value pairs, in bucket order, to a snapshot file
+template <typename K, typename V>
+void HashMap<K, V>::save(const std::string &path) const
+{
+    SnapshotWriter<K, V> out(path, HASHMAP_SNAPSHOT, count);
     for (int i = 0; i < capacity; ++i)
     {
-        Node *temp = table[i];
-        while (temp != nullptr)
+        for (Node *temp = table[i]; temp != nullptr; temp = temp->next)
+        {
+            out.write(temp->key, temp->value);
+        }
+    }
+    out.flush();
+}
+
+// Replaces the contents of the map with those of a snapshot file
+template <typename K, typename V>
+void HashMap<K, V>::load(const std::string &path)
+{
+    SnapshotReader<K, V> in(path, HASHMAP_SNAPSHOT);
+    int n = snapshot_count_as_int(in.count(), path);
+    // smallest table that insert would not resize
+    int new_capacity = 16;
+    while (new_capacity <= n)
+    {
+        new_capacity *= 2;
+    }
+    // build the new table on the side, so a failed read leaves the
+    // map unchanged
+    Node **new_table = new Node *[new_capacity];
+    for (int i = 0; i < new_capacity; ++i)
+    {
+        new_table[i] = nullptr;
+    }
+    try
+    {
+        K key;
+        V value;
+        for (int i = 0; i < n; ++i)
         {
-            allKeys.insert(temp->key, allKeys.size());
-            temp = temp->next;
+            in.read(key, value);
+            int index = hash(key) % new_capacity;
+            new_table[index] = new Node{key, value, new_table[index]};
         }
     }
-    allKeys.sort();
-    return allKeys;
+    catch (...)
+    {
+        for (int i = 0; i < new_capacity; ++i)
+        {
+            while (new_table[i] != nullptr)
+            {
+                Node *next = new_table[i]->next;
+                delete new_table[i];
+                new_table[i] = next;
+            }
+        }
+        delete[] new_table;
+        throw;
+    }
+    make_empty();
+    delete[] table;
+    table = new_table;
+    capacity = new_capacity;
+    count = n;
 }
 
 // statistics functions for the hash table implementation
@@ -465,10 +768,54 @@ double HashMap<K, V>::avg_chain_length() const
 // Private
 // the hash function
 template <typename K, typename V>
-int HashMap<K, V>::hash(const K &key) const
+template <typename Q>
+int HashMap<K, V>::hash(const Q &key) const
+{
+    // keep the low 31 bits, since a negative hash would give a
+    // negative table index
+    std::hash<Q> hashFunction;
+    return (int)(hashFunction(key) & 0x7fffffff);
+}
+
+// returns the node with the given key, or nullptr
+template <typename K, typename V>
+template <typename Q>
+typename HashMap<K, V>::Node *HashMap<K, V>::find_node(const Q &key) const
+{
+    Node *temp = table[hash(key) % capacity];
+    while (temp != nullptr && temp->key != key)
+    {
+        temp = temp->next;
+    }
+    return temp;
+}
+
+// returns the link to the node with the given key, or the null link
+// ending its chain
+template <typename K, typename V>
+template <typename Q>
+typename HashMap<K, V>::Node **HashMap<K, V>::find_link(const Q &key) const
 {
-    std::hash<K> hashFunction;
-    return hashFunction(key);
+    Node **link = &table[hash(key) % capacity];
+    while (*link != nullptr && (*link)->key != key)
+    {
+        link = &(*link)->next;
+    }
+    return link;
+}
+
+// links the new node in at a null link, resizing if due
+template <typename K, typename V>
+void HashMap<K, V>::add_node(Node **link, Node *node)
+{
+    // same threshold test as emplace, made before counting the node
+    bool resize = (double)count / capacity > load_factor_threshold;
+    *link = node;
+    count++;
+    if (resize)
+    {
+        resize_and_rehash();
+    }
 }
 
 // resize and rehash the table
@@ -482,32 +829,18 @@ void HashMap<K, V>::resize_and_rehash()
     }
     for (int i = 0; i < capacity; ++i)
     {
-        if (table[i] != nullptr)
+        Node *curr = table[i];
+        while (curr != nullptr)
         {
-            Node *curr = table[i];
-            while (curr != nullptr)
-            {
-                Node *newNode = curr;
-                newNode->key = curr->key;
-                newNode->value = curr->value;
-                newNode->next = nullptr;
-
-                K newKey = curr->key;
-                int index = (hash(newKey)) % (capacity * 2);
-
-                if (newTable[index] == nullptr)
-                {
-                    newTable[index] = newNode;
-                }
-                else
-                {
-                    newNode->next = newTable[index];
-                    newTable[index]->next = newNode;
-                }
-                curr = curr->next;
-            }
+            // relink the existing node at the front of its new chain
+            Node *next = curr->next;
+            int index = (hash(curr->key)) % (capacity * 2);
+            curr->next = newTable[index];
+            newTable[index] = curr;
+            curr = next;
         }
     }
+    delete[] table;
     capacity = capacity * 2;
     table = newTable;
 }
@@ -528,7 +861,7 @@ void HashMap<K, V>::init_table()
 template <typename K, typename V>
 void HashMap<K, V>::make_empty()
 {
-    if (*table != nullptr)
+    if (table != nullptr)
     {
         for (int i = 0; i < capacity; ++i)
         {
@@ -548,4 +881,135 @@ void HashMap<K, V>::make_empty()
     count = 0;
 }
 
+// number of threads to use for a full table scan
+template <typename K, typename V>
+int HashMap<K, V>::scan_threads() const
+{
+    int n = threads;
+    if (n == 0)
+    {
+        n = std::thread::hardware_concurrency();
+    }
+    int useful = count / min_keys_per_thread;
+    if (n > useful)
+    {
+        n = useful;
+    }
+    return n < 1 ? 1 : n;
+}
+
+// collects (and optionally sorts) the kept keys of each bucket range
+template <typename K, typename V>
+template <typename Keep>
+void HashMap<K, V>::collect_keys(ArraySeq<K> parts[], int n, Keep keep,
+                                 bool sorted) const
+{
+    auto scan = [&](int t)
+    {
+        int first = (int)((long long)capacity * t / n);
+        int last = (int)((long long)capacity * (t + 1) / n);
+        for (int i = first; i < last; ++i)
+        {
+            for (Node *temp = table[i]; temp != nullptr; temp = temp->next)
+            {
+                if (keep(temp->key))
+                {
+                    parts[t].insert(temp->key, parts[t].size());
+                }
+            }
+        }
+        if (sorted)
+        {
+            parts[t].merge_sort();
+        }
+    };
+    // the calling thread scans the first range itself
+    std::thread *workers = new std::thread[n];
+    for (int t = 1; t < n; ++t)
+    {
+        workers[t] = std::thread(scan, t);
+    }
+    scan(0);
+    for (int t = 1; t < n; ++t)
+    {
+        workers[t].join();
+    }
+    delete[] workers;
+}
+
+// merges the sorted sequences lhs and rhs into out
+template <typename K, typename V>
+void HashMap<K, V>::merge_keys(const ArraySeq<K> &lhs, const ArraySeq<K> &rhs,
+                               ArraySeq<K> &out)
+{
+    out.reserve(lhs.size() + rhs.size());
+    int i = 0;
+    int j = 0;
+    while (i < lhs.size() && j < rhs.size())
+    {
+        if (rhs[j] < lhs[i])
+        {
+            out.insert(rhs[j++], out.size());
+        }
+        else
+        {
+            out.insert(lhs[i++], out.size());
+        }
+    }
+    while (i < lhs.size())
+    {
+        out.insert(lhs[i++], out.size());
+    }
+    while (j < rhs.size())
+    {
+        out.insert(rhs[j++], out.size());
+    }
+}
+
+// batched lookup helper
+template <typename K, typename V>
+template <typename Visit>
+void HashMap<K, V>::batch_lookup(const K keys[], int n, int group_size,
+                                 Visit visit) const
+{
+    if (group_size < 1)
+    {
+        group_size = 1;
+    }
+    int *index = new int[group_size];
+    for (int start = 0; start < n; start += group_size)
+    {
+        int end = std::min(start + group_size, n);
+
+        // stage 1: hash the group and prefetch its bucket heads
+        for (int i = start; i < end; ++i)
+        {
+            index[i - start] = hash(keys[i]) % capacity;
+            __builtin_prefetch(&table[index[i - start]]);
+        }
+
+        // stage 2: prefetch the first node of each chain
+        for (int i = start; i < end; ++i)
+        {
+            Node *head = table[index[i - start]];
+            if (head != nullptr)
+            {
+                __builtin_prefetch(head);
+            }
+        }
+
+        // stage 3: walk the chains, which are now (mostly) in cache
+        for (int i = start; i < end; ++i)
+        {
+            Node *temp = table[index[i - start]];
+            while (temp != nullptr && temp->key != keys[i])
+            {
+                temp = temp->next;
+            }
+            visit(i, temp);
+        }
+    }
+    delete[] index;
+}
+
 #endif
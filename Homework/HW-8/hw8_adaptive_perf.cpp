@@ -0,0 +1,168 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_adaptive_perf.cpp
+// DATE: Fall 2021
+// DESC: Compares AdaptiveMap with the static choices it switches
+//       between (ArrayMap, HashMap, and AVLMap) for map sizes from 1
+//       to 1M. For each size every map is loaded with shuffled keys,
+//       then runs a lookup-only phase and a phase where 1% of the
+//       operations are find_keys over 16 keys. ArrayMap is skipped
+//       (nan) above array_limit keys, where its linear scans take too
+//       long. To run from the command line use:
+//          ./hw8_adaptive_perf
+//       To save this data to a file, run the command:
+//          ./hw8_adaptive_perf > adaptive_output.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "map.h"
+#include "arraymap.h"
+#include "hashmap.h"
+#include "avlmap.h"
+#include "adaptivemap.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// test parameters
+const int sizes[] = {1, 2, 4, 8, 16, 24, 32, 48, 64, 128, 1024, 10000, 100000,
+                     1000000};
+const int lookups = 500000;
+const int mixed_ops = 20000;
+const int range_width = 16;
+const int array_limit = 4096;
+
+// nanoseconds per operation of each phase
+struct Result
+{
+    double insert;
+    double lookup;
+    double mixed;
+};
+
+// loads the keys and runs both phases
+Result run(Map<int, int> &m, const vector<int> &keys);
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    const char *names[] = {"array map", "hash map", "avl map", "adaptive map"};
+    const char *phases[] = {"insert", "lookup", "1% find_keys"};
+
+    // output data header
+    cout << "# Nanoseconds per operation" << endl;
+    cout << "# Column 1 = map size" << endl;
+    int column = 2;
+    for (const char *phase : phases)
+    {
+        for (const char *name : names)
+        {
+            cout << "# Column " << column++ << " = " << name << " " << phase << endl;
+        }
+    }
+
+    for (int n : sizes)
+    {
+        vector<int> keys(n);
+        for (int i = 0; i < n; ++i)
+        {
+            keys[i] = 2 * i;
+        }
+        shuffle(keys.begin(), keys.end(), mt19937(1));
+
+        Result results[4];
+        if (n <= array_limit)
+        {
+            ArrayMap<int, int> m;
+            results[0] = run(m, keys);
+        }
+        else
+        {
+            results[0] = {NAN, NAN, NAN};
+        }
+        {
+            HashMap<int, int> m;
+            results[1] = run(m, keys);
+        }
+        {
+            AVLMap<int, int> m;
+            results[2] = run(m, keys);
+        }
+        {
+            AdaptiveMap<int, int> m;
+            results[3] = run(m, keys);
+        }
+
+        cout << n;
+        for (const Result &r : results)
+        {
+            cout << " " << r.insert;
+        }
+        for (const Result &r : results)
+        {
+            cout << " " << r.lookup;
+        }
+        for (const Result &r : results)
+        {
+            cout << " " << r.mixed;
+        }
+        cout << endl;
+    }
+}
+
+Result run(Map<int, int> &m, const vector<int> &keys)
+{
+    int n = keys.size();
+    Result result;
+
+    auto t0 = high_resolution_clock::now();
+    for (int key : keys)
+    {
+        m.insert(key, key);
+    }
+    auto t1 = high_resolution_clock::now();
+    result.insert = duration_cast<nanoseconds>(t1 - t0).count() / double(n);
+
+    // lookups of present (even) and absent (odd) keys
+    mt19937 gen(2);
+    uniform_int_distribution<int> dist(0, 2 * n - 1);
+    long found = 0;
+    t0 = high_resolution_clock::now();
+    for (int i = 0; i < lookups; ++i)
+    {
+        found += m.contains(dist(gen));
+    }
+    t1 = high_resolution_clock::now();
+    result.lookup = duration_cast<nanoseconds>(t1 - t0).count() / double(lookups);
+
+    t0 = high_resolution_clock::now();
+    for (int i = 0; i < mixed_ops; ++i)
+    {
+        int key = dist(gen);
+        if (i % 100 == 0)
+        {
+            found += m.find_keys(key, key + 2 * range_width - 1).size();
+        }
+        else
+        {
+            found += m.contains(key);
+        }
+    }
+    t1 = high_resolution_clock::now();
+    result.mixed = duration_cast<nanoseconds>(t1 - t0).count() / double(mixed_ops);
+
+    if (found < 0)
+    {
+        cerr << "impossible" << endl;
+    }
+    return result;
+}
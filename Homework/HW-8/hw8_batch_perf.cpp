@@ -0,0 +1,101 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_batch_perf.cpp
+// DATE: Fall 2021
+// DESC: Performance test driver for the HashMap batched lookups. Loads
+//       a hash map much larger than the last level cache and times
+//       random lookups using contains_many for increasing group
+//       sizes. To run from the command line use:
+//          ./hw8_batch_perf
+//       To save this data to a file, run the command:
+//          ./hw8_batch_perf > batch_output.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include "hashmap.h"
+
+using namespace std;
+using namespace std::chrono;
+
+double timed_contains_many(const HashMap<int, int> &m, const int keys[],
+                           int n, bool found[], int group_size);
+
+// test parameters (n keys in the map, about 1 GB with the table)
+const int n = 1 << 25;
+const int lookups = 1 << 22;
+const int group_sizes[] = {1, 8, 32, 128};
+const int runs = 3;
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    // output data header
+    cout << "# All times in milliseconds (msec)" << endl;
+    cout << "# Map size = " << n << ", lookups = " << lookups << endl;
+    cout << "# Column 1 = group size" << endl;
+    cout << "# Column 2 = contains_many time" << endl;
+    cout << "# Column 3 = million lookups per second" << endl;
+    cout << "# Column 4 = contains (one at a time) time" << endl;
+
+    // load the map with the even keys, so half of the lookups miss
+    HashMap<int, int> m;
+    for (int i = 0; i < n; ++i)
+    {
+        m.insert(2 * i, i);
+    }
+
+    // random lookup keys over the full key range
+    int *keys = new int[lookups];
+    bool *found = new bool[lookups];
+    mt19937 gen(42);
+    uniform_int_distribution<int> dist(0, 2 * n - 1);
+    for (int i = 0; i < lookups; ++i)
+    {
+        keys[i] = dist(gen);
+    }
+
+    // baseline: one contains call per key
+    double base = 0;
+    for (int r = 0; r < runs; ++r)
+    {
+        auto t0 = high_resolution_clock::now();
+        for (int i = 0; i < lookups; ++i)
+        {
+            found[i] = m.contains(keys[i]);
+        }
+        auto t1 = high_resolution_clock::now();
+        base += duration_cast<microseconds>(t1 - t0).count();
+    }
+    base = (base / 1000) / runs;
+
+    for (int group_size : group_sizes)
+    {
+        double t = timed_contains_many(m, keys, lookups, found, group_size);
+        cout << group_size << " " << t << " "
+             << (lookups / 1000.0) / t << " " << base << endl;
+    }
+
+    delete[] keys;
+    delete[] found;
+}
+
+double timed_contains_many(const HashMap<int, int> &m, const int keys[],
+                           int n, bool found[], int group_size)
+{
+    double total = 0;
+    for (int r = 0; r < runs; ++r)
+    {
+        auto t0 = high_resolution_clock::now();
+        m.contains_many(keys, n, found, group_size);
+        auto t1 = high_resolution_clock::now();
+        total += duration_cast<microseconds>(t1 - t0).count();
+    }
+    return (total / 1000) / runs;
+}
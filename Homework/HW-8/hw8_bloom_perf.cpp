@@ -0,0 +1,125 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_bloom_perf.cpp
+// DATE: Fall 2021
+// DESC: Performance test driver for the Bloom filter front end. Times
+//       lookups of keys that are not in the map (the same shuffled
+//       data as hw8_perf) for the BST, AVL, and hash maps with and
+//       without a BloomMap wrapper. To run from the command line use:
+//          ./hw8_bloom_perf
+//       To save this data to a file, run the command:
+//          ./hw8_bloom_perf > bloom_output.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include "util.h"
+#include "arrayseq.h"
+#include "map.h"
+#include "hashmap.h"
+#include "bstmap.h"
+#include "avlmap.h"
+#include "bloommap.h"
+
+using namespace std;
+using namespace std::chrono;
+
+double timed_misses(const Map<int, int> &m, const ArraySeq<int> &keys);
+
+// test parameters
+const int start = 15000;
+const int step = 15000;
+const int stop = 150000;
+const int bits_per_key = 10;
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    // output data header
+    cout << "# All times in milliseconds (msec) for n missing keys" << endl;
+    cout << "# Column 1 = input data size" << endl;
+    cout << "# Column 2 = bst map misses" << endl;
+    cout << "# Column 3 = bloom bst map misses" << endl;
+    cout << "# Column 4 = avl map misses" << endl;
+    cout << "# Column 5 = bloom avl map misses" << endl;
+    cout << "# Column 6 = hash map misses" << endl;
+    cout << "# Column 7 = bloom hash map misses" << endl;
+    cout << "# Column 8 = false positive rate (percent)" << endl;
+    cout << "# Column 9 = bloom avl map misses per second (millions)" << endl;
+
+    // generate shuffled data (even keys) and misses (odd keys)
+    ArraySeq<int> keys, misses;
+    for (int i = 2; i <= stop * 2; i += 2)
+    {
+        keys.insert(i, keys.size());
+        misses.insert(i + 1, misses.size());
+    }
+    faro_shuffle(keys, 7);
+    faro_shuffle(misses, 7);
+
+    // generate the timing data
+    for (int n = start; n <= stop; n += step)
+    {
+        BSTMap<int, int> m1;
+        BloomMap<int, int, BSTMap<int, int>> m2(bits_per_key);
+        AVLMap<int, int> m3;
+        BloomMap<int, int, AVLMap<int, int>> m4(bits_per_key);
+        HashMap<int, int> m5;
+        BloomMap<int, int, HashMap<int, int>> m6(bits_per_key);
+        ArraySeq<int> probe;
+        for (int i = 0; i < n; ++i)
+        {
+            m1.insert(keys[i], keys[i]);
+            m2.insert(keys[i], keys[i]);
+            m3.insert(keys[i], keys[i]);
+            m4.insert(keys[i], keys[i]);
+            m5.insert(keys[i], keys[i]);
+            m6.insert(keys[i], keys[i]);
+            probe.insert(misses[i], probe.size());
+        }
+
+        double c2 = timed_misses(m1, probe);
+        double c3 = timed_misses(m2, probe);
+        double c4 = timed_misses(m3, probe);
+        double c5 = timed_misses(m4, probe);
+        double c6 = timed_misses(m5, probe);
+        double c7 = timed_misses(m6, probe);
+
+        int false_positives = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            if (m4.filter().might_contain(probe[i]))
+            {
+                ++false_positives;
+            }
+        }
+        double c8 = (100.0 * false_positives) / n;
+        double c9 = (n / 1000.0) / c5;
+
+        cout << n << " " << c2 << " " << c3 << " " << c4 << " " << c5
+             << " " << c6 << " " << c7 << " " << c8 << " " << c9 << endl;
+    }
+}
+
+double timed_misses(const Map<int, int> &m, const ArraySeq<int> &keys)
+{
+    int hits = 0;
+    auto t0 = high_resolution_clock::now();
+    for (int i = 0; i < keys.size(); ++i)
+    {
+        if (m.contains(keys[i]))
+        {
+            ++hits;
+        }
+    }
+    auto t1 = high_resolution_clock::now();
+    if (hits != 0)
+    {
+        cerr << "unexpected hits: " << hits << endl;
+    }
+    return duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+}
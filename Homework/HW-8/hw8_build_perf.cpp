@@ -0,0 +1,81 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_build_perf.cpp
+// DATE: Fall 2021
+// DESC: Performance test driver for building AVLMap and BSTMap from
+//       sorted keys with build_from_sorted for increasing thread
+//       counts, compared to inserting the same keys one at a time
+//       into an AVLMap (a BSTMap built by sorted insert degenerates
+//       into a list, so it is not timed). To run from the command line
+//       use:
+//          ./hw8_build_perf
+//       To save this data to a file, run the command:
+//          ./hw8_build_perf > build_output.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include "avlmap.h"
+#include "bstmap.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// test parameters
+const int sizes[] = {1000000, 4000000};
+const int thread_counts[] = {1, 2, 4, 8};
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    // output data header
+    cout << "# All times in milliseconds (msec)" << endl;
+    cout << "# Column 1 = input data size" << endl;
+    cout << "# Column 2 = threads" << endl;
+    cout << "# Column 3 = avl map build_from_sorted" << endl;
+    cout << "# Column 4 = bst map build_from_sorted" << endl;
+    cout << "# Column 5 = avl map repeated insert (same for each row)" << endl;
+
+    for (int n : sizes)
+    {
+        int *keys = new int[n];
+        int *values = new int[n];
+        for (int i = 0; i < n; ++i)
+        {
+            keys[i] = 3 * i;
+            values[i] = i;
+        }
+
+        AVLMap<int, int> inserted;
+        auto t0 = high_resolution_clock::now();
+        for (int i = 0; i < n; ++i)
+        {
+            inserted.insert(keys[i], values[i]);
+        }
+        auto t1 = high_resolution_clock::now();
+        double insert_time = duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+
+        for (int threads : thread_counts)
+        {
+            AVLMap<int, int> avl;
+            BSTMap<int, int> bst;
+            avl.set_threads(threads);
+            bst.set_threads(threads);
+            auto t2 = high_resolution_clock::now();
+            avl.build_from_sorted(keys, values, n);
+            auto t3 = high_resolution_clock::now();
+            bst.build_from_sorted(keys, values, n);
+            auto t4 = high_resolution_clock::now();
+            cout << n << " " << threads
+                 << " " << duration_cast<microseconds>(t3 - t2).count() / 1000.0
+                 << " " << duration_cast<microseconds>(t4 - t3).count() / 1000.0
+                 << " " << insert_time << endl;
+        }
+        delete[] keys;
+        delete[] values;
+    }
+}
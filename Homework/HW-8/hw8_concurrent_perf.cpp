@@ -0,0 +1,145 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_concurrent_perf.cpp
+// DATE: Fall 2021
+// DESC: Reader scaling test for ConcurrentAVLMap. One writer thread
+//       keeps inserting and erasing keys while 1 to 8 reader threads
+//       look up random keys for a fixed time. The same workload is run
+//       against an AVLMap guarded by a mutex that readers and the
+//       writer share. To run from the command line use:
+//          ./hw8_concurrent_perf
+//       To save this data to a file, run the command:
+//          ./hw8_concurrent_perf > concurrent_output.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include "avlmap.h"
+#include "concurrent_avlmap.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// test parameters
+const int keys = 1000000;
+const int reader_counts[] = {1, 2, 4, 8};
+const int run_msec = 1000;
+
+// runs the writer and readers for run_msec, returning the read and
+// write operations per second
+template <typename Read, typename Write>
+void run(int readers, Read read, Write write, double &reads, double &writes);
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    // output data header
+    cout << "# Operations per second (thousands), " << keys << " keys" << endl;
+    cout << "# Column 1 = reader threads" << endl;
+    cout << "# Column 2 = concurrent avl map reads" << endl;
+    cout << "# Column 3 = concurrent avl map writes" << endl;
+    cout << "# Column 4 = locked avl map reads" << endl;
+    cout << "# Column 5 = locked avl map writes" << endl;
+
+    ConcurrentAVLMap<int, int> concurrent;
+    AVLMap<int, int> locked;
+    mutex lock;
+    for (int i = 0; i < keys; ++i)
+    {
+        concurrent.insert(2 * i, i);
+        locked.insert(2 * i, i);
+    }
+
+    for (int readers : reader_counts)
+    {
+        double c_reads, c_writes, l_reads, l_writes;
+        // the writer inserts and then erases a run of odd keys
+        run(
+            readers,
+            [&](int key)
+            { return concurrent.contains(key); },
+            [&](int key, bool add)
+            {
+                if (add)
+                    concurrent.insert(key, key);
+                else
+                    concurrent.erase(key);
+            },
+            c_reads, c_writes);
+        run(
+            readers,
+            [&](int key)
+            {
+                lock_guard<mutex> guard(lock);
+                return locked.contains(key);
+            },
+            [&](int key, bool add)
+            {
+                lock_guard<mutex> guard(lock);
+                if (add)
+                    locked.insert(key, key);
+                else
+                    locked.erase(key);
+            },
+            l_reads, l_writes);
+        cout << readers << " " << c_reads / 1000 << " " << c_writes / 1000
+             << " " << l_reads / 1000 << " " << l_writes / 1000 << endl;
+    }
+}
+
+template <typename Read, typename Write>
+void run(int readers, Read read, Write write, double &reads, double &writes)
+{
+    atomic<bool> done(false);
+    atomic<long> read_ops(0);
+    long write_ops = 0;
+    thread *workers = new thread[readers];
+    for (int r = 0; r < readers; ++r)
+    {
+        workers[r] = thread([&, r]()
+                            {
+                                mt19937 gen(r);
+                                uniform_int_distribution<int> dist(0, 2 * keys);
+                                long ops = 0;
+                                long found = 0;
+                                while (!done.load(memory_order_relaxed))
+                                {
+                                    found += read(dist(gen));
+                                    ++ops;
+                                }
+                                read_ops += ops + (found < 0);
+                            });
+    }
+    auto t0 = high_resolution_clock::now();
+    auto stop = t0 + milliseconds(run_msec);
+    const int batch = 1000;
+    while (high_resolution_clock::now() < stop)
+    {
+        for (int i = 0; i < batch; ++i)
+        {
+            write(2 * i + 1, true);
+        }
+        for (int i = 0; i < batch; ++i)
+        {
+            write(2 * i + 1, false);
+        }
+        write_ops += 2 * batch;
+    }
+    done.store(true);
+    for (int r = 0; r < readers; ++r)
+    {
+        workers[r].join();
+    }
+    delete[] workers;
+    double secs = duration_cast<microseconds>(high_resolution_clock::now() - t0).count() / 1e6;
+    reads = read_ops.load() / secs;
+    writes = write_ops / secs;
+}
@@ -0,0 +1,240 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_emplace_perf.cpp
+// DATE: Fall 2021
+// DESC: Performance test driver for move-aware inserts and
+//       heterogeneous lookup. HashMap, AVLMap, and BinSearchMap are
+//       loaded with 40-byte std::string keys (in ascending order) and
+//       256-byte std::string values by copying insert, moving insert,
+//       and emplace, counting heap allocations with a replaced global
+//       operator new. Each map is then probed with random present
+//       keys held as std::string_views, either building a std::string
+//       for each lookup or passing the view directly. To run from the
+//       command line use:
+//          ./hw8_emplace_perf
+//       To save this data to a file, run the command:
+//          ./hw8_emplace_perf > emplace_output.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include "hashmap.h"
+#include "avlmap.h"
+#include "binsearchmap.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// heap allocations so far
+static long allocations = 0;
+
+void *operator new(size_t bytes)
+{
+    ++allocations;
+    void *p = malloc(bytes ? bytes : 1);
+    if (p == nullptr)
+    {
+        throw bad_alloc();
+    }
+    return p;
+}
+
+void *operator new[](size_t bytes)
+{
+    return operator new(bytes);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    free(p);
+}
+
+// how an insert pass hands its keys and values to the map
+enum InsertKind
+{
+    COPY_INSERT,
+    MOVE_INSERT,
+    EMPLACE_INSERT
+};
+
+// the rate and allocation count of a timed pass
+struct Result
+{
+    double rate;
+    double allocs;
+};
+
+template <typename M>
+Result insert_pass(M &map, int n, InsertKind kind);
+
+template <typename M>
+Result lookup_pass(const M &map, int n, bool use_view);
+
+template <typename M>
+void run(int id, int n);
+
+// test parameters
+const int sizes[] = {1000, 10000, 100000};
+const int value_bytes = 256;
+const int lookups = 200000;
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    // output data header
+    cout << "# All rates in million operations per second" << endl;
+    cout << "# Column 1 = map (1 = hash map, 2 = AVL map, 3 = binsearch map)" << endl;
+    cout << "# Column 2 = input data size" << endl;
+    cout << "# Column 3 = copying insert rate" << endl;
+    cout << "# Column 4 = copying insert, allocations per insert" << endl;
+    cout << "# Column 5 = moving insert rate" << endl;
+    cout << "# Column 6 = moving insert, allocations per insert" << endl;
+    cout << "# Column 7 = emplace rate" << endl;
+    cout << "# Column 8 = emplace, allocations per insert" << endl;
+    cout << "# Column 9 = std::string lookup rate" << endl;
+    cout << "# Column 10 = std::string lookup, allocations per lookup" << endl;
+    cout << "# Column 11 = string_view lookup rate" << endl;
+    cout << "# Column 12 = string_view lookup, allocations per lookup" << endl;
+
+    for (int n : sizes)
+    {
+        run<HashMap<string, string>>(1, n);
+        run<AVLMap<string, string>>(2, n);
+        run<BinSearchMap<string, string>>(3, n);
+    }
+}
+
+// the i-th key (40 bytes, so never stored inline, and ascending in i)
+string make_key(int i)
+{
+    char buf[48];
+    snprintf(buf, sizeof(buf), "user:%010d:0123456789abcdefghijklmn", i);
+    return string(buf);
+}
+
+// times each kind of insert into a fresh map, then lookups into the
+// last one
+template <typename M>
+void run(int id, int n)
+{
+    cout << id << " " << n;
+    M map;
+    for (InsertKind kind : {COPY_INSERT, MOVE_INSERT, EMPLACE_INSERT})
+    {
+        map = M();
+        Result r = insert_pass(map, n, kind);
+        cout << " " << r.rate << " " << r.allocs;
+    }
+    for (bool use_view : {false, true})
+    {
+        Result r = lookup_pass(map, n, use_view);
+        cout << " " << r.rate << " " << r.allocs;
+    }
+    cout << endl;
+}
+
+// inserts the n keys in ascending order, handing them to the map as
+// the given kind of insert
+template <typename M>
+Result insert_pass(M &map, int n, InsertKind kind)
+{
+    // build the keys and values outside the timed loop
+    string *keys = new string[n];
+    string *values = new string[n];
+    for (int i = 0; i < n; ++i)
+    {
+        keys[i] = make_key(i);
+        values[i] = string(value_bytes, 'a' + i % 26);
+    }
+    long allocs0 = allocations;
+    auto t0 = high_resolution_clock::now();
+    for (int i = 0; i < n; ++i)
+    {
+        if (kind == COPY_INSERT)
+        {
+            map.insert(keys[i], values[i]);
+        }
+        else if (kind == MOVE_INSERT)
+        {
+            map.insert(std::move(keys[i]), std::move(values[i]));
+        }
+        else
+        {
+            map.emplace(std::move(keys[i]), value_bytes, 'a' + i % 26);
+        }
+    }
+    auto t1 = high_resolution_clock::now();
+    long allocs = allocations - allocs0;
+    delete[] keys;
+    delete[] values;
+    double secs = duration_cast<microseconds>(t1 - t0).count() / 1000000.0;
+    return {n / secs / 1000000.0, (double)allocs / n};
+}
+
+// looks up random present keys held as string_views, converting each
+// to a std::string first unless use_view is set
+template <typename M>
+Result lookup_pass(const M &map, int n, bool use_view)
+{
+    string *keys = new string[n];
+    for (int i = 0; i < n; ++i)
+    {
+        keys[i] = make_key(i);
+    }
+    mt19937 gen(42);
+    uniform_int_distribution<int> dist(0, n - 1);
+    string_view *probes = new string_view[lookups];
+    for (int i = 0; i < lookups; ++i)
+    {
+        probes[i] = keys[dist(gen)];
+    }
+    long found = 0;
+    long allocs0 = allocations;
+    auto t0 = high_resolution_clock::now();
+    for (int i = 0; i < lookups; ++i)
+    {
+        if (use_view)
+        {
+            found += map.contains(probes[i]);
+        }
+        else
+        {
+            found += map.contains(string(probes[i]));
+        }
+    }
+    auto t1 = high_resolution_clock::now();
+    long allocs = allocations - allocs0;
+    delete[] probes;
+    delete[] keys;
+    if (found != lookups)
+    {
+        cerr << "missing keys" << endl;
+    }
+    double secs = duration_cast<microseconds>(t1 - t0).count() / 1000000.0;
+    return {lookups / secs / 1000000.0, (double)allocs / lookups};
+}
@@ -0,0 +1,67 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_export_perf.cpp
+// DATE: Fall 2021
+// DESC: Performance test driver for the parallel HashMap export path
+//       (sorted_keys and find_keys) for increasing thread counts. The
+//       find_keys range covers half the keys. To run from the command
+//       line use:
+//          ./hw8_export_perf
+//       To save this data to a file, run the command:
+//          ./hw8_export_perf > export_output.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include "hashmap.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// test parameters
+const int sizes[] = {1000000, 4000000};
+const int thread_counts[] = {1, 2, 4, 8};
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    // output data header
+    cout << "# All times in milliseconds (msec)" << endl;
+    cout << "# Column 1 = input data size" << endl;
+    cout << "# Column 2 = threads" << endl;
+    cout << "# Column 3 = sorted_keys" << endl;
+    cout << "# Column 4 = find_keys" << endl;
+
+    for (int n : sizes)
+    {
+        HashMap<int, int> m;
+        mt19937 gen(42);
+        uniform_int_distribution<int> dist(0, 2000000000);
+        while (m.size() < n)
+        {
+            int key = dist(gen);
+            if (!m.contains(key))
+            {
+                m.insert(key, key);
+            }
+        }
+        for (int threads : thread_counts)
+        {
+            m.set_threads(threads);
+            auto t0 = high_resolution_clock::now();
+            ArraySeq<int> sorted = m.sorted_keys();
+            auto t1 = high_resolution_clock::now();
+            ArraySeq<int> found = m.find_keys(0, 1000000000);
+            auto t2 = high_resolution_clock::now();
+            cout << n << " " << threads
+                 << " " << duration_cast<microseconds>(t1 - t0).count() / 1000.0
+                 << " " << duration_cast<microseconds>(t2 - t1).count() / 1000.0
+                 << endl;
+        }
+    }
+}
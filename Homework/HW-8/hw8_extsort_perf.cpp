@@ -0,0 +1,95 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_extsort_perf.cpp
+// DATE: Fall 2021
+// DESC: Performance test driver for the external merge sort. Sorts
+//       inputs 4 times larger than the memory budget into an output
+//       file and into a BinSearchMap, reporting throughput. To run
+//       from the command line use:
+//          ./hw8_extsort_perf
+//       To save this data to a file, run the command:
+//          ./hw8_extsort_perf > extsort_output.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdio>
+#include "snapshot.h"
+#include "extsort.h"
+#include "binsearchmap.h"
+
+using namespace std;
+using namespace std::chrono;
+
+void write_input(const string &path, int n);
+
+// test parameters (memory budgets in MB, input is 4x the budget)
+const int budgets[] = {16, 64, 256};
+const int input_factor = 4;
+const char *in_file = "extsort_perf_in.bin";
+const char *out_file = "extsort_perf_out.bin";
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    // output data header
+    cout << "# All times in milliseconds (msec)" << endl;
+    cout << "# Column 1 = memory budget (MB)" << endl;
+    cout << "# Column 2 = input size (MB)" << endl;
+    cout << "# Column 3 = number of runs" << endl;
+    cout << "# Column 4 = sort to file" << endl;
+    cout << "# Column 5 = sort to file throughput (MB/sec)" << endl;
+    cout << "# Column 6 = sort into binsearch map" << endl;
+    cout << "# Column 7 = sort into binsearch map throughput (MB/sec)" << endl;
+
+    for (int budget : budgets)
+    {
+        size_t budget_bytes = (size_t)budget * 1024 * 1024;
+        int n = input_factor * budget_bytes / sizeof(int);
+        double mb = input_factor * budget;
+        write_input(in_file, n);
+
+        ExternalSorter<int> sorter(budget_bytes);
+        auto t0 = high_resolution_clock::now();
+        sorter.sort(in_file, out_file);
+        auto t1 = high_resolution_clock::now();
+        double c4 = duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+        std::remove(out_file);
+
+        BinSearchMap<int, int> m;
+        t0 = high_resolution_clock::now();
+        sorter.sort_into(in_file, [&](const int &key)
+                         { m.append_sorted(key, key); });
+        t1 = high_resolution_clock::now();
+        double c6 = duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+
+        cout << budget << " " << mb << " " << sorter.runs() << " " << c4
+             << " " << mb / (c4 / 1000) << " " << c6 << " "
+             << mb / (c6 / 1000) << endl;
+        std::remove(in_file);
+    }
+}
+
+// writes a snapshot of a deterministic permutation of 0 to n-1
+void write_input(const string &path, int n)
+{
+    ofstream out;
+    write_snapshot_header(out, path, ARRAYSEQ_SNAPSHOT, sizeof(int), 0, n);
+    const int block = 1 << 16;
+    int *buffer = new int[block];
+    unsigned long step = 1000003;
+    for (int i = 0; i < n; i += block)
+    {
+        int len = std::min(block, n - i);
+        for (int j = 0; j < len; ++j)
+        {
+            buffer[j] = (int)(((unsigned long)(i + j) * step) % n);
+        }
+        out.write(reinterpret_cast<const char *>(buffer), sizeof(int) * len);
+    }
+    delete[] buffer;
+}
@@ -0,0 +1,162 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_latency_perf.cpp
+// DATE: Fall 2021
+// DESC: Per-operation latency test for the maps and ArraySeq. Each
+//       map gets ops shuffled inserts, then ops lookups, then erases
+//       of every key, and each single operation is timed into a
+//       LatencyHistogram (see latency.h); ArraySeq gets ops appends.
+//       The output has one row per percentile and one column per
+//       structure and operation, so tail spikes (hash map rehashes,
+//       array resizes, deep tree paths) show up at the high
+//       percentiles. Times include the cost of reading the clock
+//       (tens of nanoseconds). To run from the command line use:
+//          ./hw8_latency_perf
+//       To save this data to a file, run the command:
+//          ./hw8_latency_perf > latency_output.dat
+//       and plot a column against column 2 on a log x axis.
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include "arrayseq.h"
+#include "map.h"
+#include "hashmap.h"
+#include "bstmap.h"
+#include "avlmap.h"
+#include "rbtreemap.h"
+#include "splaymap.h"
+#include "latency.h"
+
+using namespace std;
+
+// inserts, looks up, and erases ops keys, one histogram per operation
+void map_latencies(Map<int, int> &m, const vector<int> &keys,
+                   LatencyHistogram &inserts, LatencyHistogram &lookups,
+                   LatencyHistogram &erases);
+
+// test parameters
+const int ops = 1000000;
+const double percentiles[] = {0, 50, 75, 90, 95, 99, 99.9, 99.99, 99.999, 100};
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    // the keys 1 to ops in a fixed random order
+    vector<int> keys(ops);
+    for (int i = 0; i < ops; ++i)
+    {
+        keys[i] = i + 1;
+    }
+    shuffle(keys.begin(), keys.end(), mt19937(1));
+
+    vector<string> names;
+    vector<LatencyHistogram> histograms;
+    auto run_map = [&](const string &name, Map<int, int> &m)
+    {
+        LatencyHistogram inserts, lookups, erases;
+        map_latencies(m, keys, inserts, lookups, erases);
+        names.push_back(name + " insert");
+        histograms.push_back(inserts);
+        names.push_back(name + " contains");
+        histograms.push_back(lookups);
+        names.push_back(name + " erase");
+        histograms.push_back(erases);
+    };
+    {
+        HashMap<int, int> m;
+        run_map("hash map", m);
+    }
+    {
+        BSTMap<int, int> m;
+        run_map("bst map", m);
+    }
+    {
+        AVLMap<int, int> m;
+        run_map("avl map", m);
+    }
+    {
+        RBTreeMap<int, int> m;
+        run_map("rb tree map", m);
+    }
+    {
+        SplayMap<int, int> m;
+        run_map("splay map", m);
+    }
+    {
+        ArraySeq<int> seq;
+        LatencyHistogram appends;
+        for (int i = 0; i < ops; ++i)
+        {
+            appends.time([&]()
+                         { seq.insert(i, seq.size()); });
+        }
+        names.push_back("array seq append");
+        histograms.push_back(appends);
+    }
+
+    // output data header
+    cout << "# Latency of single operations in nanoseconds, " << ops
+         << " of each" << endl;
+    cout << "# Column 1 = percentile (0 = min, 100 = max)" << endl;
+    cout << "# Column 2 = 1 / (1 - percentile / 100), for a log x axis"
+         << endl;
+    for (int i = 0; i < int(names.size()); ++i)
+    {
+        const LatencyHistogram &h = histograms[i];
+        cout << "# Column " << i + 3 << " = " << names[i]
+             << " (mean " << h.mean() << ", p50 " << h.percentile(50)
+             << ", p90 " << h.percentile(90) << ", p99 " << h.percentile(99)
+             << ", p99.9 " << h.percentile(99.9) << ", max " << h.max()
+             << ")" << endl;
+    }
+
+    for (double p : percentiles)
+    {
+        // the max row has no finite x; put it one decade past the last
+        double x = p < 100 ? 1 / (1 - p / 100) : 1e6;
+        cout << setprecision(3) << p << " " << setprecision(2) << x;
+        for (const LatencyHistogram &h : histograms)
+        {
+            cout << " " << h.percentile(p);
+        }
+        cout << endl;
+    }
+}
+
+void map_latencies(Map<int, int> &m, const vector<int> &keys,
+                   LatencyHistogram &inserts, LatencyHistogram &lookups,
+                   LatencyHistogram &erases)
+{
+    for (int key : keys)
+    {
+        inserts.time([&]()
+                     { m.insert(key, key); });
+    }
+    // look up and erase in a different order than the inserts
+    vector<int> order(keys);
+    shuffle(order.begin(), order.end(), mt19937(2));
+    long found = 0;
+    for (int key : order)
+    {
+        lookups.time([&]()
+                     { found += m.contains(key); });
+    }
+    shuffle(order.begin(), order.end(), mt19937(3));
+    for (int key : order)
+    {
+        erases.time([&]()
+                    { m.erase(key); });
+    }
+    if (found != long(keys.size()))
+    {
+        cerr << "lookup missed a key" << endl;
+    }
+}
@@ -0,0 +1,129 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_layout_perf.cpp
+// DATE: Fall 2021
+// DESC: Performance test driver for the kvstore.h storage layouts.
+//       BinSearchMap and ArrayMap are loaded with 8-byte keys and 64
+//       or 256-byte values, stored either as (key, value) pairs or as
+//       parallel key and value arrays, and probed with uniformly
+//       random present keys (each lookup reads the value). To run
+//       from the command line use:
+//          ./hw8_layout_perf
+//       To save this data to a file, run the command:
+//          ./hw8_layout_perf > layout_output.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include "arraymap.h"
+#include "binsearchmap.h"
+#include "kvstore.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// a value of the given size
+template <int Bytes>
+struct Payload
+{
+    char bytes[Bytes];
+};
+
+// comparisons required by ArraySeq's sort members
+template <int Bytes>
+bool operator==(const Payload<Bytes> &lhs, const Payload<Bytes> &rhs)
+{
+    return lhs.bytes[0] == rhs.bytes[0];
+}
+
+template <int Bytes>
+bool operator<(const Payload<Bytes> &lhs, const Payload<Bytes> &rhs)
+{
+    return lhs.bytes[0] < rhs.bytes[0];
+}
+
+template <int Bytes>
+bool operator<=(const Payload<Bytes> &lhs, const Payload<Bytes> &rhs)
+{
+    return lhs.bytes[0] <= rhs.bytes[0];
+}
+
+template <typename M, int Bytes>
+double lookups_per_sec(int n);
+
+// test parameters
+const int binsearch_sizes[] = {1000, 100000, 1000000};
+const int array_sizes[] = {16, 64, 256, 1024};
+const int lookups = 1000000;
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    // output data header
+    cout << "# All rates in million lookups per second" << endl;
+    cout << "# Column 1 = map (1 = binsearch map, 2 = array map)" << endl;
+    cout << "# Column 2 = input data size" << endl;
+    cout << "# Column 3 = pair store, 64-byte values" << endl;
+    cout << "# Column 4 = column store, 64-byte values" << endl;
+    cout << "# Column 5 = pair store, 256-byte values" << endl;
+    cout << "# Column 6 = column store, 256-byte values" << endl;
+
+    for (int n : binsearch_sizes)
+    {
+        cout << 1 << " " << n;
+        cout << " " << lookups_per_sec<BinSearchMap<long, Payload<64>, ClassicSearch, PairStore>, 64>(n);
+        cout << " " << lookups_per_sec<BinSearchMap<long, Payload<64>, ClassicSearch, ColumnStore>, 64>(n);
+        cout << " " << lookups_per_sec<BinSearchMap<long, Payload<256>, ClassicSearch, PairStore>, 256>(n);
+        cout << " " << lookups_per_sec<BinSearchMap<long, Payload<256>, ClassicSearch, ColumnStore>, 256>(n);
+        cout << endl;
+    }
+    for (int n : array_sizes)
+    {
+        cout << 2 << " " << n;
+        cout << " " << lookups_per_sec<ArrayMap<long, Payload<64>, PairStore>, 64>(n);
+        cout << " " << lookups_per_sec<ArrayMap<long, Payload<64>, ColumnStore>, 64>(n);
+        cout << " " << lookups_per_sec<ArrayMap<long, Payload<256>, PairStore>, 256>(n);
+        cout << " " << lookups_per_sec<ArrayMap<long, Payload<256>, ColumnStore>, 256>(n);
+        cout << endl;
+    }
+}
+
+// builds a map M of the n keys 0, 2, ..., 2(n-1) and times random
+// lookups of present keys
+template <typename M, int Bytes>
+double lookups_per_sec(int n)
+{
+    M map;
+    Payload<Bytes> value;
+    for (int i = 0; i < n; ++i)
+    {
+        value.bytes[0] = (char)i;
+        map.insert(2L * i, value);
+    }
+    mt19937 gen(42);
+    uniform_int_distribution<int> dist(0, n - 1);
+    long *probes = new long[lookups];
+    for (int i = 0; i < lookups; ++i)
+    {
+        probes[i] = 2L * dist(gen);
+    }
+    long sum = 0;
+    auto t0 = high_resolution_clock::now();
+    for (int i = 0; i < lookups; ++i)
+    {
+        sum += map[probes[i]].bytes[0];
+    }
+    auto t1 = high_resolution_clock::now();
+    delete[] probes;
+    if (sum == 1)
+    {
+        cerr << "unlikely" << endl;
+    }
+    double secs = duration_cast<microseconds>(t1 - t0).count() / 1000000.0;
+    return lookups / secs / 1000000.0;
+}
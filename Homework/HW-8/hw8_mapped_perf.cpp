@@ -0,0 +1,97 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_mapped_perf.cpp
+// DATE: Fall 2021
+// DESC: Performance test driver for the memory-mapped sequence. Builds
+//       a multi-GB file of shuffled ints, then times reopening it, a
+//       sequential scan, and merge_sort on the mapped data. To run
+//       from the command line use:
+//          ./hw8_mapped_perf
+//       To save this data to a file, run the command:
+//          ./hw8_mapped_perf > mapped_output.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdio>
+#include "mappedseq.h"
+
+using namespace std;
+using namespace std::chrono;
+
+double timed_scan(MappedArraySeq<int> &s, long &sum);
+
+// test parameters (2^29 ints is a 2 GB file)
+const int n = 1 << 29;
+const char *mapped_file = "mapped_perf.seq";
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    // output data header
+    cout << "# All times in milliseconds (msec)" << endl;
+    cout << "# Column 1 = number of elements" << endl;
+    cout << "# Column 2 = file size (MB)" << endl;
+    cout << "# Column 3 = reopen" << endl;
+    cout << "# Column 4 = sequential scan" << endl;
+    cout << "# Column 5 = scan throughput (MB/sec)" << endl;
+    cout << "# Column 6 = merge sort" << endl;
+    cout << "# Column 7 = sorted scan" << endl;
+
+    // build the file with a deterministic permutation of 0 to n-1
+    std::remove(mapped_file);
+    {
+        MappedArraySeq<int> s(mapped_file);
+        s.reserve(n);
+        s.advise_sequential();
+        unsigned long step = 1000003;
+        for (int i = 0; i < n; ++i)
+        {
+            s.insert((int)((i * step) % n), i);
+        }
+    }
+
+    // reopen (no data is read until it is touched)
+    auto t0 = high_resolution_clock::now();
+    MappedArraySeq<int> s(mapped_file);
+    auto t1 = high_resolution_clock::now();
+    double reopen = duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+
+    long sum = 0;
+    double scan = timed_scan(s, sum);
+    double mb = (double)n * sizeof(int) / (1024 * 1024);
+
+    t0 = high_resolution_clock::now();
+    s.merge_sort();
+    t1 = high_resolution_clock::now();
+    double sort = duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+
+    long sorted_sum = 0;
+    double sorted_scan = timed_scan(s, sorted_sum);
+    if (sum != sorted_sum || s[0] != 0 || s[n - 1] != n - 1)
+    {
+        cerr << "sort check failed" << endl;
+    }
+
+    cout << n << " " << mb << " " << reopen << " " << scan << " "
+         << mb / (scan / 1000) << " " << sort << " " << sorted_scan << endl;
+
+    std::remove(mapped_file);
+}
+
+// sums the sequence front to back
+double timed_scan(MappedArraySeq<int> &s, long &sum)
+{
+    s.advise_sequential();
+    auto t0 = high_resolution_clock::now();
+    for (int i = 0; i < s.size(); ++i)
+    {
+        sum += s[i];
+    }
+    auto t1 = high_resolution_clock::now();
+    return duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+}
@@ -9,7 +9,9 @@
 //       save this data to a file, run the command:
 //          ./hw8_perf > output.dat
 //       This file can then be used by the plotting script to generate
-//       the corresponding performance graphs.
+//       the corresponding performance graphs. After the timing columns
+//       come hardware counter columns (see perfcounters.h) for each
+//       timed region; counters the system does not allow read as nan.
 //---------------------------------------------------------------------------
 
 #include <iostream>
@@ -26,16 +28,27 @@
 #include "hashmap.h"
 #include "bstmap.h"
 #include "avlmap.h"
+#include "rbtreemap.h"
+#include "perfcounters.h"
 
 using namespace std;
 using namespace std::chrono;
 
 
-double timed_insert(Map<int,int>& m, int key);
-double timed_erase(Map<int,int>& m, int key);
-double timed_contains(const Map<int,int>& m, int key);
-double timed_find_range(const Map<int,int>& m, int key1, int key2);
-double timed_sorted_keys(const Map<int,int>& m);
+// each timed helper also returns the average hardware counts of its
+// runs in events
+double timed_insert(Map<int,int>& m, int key, PerfSample& events);
+double timed_erase(Map<int,int>& m, int key, PerfSample& events);
+double timed_contains(const Map<int,int>& m, int key, PerfSample& events);
+double timed_find_range(const Map<int,int>& m, int key1, int key2,
+                        PerfSample& events);
+double timed_sorted_keys(const Map<int,int>& m, PerfSample& events);
+
+// averages the counts of several samples
+PerfSample average(const vector<PerfSample>& samples);
+
+// counters shared by the timed helpers
+PerfCounters counters;
 
 // test parameters
 const int start = 0;
@@ -80,9 +93,39 @@ int main(int argc, char* argv[])
   cout << "# Column 21 = avl map sorted keys shuffled" << endl;
 
   cout << "# Column 22 = bst map height shuffled" << endl;
-  cout << "# Column 22 = avl map height shuffled" << endl;
+  cout << "# Column 23 = avl map height shuffled" << endl;
   cout << "# Column 24 = log base 2 of input size" << endl;  
 
+  cout << "# Column 25 = rb tree map insert shuffled" << endl;
+  cout << "# Column 26 = rb tree map erase shuffled" << endl;
+  cout << "# Column 27 = rb tree map contains shuffled" << endl;
+  cout << "# Column 28 = rb tree map find range shuffled" << endl;
+  cout << "# Column 29 = rb tree map sorted keys shuffled" << endl;
+  cout << "# Column 30 = rb tree map height shuffled" << endl;
+
+  // one counter column per event for each timed region, in the order
+  // of the timing columns
+  const char* regions[] = {
+    "binsearch map insert", "hash map insert", "bst map insert",
+    "avl map insert", "binsearch map erase", "hash map erase",
+    "bst map erase", "avl map erase", "binsearch contains",
+    "hash map contains", "bst map contains", "avl map contains",
+    "binsearch find range", "hash map find range", "bst map find range",
+    "avl map find range", "binsearch sorted keys", "hash map sorted keys",
+    "bst map sorted keys", "avl map sorted keys", "rb tree map insert",
+    "rb tree map erase", "rb tree map contains", "rb tree map find range",
+    "rb tree map sorted keys"};
+  int column = 31;
+  for (const char* region : regions)
+    for (int e = 0; e < PERF_EVENT_COUNT; ++e)
+      cout << "# Column " << column++ << " = " << region << " "
+           << perf_event_names[e] << endl;
+  if (!counters.any_available())
+    cout << "# (hardware counters unavailable, counter columns are nan)"
+         << endl;
+  cout << "# (counters include the worker threads of each region; nan"
+       << " means not counted)" << endl;
+
   // generate shuffled data
   ArraySeq<int> keys, vals;
   for (int i = 2; i <= stop*2; i += 2) {
@@ -99,59 +142,78 @@ int main(int argc, char* argv[])
     HashMap<int,int> m2;
     BSTMap<int,int> m3;
     AVLMap<int,int> m4;
+    RBTreeMap<int,int> m5;
     for (int i = 0; i < n; ++i) {
       m1.insert(keys[i], vals[i]);
       m2.insert(keys[i], vals[i]);
       m3.insert(keys[i], vals[i]);
       m4.insert(keys[i], vals[i]);
+      m5.insert(keys[i], vals[i]);
     }
 
     int c22 = m3.height();
     int c23 = m4.height();
     int c24 = (n == 0) ? 0 : ceil(log2(n));
+    int c30 = m5.height();
     
     int min = 2;
     int med = n;
     int max = n * 2;
 
     // insert and erase (three cases for binsearch to be fair)
-    double c2_1 = timed_insert(m1, min - 1);
-    double c6_1 = timed_erase(m1, min - 1);    
-    double c2_2 = timed_insert(m1, med + 1);    
-    double c6_2 = timed_erase(m1, med + 1);
-    double c2_3 = timed_insert(m1, max + 1);
-    double c6_3 = timed_erase(m1, max + 1);    
+    vector<PerfSample> e2(3), e6(3);
+    PerfSample e3, e4, e5, e7, e8, e9, e25, e26;
+    double c2_1 = timed_insert(m1, min - 1, e2[0]);
+    double c6_1 = timed_erase(m1, min - 1, e6[0]);    
+    double c2_2 = timed_insert(m1, med + 1, e2[1]);    
+    double c6_2 = timed_erase(m1, med + 1, e6[1]);
+    double c2_3 = timed_insert(m1, max + 1, e2[2]);
+    double c6_3 = timed_erase(m1, max + 1, e6[2]);    
     double c2 = (c2_1 + c2_2 + c2_3) / 3; 
     double c6 = (c6_1 + c6_2 + c6_3) / 3;
-    double c3 = timed_insert(m2, med + 1);
-    double c7 = timed_erase(m2, med + 1);
-    double c4 = timed_insert(m3, med + 1);
-    double c8 = timed_erase(m3, med + 1);
-    double c5 = timed_insert(m4, med + 1);
-    double c9 = timed_erase(m4, med + 1);
+    double c3 = timed_insert(m2, med + 1, e3);
+    double c7 = timed_erase(m2, med + 1, e7);
+    double c4 = timed_insert(m3, med + 1, e4);
+    double c8 = timed_erase(m3, med + 1, e8);
+    double c5 = timed_insert(m4, med + 1, e5);
+    double c9 = timed_erase(m4, med + 1, e9);
+    double c25 = timed_insert(m5, med + 1, e25);
+    double c26 = timed_erase(m5, med + 1, e26);
     
     assert(m1.size() == n);
     assert(m2.size() == n);
     assert(m3.size() == n);
     assert(m4.size() == n);
+    assert(m5.size() == n);
     
     // contains end
-    double c10 = timed_contains(m1, max + 1);
-    double c11 = timed_contains(m2, max + 1);
-    double c12 = timed_contains(m3, max + 1);
-    double c13 = timed_contains(m4, max + 1);
+    PerfSample e10, e11, e12, e13, e27;
+    double c10 = timed_contains(m1, max + 1, e10);
+    double c11 = timed_contains(m2, max + 1, e11);
+    double c12 = timed_contains(m3, max + 1, e12);
+    double c13 = timed_contains(m4, max + 1, e13);
+    double c27 = timed_contains(m5, max + 1, e27);
 
     // key range (1/20th of values)
-    double c14 = timed_find_range(m1, med, med + (n/20));
-    double c15 = timed_find_range(m2, med, med + (n/20));
-    double c16 = timed_find_range(m3, med, med + (n/20));
-    double c17 = timed_find_range(m4, med, med + (n/20));
+    PerfSample e14, e15, e16, e17, e28;
+    double c14 = timed_find_range(m1, med, med + (n/20), e14);
+    double c15 = timed_find_range(m2, med, med + (n/20), e15);
+    double c16 = timed_find_range(m3, med, med + (n/20), e16);
+    double c17 = timed_find_range(m4, med, med + (n/20), e17);
+    double c28 = timed_find_range(m5, med, med + (n/20), e28);
     
     // sort
-    double c18 = timed_sorted_keys(m1);
-    double c19 = timed_sorted_keys(m2);
-    double c20 = timed_sorted_keys(m3);
-    double c21 = timed_sorted_keys(m4);
+    PerfSample e18, e19, e20, e21, e29;
+    double c18 = timed_sorted_keys(m1, e18);
+    double c19 = timed_sorted_keys(m2, e19);
+    double c20 = timed_sorted_keys(m3, e20);
+    double c21 = timed_sorted_keys(m4, e21);
+    double c29 = timed_sorted_keys(m5, e29);
+
+    // counter columns, in the order of the header
+    PerfSample events[] = {
+      average(e2), e3, e4, e5, average(e6), e7, e8, e9, e10, e11, e12,
+      e13, e14, e15, e16, e17, e18, e19, e20, e21, e25, e26, e27, e28, e29};
 
     cout << n
          << " " << c2 << " " << c3 << " " << c4
@@ -161,75 +223,110 @@ int main(int argc, char* argv[])
          << " " << c14 << " " << c15 << " " << c16
          << " " << c17 << " " << c18 << " " << c19
          << " " << c20 << " " << c21 << " " << c22
-         << " " << c23 << " " << c24
-         << endl;
+         << " " << c23 << " " << c24 << " " << c25
+         << " " << c26 << " " << c27 << " " << c28
+         << " " << c29 << " " << c30;
+    cout << setprecision(0);
+    for (const PerfSample& sample : events)
+      for (int e = 0; e < PERF_EVENT_COUNT; ++e)
+        cout << " " << sample.count[e];
+    cout << setprecision(2) << endl;
   }
   
 }
 
 
 // assumes keys are multiples of 2 and key to insert is odd
-double timed_insert(Map<int,int>& m, int key)
+double timed_insert(Map<int,int>& m, int key, PerfSample& events)
 {
   double total = 0;
+  vector<PerfSample> samples;
   for (int r = 0; r < runs; ++r) {
+    counters.start();
     auto t0 = high_resolution_clock::now();
     m.insert(key + (r * 2), key + (r * 2));
     auto t1 = high_resolution_clock::now();
+    samples.push_back(counters.stop());
     total += duration_cast<microseconds>(t1 - t0).count();
   }
+  events = average(samples);
   return (total/1000) / runs;
 }
 
 // removes the odd values inserted from timed_insert
-double timed_erase(Map<int,int>& m, int key)
+double timed_erase(Map<int,int>& m, int key, PerfSample& events)
 {
   double total = 0;
+  vector<PerfSample> samples;
   for (int r = 0; r < runs; ++r) {
+    counters.start();
     auto t0 = high_resolution_clock::now();
     m.erase(key + (r * 2));
     auto t1 = high_resolution_clock::now();
+    samples.push_back(counters.stop());
     total += duration_cast<microseconds>(t1 - t0).count();
   }
+  events = average(samples);
   return (total/1000) / runs;
 }
 
-double timed_contains(const Map<int,int>& m, int key) 
+double timed_contains(const Map<int,int>& m, int key, PerfSample& events)
 {
   double total = 0;
+  vector<PerfSample> samples;
   for (int r = 0; r < runs; ++r) {
+    counters.start();
     auto t0 = high_resolution_clock::now();
     m.contains(key);
     auto t1 = high_resolution_clock::now();
+    samples.push_back(counters.stop());
     total += duration_cast<microseconds>(t1 - t0).count();
   }
+  events = average(samples);
   return (total/1000) / runs;
 }
 
-double timed_find_range(const Map<int,int>& m, int key1, int key2)
+double timed_find_range(const Map<int,int>& m, int key1, int key2,
+                        PerfSample& events)
 {
   double total = 0;
+  vector<PerfSample> samples;
   for (int r = 0; r < runs; ++r) {
+    counters.start();
     auto t0 = high_resolution_clock::now();
     m.find_keys(key1, key2);
     auto t1 = high_resolution_clock::now();
+    samples.push_back(counters.stop());
     total += duration_cast<microseconds>(t1 - t0).count();
   }
+  events = average(samples);
   return (total/1000) / runs;
 }
 
-double timed_sorted_keys(const Map<int,int>& m)
+double timed_sorted_keys(const Map<int,int>& m, PerfSample& events)
 {
   double total = 0;
+  vector<PerfSample> samples;
   for (int r = 0; r < runs; ++r) {
+    counters.start();
     auto t0 = high_resolution_clock::now();
     m.sorted_keys();
     auto t1 = high_resolution_clock::now();
+    samples.push_back(counters.stop());
     total += duration_cast<microseconds>(t1 - t0).count();
   }
+  events = average(samples);
   return (total/1000) / runs;
 }
 
-
-
-
+PerfSample average(const vector<PerfSample>& samples)
+{
+  PerfSample result;
+  for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+    result.count[e] = 0;
+    for (const PerfSample& sample : samples)
+      result.count[e] += sample.count[e];
+    result.count[e] /= samples.size();
+  }
+  return result;
+}
@@ -0,0 +1,79 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_search_perf.cpp
+// DATE: Fall 2021
+// DESC: Performance test driver for the BinSearchMap search policies.
+//       Each map holds the evenly spaced keys 0, 2, ..., 2(n-1) (as in
+//       hw8_perf) and is probed with uniformly random keys in [0, 2n),
+//       so about half the lookups miss. To run from the command line
+//       use:
+//          ./hw8_search_perf
+//       To save this data to a file, run the command:
+//          ./hw8_search_perf > search_output.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include "binsearchmap.h"
+
+using namespace std;
+using namespace std::chrono;
+
+template <typename Search>
+double lookups_per_sec(int n, const int probes[], int m);
+
+// test parameters
+const int sizes[] = {10000, 1000000, 100000000};
+const int lookups = 1000000;
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    // output data header
+    cout << "# All rates in million lookups per second" << endl;
+    cout << "# Column 1 = input data size" << endl;
+    cout << "# Column 2 = classic search" << endl;
+    cout << "# Column 3 = branchless search" << endl;
+    cout << "# Column 4 = interpolation search" << endl;
+
+    int *probes = new int[lookups];
+    for (int n : sizes)
+    {
+        mt19937 gen(42);
+        uniform_int_distribution<int> dist(0, 2 * n - 1);
+        for (int i = 0; i < lookups; ++i)
+        {
+            probes[i] = dist(gen);
+        }
+        cout << n;
+        cout << " " << lookups_per_sec<ClassicSearch>(n, probes, lookups);
+        cout << " " << lookups_per_sec<BranchlessSearch>(n, probes, lookups);
+        cout << " " << lookups_per_sec<InterpolationSearch>(n, probes, lookups);
+        cout << endl;
+    }
+    delete[] probes;
+}
+
+// builds a map of n keys with the Search policy and times m lookups
+template <typename Search>
+double lookups_per_sec(int n, const int probes[], int m)
+{
+    BinSearchMap<int, int, Search> map;
+    for (int i = 0; i < n; ++i)
+    {
+        map.append_sorted(2 * i, i);
+    }
+    auto t0 = high_resolution_clock::now();
+    for (int i = 0; i < m; ++i)
+    {
+        map.contains(probes[i]);
+    }
+    auto t1 = high_resolution_clock::now();
+    double secs = duration_cast<microseconds>(t1 - t0).count() / 1000000.0;
+    return m / secs / 1000000.0;
+}
@@ -0,0 +1,197 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_skiplist_perf.cpp
+// DATE: Fall 2021
+// DESC: Thread scaling test for ConcurrentSkipListMap. Every thread
+//       runs the same mix of lookups, writes (an insert followed later
+//       by the erase of a key it inserted earlier), and range scans
+//       for a fixed time, for 1, 2, 4, ... threads up to the number of
+//       cores. The same mixes are run against an AVLMap guarded by one
+//       mutex. To run from the command line use:
+//          ./hw8_skiplist_perf
+//       To save this data to a file, run the command:
+//          ./hw8_skiplist_perf > skiplist_output.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "avlmap.h"
+#include "concurrent_skiplistmap.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// test parameters
+const int keys = 1000000;
+const int scan_width = 100;
+const int run_msec = 1000;
+
+// operation mix, in percent
+struct Mix
+{
+    const char *name;
+    int lookups;
+    int writes;
+    int scans;
+};
+
+const Mix mixes[] = {{"lookup-heavy", 90, 10, 0},
+                     {"write-heavy", 50, 50, 0},
+                     {"scan", 70, 20, 10}};
+
+// runs threads copies of the mix for run_msec, returning the total
+// operations per second
+template <typename Lookup, typename Insert, typename Erase, typename Scan>
+double run(int threads, const Mix &mix, Lookup lookup, Insert insert,
+           Erase erase, Scan scan);
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    vector<int> thread_counts;
+    int cores = max(1u, thread::hardware_concurrency());
+    for (int t = 1; t < cores; t *= 2)
+    {
+        thread_counts.push_back(t);
+    }
+    thread_counts.push_back(cores);
+
+    // output data header
+    cout << "# Operations per second (thousands), " << keys << " keys" << endl;
+    cout << "# Column 1 = threads" << endl;
+    int column = 2;
+    for (const Mix &mix : mixes)
+    {
+        cout << "# Column " << column++ << " = skip list map " << mix.name
+             << " (" << mix.lookups << "/" << mix.writes << "/" << mix.scans
+             << " lookup/write/scan)" << endl;
+        cout << "# Column " << column++ << " = locked avl map " << mix.name << endl;
+    }
+
+    // even keys are loaded up front; writers insert and erase odd keys
+    ConcurrentSkipListMap<int, int> skiplist;
+    AVLMap<int, int> locked;
+    mutex lock;
+    for (int i = 0; i < keys; ++i)
+    {
+        skiplist.insert(2 * i, i);
+        locked.insert(2 * i, i);
+    }
+
+    for (int threads : thread_counts)
+    {
+        cout << threads;
+        for (const Mix &mix : mixes)
+        {
+            double s_ops = run(
+                threads, mix,
+                [&](int key)
+                { return skiplist.contains(key); },
+                [&](int key)
+                { skiplist.insert(key, key); },
+                [&](int key)
+                { skiplist.erase(key); },
+                [&](int key)
+                { return skiplist.find_keys(key, key + 2 * scan_width).size(); });
+            double l_ops = run(
+                threads, mix,
+                [&](int key)
+                {
+                    lock_guard<mutex> guard(lock);
+                    return locked.contains(key);
+                },
+                [&](int key)
+                {
+                    lock_guard<mutex> guard(lock);
+                    locked.insert(key, key);
+                },
+                [&](int key)
+                {
+                    lock_guard<mutex> guard(lock);
+                    locked.erase(key);
+                },
+                [&](int key)
+                {
+                    lock_guard<mutex> guard(lock);
+                    return locked.find_keys(key, key + 2 * scan_width).size();
+                });
+            cout << " " << s_ops / 1000 << " " << l_ops / 1000;
+        }
+        cout << endl;
+    }
+}
+
+template <typename Lookup, typename Insert, typename Erase, typename Scan>
+double run(int threads, const Mix &mix, Lookup lookup, Insert insert,
+           Erase erase, Scan scan)
+{
+    atomic<bool> done(false);
+    atomic<long> total_ops(0);
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.push_back(thread([&, t]()
+                                 {
+                                     mt19937 gen(t);
+                                     uniform_int_distribution<int> key_dist(0, 2 * keys);
+                                     uniform_int_distribution<int> op_dist(0, 99);
+                                     // odd keys owned by this thread, spread
+                                     // over the key range and erased in the
+                                     // order they were inserted
+                                     const int window = 64;
+                                     int inserted[window];
+                                     int next = 0;
+                                     long ops = 0;
+                                     long found = 0;
+                                     while (!done.load(memory_order_relaxed))
+                                     {
+                                         int op = op_dist(gen);
+                                         int key = key_dist(gen);
+                                         if (op < mix.lookups)
+                                         {
+                                             found += lookup(key);
+                                         }
+                                         else if (op < mix.lookups + mix.writes)
+                                         {
+                                             int odd = 2 * int((long(next) * 7919 % (keys / threads)) * threads + t) + 1;
+                                             if (next >= window)
+                                             {
+                                                 erase(inserted[next % window]);
+                                             }
+                                             insert(odd);
+                                             inserted[next % window] = odd;
+                                             ++next;
+                                         }
+                                         else
+                                         {
+                                             found += scan(key);
+                                         }
+                                         ++ops;
+                                     }
+                                     // leave the map as it was
+                                     for (int i = max(0, next - window); i < next; ++i)
+                                     {
+                                         erase(inserted[i % window]);
+                                     }
+                                     total_ops += ops + (found < 0);
+                                 }));
+    }
+    auto t0 = high_resolution_clock::now();
+    this_thread::sleep_for(milliseconds(run_msec));
+    done.store(true);
+    for (thread &worker : workers)
+    {
+        worker.join();
+    }
+    double secs = duration_cast<microseconds>(high_resolution_clock::now() - t0).count() / 1e6;
+    return total_ops.load() / secs;
+}
@@ -0,0 +1,148 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_smallseq_perf.cpp
+// DATE: Fall 2021
+// DESC: Performance test driver for small find_keys results. An
+//       AVLMap is loaded with shuffled keys and probed with ranges
+//       that match a few keys each. Every range is collected into a
+//       new ArraySeq (the result of find_keys) and into a new
+//       SmallArraySeq<int, 16>, counting heap allocations with a
+//       replaced global operator new. To run from the command line
+//       use:
+//          ./hw8_smallseq_perf
+//       To save this data to a file, run the command:
+//          ./hw8_smallseq_perf > smallseq_output.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include "arrayseq.h"
+#include "avlmap.h"
+#include "smallarrayseq.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// heap allocations so far
+static long allocations = 0;
+
+void *operator new(size_t bytes)
+{
+    ++allocations;
+    void *p = malloc(bytes ? bytes : 1);
+    if (p == nullptr)
+    {
+        throw bad_alloc();
+    }
+    return p;
+}
+
+void *operator new[](size_t bytes)
+{
+    return operator new(bytes);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    free(p);
+}
+
+// test parameters
+const int keys = 1000000;
+const int queries = 1000000;
+const int widths[] = {1, 2, 4, 8, 12, 16, 24, 32};
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    // output data header
+    cout << "# " << queries << " find_keys queries on " << keys << " keys" << endl;
+    cout << "# Column 1 = keys matched per query" << endl;
+    cout << "# Column 2 = array seq time (msec)" << endl;
+    cout << "# Column 3 = small array seq (N = 16) time (msec)" << endl;
+    cout << "# Column 4 = array seq allocations per query" << endl;
+    cout << "# Column 5 = small array seq allocations per query" << endl;
+
+    // keys 0 to keys-1, inserted in a fixed random order
+    AVLMap<int, int> m;
+    {
+        ArraySeq<int> order;
+        order.reserve(keys);
+        for (int i = 0; i < keys; ++i)
+        {
+            order.insert(i, i);
+        }
+        mt19937 gen(1);
+        for (int i = keys - 1; i > 0; --i)
+        {
+            swap(order[i], order[uniform_int_distribution<int>(0, i)(gen)]);
+        }
+        for (int i = 0; i < keys; ++i)
+        {
+            m.insert(order[i], order[i]);
+        }
+    }
+
+    for (int width : widths)
+    {
+        long found = 0;
+        mt19937 gen(2);
+        uniform_int_distribution<int> dist(0, keys - width);
+
+        long before = allocations;
+        auto t0 = high_resolution_clock::now();
+        for (int q = 0; q < queries; ++q)
+        {
+            int k1 = dist(gen);
+            ArraySeq<int> result = m.find_keys(k1, k1 + width - 1);
+            found += result.size();
+        }
+        auto t1 = high_resolution_clock::now();
+        long array_allocs = allocations - before;
+
+        gen.seed(2);
+        before = allocations;
+        auto t2 = high_resolution_clock::now();
+        for (int q = 0; q < queries; ++q)
+        {
+            int k1 = dist(gen);
+            SmallArraySeq<int, 16> result;
+            m.find_keys(k1, k1 + width - 1, result);
+            found -= result.size();
+        }
+        auto t3 = high_resolution_clock::now();
+        long small_allocs = allocations - before;
+
+        if (found != 0)
+        {
+            cerr << "result sizes differ" << endl;
+        }
+        cout << width
+             << " " << duration_cast<microseconds>(t1 - t0).count() / 1000.0
+             << " " << duration_cast<microseconds>(t3 - t2).count() / 1000.0
+             << " " << double(array_allocs) / queries
+             << " " << double(small_allocs) / queries << endl;
+    }
+}
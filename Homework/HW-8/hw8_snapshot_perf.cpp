@@ -0,0 +1,138 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_snapshot_perf.cpp
+// DATE: Fall 2021
+// DESC: Performance test driver for the binary snapshot format. For
+//       each map (and ArraySeq) compares rebuilding the collection by
+//       re-inserting every key against loading it from a snapshot
+//       file written by save. To run from the command line use:
+//          ./hw8_snapshot_perf
+//       To save this data to a file, run the command:
+//          ./hw8_snapshot_perf > snapshot_output.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include "arrayseq.h"
+#include "map.h"
+#include "binsearchmap.h"
+#include "hashmap.h"
+#include "bstmap.h"
+#include "avlmap.h"
+
+using namespace std;
+using namespace std::chrono;
+
+double timed_reinsert(Map<int, int> &m, const ArraySeq<int> &keys);
+template <typename C>
+double timed_load(C &c);
+
+// test parameters
+const int sizes[] = {1000000, 10000000};
+const char *snapshot_file = "snapshot_perf.bin";
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    // output data header
+    cout << "# All times in milliseconds (msec)" << endl;
+    cout << "# Column 1 = input data size" << endl;
+    cout << "# Column 2 = arrayseq insert" << endl;
+    cout << "# Column 3 = arrayseq load" << endl;
+    cout << "# Column 4 = binsearch map insert (sorted keys)" << endl;
+    cout << "# Column 5 = binsearch map load" << endl;
+    cout << "# Column 6 = hash map insert shuffled" << endl;
+    cout << "# Column 7 = hash map load" << endl;
+    cout << "# Column 8 = bst map insert shuffled" << endl;
+    cout << "# Column 9 = bst map load" << endl;
+    cout << "# Column 10 = avl map insert shuffled" << endl;
+    cout << "# Column 11 = avl map load" << endl;
+
+    for (int n : sizes)
+    {
+        // sorted and (randomly) shuffled keys
+        ArraySeq<int> sorted, shuffled;
+        sorted.reserve(n);
+        shuffled.reserve(n);
+        for (int i = 0; i < n; ++i)
+        {
+            sorted.insert(2 * i, i);
+            shuffled.insert(2 * i, i);
+        }
+        mt19937 gen(42);
+        for (int i = n - 1; i > 0; --i)
+        {
+            int j = uniform_int_distribution<int>(0, i)(gen);
+            std::swap(shuffled[i], shuffled[j]);
+        }
+
+        cout << n;
+
+        {
+            ArraySeq<int> s1, s2;
+            auto t0 = high_resolution_clock::now();
+            for (int i = 0; i < n; ++i)
+            {
+                s1.insert(shuffled[i], i);
+            }
+            auto t1 = high_resolution_clock::now();
+            s1.save(snapshot_file);
+            cout << " " << duration_cast<microseconds>(t1 - t0).count() / 1000.0
+                 << " " << timed_load(s2);
+        }
+        {
+            BinSearchMap<int, int> m1, m2;
+            double t = timed_reinsert(m1, sorted);
+            m1.save(snapshot_file);
+            cout << " " << t << " " << timed_load(m2);
+        }
+        {
+            HashMap<int, int> m1, m2;
+            double t = timed_reinsert(m1, shuffled);
+            m1.save(snapshot_file);
+            cout << " " << t << " " << timed_load(m2);
+        }
+        {
+            BSTMap<int, int> m1, m2;
+            double t = timed_reinsert(m1, shuffled);
+            m1.save(snapshot_file);
+            cout << " " << t << " " << timed_load(m2);
+        }
+        {
+            AVLMap<int, int> m1, m2;
+            double t = timed_reinsert(m1, shuffled);
+            m1.save(snapshot_file);
+            cout << " " << t << " " << timed_load(m2);
+        }
+        cout << endl;
+    }
+    std::remove(snapshot_file);
+}
+
+// inserts each key (with itself as the value) into the empty map
+double timed_reinsert(Map<int, int> &m, const ArraySeq<int> &keys)
+{
+    auto t0 = high_resolution_clock::now();
+    for (int i = 0; i < keys.size(); ++i)
+    {
+        m.insert(keys[i], keys[i]);
+    }
+    auto t1 = high_resolution_clock::now();
+    return duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+}
+
+// loads the collection from the snapshot file
+template <typename C>
+double timed_load(C &c)
+{
+    auto t0 = high_resolution_clock::now();
+    c.load(snapshot_file);
+    auto t1 = high_resolution_clock::now();
+    return duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+}
@@ -7,9 +7,32 @@
 
 #include <iostream>
 #include <string>
+#include <cstdio>
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <map>
+#include <random>
+#include <string_view>
 #include <gtest/gtest.h>
 #include "arrayseq.h"
 #include "avlmap.h"
+#include "hashmap.h"
+#include "bstmap.h"
+#include "rbtreemap.h"
+#include "splaymap.h"
+#include "concurrent_avlmap.h"
+#include "concurrent_skiplistmap.h"
+#include "perfcounters.h"
+#include "latency.h"
+#include "workload.h"
+#include "smallarrayseq.h"
+#include "bloommap.h"
+#include "binsearchmap.h"
+#include "mappedseq.h"
+#include "extsort.h"
+#include "arraymap.h"
+#include "adaptivemap.h"
 
 using namespace std;
 
@@ -463,6 +486,2031 @@ TEST(BasicAVLMapTests, EraseRebalanceCheck)
     ASSERT_EQ(3, c3.height());
 }
 
+//----------------------------------------------------------------------
+// Batched lookup tests for the HashMap implementation of Map
+//----------------------------------------------------------------------
+
+TEST(BatchHashMapTests, ContainsManyCheck)
+{
+    HashMap<int, int> m;
+    for (int i = 0; i < 1000; i += 2)
+        m.insert(i, i * 10);
+    int keys[1000];
+    bool found[1000];
+    for (int i = 0; i < 1000; ++i)
+        keys[i] = 999 - i;
+    m.contains_many(keys, 1000, found);
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_EQ(keys[i] % 2 == 0, found[i]);
+}
+
+TEST(BatchHashMapTests, FindManyCheck)
+{
+    HashMap<int, int> m;
+    for (int i = 0; i < 500; ++i)
+        m.insert(i * 3, i);
+    int keys[600];
+    const int *values[600];
+    for (int i = 0; i < 600; ++i)
+        keys[i] = i * 3;
+    // group sizes that do and don't divide the number of keys
+    for (int group_size : {1, 7, 32, 128})
+    {
+        m.find_many(keys, 600, values, group_size);
+        for (int i = 0; i < 500; ++i)
+        {
+            ASSERT_NE(nullptr, values[i]);
+            ASSERT_EQ(i, *values[i]);
+        }
+        for (int i = 500; i < 600; ++i)
+            ASSERT_EQ(nullptr, values[i]);
+    }
+}
+
+TEST(BatchHashMapTests, RehashKeepsChainsCheck)
+{
+    // colliding keys force multi-node chains across several rehashes
+    HashMap<int, int> m;
+    for (int i = 0; i < 4096; ++i)
+        m.insert(i * 64, i);
+    ASSERT_EQ(4096, m.size());
+    for (int i = 0; i < 4096; ++i)
+    {
+        ASSERT_EQ(true, m.contains(i * 64));
+        ASSERT_EQ(i, m[i * 64]);
+    }
+}
+
+//----------------------------------------------------------------------
+// Tests for the Bloom filter front end (BloomMap)
+//----------------------------------------------------------------------
+
+TEST(BloomMapTests, NoFalseNegativesCheck)
+{
+    BloomFilter<int> f(1000, 10);
+    for (int i = 0; i < 1000; ++i)
+        f.insert(i * 7);
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_EQ(true, f.might_contain(i * 7));
+}
+
+// false positive rate of a blocked Bloom filter with 512-bit blocks:
+// the keys per block are Poisson distributed, and a block holding c
+// keys has each bit set with probability 1 - (1 - 1/512)^(k c)
+double blocked_bloom_rate(int keys, long bits, int probes)
+{
+    double lambda = keys / (bits / 512.0);
+    double p = std::exp(-lambda);
+    double rate = 0;
+    for (int c = 0; c < 10 * lambda + 100; ++c)
+    {
+        if (c > 0)
+            p *= lambda / c;
+        double set = 1 - std::pow(1 - 1.0 / 512, (double)probes * c);
+        rate += p * std::pow(set, probes);
+    }
+    return rate;
+}
+
+TEST(BloomMapTests, FalsePositiveRateCheck)
+{
+    // 7 probes at 10 bits per key and 11 at 16
+    int probes[] = {7, 11};
+    int bits_per_key[] = {10, 16};
+    for (int t = 0; t < 2; ++t)
+    {
+        BloomFilter<int> f(10000, bits_per_key[t]);
+        for (int i = 0; i < 10000; ++i)
+            f.insert(2 * i);
+        int lookups = 200000;
+        int false_positives = 0;
+        for (int i = 0; i < lookups; ++i)
+            if (f.might_contain(2 * i + 1))
+                ++false_positives;
+        double expected = blocked_bloom_rate(10000, f.bits(), probes[t]);
+        ASSERT_LT((double)false_positives / lookups, 1.2 * expected);
+    }
+}
+
+TEST(BloomMapTests, WrappedMapOperationsCheck)
+{
+    BloomMap<int, int, AVLMap<int, int>> m;
+    for (int i = 0; i < 100; ++i)
+        m.insert(i * 2, i);
+    ASSERT_EQ(100, m.size());
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(true, m.contains(i * 2));
+        ASSERT_EQ(false, m.contains(i * 2 + 1));
+        ASSERT_EQ(i, m[i * 2]);
+    }
+    m[10] = 50;
+    ASSERT_EQ(50, m[10]);
+    ASSERT_THROW(m[11], std::out_of_range);
+    ArraySeq<int> keys = m.find_keys(10, 20);
+    ASSERT_EQ(6, keys.size());
+    ASSERT_EQ(10, keys[0]);
+    ASSERT_EQ(20, keys[5]);
+}
+
+TEST(BloomMapTests, EraseRebuildCheck)
+{
+    BloomMap<int, int, BSTMap<int, int>> m;
+    for (int i = 0; i < 200; ++i)
+        m.insert(i, i);
+    long bits = m.filter().bits();
+    // bulk erase triggers a rebuild, shrinking the filter
+    for (int i = 0; i < 150; ++i)
+        m.erase(i);
+    ASSERT_EQ(50, m.size());
+    ASSERT_LT(m.filter().bits(), bits);
+    for (int i = 0; i < 150; ++i)
+        ASSERT_EQ(false, m.contains(i));
+    for (int i = 150; i < 200; ++i)
+        ASSERT_EQ(true, m.contains(i));
+    ASSERT_THROW(m.erase(10), std::out_of_range);
+}
+
+//----------------------------------------------------------------------
+// Binary snapshot save and load tests
+//----------------------------------------------------------------------
+
+const char *snapshot_file = "snapshot_test.bin";
+
+TEST(SnapshotTests, ArraySeqRoundTripCheck)
+{
+    ArraySeq<int> s1;
+    for (int i = 0; i < 100; ++i)
+        s1.insert(100 - i, i);
+    s1.save(snapshot_file);
+    ArraySeq<int> s2;
+    s2.insert(5, 0);
+    s2.load(snapshot_file);
+    std::remove(snapshot_file);
+    ASSERT_EQ(100, s2.size());
+    for (int i = 0; i < 100; ++i)
+        ASSERT_EQ(100 - i, s2[i]);
+    // the loaded sequence is still growable
+    s2.insert(0, 100);
+    ASSERT_EQ(101, s2.size());
+}
+
+TEST(SnapshotTests, BinSearchMapRoundTripCheck)
+{
+    BinSearchMap<int, double> m1;
+    for (int i = 0; i < 50; ++i)
+        m1.insert((i * 17) % 50, i / 2.0);
+    m1.save(snapshot_file);
+    BinSearchMap<int, double> m2;
+    m2.load(snapshot_file);
+    std::remove(snapshot_file);
+    ASSERT_EQ(50, m2.size());
+    for (int i = 0; i < 50; ++i)
+        ASSERT_EQ(i / 2.0, m2[(i * 17) % 50]);
+    ArraySeq<int> keys = m2.sorted_keys();
+    for (int i = 0; i < 50; ++i)
+        ASSERT_EQ(i, keys[i]);
+}
+
+TEST(SnapshotTests, HashMapRoundTripCheck)
+{
+    HashMap<int, int> m1;
+    for (int i = 0; i < 1000; ++i)
+        m1.insert(i * 3, i);
+    m1.save(snapshot_file);
+    HashMap<int, int> m2;
+    m2.insert(1, 1);
+    m2.load(snapshot_file);
+    std::remove(snapshot_file);
+    ASSERT_EQ(1000, m2.size());
+    ASSERT_EQ(false, m2.contains(1));
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_EQ(i, m2[i * 3]);
+}
+
+TEST(SnapshotTests, BSTMapRoundTripCheck)
+{
+    BSTMap<int, int> m1;
+    for (int i = 0; i < 127; ++i)
+        m1.insert(i, -i);
+    m1.save(snapshot_file);
+    BSTMap<int, int> m2;
+    m2.load(snapshot_file);
+    std::remove(snapshot_file);
+    ASSERT_EQ(127, m2.size());
+    // built balanced, not as the degenerate tree that was saved
+    ASSERT_EQ(7, m2.height());
+    for (int i = 0; i < 127; ++i)
+        ASSERT_EQ(-i, m2[i]);
+}
+
+TEST(SnapshotTests, AVLMapRoundTripCheck)
+{
+    AVLMap<int, int> m1;
+    for (int i = 0; i < 1000; ++i)
+        m1.insert((i * 7) % 1000, i);
+    m1.save(snapshot_file);
+    AVLMap<int, int> m2;
+    m2.load(snapshot_file);
+    std::remove(snapshot_file);
+    ASSERT_EQ(1000, m2.size());
+    ASSERT_EQ(10, m2.height());
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_EQ(i, m2[(i * 7) % 1000]);
+    // the loaded tree keeps rebalancing correctly
+    for (int i = 1000; i < 2000; ++i)
+        m2.insert(i, i);
+    ASSERT_LE(m2.height(), 15);
+}
+
+TEST(SnapshotTests, MismatchedSnapshotCheck)
+{
+    AVLMap<int, int> m1;
+    m1.insert(1, 1);
+    m1.save(snapshot_file);
+    BSTMap<int, int> m2;
+    ASSERT_THROW(m2.load(snapshot_file), std::runtime_error);
+    AVLMap<int, double> m3;
+    ASSERT_THROW(m3.load(snapshot_file), std::runtime_error);
+    std::remove(snapshot_file);
+    ASSERT_THROW(m1.load(snapshot_file), std::runtime_error);
+}
+
+// writes a snapshot header claiming count records followed by n int
+// records (each key doubling as its value, sequences have no values)
+void write_int_snapshot(SnapshotKind kind, std::uint64_t count,
+                        const int *keys, int n)
+{
+    std::ofstream out(snapshot_file, std::ios::binary | std::ios::trunc);
+    std::uint32_t value_size = kind == ARRAYSEQ_SNAPSHOT ? 0 : sizeof(int);
+    SnapshotHeader header = make_snapshot_header(kind, sizeof(int),
+                                                 value_size, count);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (int i = 0; i < n; ++i)
+    {
+        out.write(reinterpret_cast<const char *>(&keys[i]), sizeof(int));
+        out.write(reinterpret_cast<const char *>(&keys[i]), value_size);
+    }
+}
+
+TEST(SnapshotTests, TruncatedSnapshotCheck)
+{
+    int keys[] = {1, 2, 3};
+    HashMap<int, int> m;
+    m.insert(10, 10);
+    // more records claimed than the file holds
+    write_int_snapshot(HASHMAP_SNAPSHOT, 4, keys, 3);
+    ASSERT_THROW(m.load(snapshot_file), std::runtime_error);
+    write_int_snapshot(HASHMAP_SNAPSHOT, 1ull << 40, keys, 3);
+    ASSERT_THROW(m.load(snapshot_file), std::runtime_error);
+    // a failed load leaves the map unchanged
+    ASSERT_EQ(1, m.size());
+    ASSERT_EQ(10, m[10]);
+    AVLMap<int, int> t;
+    t.insert(10, 10);
+    write_int_snapshot(AVLMAP_SNAPSHOT, 4, keys, 3);
+    ASSERT_THROW(t.load(snapshot_file), std::runtime_error);
+    ASSERT_EQ(1, t.size());
+    ArraySeq<int> a;
+    write_int_snapshot(ARRAYSEQ_SNAPSHOT, 1ull << 40, keys, 0);
+    ASSERT_THROW(a.load(snapshot_file), std::runtime_error);
+    std::remove(snapshot_file);
+}
+
+TEST(SnapshotTests, OutOfOrderSnapshotCheck)
+{
+    int keys[] = {1, 3, 2, 4};
+    write_int_snapshot(BSTMAP_SNAPSHOT, 4, keys, 4);
+    BSTMap<int, int> b;
+    b.insert(10, 10);
+    ASSERT_THROW(b.load(snapshot_file), std::runtime_error);
+    ASSERT_EQ(1, b.size());
+    ASSERT_EQ(10, b[10]);
+    write_int_snapshot(AVLMAP_SNAPSHOT, 4, keys, 4);
+    AVLMap<int, int> a;
+    a.insert(10, 10);
+    ASSERT_THROW(a.load(snapshot_file), std::runtime_error);
+    ASSERT_EQ(1, a.size());
+    ASSERT_EQ(10, a[10]);
+    write_int_snapshot(BINSEARCHMAP_SNAPSHOT, 4, keys, 4);
+    BinSearchMap<int, int> s;
+    ASSERT_THROW(s.load(snapshot_file), std::runtime_error);
+    std::remove(snapshot_file);
+}
+
+//----------------------------------------------------------------------
+// Memory-mapped ArraySeq (MappedArraySeq) tests
+//----------------------------------------------------------------------
+
+const char *mapped_file = "mapped_test.seq";
+
+TEST(MappedArraySeqTests, InsertEraseCheck)
+{
+    std::remove(mapped_file);
+    {
+        MappedArraySeq<int> s(mapped_file);
+        ASSERT_EQ(true, s.empty());
+        for (int i = 0; i < 100; ++i)
+            s.insert(i, i);
+        s.insert(-1, 0);
+        s.erase(50);
+        ASSERT_EQ(100, s.size());
+        ASSERT_EQ(-1, s[0]);
+        ASSERT_EQ(48, s[49]);
+        ASSERT_EQ(50, s[50]);
+        ASSERT_EQ(true, s.contains(99));
+        ASSERT_EQ(false, s.contains(49));
+        ASSERT_THROW(s[100], std::out_of_range);
+        ASSERT_THROW(s.insert(0, 101), std::out_of_range);
+    }
+    std::remove(mapped_file);
+}
+
+TEST(MappedArraySeqTests, ReopenCheck)
+{
+    std::remove(mapped_file);
+    {
+        MappedArraySeq<double> s(mapped_file);
+        for (int i = 0; i < 1000; ++i)
+            s.insert(i / 4.0, i);
+    }
+    {
+        MappedArraySeq<double> s(mapped_file);
+        ASSERT_EQ(1000, s.size());
+        for (int i = 0; i < 1000; ++i)
+            ASSERT_EQ(i / 4.0, s[i]);
+        // the file is also a valid ArraySeq snapshot
+        ArraySeq<double> a;
+        a.load(mapped_file);
+        ASSERT_EQ(1000, a.size());
+        ASSERT_EQ(999 / 4.0, a[999]);
+    }
+    ASSERT_THROW(MappedArraySeq<int> s(mapped_file), std::runtime_error);
+    std::remove(mapped_file);
+}
+
+TEST(MappedArraySeqTests, SortCheck)
+{
+    std::remove(mapped_file);
+    {
+        MappedArraySeq<int> s(mapped_file);
+        for (int i = 0; i < 1001; ++i)
+            s.insert((i * 389) % 1001, i);
+        // a file with the old scratch name is left alone
+        std::string scratch = std::string(mapped_file) + ".scratch";
+        {
+            std::ofstream out(scratch);
+            out << "keep";
+        }
+        s.merge_sort();
+        for (int i = 0; i < 1001; ++i)
+            ASSERT_EQ(i, s[i]);
+        std::ifstream in(scratch);
+        std::string text;
+        in >> text;
+        ASSERT_EQ("keep", text);
+        std::remove(scratch.c_str());
+        for (int i = 0; i < 1001; ++i)
+            s[i] = (i * 577) % 1001;
+        s.quick_sort();
+        for (int i = 0; i < 1001; ++i)
+            ASSERT_EQ(i, s[i]);
+    }
+    std::remove(mapped_file);
+}
+
+TEST(MappedArraySeqTests, QuickSortDuplicatesCheck)
+{
+    std::remove(mapped_file);
+    {
+        // all keys equal, which one level of recursion per element
+        // would overflow the stack on
+        MappedArraySeq<int> s(mapped_file);
+        s.reserve(1000000);
+        for (int i = 0; i < 1000000; ++i)
+            s.insert(7, i);
+        s.quick_sort();
+        ASSERT_EQ(1000000, s.size());
+        ASSERT_EQ(7, s[0]);
+        ASSERT_EQ(7, s[999999]);
+        // few distinct keys
+        for (int i = 0; i < 1000000; ++i)
+            s[i] = (int)(((long)i * 7919) % 5);
+        s.quick_sort();
+        for (int i = 0; i < 1000000; ++i)
+            ASSERT_EQ(i / 200000, s[i]);
+    }
+    std::remove(mapped_file);
+}
+
+TEST(MappedArraySeqTests, ReopenHeaderOnlyCheck)
+{
+    // an empty ArraySeq snapshot holds only a header (capacity 0)
+    std::remove(mapped_file);
+    ArraySeq<int> empty;
+    empty.save(mapped_file);
+    {
+        MappedArraySeq<int> s(mapped_file);
+        ASSERT_EQ(0, s.size());
+        for (int i = 0; i < 2000; ++i)
+            s.insert(i, i);
+    }
+    {
+        MappedArraySeq<int> s(mapped_file);
+        ASSERT_EQ(2000, s.size());
+        ASSERT_EQ(1999, s[1999]);
+    }
+    // a header claiming more elements than the file holds is rejected
+    {
+        std::ofstream out(mapped_file, std::ios::binary | std::ios::trunc);
+        SnapshotHeader header = make_snapshot_header(ARRAYSEQ_SNAPSHOT,
+                                                     sizeof(int), 0, 100);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+    ASSERT_THROW(MappedArraySeq<int> s(mapped_file), std::runtime_error);
+    std::remove(mapped_file);
+}
+
+//----------------------------------------------------------------------
+// External merge sort tests
+//----------------------------------------------------------------------
+
+TEST(ExternalSortTests, SortToFileCheck)
+{
+    ArraySeq<int> s;
+    for (int i = 0; i < 20000; ++i)
+        s.insert((i * 7919) % 20000, i);
+    s.save("extsort_in.bin");
+    // 12 KB budget, so the input is spread over many runs
+    ExternalSorter<int> sorter(12 * 1024);
+    sorter.sort("extsort_in.bin", "extsort_out.bin");
+    ASSERT_LT(1, sorter.runs());
+    // a 12 KB budget only has room to merge two 4 KB runs at a time
+    ASSERT_EQ(sorter.runs() - 1, sorter.merges());
+    ArraySeq<int> sorted;
+    sorted.load("extsort_out.bin");
+    std::remove("extsort_in.bin");
+    std::remove("extsort_out.bin");
+    ASSERT_EQ(20000, sorted.size());
+    for (int i = 0; i < 20000; ++i)
+        ASSERT_EQ(i, sorted[i]);
+}
+
+TEST(ExternalSortTests, DuplicatesAndEmptyCheck)
+{
+    ArraySeq<int> s;
+    s.save("extsort_in.bin");
+    ExternalSorter<int> sorter(4096);
+    sorter.sort("extsort_in.bin", "extsort_out.bin");
+    ArraySeq<int> sorted;
+    sorted.load("extsort_out.bin");
+    ASSERT_EQ(0, sorted.size());
+    for (int i = 0; i < 5000; ++i)
+        s.insert(i % 3, i);
+    s.save("extsort_in.bin");
+    sorter.sort("extsort_in.bin", "extsort_out.bin");
+    sorted.load("extsort_out.bin");
+    std::remove("extsort_in.bin");
+    std::remove("extsort_out.bin");
+    ASSERT_EQ(5000, sorted.size());
+    for (int i = 1; i < 5000; ++i)
+        ASSERT_LE(sorted[i - 1], sorted[i]);
+}
+
+TEST(ExternalSortTests, StreamIntoBinSearchMapCheck)
+{
+    ArraySeq<int> s;
+    for (int i = 0; i < 10000; ++i)
+        s.insert((i * 3001) % 10000, i);
+    s.save("extsort_in.bin");
+    ExternalSorter<int> sorter(12 * 1024);
+    BinSearchMap<int, int> m;
+    sorter.sort_into("extsort_in.bin", [&](const int &key)
+                     { m.append_sorted(key, 2 * key); });
+    std::remove("extsort_in.bin");
+    ASSERT_EQ(10000, m.size());
+    for (int i = 0; i < 10000; ++i)
+        ASSERT_EQ(2 * i, m[i]);
+    ASSERT_THROW(m.append_sorted(5, 5), std::invalid_argument);
+}
+
+TEST(ExternalSortTests, RunFilesCheck)
+{
+    char dir[] = "extsort_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(dir));
+    ArraySeq<int> s;
+    for (int i = 0; i < 10000; ++i)
+        s.insert((i * 3001) % 10000, i);
+    s.save("extsort_in.bin");
+    // a second sorter in the same directory, run while the first is
+    // merging, must not touch the first one's run files
+    ExternalSorter<int> outer(64 * 1024, dir), inner(12 * 1024, dir);
+    int visited = 0;
+    outer.sort_into("extsort_in.bin", [&](const int &key)
+                    {
+                        ASSERT_EQ(visited++, key);
+                        if (key == 5000)
+                            inner.sort("extsort_in.bin", "extsort_out.bin");
+                    });
+    ASSERT_EQ(10000, visited);
+    ASSERT_LT(1, outer.runs());
+    ASSERT_EQ(1, outer.merges());
+    ArraySeq<int> sorted;
+    sorted.load("extsort_out.bin");
+    ASSERT_EQ(10000, sorted.size());
+    // a failed sort still removes its run files
+    ASSERT_THROW(outer.sort_into("extsort_in.bin", [](const int &key)
+                                 {
+                                     if (key == 100)
+                                         throw std::runtime_error("stop");
+                                 }),
+                 std::runtime_error);
+    std::remove("extsort_in.bin");
+    std::remove("extsort_out.bin");
+    // rmdir only succeeds on an empty directory
+    ASSERT_EQ(0, rmdir(dir));
+}
+
+//----------------------------------------------------------------------
+// Search Policy Tests
+//----------------------------------------------------------------------
+
+// checks every key and gap of a map holding the keys 3, 6, ..., 3n
+template <typename M>
+void check_search_policy(M &m, int n)
+{
+    for (int i = n; i > 0; --i)
+        m.insert(3 * i, i);
+    ASSERT_EQ(n, m.size());
+    ASSERT_EQ(false, m.contains(0));
+    ASSERT_EQ(false, m.contains(3 * n + 1));
+    for (int i = 1; i <= n; ++i)
+    {
+        ASSERT_EQ(true, m.contains(3 * i));
+        ASSERT_EQ(false, m.contains(3 * i + 1));
+        ASSERT_EQ(false, m.contains(3 * i - 1));
+        ASSERT_EQ(i, m[3 * i]);
+    }
+    ArraySeq<int> keys = m.find_keys(4, 15);
+    ASSERT_EQ(4, keys.size());
+    ASSERT_EQ(6, keys[0]);
+    ASSERT_EQ(15, keys[3]);
+    m.erase(3);
+    m.erase(3 * n);
+    ASSERT_EQ(false, m.contains(3));
+    ASSERT_EQ(false, m.contains(3 * n));
+    ASSERT_EQ(true, m.contains(6));
+    ASSERT_THROW(m.erase(3), std::out_of_range);
+}
+
+TEST(SearchPolicyTests, ClassicSearchCheck)
+{
+    BinSearchMap<int, int, ClassicSearch> m;
+    check_search_policy(m, 1000);
+}
+
+TEST(SearchPolicyTests, BranchlessSearchCheck)
+{
+    BinSearchMap<int, int, BranchlessSearch> m;
+    ASSERT_EQ(false, m.contains(1));
+    check_search_policy(m, 1000);
+    BinSearchMap<std::string, int, BranchlessSearch> s;
+    s.insert("m", 1);
+    s.insert("c", 2);
+    s.insert("x", 3);
+    ASSERT_EQ(true, s.contains("c"));
+    ASSERT_EQ(false, s.contains("d"));
+    ASSERT_EQ(3, s["x"]);
+}
+
+TEST(SearchPolicyTests, InterpolationSearchCheck)
+{
+    BinSearchMap<int, int, InterpolationSearch> m;
+    ASSERT_EQ(false, m.contains(1));
+    check_search_policy(m, 1000);
+    // skewed keys fall back to binary search
+    BinSearchMap<long, int, InterpolationSearch> skewed;
+    for (int i = 0; i < 60; ++i)
+        skewed.insert(1L << i, i);
+    for (int i = 0; i < 60; ++i)
+    {
+        ASSERT_EQ(true, skewed.contains(1L << i));
+        ASSERT_EQ(false, skewed.contains(3L << i));
+    }
+}
+
+//----------------------------------------------------------------------
+// Parallel Export Tests
+//----------------------------------------------------------------------
+
+TEST(ParallelExportTests, SortedKeysCheck)
+{
+    HashMap<int, int> m;
+    for (int i = 0; i < 100000; ++i)
+        m.insert((i * 7919) % 100000, i);
+    for (int threads : {1, 3, 4})
+    {
+        m.set_threads(threads);
+        ArraySeq<int> keys = m.sorted_keys();
+        ASSERT_EQ(100000, keys.size());
+        for (int i = 0; i < keys.size(); ++i)
+            ASSERT_EQ(i, keys[i]);
+    }
+}
+
+TEST(ParallelExportTests, FindKeysCheck)
+{
+    HashMap<int, int> m;
+    for (int i = 0; i < 100000; ++i)
+        m.insert(2 * i, i);
+    m.set_threads(4);
+    ArraySeq<int> keys = m.find_keys(1001, 60000);
+    ASSERT_EQ(29500, keys.size());
+    keys.merge_sort();
+    for (int i = 0; i < keys.size(); ++i)
+        ASSERT_EQ(1002 + 2 * i, keys[i]);
+    ASSERT_EQ(0, m.find_keys(-10, -1).size());
+}
+
+TEST(ParallelExportTests, SmallMapCheck)
+{
+    HashMap<int, int> m;
+    m.set_threads(8);
+    ASSERT_EQ(0, m.sorted_keys().size());
+    m.insert(3, 0);
+    m.insert(1, 0);
+    m.insert(2, 0);
+    ArraySeq<int> keys = m.sorted_keys();
+    ASSERT_EQ(3, keys.size());
+    ASSERT_EQ(1, keys[0]);
+    ASSERT_EQ(3, keys[2]);
+    ASSERT_EQ(2, m.find_keys(2, 5).size());
+}
+
+//----------------------------------------------------------------------
+// Red-Black Tree Map Tests
+//----------------------------------------------------------------------
+
+TEST(RBTreeMapTests, InsertAndAccessCheck)
+{
+    RBTreeMap<int, char> m;
+    ASSERT_EQ(true, m.empty());
+    ASSERT_EQ(0, m.height());
+    m.insert(20, 'a');
+    m.insert(10, 'b');
+    m.insert(30, 'c');
+    ASSERT_EQ(3, m.size());
+    ASSERT_EQ(true, m.contains(10));
+    ASSERT_EQ(false, m.contains(15));
+    ASSERT_EQ('c', m[30]);
+    m[30] = 'd';
+    ASSERT_EQ('d', m[30]);
+    ASSERT_THROW(m[15], std::out_of_range);
+    ASSERT_THROW(m.erase(15), std::out_of_range);
+    ASSERT_EQ(true, m.valid());
+}
+
+TEST(RBTreeMapTests, SortedInsertBalanceCheck)
+{
+    RBTreeMap<int, int> m;
+    for (int i = 0; i < 1023; ++i)
+    {
+        m.insert(i, i);
+        ASSERT_EQ(true, m.valid());
+    }
+    // height is at most 2 lg(n + 1)
+    ASSERT_LE(m.height(), 20);
+    ArraySeq<int> keys = m.sorted_keys();
+    ASSERT_EQ(1023, keys.size());
+    for (int i = 0; i < keys.size(); ++i)
+        ASSERT_EQ(i, keys[i]);
+    keys = m.find_keys(100, 199);
+    ASSERT_EQ(100, keys.size());
+    ASSERT_EQ(100, keys[0]);
+    ASSERT_EQ(199, keys[99]);
+}
+
+TEST(RBTreeMapTests, RandomEraseCheck)
+{
+    RBTreeMap<int, int> m;
+    const int n = 2000;
+    for (int i = 0; i < n; ++i)
+        m.insert((i * 7919) % n, i);
+    ASSERT_EQ(true, m.valid());
+    // erase every other key in a scattered order
+    for (int i = 0; i < n; ++i)
+    {
+        int key = (i * 4099) % n;
+        if (key % 2 == 0)
+        {
+            m.erase(key);
+            ASSERT_EQ(true, m.valid());
+        }
+    }
+    ASSERT_EQ(n / 2, m.size());
+    for (int i = 0; i < n; ++i)
+        ASSERT_EQ(i % 2 == 1, m.contains(i));
+    for (int i = 1; i < n; i += 2)
+        m.erase(i);
+    ASSERT_EQ(true, m.empty());
+    ASSERT_EQ(true, m.valid());
+}
+
+TEST(RBTreeMapTests, CopyAndMoveCheck)
+{
+    RBTreeMap<int, int> m1;
+    for (int i = 0; i < 100; ++i)
+        m1.insert(i, i * 2);
+    RBTreeMap<int, int> m2(m1);
+    ASSERT_EQ(true, m2.valid());
+    m2.erase(50);
+    ASSERT_EQ(true, m1.contains(50));
+    ASSERT_EQ(99, m2.size());
+    RBTreeMap<int, int> m3(std::move(m2));
+    ASSERT_EQ(0, m2.size());
+    ASSERT_EQ(99, m3.size());
+    ASSERT_EQ(true, m3.valid());
+    m1 = m3;
+    ASSERT_EQ(false, m1.contains(50));
+    ASSERT_EQ(true, m1.valid());
+    m2 = std::move(m1);
+    ASSERT_EQ(98, m2[49]);
+    ASSERT_EQ(true, m1.empty());
+}
+
+//----------------------------------------------------------------------
+// Splay Map Tests
+//----------------------------------------------------------------------
+
+TEST(SplayMapTests, InsertAndAccessCheck)
+{
+    SplayMap<int, char> m;
+    ASSERT_EQ(true, m.empty());
+    ASSERT_EQ(false, m.contains(1));
+    m.insert(20, 'a');
+    m.insert(10, 'b');
+    m.insert(30, 'c');
+    ASSERT_EQ(3, m.size());
+    ASSERT_EQ(true, m.contains(10));
+    ASSERT_EQ(false, m.contains(15));
+    ASSERT_EQ('c', m[30]);
+    m[30] = 'd';
+    const SplayMap<int, char> &cm = m;
+    ASSERT_EQ('d', cm[30]);
+    ASSERT_THROW(m[15], std::out_of_range);
+    ASSERT_THROW(cm[15], std::out_of_range);
+    ASSERT_THROW(m.erase(15), std::out_of_range);
+}
+
+TEST(SplayMapTests, AccessMovesKeyToRootCheck)
+{
+    SplayMap<int, int> m;
+    for (int i = 0; i < 1000; ++i)
+        m.insert((i * 7919) % 1000, i);
+    m.contains(500);
+    ASSERT_EQ(1, m.depth(500));
+    m[123];
+    ASSERT_EQ(1, m.depth(123));
+    // the previous root stays close by
+    ASSERT_LE(m.depth(500), 3);
+    ASSERT_EQ(0, m.depth(1000));
+}
+
+TEST(SplayMapTests, DeepTreeCheck)
+{
+    // sorted inserts build a path, which must not be walked recursively
+    SplayMap<int, int> m;
+    const int n = 200000;
+    for (int i = 0; i < n; ++i)
+        m.insert(i, i);
+    ASSERT_EQ(n, m.height());
+    ArraySeq<int> keys = m.sorted_keys();
+    ASSERT_EQ(n, keys.size());
+    ASSERT_EQ(n - 1, keys[n - 1]);
+    keys = m.find_keys(10, 19);
+    ASSERT_EQ(10, keys.size());
+    ASSERT_EQ(10, keys[0]);
+    SplayMap<int, int> copy(m);
+    ASSERT_EQ(n, copy.size());
+    // splaying the deepest key roughly halves the depth
+    ASSERT_EQ(true, m.contains(0));
+    ASSERT_LT(m.height(), n / 2 + 2);
+}
+
+TEST(SplayMapTests, EraseCheck)
+{
+    SplayMap<int, int> m;
+    const int n = 2000;
+    for (int i = 0; i < n; ++i)
+        m.insert((i * 7919) % n, i);
+    for (int i = 0; i < n; i += 2)
+        m.erase(i);
+    ASSERT_EQ(n / 2, m.size());
+    for (int i = 0; i < n; ++i)
+        ASSERT_EQ(i % 2 == 1, m.contains(i));
+    ArraySeq<int> keys = m.sorted_keys();
+    for (int i = 0; i < keys.size(); ++i)
+        ASSERT_EQ(2 * i + 1, keys[i]);
+    for (int i = 1; i < n; i += 2)
+        m.erase(i);
+    ASSERT_EQ(true, m.empty());
+    ASSERT_EQ(0, m.height());
+}
+
+TEST(SplayMapTests, CopyAndMoveCheck)
+{
+    SplayMap<int, int> m1;
+    for (int i = 0; i < 100; ++i)
+        m1.insert(i, i * 2);
+    SplayMap<int, int> m2(m1);
+    m2.erase(50);
+    ASSERT_EQ(true, m1.contains(50));
+    ASSERT_EQ(99, m2.size());
+    SplayMap<int, int> m3(std::move(m2));
+    ASSERT_EQ(0, m2.size());
+    ASSERT_EQ(99, m3.size());
+    m1 = m3;
+    ASSERT_EQ(false, m1.contains(50));
+    m2 = std::move(m1);
+    ASSERT_EQ(98, m2[49]);
+    ASSERT_EQ(true, m1.empty());
+}
+
+//----------------------------------------------------------------------
+// Build From Sorted Tests
+//----------------------------------------------------------------------
+
+// enough keys for four build threads
+const int build_n = 4 * 65536 + 77;
+
+TEST(BuildFromSortedTests, AVLMapBuildCheck)
+{
+    int *keys = new int[build_n];
+    int *values = new int[build_n];
+    for (int i = 0; i < build_n; ++i)
+    {
+        keys[i] = 2 * i;
+        values[i] = i;
+    }
+    for (int threads : {1, 4})
+    {
+        AVLMap<int, int> m;
+        m.insert(-5, 0);
+        m.set_threads(threads);
+        m.build_from_sorted(keys, values, build_n);
+        ASSERT_EQ(build_n, m.size());
+        ASSERT_EQ(19, m.height());
+        ASSERT_EQ(false, m.contains(-5));
+        ASSERT_EQ(500, m[1000]);
+        ArraySeq<int> sorted = m.sorted_keys();
+        for (int i = 0; i < build_n; ++i)
+            ASSERT_EQ(2 * i, sorted[i]);
+        // the heights set by the build keep later inserts balanced
+        for (int i = 0; i < 1000; ++i)
+            m.insert(2 * build_n + i, i);
+        ASSERT_EQ(19, m.height());
+    }
+    delete[] keys;
+    delete[] values;
+}
+
+TEST(BuildFromSortedTests, BSTMapBuildCheck)
+{
+    int *keys = new int[build_n];
+    int *values = new int[build_n];
+    for (int i = 0; i < build_n; ++i)
+    {
+        keys[i] = i;
+        values[i] = -i;
+    }
+    BSTMap<int, int> m;
+    m.set_threads(4);
+    m.build_from_sorted(keys, values, build_n);
+    ASSERT_EQ(build_n, m.size());
+    ASSERT_EQ(19, m.height());
+    ASSERT_EQ(-12345, m[12345]);
+    ASSERT_EQ(100, m.find_keys(1000, 1099).size());
+    m.build_from_sorted(keys, values, 0);
+    ASSERT_EQ(0, m.size());
+    ASSERT_EQ(0, m.height());
+    delete[] keys;
+    delete[] values;
+}
+
+// a key whose copy throws for one chosen value, to fail a build part
+// way through
+struct FragileKey
+{
+    static int fragile;
+    int value = 0;
+    FragileKey() = default;
+    FragileKey(int v) : value(v) {}
+    FragileKey(const FragileKey &rhs) : value(rhs.value) { check(); }
+    FragileKey &operator=(const FragileKey &rhs)
+    {
+        value = rhs.value;
+        check();
+        return *this;
+    }
+    void check() const
+    {
+        if (value == fragile)
+            throw std::runtime_error("fragile key");
+    }
+    bool operator<(const FragileKey &rhs) const { return value < rhs.value; }
+    bool operator>(const FragileKey &rhs) const { return value > rhs.value; }
+    bool operator<=(const FragileKey &rhs) const { return value <= rhs.value; }
+    bool operator>=(const FragileKey &rhs) const { return value >= rhs.value; }
+    bool operator==(const FragileKey &rhs) const { return value == rhs.value; }
+    bool operator!=(const FragileKey &rhs) const { return value != rhs.value; }
+};
+
+int FragileKey::fragile = -1;
+
+template <typename M>
+void check_failed_build(FragileKey *keys, int *values)
+{
+    // one failure in the left half (built on a new thread), one in the
+    // right half, and one at the root
+    for (int fragile : {10, build_n - 10, (build_n - 1) / 2})
+    {
+        M m;
+        m.insert(FragileKey(-5), 5);
+        m.set_threads(4);
+        FragileKey::fragile = fragile;
+        ASSERT_THROW(m.build_from_sorted(keys, values, build_n), std::runtime_error);
+        FragileKey::fragile = -1;
+        // the map is unchanged, and the partial subtrees were freed
+        ASSERT_EQ(1, m.size());
+        ASSERT_EQ(5, m[FragileKey(-5)]);
+    }
+}
+
+TEST(BuildFromSortedTests, FailedBuildCheck)
+{
+    FragileKey *keys = new FragileKey[build_n];
+    int *values = new int[build_n];
+    for (int i = 0; i < build_n; ++i)
+    {
+        keys[i] = FragileKey(i);
+        values[i] = i;
+    }
+    check_failed_build<AVLMap<FragileKey, int>>(keys, values);
+    check_failed_build<BSTMap<FragileKey, int>>(keys, values);
+    delete[] keys;
+    delete[] values;
+}
+
+TEST(BuildFromSortedTests, UnsortedKeysCheck)
+{
+    int keys[] = {1, 3, 3, 4};
+    int values[] = {0, 0, 0, 0};
+    AVLMap<int, int> avl;
+    BSTMap<int, int> bst;
+    avl.insert(7, 7);
+    ASSERT_THROW(avl.build_from_sorted(keys, values, 4), std::invalid_argument);
+    ASSERT_THROW(bst.build_from_sorted(keys, values, 4), std::invalid_argument);
+    // a failed build leaves the map unchanged
+    ASSERT_EQ(1, avl.size());
+    ASSERT_EQ(7, avl[7]);
+    avl.build_from_sorted(keys, values, 2);
+    ASSERT_EQ(2, avl.size());
+}
+
+//----------------------------------------------------------------------
+// Concurrent AVL Map Tests
+//----------------------------------------------------------------------
+
+TEST(ConcurrentAVLMapTests, BasicOperationsCheck)
+{
+    ConcurrentAVLMap<int, int> m;
+    ASSERT_EQ(true, m.empty());
+    for (int i = 0; i < 1000; ++i)
+        m.insert(i, 10 * i);
+    ASSERT_EQ(1000, m.size());
+    ASSERT_EQ(10, m.height());
+    ASSERT_EQ(120, m[12]);
+    m.update(12, -1);
+    ASSERT_EQ(-1, m[12]);
+    ASSERT_THROW(m[1000], std::out_of_range);
+    ASSERT_THROW(m.update(1000, 0), std::out_of_range);
+    ASSERT_THROW(m.erase(1000), std::out_of_range);
+    for (int i = 0; i < 1000; i += 2)
+        m.erase(i);
+    ASSERT_EQ(500, m.size());
+    ASSERT_EQ(false, m.contains(12));
+    ASSERT_EQ(true, m.contains(13));
+    ArraySeq<int> keys = m.sorted_keys();
+    for (int i = 0; i < keys.size(); ++i)
+        ASSERT_EQ(2 * i + 1, keys[i]);
+    ASSERT_EQ(5, m.find_keys(10, 20).size());
+    ASSERT_LE(m.height(), 10);
+}
+
+TEST(ConcurrentAVLMapTests, ReclaimsReplacedNodesCheck)
+{
+    // with no readers pinned, replaced nodes are freed within two
+    // writes of being retired
+    ConcurrentAVLMap<int, int> m;
+    for (int i = 0; i < 5000; ++i)
+    {
+        m.insert((i * 7919) % 5000, i);
+        ASSERT_LE(m.pending_frees(), 3 * m.height());
+    }
+    for (int i = 0; i < 5000; ++i)
+        m.erase(i);
+    ASSERT_EQ(0, m.size());
+}
+
+TEST(ConcurrentAVLMapTests, ReadersDuringWritesCheck)
+{
+    // even keys stay put while the writer inserts and erases odd keys;
+    // readers must always find the evens and see sorted snapshots
+    const int n = 2000;
+    ConcurrentAVLMap<int, int> m;
+    for (int i = 0; i < n; i += 2)
+        m.insert(i, i);
+    std::atomic<bool> done(false);
+    std::atomic<int> errors(0);
+    auto reader = [&](int seed)
+    {
+        int i = seed;
+        while (!done.load())
+        {
+            i = (i * 7919 + 13) % n;
+            int key = i - i % 2;
+            if (!m.contains(key) || m[key] != key)
+                ++errors;
+            if (i % 97 == 0)
+            {
+                ArraySeq<int> keys = m.find_keys(0, n);
+                for (int j = 0; j + 1 < keys.size(); ++j)
+                    if (!(keys[j] < keys[j + 1]))
+                        ++errors;
+                if (keys.size() < n / 2)
+                    ++errors;
+            }
+        }
+    };
+    std::thread r1(reader, 1);
+    std::thread r2(reader, 2);
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int i = 1; i < n; i += 2)
+            m.insert(i, i);
+        for (int i = 1; i < n; i += 2)
+            m.erase(i);
+    }
+    done.store(true);
+    r1.join();
+    r2.join();
+    ASSERT_EQ(0, errors.load());
+    ASSERT_EQ(n / 2, m.size());
+}
+
+TEST(ConcurrentSkipListMapTests, BasicOperationsCheck)
+{
+    ConcurrentSkipListMap<int, int> m;
+    ASSERT_EQ(true, m.empty());
+    for (int i = 0; i < 1000; ++i)
+        m.insert((i * 7919) % 1000, i);
+    ASSERT_EQ(1000, m.size());
+    m.insert(5, -5);
+    ASSERT_EQ(1000, m.size());
+    ASSERT_EQ(1, m[(7919) % 1000]);
+    m.update(12, -1);
+    ASSERT_EQ(-1, m[12]);
+    ASSERT_THROW(m[1000], std::out_of_range);
+    ASSERT_THROW(m.update(1000, 0), std::out_of_range);
+    ASSERT_THROW(m.erase(1000), std::out_of_range);
+    for (int i = 0; i < 1000; i += 2)
+        m.erase(i);
+    ASSERT_EQ(500, m.size());
+    ASSERT_THROW(m.erase(12), std::out_of_range);
+    ASSERT_EQ(false, m.contains(12));
+    ASSERT_EQ(true, m.contains(13));
+    ArraySeq<int> keys = m.sorted_keys();
+    ASSERT_EQ(500, keys.size());
+    for (int i = 0; i < keys.size(); ++i)
+        ASSERT_EQ(2 * i + 1, keys[i]);
+    keys = m.find_keys(10, 20);
+    ASSERT_EQ(5, keys.size());
+    ASSERT_EQ(11, keys[0]);
+    ASSERT_EQ(0, m.find_keys(2000, 3000).size());
+}
+
+TEST(ConcurrentSkipListMapTests, ConcurrentWritersCheck)
+{
+    // each writer inserts its own keys and erases half of them while
+    // the others do the same; every thread races on the shared towers
+    const int writers = 4;
+    const int n = 2000;
+    ConcurrentSkipListMap<int, int> m;
+    auto writer = [&](int w)
+    {
+        for (int i = 0; i < n; ++i)
+            m.insert(i * writers + w, w);
+        for (int i = 0; i < n; i += 2)
+            m.erase(i * writers + w);
+    };
+    std::thread threads[writers];
+    for (int w = 0; w < writers; ++w)
+        threads[w] = std::thread(writer, w);
+    for (int w = 0; w < writers; ++w)
+        threads[w].join();
+    ASSERT_EQ(writers * n / 2, m.size());
+    ArraySeq<int> keys = m.sorted_keys();
+    ASSERT_EQ(writers * n / 2, keys.size());
+    for (int i = 0; i < keys.size(); ++i)
+    {
+        int k = keys[i];
+        ASSERT_EQ(1, (k / writers) % 2);
+        ASSERT_EQ(k % writers, m[k]);
+        if (i > 0)
+            ASSERT_LT(keys[i - 1], k);
+    }
+}
+
+TEST(ConcurrentSkipListMapTests, RacingInsertEraseCheck)
+{
+    // two threads insert and erase the same odd keys, so inserts see
+    // present keys and erases lose races; the even keys stay put and
+    // scans must always find them in order
+    const int n = 2000;
+    ConcurrentSkipListMap<int, int> m;
+    for (int i = 0; i < n; i += 2)
+        m.insert(i, i);
+    std::atomic<bool> done(false);
+    std::atomic<int> errors(0);
+    auto churn = [&]()
+    {
+        for (int round = 0; round < 5; ++round)
+        {
+            for (int i = 1; i < n; i += 2)
+                m.insert(i, i);
+            for (int i = 1; i < n; i += 2)
+            {
+                try
+                {
+                    m.erase(i);
+                }
+                catch (std::out_of_range &)
+                {
+                }
+            }
+        }
+    };
+    auto reader = [&]()
+    {
+        while (!done.load())
+        {
+            ArraySeq<int> keys = m.find_keys(100, 300);
+            int evens = 0;
+            for (int j = 0; j < keys.size(); ++j)
+            {
+                if (j > 0 && !(keys[j - 1] < keys[j]))
+                    ++errors;
+                evens += keys[j] % 2 == 0;
+            }
+            if (evens != 101 || !m.contains(200) || m[200] != 200)
+                ++errors;
+        }
+    };
+    std::thread r(reader);
+    std::thread w1(churn);
+    std::thread w2(churn);
+    w1.join();
+    w2.join();
+    done.store(true);
+    r.join();
+    ASSERT_EQ(0, errors.load());
+    ASSERT_EQ(n / 2, m.size());
+    ASSERT_EQ(n / 2, m.sorted_keys().size());
+}
+
+TEST(ConcurrentSkipListMapTests, ReclaimsErasedNodesCheck)
+{
+    // with no other threads pinned, erased nodes are freed a few
+    // collects after being retired
+    ConcurrentSkipListMap<int, int> m;
+    for (int round = 0; round < 10; ++round)
+    {
+        for (int i = 0; i < 1000; ++i)
+            m.insert(i, i);
+        for (int i = 0; i < 1000; ++i)
+            m.update(i, -i);
+        for (int i = 0; i < 1000; ++i)
+            m.erase(i);
+        ASSERT_LE(m.pending_frees(), 100);
+    }
+    ASSERT_EQ(0, m.size());
+}
+
+TEST(PerfCounterTests, DegradesGracefullyCheck)
+{
+    // counters may be unavailable (no PMU, perf_event_paranoid, or a
+    // container), in which case they read as NaN; available ones
+    // count the region's work
+    PerfCounters counters;
+    // each region is scaled on its own, so later regions read the same
+    for (int region = 0; region < 3; ++region)
+    {
+        counters.start();
+        volatile long sum = 0;
+        for (int i = 0; i < 100000; ++i)
+            sum = sum + i;
+        PerfSample sample = counters.stop();
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e)
+        {
+            // an available event that never got a counter also reads
+            // as NaN
+            if (!counters.available(PerfEvent(e)))
+                ASSERT_TRUE(std::isnan(sample.count[e]));
+            else if (!std::isnan(sample.count[e]))
+                ASSERT_LE(0, sample.count[e]);
+        }
+        if (counters.available(PERF_INSTRUCTIONS) &&
+            !std::isnan(sample.count[PERF_INSTRUCTIONS]))
+        {
+            ASSERT_LT(100000, sample.count[PERF_INSTRUCTIONS]);
+            ASSERT_GT(10000000, sample.count[PERF_INSTRUCTIONS]);
+        }
+    }
+}
+
+TEST(PerfCounterTests, CountsWorkerThreadsCheck)
+{
+    PerfCounters counters;
+    // nothing to check where the counter is unavailable
+    if (!counters.available(PERF_INSTRUCTIONS))
+        return;
+    // the same work on a joined worker thread is counted
+    counters.start();
+    std::thread worker([]()
+    {
+        volatile long sum = 0;
+        for (int i = 0; i < 1000000; ++i)
+            sum = sum + i;
+    });
+    worker.join();
+    PerfSample sample = counters.stop();
+    if (std::isnan(sample.count[PERF_INSTRUCTIONS]))
+        return;
+    ASSERT_LT(1000000, sample.count[PERF_INSTRUCTIONS]);
+}
+
+TEST(LatencyHistogramTests, PercentileCheck)
+{
+    LatencyHistogram h;
+    ASSERT_EQ(0u, h.count());
+    ASSERT_EQ(0u, h.percentile(50));
+    ASSERT_THROW(h.percentile(101), std::invalid_argument);
+    // small values are exact
+    for (int v = 1; v <= 100; ++v)
+        h.record(v);
+    ASSERT_EQ(100u, h.count());
+    ASSERT_EQ(1u, h.min());
+    ASSERT_EQ(100u, h.max());
+    ASSERT_EQ(50u, h.percentile(50));
+    ASSERT_EQ(99u, h.percentile(99));
+    ASSERT_EQ(100u, h.percentile(100));
+    ASSERT_EQ(1u, h.percentile(0));
+    ASSERT_DOUBLE_EQ(50.5, h.mean());
+    // large values are within 1/128
+    h.reset();
+    for (std::uint64_t v = 1000; v <= 1000000; v += 1000)
+        h.record(v);
+    std::uint64_t p90 = h.percentile(90);
+    ASSERT_LE(900000u, p90);
+    ASSERT_GE(900000u + 900000u / 128, p90);
+    ASSERT_EQ(1000000u, h.percentile(100));
+    h.record(UINT64_MAX);
+    ASSERT_EQ(UINT64_MAX, h.max());
+    ASSERT_EQ(UINT64_MAX, h.percentile(100));
+}
+
+TEST(LatencyHistogramTests, MergeAndTimeCheck)
+{
+    LatencyHistogram a, b;
+    for (int i = 0; i < 1000; ++i)
+    {
+        a.record(10);
+        b.record(5000);
+    }
+    a.merge(b);
+    ASSERT_EQ(2000u, a.count());
+    ASSERT_EQ(10u, a.min());
+    ASSERT_EQ(5000u, a.max());
+    ASSERT_EQ(10u, a.percentile(50));
+    ASSERT_LE(4960u, a.percentile(51));
+    ASSERT_GE(5000u, a.percentile(51));
+    LatencyHistogram t;
+    volatile int sum = 0;
+    t.time([&]()
+           { for (int i = 0; i < 1000; ++i) sum = sum + i; });
+    ASSERT_EQ(1u, t.count());
+    ASSERT_LT(0u, t.max());
+}
+
+TEST(WorkloadTests, KeyDistributionsCheck)
+{
+    const long n = 1000;
+    const int draws = 100000;
+    ASSERT_THROW(KeyChooser(UNIFORM_KEYS, 0), std::invalid_argument);
+    ASSERT_THROW(KeyChooser(ZIPFIAN_KEYS, n, 1, 1.5), std::invalid_argument);
+    for (int d = 0; d < KEY_DISTRIBUTION_COUNT; ++d)
+    {
+        KeyChooser keys(KeyDistribution(d), n);
+        for (int i = 0; i < draws; ++i)
+        {
+            long r = keys.next();
+            ASSERT_LE(0, r);
+            ASSERT_GT(n, r);
+        }
+    }
+    // the most popular zipfian record gets far more than its share
+    KeyChooser zipf(ZIPFIAN_KEYS, n);
+    std::vector<int> hits(n);
+    for (int i = 0; i < draws; ++i)
+        ++hits[zipf.next()];
+    ASSERT_LT(20 * draws / n, *std::max_element(hits.begin(), hits.end()));
+    // latest favors the newest records, including added ones
+    KeyChooser latest(LATEST_KEYS, n);
+    ASSERT_EQ(n, latest.add_record());
+    int newest = 0;
+    for (int i = 0; i < draws; ++i)
+        newest += latest.next() >= n - 9;
+    ASSERT_LT(draws / 4, newest);
+    // hotspot sends 80% of the draws to the first 20% of records
+    KeyChooser hotspot(HOTSPOT_KEYS, n);
+    int hot = 0;
+    for (int i = 0; i < draws; ++i)
+        hot += hotspot.next() < n / 5;
+    ASSERT_NEAR(0.8, double(hot) / draws, 0.02);
+    // sequential ascends with small gaps and wraps around
+    KeyChooser seq(SEQUENTIAL_KEYS, n);
+    long prev = seq.next();
+    int wraps = 0;
+    for (int i = 0; i < 2000; ++i)
+    {
+        long r = seq.next();
+        if (r < prev)
+            ++wraps;
+        else
+            ASSERT_GE(18, r - prev);
+        prev = r;
+    }
+    ASSERT_LE(1, wraps);
+}
+
+TEST(WorkloadTests, RunWorkloadCheck)
+{
+    AVLMap<int, int> m;
+    load_records(m, 1000);
+    ASSERT_EQ(1000, m.size());
+    ASSERT_EQ(999, m[999]);
+    KeyChooser keys(UNIFORM_KEYS, 1000);
+    ASSERT_LT(0, run_workload(m, UPDATE_HEAVY, keys, 20));
+    ASSERT_EQ(1000, m.size());
+    ASSERT_LT(0, run_workload(m, INSERT_ONLY, keys, 20));
+    ASSERT_LT(1000, keys.count());
+    ASSERT_EQ(keys.count(), m.size());
+    ASSERT_EQ(true, m.contains(keys.count() - 1));
+}
+
+TEST(SmallArraySeqTests, InlineAndSpillCheck)
+{
+    SmallArraySeq<int, 4> s;
+    ASSERT_EQ(true, s.empty());
+    ASSERT_EQ(true, s.is_inline());
+    ASSERT_EQ(4, s.capacity());
+    for (int i = 0; i < 4; ++i)
+        s.insert(i, i);
+    ASSERT_EQ(true, s.is_inline());
+    s.insert(-1, 0);
+    ASSERT_EQ(false, s.is_inline());
+    ASSERT_EQ(8, s.capacity());
+    ASSERT_EQ(5, s.size());
+    for (int i = 0; i < 5; ++i)
+        ASSERT_EQ(i - 1, s[i]);
+    // inserting one of its own elements while full
+    for (int i = 5; i < 8; ++i)
+        s.insert(i - 1, i);
+    s.insert(s[0], 8);
+    ASSERT_EQ(-1, s[8]);
+    s.erase(8);
+    s.erase(0);
+    ASSERT_EQ(7, s.size());
+    ASSERT_EQ(0, s[0]);
+    ASSERT_EQ(true, s.contains(6));
+    ASSERT_EQ(false, s.contains(-1));
+    ASSERT_THROW(s[7], std::out_of_range);
+    ASSERT_THROW(s.insert(0, 8), std::out_of_range);
+    ASSERT_THROW(s.erase(-1), std::out_of_range);
+    SmallArraySeq<int, 4> r;
+    for (int i = 0; i < 10; ++i)
+        r.insert(10 - i, i);
+    r.sort();
+    for (int i = 0; i < 10; ++i)
+        ASSERT_EQ(i + 1, r[i]);
+}
+
+TEST(SmallArraySeqTests, CopyAndMoveCheck)
+{
+    SmallArraySeq<std::string, 2> small, big;
+    small.insert("a", 0);
+    for (int i = 0; i < 5; ++i)
+        big.insert(std::string(1, char('a' + i)), i);
+    // copies are deep, whether inline or spilled
+    SmallArraySeq<std::string, 2> c1(small), c2(big);
+    c1[0] = "z";
+    c2[0] = "z";
+    ASSERT_EQ("a", small[0]);
+    ASSERT_EQ("a", big[0]);
+    ASSERT_EQ(5, c2.size());
+    ASSERT_EQ(false, c2.is_inline());
+    c2 = small;
+    ASSERT_EQ(1, c2.size());
+    ASSERT_EQ("a", c2[0]);
+    // moving a spilled sequence steals its array
+    const std::string *heap = big.data();
+    SmallArraySeq<std::string, 2> m1(std::move(big));
+    ASSERT_EQ(heap, m1.data());
+    ASSERT_EQ(0, big.size());
+    ASSERT_EQ(true, big.is_inline());
+    big.insert("again", 0);
+    ASSERT_EQ("again", big[0]);
+    // moving an inline sequence moves the elements
+    SmallArraySeq<std::string, 2> m2(std::move(small));
+    ASSERT_EQ(true, m2.is_inline());
+    ASSERT_EQ("a", m2[0]);
+    ASSERT_EQ(0, small.size());
+    m2 = std::move(m1);
+    ASSERT_EQ(heap, m2.data());
+    ASSERT_EQ("e", m2[4]);
+    m2 = std::move(m2);
+    ASSERT_EQ(5, m2.size());
+}
+
+TEST(SmallArraySeqTests, SelfInsertCheck)
+{
+    // long strings, so a moved-from element is left empty
+    std::string first(40, 'a'), second(40, 'b');
+    SmallArraySeq<std::string, 4> s;
+    s.insert(second, 0);
+    s.insert(first, 0);
+    // inserting one of the sequence's own elements, with room to spare
+    s.insert(s[0], 0);
+    ASSERT_EQ(3, s.size());
+    ASSERT_EQ(first, s[0]);
+    ASSERT_EQ(first, s[1]);
+    ASSERT_EQ(second, s[2]);
+    s.insert(s[2], 1);
+    ASSERT_EQ(second, s[1]);
+    ASSERT_EQ(second, s[3]);
+    // and when the insert spills to the heap
+    s.insert(s[3], 0);
+    ASSERT_EQ(false, s.is_inline());
+    ASSERT_EQ(5, s.size());
+    ASSERT_EQ(second, s[0]);
+    ASSERT_EQ(second, s[4]);
+}
+
+TEST(SmallArraySeqTests, FindKeysIntoAnySequenceCheck)
+{
+    AVLMap<int, int> a;
+    BSTMap<int, int> b;
+    RBTreeMap<int, int> r;
+    for (int i = 0; i < 100; ++i)
+    {
+        int k = (i * 37) % 100;
+        a.insert(k, k);
+        b.insert(k, k);
+        r.insert(k, k);
+    }
+    SmallArraySeq<int, 16> sa, sb, sr;
+    a.find_keys(10, 19, sa);
+    b.find_keys(10, 19, sb);
+    r.find_keys(10, 19, sr);
+    ASSERT_EQ(true, sa.is_inline());
+    ASSERT_EQ(10, sa.size());
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_EQ(10 + i, sa[i]);
+        ASSERT_EQ(10 + i, sb[i]);
+        ASSERT_EQ(10 + i, sr[i]);
+    }
+    // results are appended
+    ArraySeq<int> keys;
+    keys.insert(-1, 0);
+    a.find_keys(98, 200, keys);
+    ASSERT_EQ(3, keys.size());
+    ASSERT_EQ(99, keys[2]);
+}
+
+//----------------------------------------------------------------------
+// AdaptiveMap Tests
+//----------------------------------------------------------------------
+
+typedef AdaptiveMap<int, int> IntAdaptiveMap;
+
+TEST(AdaptiveMapTests, LayoutTransitionsCheck)
+{
+    AdaptiveMap<int, int> m;
+    m.set_array_max(8);
+    m.set_tree_after_ranges(4);
+    ASSERT_EQ(IntAdaptiveMap::ARRAY_LAYOUT, m.layout());
+    for (int i = 0; i < 8; ++i)
+    {
+        m.insert(i, i * 10);
+    }
+    ASSERT_EQ(IntAdaptiveMap::ARRAY_LAYOUT, m.layout());
+    m.insert(8, 80);
+    ASSERT_EQ(IntAdaptiveMap::HASH_LAYOUT, m.layout());
+    // range queries turn the hash table into a tree
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_EQ(3, m.find_keys(2, 4).size());
+        ASSERT_EQ(IntAdaptiveMap::HASH_LAYOUT, m.layout());
+    }
+    ASSERT_EQ(3, m.find_keys(2, 4).size());
+    ASSERT_EQ(IntAdaptiveMap::TREE_LAYOUT, m.layout());
+    // shrinking below half of array_max returns to an array
+    for (int i = 0; i < 6; ++i)
+    {
+        m.erase(i);
+    }
+    ASSERT_EQ(IntAdaptiveMap::ARRAY_LAYOUT, m.layout());
+    ASSERT_EQ(3, m.size());
+    ASSERT_EQ(60, m[6]);
+    ASSERT_EQ(80, m[8]);
+}
+
+TEST(AdaptiveMapTests, OperationsAcrossLayoutsCheck)
+{
+    AdaptiveMap<int, int> m;
+    m.set_array_max(8);
+    ASSERT_EQ(true, m.empty());
+    for (int i = 0; i < 1000; ++i)
+    {
+        int k = (i * 37) % 1000;
+        m.insert(k, k + 1);
+        ASSERT_EQ(i + 1, m.size());
+        ASSERT_EQ(k + 1, m[k]);
+    }
+    ASSERT_EQ(IntAdaptiveMap::HASH_LAYOUT, m.layout());
+    ArraySeq<int> keys = m.sorted_keys();
+    ASSERT_EQ(IntAdaptiveMap::TREE_LAYOUT, m.layout());
+    ASSERT_EQ(1000, keys.size());
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(i, keys[i]);
+        ASSERT_EQ(i + 1, m[i]);
+    }
+    m[5] = 50;
+    const AdaptiveMap<int, int> &c = m;
+    ASSERT_EQ(50, c[5]);
+    ASSERT_EQ(false, m.contains(1000));
+    ASSERT_THROW(m[1000], std::out_of_range);
+    ASSERT_THROW(m.erase(1000), std::out_of_range);
+    for (int i = 0; i < 999; ++i)
+    {
+        m.erase(i);
+        ASSERT_EQ(false, m.contains(i));
+    }
+    ASSERT_EQ(IntAdaptiveMap::ARRAY_LAYOUT, m.layout());
+    ASSERT_EQ(1, m.size());
+    ASSERT_EQ(1000, m[999]);
+    m.erase(999);
+    ASSERT_EQ(true, m.empty());
+}
+
+TEST(AdaptiveMapTests, SettingsCheck)
+{
+    AdaptiveMap<int, int> m;
+    // by default up to 16 pairs stay in an array
+    for (int i = 0; i < 16; ++i)
+    {
+        m.insert(100 + i, i);
+    }
+    ASSERT_EQ(IntAdaptiveMap::ARRAY_LAYOUT, m.layout());
+    m.insert(116, 16);
+    ASSERT_EQ(IntAdaptiveMap::HASH_LAYOUT, m.layout());
+    for (int i = 0; i < 10; ++i)
+    {
+        m.erase(100 + i);
+    }
+    ASSERT_EQ(IntAdaptiveMap::ARRAY_LAYOUT, m.layout());
+    for (int i = 10; i <= 16; ++i)
+    {
+        m.erase(100 + i);
+    }
+    ASSERT_THROW(m.set_array_max(-1), std::invalid_argument);
+    ASSERT_THROW(m.set_tree_after_ranges(-1), std::invalid_argument);
+    for (int i = 0; i < 5; ++i)
+    {
+        m.insert(i, i);
+    }
+    // lowering the limit switches right away
+    m.set_array_max(4);
+    ASSERT_EQ(IntAdaptiveMap::HASH_LAYOUT, m.layout());
+    m.set_array_max(100);
+    ASSERT_EQ(IntAdaptiveMap::ARRAY_LAYOUT, m.layout());
+    // 0 never builds a tree
+    m.set_array_max(0);
+    m.set_tree_after_ranges(0);
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_EQ(5, m.find_keys(0, 10).size());
+    }
+    ASSERT_EQ(IntAdaptiveMap::HASH_LAYOUT, m.layout());
+    ASSERT_EQ(4, m[4]);
+}
+
+//----------------------------------------------------------------------
+// Column Store Tests
+//----------------------------------------------------------------------
+
+TEST(ColumnStoreTests, BinSearchMapSearchPoliciesCheck)
+{
+    BinSearchMap<int, int, ClassicSearch, ColumnStore> classic;
+    check_search_policy(classic, 1000);
+    BinSearchMap<int, int, BranchlessSearch, ColumnStore> branchless;
+    check_search_policy(branchless, 1000);
+    BinSearchMap<int, int, InterpolationSearch, ColumnStore> interpolation;
+    check_search_policy(interpolation, 1000);
+    BinSearchMap<std::string, int, ClassicSearch, ColumnStore> s;
+    s.insert("m", 1);
+    s.insert("c", 2);
+    s.append_sorted("x", 3);
+    ASSERT_THROW(s.append_sorted("a", 4), std::invalid_argument);
+    ASSERT_EQ(true, s.contains("c"));
+    ASSERT_EQ(false, s.contains("d"));
+    s["x"] = 30;
+    ASSERT_EQ(30, s["x"]);
+    ASSERT_EQ(3, s.size());
+}
+
+TEST(ColumnStoreTests, SnapshotAcrossLayoutsCheck)
+{
+    // both layouts write the same snapshot records
+    BinSearchMap<int, double> m1;
+    for (int i = 0; i < 50; ++i)
+        m1.insert((i * 17) % 50, i / 2.0);
+    m1.save(snapshot_file);
+    BinSearchMap<int, double, ClassicSearch, ColumnStore> m2;
+    m2.load(snapshot_file);
+    std::remove(snapshot_file);
+    ASSERT_EQ(50, m2.size());
+    for (int i = 0; i < 50; ++i)
+        ASSERT_EQ(i / 2.0, m2[(i * 17) % 50]);
+    m2.save(snapshot_file);
+    BinSearchMap<int, double> m3;
+    m3.load(snapshot_file);
+    std::remove(snapshot_file);
+    ASSERT_EQ(50, m3.size());
+    ASSERT_EQ(24.5, m3[(49 * 17) % 50]);
+}
+
+TEST(ColumnStoreTests, ArrayMapCheck)
+{
+    ArrayMap<int, std::string, ColumnStore> m;
+    ASSERT_EQ(true, m.empty());
+    for (int i = 0; i < 20; ++i)
+        m.insert((i * 7) % 20, std::to_string(i));
+    ASSERT_EQ(20, m.size());
+    for (int i = 0; i < 20; ++i)
+        ASSERT_EQ(std::to_string(i), m[(i * 7) % 20]);
+    m[7] = "seven";
+    ASSERT_EQ("seven", m[7]);
+    m.erase(0);
+    m.erase(19);
+    ASSERT_EQ(false, m.contains(0));
+    ASSERT_EQ(false, m.contains(19));
+    ASSERT_THROW(m.erase(0), std::out_of_range);
+    ASSERT_THROW(m[19], std::out_of_range);
+    // erasing keeps keys and values lined up
+    for (int i = 1; i < 20; ++i)
+    {
+        int k = (i * 7) % 20;
+        if (k != 0 && k != 19 && k != 7)
+            ASSERT_EQ(std::to_string(i), m[k]);
+    }
+    ArraySeq<int> keys = m.find_keys(5, 8);
+    ASSERT_EQ(4, keys.size());
+    ASSERT_EQ(5, keys[0]);
+    ASSERT_EQ(8, keys[3]);
+}
+
+//----------------------------------------------------------------------
+// Move-Aware Insert and Heterogeneous Lookup Tests
+//----------------------------------------------------------------------
+
+// a value that counts its copies
+struct Tracked
+{
+    static int copies;
+    std::string text;
+    Tracked() {}
+    Tracked(const char *text) : text(text) {}
+    Tracked(const Tracked &rhs) : text(rhs.text) { ++copies; }
+    Tracked(Tracked &&rhs) = default;
+    Tracked &operator=(const Tracked &rhs) { text = rhs.text; ++copies; return *this; }
+    Tracked &operator=(Tracked &&rhs) = default;
+};
+
+int Tracked::copies = 0;
+
+// comparisons required by ArraySeq's sort members
+bool operator==(const Tracked &lhs, const Tracked &rhs) { return lhs.text == rhs.text; }
+bool operator<(const Tracked &lhs, const Tracked &rhs) { return lhs.text < rhs.text; }
+bool operator<=(const Tracked &lhs, const Tracked &rhs) { return lhs.text <= rhs.text; }
+
+// keys long enough to live on the heap
+std::string long_key(int i)
+{
+    return "a key that does not fit inline " + std::to_string(i);
+}
+
+template <typename M>
+void check_move_aware(M &m)
+{
+    Tracked::copies = 0;
+    for (int i = 0; i < 50; i += 2)
+    {
+        std::string key = long_key(i);
+        Tracked value("value");
+        m.insert(std::move(key), std::move(value));
+        ASSERT_EQ(true, key.empty());
+    }
+    for (int i = 1; i < 50; i += 2)
+        m.emplace(long_key(i), "emplaced");
+    ASSERT_EQ(0, Tracked::copies);
+    ASSERT_EQ(50, m.size());
+    ASSERT_EQ("value", m[long_key(10)].text);
+    ASSERT_EQ("emplaced", m[long_key(11)].text);
+    // a present key leaves the key and args alone
+    std::string key = long_key(20);
+    Tracked value("other");
+    ASSERT_EQ(false, m.try_emplace(std::move(key), std::move(value)));
+    ASSERT_EQ(long_key(20), key);
+    ASSERT_EQ("other", value.text);
+    ASSERT_EQ("value", m[long_key(20)].text);
+    ASSERT_EQ(true, m.try_emplace(long_key(50), "new"));
+    ASSERT_EQ(51, m.size());
+    ASSERT_EQ("new", m[long_key(50)].text);
+    // copying insert still copies
+    m.insert(long_key(60), value);
+    ASSERT_EQ(1, Tracked::copies);
+    for (int i = 0; i <= 50; ++i)
+        ASSERT_EQ(true, m.contains(long_key(i)));
+}
+
+template <typename M>
+void check_heterogeneous(M &m)
+{
+    for (int i = 0; i < 50; ++i)
+        m.insert(long_key(i), i);
+    for (int i = 0; i < 50; ++i)
+    {
+        std::string key = long_key(i);
+        std::string_view view(key);
+        ASSERT_EQ(true, m.contains(view));
+        ASSERT_EQ(i, m[view]);
+        const M &cm = m;
+        ASSERT_EQ(i, cm[view]);
+    }
+    std::string_view view("a key that does not fit inline");
+    ASSERT_EQ(false, m.contains(view));
+    ASSERT_THROW(m[view], std::out_of_range);
+    m[std::string_view(long_key(3))] = 300;
+    ASSERT_EQ(300, m[long_key(3)]);
+}
+
+TEST(MoveAwareTests, MoveInsertAndEmplaceCheck)
+{
+    { BinSearchMap<std::string, Tracked> m; check_move_aware(m); }
+    { BinSearchMap<std::string, Tracked, ClassicSearch, ColumnStore> m; check_move_aware(m); }
+    { ArrayMap<std::string, Tracked> m; check_move_aware(m); }
+    { ArrayMap<std::string, Tracked, ColumnStore> m; check_move_aware(m); }
+    { HashMap<std::string, Tracked> m; check_move_aware(m); }
+    { BSTMap<std::string, Tracked> m; check_move_aware(m); }
+    { AVLMap<std::string, Tracked> m; check_move_aware(m); }
+    { RBTreeMap<std::string, Tracked> m; check_move_aware(m); }
+    { SplayMap<std::string, Tracked> m; check_move_aware(m); }
+    { BloomMap<std::string, Tracked, AVLMap<std::string, Tracked>> m; check_move_aware(m); }
+    { AdaptiveMap<std::string, Tracked> m; check_move_aware(m); }
+}
+
+TEST(MoveAwareTests, HeterogeneousLookupCheck)
+{
+    { BinSearchMap<std::string, int> m; check_heterogeneous(m); }
+    { BinSearchMap<std::string, int, BranchlessSearch, ColumnStore> m; check_heterogeneous(m); }
+    { ArrayMap<std::string, int> m; check_heterogeneous(m); }
+    { HashMap<std::string, int> m; check_heterogeneous(m); }
+    { BSTMap<std::string, int> m; check_heterogeneous(m); }
+    { AVLMap<std::string, int> m; check_heterogeneous(m); }
+    { RBTreeMap<std::string, int> m; check_heterogeneous(m); }
+    { SplayMap<std::string, int> m; check_heterogeneous(m); }
+    { BloomMap<std::string, int, BSTMap<std::string, int>> m; check_heterogeneous(m); }
+    { AdaptiveMap<std::string, int> m; check_heterogeneous(m); }
+}
+
+// try_emplace with a key type that converts to K but is not a
+// transparent lookup type
+template <typename M>
+void check_converting_emplace(M &m)
+{
+    for (int i = 0; i < 100; ++i)
+        m.insert(std::to_string(i), i);
+    std::string s = "7";
+    ASSERT_EQ(false, m.try_emplace(s.c_str(), 1));
+    ASSERT_EQ(100, m.size());
+    ASSERT_EQ(7, m["7"]);
+    s = "100";
+    ASSERT_EQ(true, m.try_emplace(s.c_str(), 1));
+    ASSERT_EQ(101, m.size());
+    ASSERT_EQ(1, m["100"]);
+}
+
+TEST(MoveAwareTests, ConvertingEmplaceCheck)
+{
+    { BinSearchMap<std::string, int> m; check_converting_emplace(m); }
+    { ArrayMap<std::string, int> m; check_converting_emplace(m); }
+    { HashMap<std::string, int> m; check_converting_emplace(m); }
+    { BSTMap<std::string, int> m; check_converting_emplace(m); }
+    { AVLMap<std::string, int> m; check_converting_emplace(m); }
+    { RBTreeMap<std::string, int> m; check_converting_emplace(m); }
+    { SplayMap<std::string, int> m; check_converting_emplace(m); }
+    { BloomMap<std::string, int, HashMap<std::string, int>> m; check_converting_emplace(m); }
+    { AdaptiveMap<std::string, int> m; check_converting_emplace(m); }
+}
+
+TEST(MoveAwareTests, NegativeHashKeysCheck)
+{
+    // keys whose std::hash is negative as an int index a bucket
+    HashMap<int, int> m;
+    for (int i = -500; i < 500; ++i)
+        m.insert(i, i * 2);
+    for (int i = -500; i < 500; ++i)
+        ASSERT_EQ(i * 2, m[i]);
+    HashMap<long, int> big;
+    big.insert(-1L, 1);
+    big.insert(0x80000000L, 2);
+    ASSERT_EQ(1, big[-1L]);
+    ASSERT_EQ(2, big[0x80000000L]);
+}
+
+//----------------------------------------------------------------------
+// Single-Pass Find, Upsert, and Erase Tests
+//----------------------------------------------------------------------
+
+template <typename M>
+void check_single_pass(M &m)
+{
+    // find does not throw
+    ASSERT_EQ(nullptr, m.find(1));
+    ASSERT_EQ(false, m.try_erase(1));
+    // counting with get_or_insert_default
+    for (int i = 0; i < 300; ++i)
+        m.get_or_insert_default(i % 100) += 1;
+    ASSERT_EQ(100, m.size());
+    for (int i = 0; i < 100; ++i)
+        ASSERT_EQ(3, m[i]);
+    ASSERT_EQ(0, m.get_or_insert_default(500));
+    ASSERT_EQ(101, m.size());
+    // insert_or_assign adds, then assigns
+    ASSERT_EQ(true, m.insert_or_assign(600, 6));
+    ASSERT_EQ(false, m.insert_or_assign(600, 60));
+    ASSERT_EQ(60, m[600]);
+    ASSERT_EQ(102, m.size());
+    int *value = m.find(600);
+    ASSERT_NE(nullptr, value);
+    *value = 61;
+    const M &cm = m;
+    ASSERT_EQ(61, *cm.find(600));
+    ASSERT_EQ(nullptr, cm.find(601));
+    // try_erase reports, erase still throws
+    for (int i = 0; i < 100; i += 2)
+        ASSERT_EQ(true, m.try_erase(i));
+    for (int i = 0; i < 100; i += 2)
+        ASSERT_EQ(false, m.try_erase(i));
+    ASSERT_THROW(m.erase(0), std::out_of_range);
+    ASSERT_EQ(52, m.size());
+    for (int i = 0; i < 100; ++i)
+        ASSERT_EQ(i % 2 == 1, m.contains(i));
+    ASSERT_EQ(true, m.try_erase(500));
+    ASSERT_EQ(true, m.try_erase(600));
+    ASSERT_EQ(50, m.size());
+}
+
+template <typename M>
+void check_against_std_map(M &m)
+{
+    std::map<int, int> ref;
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> key(0, 199);
+    for (int i = 0; i < 5000; ++i)
+    {
+        int k = key(gen);
+        switch (i % 4)
+        {
+        case 0:
+            m.get_or_insert_default(k) += i;
+            ref[k] += i;
+            break;
+        case 1:
+            ASSERT_EQ(ref.count(k) == 0, m.insert_or_assign(k, i));
+            ref[k] = i;
+            break;
+        case 2:
+            ASSERT_EQ(ref.erase(k) == 1, m.try_erase(k));
+            break;
+        default:
+        {
+            int *value = m.find(k);
+            ASSERT_EQ(ref.count(k) == 1, value != nullptr);
+            if (value != nullptr)
+                ASSERT_EQ(ref[k], *value);
+        }
+        }
+        ASSERT_EQ((int)ref.size(), m.size());
+    }
+    ArraySeq<int> keys = m.sorted_keys();
+    ASSERT_EQ((int)ref.size(), keys.size());
+    int i = 0;
+    for (auto &p : ref)
+    {
+        ASSERT_EQ(p.first, keys[i++]);
+        ASSERT_EQ(p.second, m[p.first]);
+    }
+}
+
+TEST(SinglePassTests, HashMapLoadFactorCheck)
+{
+    // the table grows once the load factor passes 0.75, whichever
+    // insert path adds the keys (the check comes before the new key,
+    // so a 16-bucket table can reach 13 / 16)
+    HashMap<int, int> a, b, c;
+    for (int i = 0; i < 1000; ++i)
+    {
+        a.insert(i, i);
+        b.get_or_insert_default(i) = i;
+        c.insert_or_assign(i, i);
+        ASSERT_LE(a.avg_chain_length(), 0.8125);
+        ASSERT_LE(b.avg_chain_length(), 0.8125);
+        ASSERT_LE(c.avg_chain_length(), 0.8125);
+    }
+}
+
+TEST(SinglePassTests, FindUpsertEraseCheck)
+{
+    { BinSearchMap<int, int> m; check_single_pass(m); }
+    { BinSearchMap<int, int, BranchlessSearch, ColumnStore> m; check_single_pass(m); }
+    { ArrayMap<int, int> m; check_single_pass(m); }
+    { ArrayMap<int, int, ColumnStore> m; check_single_pass(m); }
+    { HashMap<int, int> m; check_single_pass(m); }
+    { BSTMap<int, int> m; check_single_pass(m); }
+    { AVLMap<int, int> m; check_single_pass(m); }
+    { RBTreeMap<int, int> m; check_single_pass(m); }
+    { SplayMap<int, int> m; check_single_pass(m); }
+    { BloomMap<int, int, BSTMap<int, int>> m; check_single_pass(m); }
+    { AdaptiveMap<int, int> m; check_single_pass(m); }
+}
+
+TEST(SinglePassTests, RandomOperationsCheck)
+{
+    { BinSearchMap<int, int> m; check_against_std_map(m); }
+    { ArrayMap<int, int> m; check_against_std_map(m); }
+    { HashMap<int, int> m; check_against_std_map(m); }
+    { BSTMap<int, int> m; check_against_std_map(m); }
+    { AVLMap<int, int> m; check_against_std_map(m); ASSERT_LE(m.height(), 11); }
+    { RBTreeMap<int, int> m; check_against_std_map(m); ASSERT_EQ(true, m.valid()); }
+    { SplayMap<int, int> m; check_against_std_map(m); }
+    { BloomMap<int, int, AVLMap<int, int>> m; check_against_std_map(m); }
+    { AdaptiveMap<int, int> m; m.set_array_max(64); check_against_std_map(m); }
+}
+
+TEST(SinglePassTests, ThroughMapReferenceCheck)
+{
+    // the new members are virtual, so they work through Map&
+    AdaptiveMap<std::string, int> adaptive;
+    RBTreeMap<std::string, int> rbtree;
+    Map<std::string, int> *maps[] = {&adaptive, &rbtree};
+    for (Map<std::string, int> *m : maps)
+    {
+        const char *words[] = {"a", "b", "a", "c", "a", "b"};
+        for (const char *w : words)
+            m->get_or_insert_default(w)++;
+        ASSERT_EQ(3, m->size());
+        ASSERT_EQ(3, *m->find("a"));
+        ASSERT_EQ(2, *m->find("b"));
+        ASSERT_EQ(nullptr, m->find("d"));
+        ASSERT_EQ(true, m->try_erase("c"));
+        ASSERT_EQ(false, m->try_erase("c"));
+    }
+}
+
 //----------------------------------------------------------------------
 // Main
 //----------------------------------------------------------------------
@@ -0,0 +1,178 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_upsert_perf.cpp
+// DATE: Fall 2021
+// DESC: Performance test driver for the single-pass map members. Each
+//       map keeps a counter per key and is updated with uniformly
+//       random keys, either by contains followed by operator[] or
+//       insert (two searches) or by get_or_insert_default (one). Keys
+//       are then erased by contains followed by erase or by try_erase,
+//       and looked up (half of them missing) by operator[] with a
+//       try/catch or by find. To run from the command line use:
+//          ./hw8_upsert_perf
+//       To save this data to a file, run the command:
+//          ./hw8_upsert_perf > upsert_output.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include "hashmap.h"
+#include "avlmap.h"
+#include "rbtreemap.h"
+#include "splaymap.h"
+#include "binsearchmap.h"
+
+using namespace std;
+using namespace std::chrono;
+
+template <typename M>
+void run(int id, int n);
+
+// test parameters
+const int sizes[] = {1000, 100000};
+const int updates = 500000;
+const int lookups = 100000;
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    // output data header
+    cout << "# All rates in million operations per second" << endl;
+    cout << "# Column 1 = map (1 = hash, 2 = AVL, 3 = red-black, 4 = splay, 5 = binsearch)" << endl;
+    cout << "# Column 2 = number of distinct keys" << endl;
+    cout << "# Column 3 = counter update by contains + operator[] or insert" << endl;
+    cout << "# Column 4 = counter update by get_or_insert_default" << endl;
+    cout << "# Column 5 = erase by contains + erase" << endl;
+    cout << "# Column 6 = erase by try_erase" << endl;
+    cout << "# Column 7 = lookup (half missing) by operator[] + catch" << endl;
+    cout << "# Column 8 = lookup (half missing) by find" << endl;
+
+    for (int n : sizes)
+    {
+        run<HashMap<int, long>>(1, n);
+        run<AVLMap<int, long>>(2, n);
+        run<RBTreeMap<int, long>>(3, n);
+        run<SplayMap<int, long>>(4, n);
+        // inserts into a sorted array shift half of it on average, so
+        // the binsearch map only runs at the small size
+        if (n <= 1000)
+        {
+            run<BinSearchMap<int, long>>(5, n);
+        }
+    }
+}
+
+// rate of ops operations taking the time between t0 and t1
+double rate(int ops, high_resolution_clock::time_point t0,
+            high_resolution_clock::time_point t1)
+{
+    double secs = duration_cast<microseconds>(t1 - t0).count() / 1000000.0;
+    return ops / secs / 1000000.0;
+}
+
+// times each pair of (two-search, single-pass) idioms on a map M with
+// keys drawn from [0, n)
+template <typename M>
+void run(int id, int n)
+{
+    mt19937 gen(42);
+    uniform_int_distribution<int> dist(0, n - 1);
+    int *keys = new int[updates];
+    for (int i = 0; i < updates; ++i)
+    {
+        keys[i] = dist(gen);
+    }
+    long check = 0;
+    cout << id << " " << n;
+
+    // counter updates
+    M two_pass;
+    auto t0 = high_resolution_clock::now();
+    for (int i = 0; i < updates; ++i)
+    {
+        if (two_pass.contains(keys[i]))
+        {
+            two_pass[keys[i]] += 1;
+        }
+        else
+        {
+            two_pass.insert(keys[i], 1);
+        }
+    }
+    auto t1 = high_resolution_clock::now();
+    cout << " " << rate(updates, t0, t1);
+    M one_pass;
+    t0 = high_resolution_clock::now();
+    for (int i = 0; i < updates; ++i)
+    {
+        one_pass.get_or_insert_default(keys[i]) += 1;
+    }
+    t1 = high_resolution_clock::now();
+    cout << " " << rate(updates, t0, t1);
+
+    // lookups of keys in [0, 2n), about half of them missing (done
+    // before the erases so the maps still hold every key)
+    uniform_int_distribution<int> wide(0, 2 * n - 1);
+    for (int i = 0; i < lookups; ++i)
+    {
+        keys[i] = wide(gen);
+    }
+    t0 = high_resolution_clock::now();
+    for (int i = 0; i < lookups; ++i)
+    {
+        try
+        {
+            check += two_pass[keys[i]];
+        }
+        catch (const out_of_range &)
+        {
+            --check;
+        }
+    }
+    t1 = high_resolution_clock::now();
+    double catch_rate = rate(lookups, t0, t1);
+    t0 = high_resolution_clock::now();
+    for (int i = 0; i < lookups; ++i)
+    {
+        const long *value = one_pass.find(keys[i]);
+        check += value != nullptr ? *value : -1;
+    }
+    t1 = high_resolution_clock::now();
+    double find_rate = rate(lookups, t0, t1);
+
+    // erases of random keys, some already gone
+    for (int i = 0; i < n; ++i)
+    {
+        keys[i] = dist(gen);
+    }
+    t0 = high_resolution_clock::now();
+    for (int i = 0; i < n; ++i)
+    {
+        if (two_pass.contains(keys[i]))
+        {
+            two_pass.erase(keys[i]);
+        }
+    }
+    t1 = high_resolution_clock::now();
+    cout << " " << rate(n, t0, t1);
+    t0 = high_resolution_clock::now();
+    for (int i = 0; i < n; ++i)
+    {
+        one_pass.try_erase(keys[i]);
+    }
+    t1 = high_resolution_clock::now();
+    cout << " " << rate(n, t0, t1);
+
+    cout << " " << catch_rate << " " << find_rate << endl;
+    delete[] keys;
+    if (two_pass.size() != one_pass.size() || check == 1)
+    {
+        cerr << "maps differ" << endl;
+    }
+}
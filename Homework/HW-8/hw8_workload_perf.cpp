@@ -0,0 +1,102 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_workload_perf.cpp
+// DATE: Fall 2021
+// DESC: Throughput of each map under the workload mixes of
+//       workload.h (read-heavy, update-heavy, scan-heavy, and
+//       insert-only) with each key distribution (uniform, zipfian,
+//       latest, hotspot, and sequential with gaps). Every run starts
+//       from a freshly loaded map and lasts run_msec. To run from the
+//       command line use:
+//          ./hw8_workload_perf
+//       To save this data to a file, run the command:
+//          ./hw8_workload_perf > workload_output.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <memory>
+#include "map.h"
+#include "binsearchmap.h"
+#include "hashmap.h"
+#include "bstmap.h"
+#include "avlmap.h"
+#include "rbtreemap.h"
+#include "splaymap.h"
+#include "workload.h"
+
+using namespace std;
+
+// test parameters
+const long records = 100000;
+const int run_msec = 250;
+const int scan_length = 100;
+const OperationMix mixes[] = {READ_HEAVY, UPDATE_HEAVY, SCAN_HEAVY, INSERT_ONLY};
+
+// the maps under test
+struct Structure
+{
+    const char *name;
+    function<Map<int, int> *()> make;
+};
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    const Structure structures[] = {
+        {"binsearch map", []()
+         { return new BinSearchMap<int, int>(); }},
+        {"hash map", []()
+         { return new HashMap<int, int>(); }},
+        {"bst map", []()
+         { return new BSTMap<int, int>(); }},
+        {"avl map", []()
+         { return new AVLMap<int, int>(); }},
+        {"rb tree map", []()
+         { return new RBTreeMap<int, int>(); }},
+        {"splay map", []()
+         { return new SplayMap<int, int>(); }}};
+
+    // output data header
+    cout << "# Operations per second (thousands), " << records
+         << " records loaded, " << run_msec << " msec per run" << endl;
+    cout << "# Column 1 = mix (";
+    for (int i = 0; i < 4; ++i)
+    {
+        cout << (i ? ", " : "") << i + 1 << " = " << mixes[i].name << " "
+             << mixes[i].reads << "/" << mixes[i].updates << "/"
+             << mixes[i].scans << "/" << mixes[i].inserts;
+    }
+    cout << " read/update/scan/insert)" << endl;
+    cout << "# Column 2 = key distribution (";
+    for (int d = 0; d < KEY_DISTRIBUTION_COUNT; ++d)
+    {
+        cout << (d ? ", " : "") << d + 1 << " = " << key_distribution_names[d];
+    }
+    cout << ")" << endl;
+    int column = 3;
+    for (const Structure &s : structures)
+    {
+        cout << "# Column " << column++ << " = " << s.name << endl;
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int d = 0; d < KEY_DISTRIBUTION_COUNT; ++d)
+        {
+            cout << i + 1 << " " << d + 1;
+            for (const Structure &s : structures)
+            {
+                unique_ptr<Map<int, int>> m(s.make());
+                load_records(*m, records);
+                KeyChooser keys(KeyDistribution(d), records);
+                cout << " " << run_workload(*m, mixes[i], keys, run_msec, scan_length) / 1000;
+            }
+            cout << endl;
+        }
+    }
+}
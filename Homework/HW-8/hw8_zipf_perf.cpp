@@ -0,0 +1,121 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw8_zipf_perf.cpp
+// DATE: Fall 2021
+// DESC: Performance test driver comparing the tree maps on uniform
+//       (shuffled) and skewed (Zipfian) lookups. Each map is loaded
+//       with the same shuffled keys as hw8_perf, then probed with
+//       keys drawn uniformly and from a Zipf(0.99)
+//       distribution over the keys. To run from the command line use:
+//          ./hw8_zipf_perf
+//       To save this data to a file, run the command:
+//          ./hw8_zipf_perf > zipf_output.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include "util.h"
+#include "arrayseq.h"
+#include "map.h"
+#include "bstmap.h"
+#include "avlmap.h"
+#include "rbtreemap.h"
+#include "splaymap.h"
+
+using namespace std;
+using namespace std::chrono;
+
+double timed_lookups(const Map<int, int> &m, const ArraySeq<int> &probes);
+
+// test parameters
+const int sizes[] = {10000, 50000, 100000};
+const int lookups = 1000000;
+const double skew = 0.99;
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    // output data header
+    cout << "# All times in milliseconds (msec) for all lookups" << endl;
+    cout << "# Column 1 = input data size" << endl;
+    cout << "# Column 2 = bst map uniform lookups" << endl;
+    cout << "# Column 3 = avl map uniform lookups" << endl;
+    cout << "# Column 4 = rb tree map uniform lookups" << endl;
+    cout << "# Column 5 = splay map uniform lookups" << endl;
+    cout << "# Column 6 = bst map zipfian lookups" << endl;
+    cout << "# Column 7 = avl map zipfian lookups" << endl;
+    cout << "# Column 8 = rb tree map zipfian lookups" << endl;
+    cout << "# Column 9 = splay map zipfian lookups" << endl;
+    cout << "# Column 10 = splay map average depth of zipfian lookups" << endl;
+
+    for (int n : sizes)
+    {
+        // shuffled keys, as in hw8_perf
+        ArraySeq<int> keys;
+        keys.reserve(n);
+        for (int i = 1; i <= n; ++i)
+        {
+            keys.insert(2 * i, keys.size());
+        }
+        faro_shuffle(keys, 7);
+
+        // uniform probes cycle through the keys, zipfian probes map
+        // each drawn rank to a key (so the hot keys are scattered)
+        ArraySeq<int> ranks, uniform, zipf;
+        load_zipfian(ranks, lookups, n, skew);
+        uniform.reserve(lookups);
+        zipf.reserve(lookups);
+        for (int i = 0; i < lookups; ++i)
+        {
+            uniform.insert(keys[(int)((i * 7919L) % n)], i);
+            zipf.insert(keys[ranks[i] - 1], i);
+        }
+
+        BSTMap<int, int> m1;
+        AVLMap<int, int> m2;
+        RBTreeMap<int, int> m3;
+        SplayMap<int, int> m4;
+        for (int i = 0; i < n; ++i)
+        {
+            m1.insert(keys[i], i);
+            m2.insert(keys[i], i);
+            m3.insert(keys[i], i);
+            m4.insert(keys[i], i);
+        }
+
+        cout << n;
+        cout << " " << timed_lookups(m1, uniform);
+        cout << " " << timed_lookups(m2, uniform);
+        cout << " " << timed_lookups(m3, uniform);
+        cout << " " << timed_lookups(m4, uniform);
+        cout << " " << timed_lookups(m1, zipf);
+        cout << " " << timed_lookups(m2, zipf);
+        cout << " " << timed_lookups(m3, zipf);
+        cout << " " << timed_lookups(m4, zipf);
+
+        // depth of each zipfian key just before it is looked up
+        long total_depth = 0;
+        for (int i = 0; i < lookups; ++i)
+        {
+            total_depth += m4.depth(zipf[i]);
+            m4.contains(zipf[i]);
+        }
+        cout << " " << (double)total_depth / lookups << endl;
+    }
+}
+
+// looks up each probe key in the map
+double timed_lookups(const Map<int, int> &m, const ArraySeq<int> &probes)
+{
+    auto t0 = high_resolution_clock::now();
+    for (int i = 0; i < probes.size(); ++i)
+    {
+        m.contains(probes[i]);
+    }
+    auto t1 = high_resolution_clock::now();
+    return duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+}
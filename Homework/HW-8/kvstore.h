@@ -0,0 +1,289 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: kvstore.h
+// DATE: Fall 2021
+// DESC: Storage policies for the array-based maps (BinSearchMap and
+//       ArrayMap), which keep their key-value pairs in index order.
+//       PairStore keeps one array of (key, value) pairs, so a search
+//       over the keys also pulls every value it skips through the
+//       cache. ColumnStore keeps the keys in one array and the values
+//       in a parallel array, so searches touch only key bytes and the
+//       values are read once the index is known. Each store exposes
+//       its searchable items (pairs or bare keys) along with a KeyOf
+//       projection giving an item's key, which is what the search
+//       policies in binsearchmap.h take.
+//---------------------------------------------------------------------------
+
+#ifndef KVSTORE_H
+#define KVSTORE_H
+
+#include <tuple>
+#include <utility>
+#include "arrayseq.h"
+
+// The key of a (key, value) pair
+struct PairKey
+{
+    template <typename K, typename V>
+    const K &operator()(const std::pair<K, V> &item) const
+    {
+        return item.first;
+    }
+};
+
+// The key of a bare key
+struct BareKey
+{
+    template <typename K>
+    const K &operator()(const K &item) const
+    {
+        return item;
+    }
+};
+
+//----------------------------------------------------------------------
+// Both stores provide the members below. Indexes must be valid
+// (0 <= i < size(), or <= size() for insert); they are checked by
+// the underlying ArraySeq, which throws out_of_range.
+//----------------------------------------------------------------------
+
+// An array of (key, value) pairs (the default)
+template <typename K, typename V>
+class PairStore
+{
+public:
+    // the searchable items and how to get their keys
+    typedef std::pair<K, V> Item;
+    typedef PairKey KeyOf;
+
+    // Returns the number of key-value pairs
+    int size() const;
+
+    // Tests if the store is empty
+    bool empty() const;
+
+    // Returns the key at index i
+    const K &key(int i) const;
+
+    // Returns the value at index i
+    V &value(int i);
+    const V &value(int i) const;
+
+    // Inserts the key-value pair at index i
+    void insert(const K &key, const V &value, int i);
+
+    // Inserts key and a value constructed from args at index i
+    template <typename KK, typename... Args>
+    void emplace(int i, KK &&key, Args &&...args);
+
+    // Removes the key-value pair at index i
+    void erase(int i);
+
+    // Grows the capacity to hold at least n pairs without resizing
+    void reserve(int n);
+
+    // Returns the items in index order for searching with KeyOf. The
+    // pointer is invalidated by any insert or erase.
+    const Item *items() const;
+
+private:
+    ArraySeq<std::pair<K, V>> seq;
+};
+
+// Parallel arrays of keys and values
+template <typename K, typename V>
+class ColumnStore
+{
+public:
+    // the searchable items and how to get their keys
+    typedef K Item;
+    typedef BareKey KeyOf;
+
+    // Returns the number of key-value pairs
+    int size() const;
+
+    // Tests if the store is empty
+    bool empty() const;
+
+    // Returns the key at index i
+    const K &key(int i) const;
+
+    // Returns the value at index i
+    V &value(int i);
+    const V &value(int i) const;
+
+    // Inserts the key-value pair at index i
+    void insert(const K &key, const V &value, int i);
+
+    // Inserts key and a value constructed from args at index i
+    template <typename KK, typename... Args>
+    void emplace(int i, KK &&key, Args &&...args);
+
+    // Removes the key-value pair at index i
+    void erase(int i);
+
+    // Grows the capacity to hold at least n pairs without resizing
+    void reserve(int n);
+
+    // Returns the keys in index order for searching with KeyOf. The
+    // pointer is invalidated by any insert or erase.
+    const Item *items() const;
+
+private:
+    // keys[i] goes with values[i]
+    ArraySeq<K> keys;
+    ArraySeq<V> values;
+};
+
+// Returns the number of key-value pairs
+template <typename K, typename V>
+int PairStore<K, V>::size() const
+{
+    return seq.size();
+}
+
+// Tests if the store is empty
+template <typename K, typename V>
+bool PairStore<K, V>::empty() const
+{
+    return seq.empty();
+}
+
+// Returns the key at index i
+template <typename K, typename V>
+const K &PairStore<K, V>::key(int i) const
+{
+    return seq[i].first;
+}
+
+// Returns the value at index i
+template <typename K, typename V>
+V &PairStore<K, V>::value(int i)
+{
+    return seq[i].second;
+}
+
+// Returns the value at index i
+template <typename K, typename V>
+const V &PairStore<K, V>::value(int i) const
+{
+    return seq[i].second;
+}
+
+// Inserts the key-value pair at index i
+template <typename K, typename V>
+void PairStore<K, V>::insert(const K &key, const V &value, int i)
+{
+    seq.insert({key, value}, i);
+}
+
+// Inserts key and a value constructed from args at index i
+template <typename K, typename V>
+template <typename KK, typename... Args>
+void PairStore<K, V>::emplace(int i, KK &&key, Args &&...args)
+{
+    seq.insert(std::pair<K, V>(std::piecewise_construct,
+                               std::forward_as_tuple(std::forward<KK>(key)),
+                               std::forward_as_tuple(std::forward<Args>(args)...)),
+               i);
+}
+
+// Removes the key-value pair at index i
+template <typename K, typename V>
+void PairStore<K, V>::erase(int i)
+{
+    seq.erase(i);
+}
+
+// Grows the capacity to hold at least n pairs
+template <typename K, typename V>
+void PairStore<K, V>::reserve(int n)
+{
+    seq.reserve(n);
+}
+
+// Returns the items in index order
+template <typename K, typename V>
+const typename PairStore<K, V>::Item *PairStore<K, V>::items() const
+{
+    return seq.data();
+}
+
+// Returns the number of key-value pairs
+template <typename K, typename V>
+int ColumnStore<K, V>::size() const
+{
+    return keys.size();
+}
+
+// Tests if the store is empty
+template <typename K, typename V>
+bool ColumnStore<K, V>::empty() const
+{
+    return keys.empty();
+}
+
+// Returns the key at index i
+template <typename K, typename V>
+const K &ColumnStore<K, V>::key(int i) const
+{
+    return keys[i];
+}
+
+// Returns the value at index i
+template <typename K, typename V>
+V &ColumnStore<K, V>::value(int i)
+{
+    return values[i];
+}
+
+// Returns the value at index i
+template <typename K, typename V>
+const V &ColumnStore<K, V>::value(int i) const
+{
+    return values[i];
+}
+
+// Inserts the key-value pair at index i
+template <typename K, typename V>
+void ColumnStore<K, V>::insert(const K &key, const V &value, int i)
+{
+    // insert the value first, so a bad index leaves both arrays alone
+    values.insert(value, i);
+    keys.insert(key, i);
+}
+
+// Inserts key and a value constructed from args at index i
+template <typename K, typename V>
+template <typename KK, typename... Args>
+void ColumnStore<K, V>::emplace(int i, KK &&key, Args &&...args)
+{
+    K new_key(std::forward<KK>(key));
+    values.insert(V(std::forward<Args>(args)...), i);
+    keys.insert(std::move(new_key), i);
+}
+
+// Removes the key-value pair at index i
+template <typename K, typename V>
+void ColumnStore<K, V>::erase(int i)
+{
+    values.erase(i);
+    keys.erase(i);
+}
+
+// Grows the capacity to hold at least n pairs
+template <typename K, typename V>
+void ColumnStore<K, V>::reserve(int n)
+{
+    keys.reserve(n);
+    values.reserve(n);
+}
+
+// Returns the keys in index order
+template <typename K, typename V>
+const typename ColumnStore<K, V>::Item *ColumnStore<K, V>::items() const
+{
+    return keys.data();
+}
+
+#endif
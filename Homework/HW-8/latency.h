@@ -0,0 +1,246 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: latency.h
+// DATE: Fall 2021
+// DESC: A log-linear latency histogram in the style of HdrHistogram.
+//       Each power of two range of values is split into 128 equal
+//       buckets, so any recorded value is reported within 1/128
+//       (under 1%) of its true value, and values below 128 are exact.
+//       The whole range of 64-bit values fits in a fixed array of
+//       about 7,400 counts. Recording is a leading zero count, a
+//       shift, and an increment, so it is cheap enough to wrap every
+//       operation of a multi-million operation run.
+//---------------------------------------------------------------------------
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+
+class LatencyHistogram
+{
+public:
+    // Creates an empty histogram
+    LatencyHistogram();
+
+    // Records one value (typically nanoseconds)
+    void record(std::uint64_t value);
+
+    // Records the nanoseconds taken by op()
+    template <typename Op>
+    void time(Op op);
+
+    // Adds the counts of another histogram to this one
+    void merge(const LatencyHistogram &other);
+
+    // Removes every recorded value
+    void reset();
+
+    // Returns the number of recorded values
+    std::uint64_t count() const;
+
+    // Returns the smallest and largest recorded values (exact), or 0
+    // if the histogram is empty
+    std::uint64_t min() const;
+    std::uint64_t max() const;
+
+    // Returns the mean of the recorded values (bucket precision)
+    double mean() const;
+
+    // Returns the value at or below which the given percent of the
+    // recorded values fall, to bucket precision (reported as the
+    // bucket's largest value, capped at max()). Returns 0 if the
+    // histogram is empty. Throws invalid_argument unless 0 <= percent
+    // <= 100.
+    std::uint64_t percentile(double percent) const;
+
+private:
+    // log2 of the buckets per power of two range
+    static const int precision_bits = 7;
+    static const int sub_buckets = 1 << precision_bits;
+
+    // values below sub_buckets, then sub_buckets per power of two
+    // from 2^precision_bits to 2^63
+    static const int bucket_count = (64 - precision_bits + 1) * sub_buckets;
+
+    std::uint64_t counts[bucket_count];
+    std::uint64_t total;
+    std::uint64_t min_value;
+    std::uint64_t max_value;
+
+    // the bucket holding value
+    static int bucket(std::uint64_t value);
+
+    // the smallest and largest values of bucket b
+    static std::uint64_t bucket_low(int b);
+    static std::uint64_t bucket_high(int b);
+};
+
+// creates an empty histogram
+inline LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+// records one value
+inline void LatencyHistogram::record(std::uint64_t value)
+{
+    ++counts[bucket(value)];
+    ++total;
+    if (value < min_value)
+    {
+        min_value = value;
+    }
+    if (value > max_value)
+    {
+        max_value = value;
+    }
+}
+
+// records the nanoseconds taken by op()
+template <typename Op>
+void LatencyHistogram::time(Op op)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    op();
+    auto t1 = std::chrono::steady_clock::now();
+    record(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+}
+
+// adds the counts of another histogram
+inline void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    for (int b = 0; b < bucket_count; ++b)
+    {
+        counts[b] += other.counts[b];
+    }
+    total += other.total;
+    if (other.min_value < min_value)
+    {
+        min_value = other.min_value;
+    }
+    if (other.max_value > max_value)
+    {
+        max_value = other.max_value;
+    }
+}
+
+// removes every recorded value
+inline void LatencyHistogram::reset()
+{
+    for (int b = 0; b < bucket_count; ++b)
+    {
+        counts[b] = 0;
+    }
+    total = 0;
+    min_value = UINT64_MAX;
+    max_value = 0;
+}
+
+// number of recorded values
+inline std::uint64_t LatencyHistogram::count() const
+{
+    return total;
+}
+
+// smallest recorded value
+inline std::uint64_t LatencyHistogram::min() const
+{
+    return total == 0 ? 0 : min_value;
+}
+
+// largest recorded value
+inline std::uint64_t LatencyHistogram::max() const
+{
+    return max_value;
+}
+
+// mean of the recorded values, using each bucket's midpoint
+inline double LatencyHistogram::mean() const
+{
+    if (total == 0)
+    {
+        return 0;
+    }
+    double sum = 0;
+    for (int b = 0; b < bucket_count; ++b)
+    {
+        if (counts[b] != 0)
+        {
+            sum += counts[b] * ((double(bucket_low(b)) + bucket_high(b)) / 2);
+        }
+    }
+    return sum / total;
+}
+
+// value at the given percentile
+inline std::uint64_t LatencyHistogram::percentile(double percent) const
+{
+    if (!(percent >= 0 && percent <= 100))
+    {
+        throw std::invalid_argument("LatencyHistogram::percentile(percent)");
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+    // rank of the value, counting from 1
+    std::uint64_t rank = std::uint64_t(percent / 100 * total + 0.5);
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+    std::uint64_t seen = 0;
+    for (int b = 0; b < bucket_count; ++b)
+    {
+        seen += counts[b];
+        if (seen >= rank)
+        {
+            std::uint64_t high = bucket_high(b);
+            return high < max_value ? high : max_value;
+        }
+    }
+    return max_value;
+}
+
+// bucket holding value
+inline int LatencyHistogram::bucket(std::uint64_t value)
+{
+    if (value < std::uint64_t(sub_buckets))
+    {
+        return int(value);
+    }
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - precision_bits;
+    // the top precision_bits + 1 bits of value, in [sub_buckets,
+    // 2 * sub_buckets)
+    int mantissa = int(value >> shift);
+    return (shift + 1) * sub_buckets + mantissa - sub_buckets;
+}
+
+// smallest value of bucket b
+inline std::uint64_t LatencyHistogram::bucket_low(int b)
+{
+    if (b < sub_buckets)
+    {
+        return b;
+    }
+    int shift = b / sub_buckets - 1;
+    std::uint64_t mantissa = b % sub_buckets + sub_buckets;
+    return mantissa << shift;
+}
+
+// largest value of bucket b
+inline std::uint64_t LatencyHistogram::bucket_high(int b)
+{
+    if (b < sub_buckets)
+    {
+        return b;
+    }
+    int shift = b / sub_buckets - 1;
+    return bucket_low(b) + ((std::uint64_t(1) << shift) - 1);
+}
+
+#endif
@@ -18,9 +18,29 @@
 #ifndef MAP_H
 #define MAP_H
 
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include "arrayseq.h"
 
 
+// Marks Q as a type that can look up K keys without building a K
+// (heterogeneous lookup), e.g. std::string_view for std::string
+// keys. Q must compare with K using ==, <, and >, and std::hash<Q>
+// must agree with std::hash<K> on equal keys. Specialize for other
+// key types.
+template<typename K, typename Q>
+struct is_transparent_key : std::false_type {};
+
+template<>
+struct is_transparent_key<std::string, std::string_view> : std::true_type {};
+
+// Enables a map's heterogeneous lookup overloads for transparent Q
+template<typename K, typename Q>
+using enable_if_transparent =
+  typename std::enable_if<is_transparent_key<K, Q>::value, int>::type;
+
+
 template<typename K, typename V>
 class Map
 {
@@ -43,17 +63,41 @@ public:
   // given key is not in the collection. 
   virtual const V& operator[](const K& key) const = 0;
 
+  // Returns a pointer to the value for a given key, or nullptr if
+  // the key is not in the collection. Unlike operator[], does not
+  // throw, and finds the key in a single search.
+  virtual V* find(const K& key) = 0;
+  virtual const V* find(const K& key) const = 0;
+
   // Extends the collection by adding the given key-value
   // pair. Assumes the key being added is not present in the
   // collection. Insert does not check if the key is present.
   virtual void insert(const K& key, const V& value) = 0;
 
+  // Same as insert, but moves the key and value into the
+  // collection instead of copying them.
+  virtual void insert(K&& key, V&& value) = 0;
+
+  // Adds the key-value pair if the key is not in the collection, and
+  // otherwise assigns value to the key's value. Returns true if the
+  // pair was added. Done in a single search (no contains first).
+  virtual bool insert_or_assign(const K& key, const V& value) = 0;
+
+  // Returns the value for a given key, first adding the key with a
+  // default-constructed value if it is not in the collection. Done
+  // in a single search, e.g., m.get_or_insert_default(word) += 1.
+  virtual V& get_or_insert_default(const K& key) = 0;
+
   // Shrinks the collection by removing the key-value pair with the
   // given key. Does not modify the collection if the collection does
   // not contain the key. Throws out_of_range if the given key is not
   // in the collection.
   virtual void erase(const K& key) = 0;
 
+  // Same as erase, but returns false instead of throwing if the key
+  // is not in the collection, and true if the pair was removed.
+  virtual bool try_erase(const K& key) = 0;
+
   // Returns true if the key is in the collection, and false otherwise.
   virtual bool contains(const K& key) const = 0;
 
@@ -0,0 +1,560 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: mappedseq.h
+// DATE: Fall 2021
+// DESC: An array-based sequence whose storage is a memory-mapped file
+//       instead of the heap, so the OS page cache manages the data and
+//       sequences larger than memory can be scanned and sorted in
+//       place. The file is laid out as an ArraySeq snapshot (header
+//       followed by the elements, plus unused capacity at the end), so
+//       reopening a file is instant and ArraySeq::load can read
+//       it. Only trivially copyable element types are supported.
+//---------------------------------------------------------------------------
+
+#ifndef MAPPEDSEQ_H
+#define MAPPEDSEQ_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "sequence.h"
+#include "snapshot.h"
+
+template <typename T>
+class MappedArraySeq : public Sequence<T>
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "MappedArraySeq requires a trivially copyable type");
+
+public:
+    // Opens the sequence stored in the file at path, creating an
+    // empty one if the file does not exist. Throws runtime_error if
+    // the file cannot be mapped or holds a different element type.
+    MappedArraySeq(const std::string &path);
+
+    // the mapping is owned by one object, so copying is not allowed
+    MappedArraySeq(const MappedArraySeq &rhs) = delete;
+    MappedArraySeq &operator=(const MappedArraySeq &rhs) = delete;
+
+    // Move constructor
+    MappedArraySeq(MappedArraySeq &&rhs);
+
+    // Move assignment operator
+    MappedArraySeq &operator=(MappedArraySeq &&rhs);
+
+    // Destructor (unmaps the file, the data stays in the file)
+    ~MappedArraySeq();
+
+    // Returns the number of elements in the sequence
+    int size() const;
+
+    // Tests if the sequence is empty
+    bool empty() const;
+
+    // Returns a reference to the element at the index in the
+    // sequence. Throws out_of_range if index is invalid.
+    T &operator[](int index);
+
+    // Returns a constant address to the element at the index in the
+    // sequence. Throws out_of_range if index is invalid.
+    const T &operator[](int index) const;
+
+    // Extends the sequence by inserting the element at the given
+    // index. Throws out_of_range if the index is invalid.
+    void insert(const T &elem, int index);
+
+    // Shrinks the sequence by removing the element at the index in the
+    // sequence. Throws out_of_range if index is invalid.
+    void erase(int index);
+
+    // Returns true if the element is in the sequence, and false
+    // otherwise.
+    bool contains(const T &elem) const;
+
+    // Sorts the elements in the sequence (using merge sort)
+    void sort();
+
+    // Sorts the sequence with a bottom-up merge sort. Each pass
+    // streams sequentially through the data and a scratch file of the
+    // same size, which suits data larger than memory.
+    void merge_sort();
+
+    // Sorts the sequence in place with quick sort (random access)
+    void quick_sort();
+
+    // Grows the file to hold at least n elements without remapping
+    void reserve(int n);
+
+    // Hints to the OS that the data will be accessed sequentially
+    // (aggressive read-ahead) or randomly (no read-ahead)
+    void advise_sequential();
+    void advise_random();
+
+    // Writes changes to the file (they are otherwise written back by
+    // the OS at some point, and at the latest when unmapped)
+    void flush();
+
+private:
+    // the backing file
+    std::string path;
+    int fd = -1;
+
+    // the mapping (header followed by the elements)
+    char *base = nullptr;
+    std::size_t mapped_bytes = 0;
+    T *array = nullptr;
+
+    // size of list
+    int count = 0;
+
+    // max capacity of the mapping
+    int capacity = 0;
+
+    // bytes before the first element
+    static const std::size_t data_offset = sizeof(SnapshotHeader);
+
+    // grow the file to hold the given capacity and remap it
+    void remap(int new_capacity);
+
+    // record count in the file header
+    void store_count();
+
+    // unmap and close the file
+    void close();
+
+    // merge the sorted runs src[start..mid) and src[mid..end) into dst
+    void merge(const T *src, T *dst, int start, int mid, int end);
+
+    // quick sort helper
+    void quick_sort(int start, int end);
+};
+
+// throws a runtime_error describing the failed system call
+inline void mapped_seq_error(const std::string &what, const std::string &path)
+{
+    throw std::runtime_error(what + " failed for " + path + ": " +
+                             std::strerror(errno));
+}
+
+// Opens (or creates) the sequence stored in the file at path
+template <typename T>
+MappedArraySeq<T>::MappedArraySeq(const std::string &path)
+    : path(path)
+{
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        mapped_seq_error("open", path);
+    }
+    // the destructor does not run if the constructor throws, so
+    // close the file (and any mapping) on every failure below
+    try
+    {
+        struct stat st;
+        if (fstat(fd, &st) < 0)
+        {
+            mapped_seq_error("fstat", path);
+        }
+        if (st.st_size == 0)
+        {
+            // new file, write an empty header
+            SnapshotHeader header = make_snapshot_header(ARRAYSEQ_SNAPSHOT,
+                                                         sizeof(T), 0, 0);
+            if (::write(fd, &header, sizeof(header)) != sizeof(header))
+            {
+                mapped_seq_error("write", path);
+            }
+            remap(16);
+            return;
+        }
+        if ((std::size_t)st.st_size < data_offset)
+        {
+            throw std::runtime_error("not a snapshot file: " + path);
+        }
+        mapped_bytes = st.st_size;
+        void *addr = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE,
+                          MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            mapped_seq_error("mmap", path);
+        }
+        base = static_cast<char *>(addr);
+        array = reinterpret_cast<T *>(base + data_offset);
+        const SnapshotHeader *header = reinterpret_cast<SnapshotHeader *>(base);
+        check_snapshot_header(*header, path, ARRAYSEQ_SNAPSHOT, sizeof(T), 0);
+        // a header-only file (e.g., an empty ArraySeq::save) has no
+        // room for elements yet, so capacity may be 0
+        capacity = (mapped_bytes - data_offset) / sizeof(T);
+        if (header->count > (std::uint64_t)capacity)
+        {
+            throw std::runtime_error("snapshot count exceeds file size: " + path);
+        }
+        count = header->count;
+    }
+    catch (...)
+    {
+        close();
+        throw;
+    }
+}
+
+// Move constructor
+template <typename T>
+MappedArraySeq<T>::MappedArraySeq(MappedArraySeq &&rhs)
+{
+    *this = std::move(rhs);
+}
+
+// Move assignment operator
+template <typename T>
+MappedArraySeq<T> &MappedArraySeq<T>::operator=(MappedArraySeq &&rhs)
+{
+    if (this != &rhs)
+    {
+        close();
+        path = rhs.path;
+        fd = rhs.fd;
+        base = rhs.base;
+        mapped_bytes = rhs.mapped_bytes;
+        array = rhs.array;
+        count = rhs.count;
+        capacity = rhs.capacity;
+        rhs.fd = -1;
+        rhs.base = nullptr;
+        rhs.array = nullptr;
+        rhs.mapped_bytes = 0;
+        rhs.count = 0;
+        rhs.capacity = 0;
+    }
+    return *this;
+}
+
+// Destructor
+template <typename T>
+MappedArraySeq<T>::~MappedArraySeq()
+{
+    close();
+}
+
+// Returns the number of elements in the sequence
+template <typename T>
+int MappedArraySeq<T>::size() const
+{
+    return count;
+}
+
+// Tests if the sequence is empty
+template <typename T>
+bool MappedArraySeq<T>::empty() const
+{
+    return count == 0;
+}
+
+// Returns a reference to the element at the index
+template <typename T>
+T &MappedArraySeq<T>::operator[](int index)
+{
+    if (index >= count || index < 0)
+    {
+        throw std::out_of_range("MappedArraySeq<T>::operator[](index)");
+    }
+    return array[index];
+}
+
+// Returns a constant address to the element at the index
+template <typename T>
+const T &MappedArraySeq<T>::operator[](int index) const
+{
+    if (index >= count || index < 0)
+    {
+        throw std::out_of_range("MappedArraySeq<T>::operator[](index)");
+    }
+    return array[index];
+}
+
+// Extends the sequence by inserting the element at the given index
+template <typename T>
+void MappedArraySeq<T>::insert(const T &elem, int index)
+{
+    if (index > count || index < 0)
+    {
+        throw std::out_of_range("MappedArraySeq<T>::insert(elem, index)");
+    }
+    if (count == capacity)
+    {
+        // capacity is 0 for a reopened header-only file
+        remap(std::max(1, capacity * 2));
+    }
+    std::memmove(array + index + 1, array + index,
+                 sizeof(T) * (count - index));
+    array[index] = elem;
+    ++count;
+    store_count();
+}
+
+// Shrinks the sequence by removing the element at the index
+template <typename T>
+void MappedArraySeq<T>::erase(int index)
+{
+    if (index >= count || index < 0)
+    {
+        throw std::out_of_range("MappedArraySeq<T>::erase(index)");
+    }
+    std::memmove(array + index, array + index + 1,
+                 sizeof(T) * (count - index - 1));
+    --count;
+    store_count();
+}
+
+// Returns true if the element is in the sequence
+template <typename T>
+bool MappedArraySeq<T>::contains(const T &elem) const
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (array[i] == elem)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Sorts the elements in the sequence
+template <typename T>
+void MappedArraySeq<T>::sort()
+{
+    merge_sort();
+}
+
+// Bottom-up merge sort through a mapped scratch file
+template <typename T>
+void MappedArraySeq<T>::merge_sort()
+{
+    if (count < 2)
+    {
+        return;
+    }
+    // the scratch file gets a fresh name next to the data (so no other
+    // file or concurrent sort is clobbered) and is unlinked right
+    // away, so it is removed even if the process dies mid-sort
+    std::string scratch_path = path + ".scratchXXXXXX";
+    int scratch_fd = mkstemp(&scratch_path[0]);
+    if (scratch_fd < 0)
+    {
+        mapped_seq_error("mkstemp", scratch_path);
+    }
+    ::unlink(scratch_path.c_str());
+    std::size_t scratch_bytes = sizeof(T) * count;
+    if (ftruncate(scratch_fd, scratch_bytes) < 0)
+    {
+        ::close(scratch_fd);
+        mapped_seq_error("ftruncate", scratch_path);
+    }
+    void *addr = mmap(nullptr, scratch_bytes, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, scratch_fd, 0);
+    ::close(scratch_fd);
+    if (addr == MAP_FAILED)
+    {
+        mapped_seq_error("mmap", scratch_path);
+    }
+    T *scratch = static_cast<T *>(addr);
+    madvise(addr, scratch_bytes, MADV_SEQUENTIAL);
+    advise_sequential();
+
+    // merge runs of doubling width, alternating between the two files
+    T *src = array;
+    T *dst = scratch;
+    for (long width = 1; width < count; width *= 2)
+    {
+        for (long start = 0; start < count; start += 2 * width)
+        {
+            int mid = (int)std::min(start + width, (long)count);
+            int end = (int)std::min(start + 2 * width, (long)count);
+            merge(src, dst, (int)start, mid, end);
+        }
+        std::swap(src, dst);
+    }
+    if (src != array)
+    {
+        std::memcpy(array, src, sizeof(T) * count);
+    }
+    munmap(addr, scratch_bytes);
+}
+
+// Sorts the sequence in place with quick sort
+template <typename T>
+void MappedArraySeq<T>::quick_sort()
+{
+    advise_random();
+    quick_sort(0, count - 1);
+}
+
+// Grows the file to hold at least n elements
+template <typename T>
+void MappedArraySeq<T>::reserve(int n)
+{
+    if (n > capacity)
+    {
+        remap(n);
+    }
+}
+
+// Hints that the data will be accessed sequentially
+template <typename T>
+void MappedArraySeq<T>::advise_sequential()
+{
+    madvise(base, mapped_bytes, MADV_SEQUENTIAL);
+}
+
+// Hints that the data will be accessed randomly
+template <typename T>
+void MappedArraySeq<T>::advise_random()
+{
+    madvise(base, mapped_bytes, MADV_RANDOM);
+}
+
+// Writes changes to the file
+template <typename T>
+void MappedArraySeq<T>::flush()
+{
+    if (base != nullptr && msync(base, mapped_bytes, MS_SYNC) < 0)
+    {
+        mapped_seq_error("msync", path);
+    }
+}
+
+// grow the file to hold the given capacity and remap it
+template <typename T>
+void MappedArraySeq<T>::remap(int new_capacity)
+{
+    std::size_t new_bytes = data_offset + sizeof(T) * new_capacity;
+    if (ftruncate(fd, new_bytes) < 0)
+    {
+        mapped_seq_error("ftruncate", path);
+    }
+    // map the new region before unmapping the old one, so a failed
+    // mmap leaves the sequence as it was
+    void *addr = mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED)
+    {
+        mapped_seq_error("mmap", path);
+    }
+    if (base != nullptr)
+    {
+        munmap(base, mapped_bytes);
+    }
+    base = static_cast<char *>(addr);
+    mapped_bytes = new_bytes;
+    array = reinterpret_cast<T *>(base + data_offset);
+    capacity = new_capacity;
+}
+
+// record count in the file header
+template <typename T>
+void MappedArraySeq<T>::store_count()
+{
+    reinterpret_cast<SnapshotHeader *>(base)->count = count;
+}
+
+// unmap and close the file
+template <typename T>
+void MappedArraySeq<T>::close()
+{
+    if (base != nullptr)
+    {
+        munmap(base, mapped_bytes);
+        base = nullptr;
+        array = nullptr;
+    }
+    if (fd >= 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+// merge the sorted runs src[start..mid) and src[mid..end) into dst
+template <typename T>
+void MappedArraySeq<T>::merge(const T *src, T *dst, int start, int mid,
+                              int end)
+{
+    int first1 = start;
+    int first2 = mid;
+    int i = start;
+    while (first1 < mid && first2 < end)
+    {
+        if (src[first2] < src[first1])
+        {
+            dst[i++] = src[first2++];
+        }
+        else
+        {
+            dst[i++] = src[first1++];
+        }
+    }
+    while (first1 < mid)
+    {
+        dst[i++] = src[first1++];
+    }
+    while (first2 < end)
+    {
+        dst[i++] = src[first2++];
+    }
+}
+
+// quick sort helper
+template <typename T>
+void MappedArraySeq<T>::quick_sort(int start, int end)
+{
+    // recursing into the smaller side and looping on the larger one
+    // keeps the stack depth at log n
+    while (start < end)
+    {
+        // middle element pivot to avoid quadratic time on sorted data
+        std::swap(array[start], array[start + (end - start) / 2]);
+        T pivot_val = array[start];
+        // three-way partition into [start, lt) < pivot, [lt, i) equal
+        // to it, and (gt, end] > pivot, so equal keys are placed in
+        // one pass instead of one level each
+        int lt = start;
+        int i = start + 1;
+        int gt = end;
+        while (i <= gt)
+        {
+            if (array[i] < pivot_val)
+            {
+                std::swap(array[lt++], array[i++]);
+            }
+            else if (pivot_val < array[i])
+            {
+                std::swap(array[i], array[gt--]);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+        if (lt - start < end - gt)
+        {
+            quick_sort(start, lt - 1);
+            start = gt + 1;
+        }
+        else
+        {
+            quick_sort(gt + 1, end);
+            end = lt - 1;
+        }
+    }
+}
+
+#endif
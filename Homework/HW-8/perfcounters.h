@@ -0,0 +1,222 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: perfcounters.h
+// DATE: Fall 2021
+// DESC: Hardware performance counters for the perf drivers, read
+//       through Linux perf_event_open. PerfCounters counts cycles,
+//       instructions, L1 data cache read misses, last level cache
+//       read misses, branch misses, and data TLB read misses for the
+//       calling thread (user mode only) between start and stop. The
+//       events are inherited, so worker threads started after the
+//       counters were opened are counted too, but only once they
+//       exit: join them before stop. Each event is opened on its own,
+//       so an event the CPU or kernel does not offer (or that
+//       perf_event_paranoid forbids, or a non-Linux build) just reads
+//       as NaN while the others still count. Counts are scaled up if
+//       the kernel had to multiplex the counters during the region,
+//       and an event that never got a counter in the region reads as
+//       NaN.
+//---------------------------------------------------------------------------
+
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// the events PerfCounters counts
+enum PerfEvent
+{
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_DTLB_MISSES,
+    PERF_EVENT_COUNT
+};
+
+// event names for data file headers
+const char *const perf_event_names[PERF_EVENT_COUNT] = {
+    "cycles", "instructions", "L1d misses",
+    "LLC misses", "branch misses", "dTLB misses"};
+
+// the event counts of one region (NaN for unavailable or uncounted
+// events)
+struct PerfSample
+{
+    double count[PERF_EVENT_COUNT];
+};
+
+class PerfCounters
+{
+public:
+    // Opens every event the system allows
+    PerfCounters();
+
+    // Closes the events
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    // Returns true if the event could be opened
+    bool available(PerfEvent event) const;
+
+    // Returns true if at least one event could be opened
+    bool any_available() const;
+
+    // Resets and starts the counters
+    void start();
+
+    // Stops the counters and returns the counts since start
+    PerfSample stop();
+
+private:
+    // file descriptor per event (-1 if unavailable)
+    int fds[PERF_EVENT_COUNT];
+
+    // time enabled and time running per event at start (the kernel
+    // only resets the counts, these keep accumulating from open)
+    std::uint64_t enabled_at[PERF_EVENT_COUNT];
+    std::uint64_t running_at[PERF_EVENT_COUNT];
+};
+
+// opens the events
+inline PerfCounters::PerfCounters()
+{
+    for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+    {
+        fds[i] = -1;
+        enabled_at[i] = 0;
+        running_at[i] = 0;
+    }
+#ifdef __linux__
+    const std::uint64_t read_miss =
+        (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    const std::uint32_t types[PERF_EVENT_COUNT] = {
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+        PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE};
+    const std::uint64_t configs[PERF_EVENT_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_L1D | read_miss, PERF_COUNT_HW_CACHE_LL | read_miss,
+        PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_DTLB | read_miss};
+    for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = types[i];
+        attr.config = configs[i];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        // count threads the region starts (e.g. HashMap::find_keys)
+        attr.inherit = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+}
+
+// closes the events
+inline PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+    for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+    {
+        if (fds[i] >= 0)
+        {
+            close(fds[i]);
+        }
+    }
+#endif
+}
+
+// Returns true if the event could be opened
+inline bool PerfCounters::available(PerfEvent event) const
+{
+    return fds[event] >= 0;
+}
+
+// Returns true if at least one event could be opened
+inline bool PerfCounters::any_available() const
+{
+    for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+    {
+        if (fds[i] >= 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// resets and starts the counters
+inline void PerfCounters::start()
+{
+#ifdef __linux__
+    for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+    {
+        if (fds[i] >= 0)
+        {
+            // value, time enabled, time running
+            std::uint64_t values[3];
+            if (read(fds[i], values, sizeof(values)) == sizeof(values))
+            {
+                enabled_at[i] = values[1];
+                running_at[i] = values[2];
+            }
+            ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+// stops the counters and returns the counts
+inline PerfSample PerfCounters::stop()
+{
+    PerfSample sample;
+    for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+    {
+        sample.count[i] = NAN;
+    }
+#ifdef __linux__
+    for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+    {
+        if (fds[i] >= 0)
+        {
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+    {
+        // value, time enabled, time running
+        std::uint64_t values[3];
+        if (fds[i] >= 0 && read(fds[i], values, sizeof(values)) == sizeof(values))
+        {
+            // scale up by the region's own share of time running;
+            // if the event never ran in the region the count says
+            // nothing, so leave NaN
+            std::uint64_t enabled = values[1] - enabled_at[i];
+            std::uint64_t running = values[2] - running_at[i];
+            if (running != 0)
+            {
+                sample.count[i] = double(values[0]) * enabled / running;
+            }
+        }
+    }
+#endif
+    return sample;
+}
+
+#endif
@@ -71,61 +71,67 @@ set yrange [0:*] noreverse writeback
 set output outfile1
 
 # Plot the data
-set title "BinSearchMap vs HashMap vs BSTMap vs AVLMap Insert Performance";
+set title "BinSearchMap vs HashMap vs BSTMap vs AVLMap vs RBTreeMap Insert Performance";
 plot  infile u 1:2 t "BinSearchMap Insert" w linespoints lw 3 lc rgb RED pointtype 6, \
       infile u 1:3 t "HashMap Insert" w linespoints lw 3 lc rgb GREEN pointtype 6, \
       infile u 1:4 t "BSTMap Insert" w linespoints lw 3 lc rgb YELLOW pointtype 6, \
-      infile u 1:5 t "AVLMap Insert" w linespoints lw 3 lc rgb BLUE pointtype 6;
+      infile u 1:5 t "AVLMap Insert" w linespoints lw 3 lc rgb BLUE pointtype 6, \
+      infile u 1:25 t "RBTreeMap Insert" w linespoints lw 3 lc rgb ORANGE pointtype 6;
 
 
 # Save the graph
 set output outfile2
 
 # Plot the data
-set title "BinSearchMap vs HashMap vs BSTMap vs AVLMap Erase Performance";
+set title "BinSearchMap vs HashMap vs BSTMap vs AVLMap vs RBTreeMap Erase Performance";
 plot  infile u 1:6 t "BinSearchMap Erase" w linespoints lw 3 lc rgb RED pointtype 6, \
       infile u 1:7 t "HashMap Erase" w linespoints lw 3 lc rgb GREEN pointtype 6, \
       infile u 1:8 t "BSTMap Erase" w linespoints lw 3 lc rgb YELLOW pointtype 6, \
-      infile u 1:9 t "AVLMap Erase" w linespoints lw 3 lc rgb BLUE pointtype 6;
+      infile u 1:9 t "AVLMap Erase" w linespoints lw 3 lc rgb BLUE pointtype 6, \
+      infile u 1:26 t "RBTreeMap Erase" w linespoints lw 3 lc rgb ORANGE pointtype 6;
 
 # Save the graph
 set output outfile3
 
 # Plot the data
-set title "BinSearchMap vs HashMap vs BSTMap vs AVLMap Contains Performance";
+set title "BinSearchMap vs HashMap vs BSTMap vs AVLMap vs RBTreeMap Contains Performance";
 plot  infile u 1:10 t "BinSearchMap Contains" w linespoints lw 3 lc rgb RED pointtype 6, \
       infile u 1:11 t "HashMap Contains" w linespoints lw 3 lc rgb GREEN pointtype 6, \
       infile u 1:12 t "BSTMap Contains" w linespoints lw 3 lc rgb YELLOW pointtype 6, \
-      infile u 1:13 t "AVLMap Contains" w linespoints lw 3 lc rgb BLUE pointtype 6;
+      infile u 1:13 t "AVLMap Contains" w linespoints lw 3 lc rgb BLUE pointtype 6, \
+      infile u 1:27 t "RBTreeMap Contains" w linespoints lw 3 lc rgb ORANGE pointtype 6;
       
 # Save the graph
 set output outfile4
 
 # Plot the data
-set title "BinSearchMap vs HashMap vs BSTMap vs AVLMap Find Range Performance";
+set title "BinSearchMap vs HashMap vs BSTMap vs AVLMap vs RBTreeMap Find Range Performance";
 plot  infile u 1:14 t "BinSearchMap Find Range" w linespoints lw 3 lc rgb RED pointtype 6, \
       infile u 1:15 t "HashMap Find Range" w linespoints lw 3 lc rgb GREEN pointtype 6, \
       infile u 1:16 t "BSTMap Find Range" w linespoints lw 3 lc rgb YELLOW pointtype 6, \
-      infile u 1:17 t "AVLMap Find Range" w linespoints lw 3 lc rgb BLUE pointtype 6;
+      infile u 1:17 t "AVLMap Find Range" w linespoints lw 3 lc rgb BLUE pointtype 6, \
+      infile u 1:28 t "RBTreeMap Find Range" w linespoints lw 3 lc rgb ORANGE pointtype 6;
 
 # Save the graph
 set output outfile5
 
 # Plot the data
-set title "BinSearchMap vs HashMap vs BSTMap vs AVLMap Sorted Keys Performance";
+set title "BinSearchMap vs HashMap vs BSTMap vs AVLMap vs RBTreeMap Sorted Keys Performance";
 plot  infile u 1:18 t "BinSearchMap Sorted Keys" w linespoints lw 3 lc rgb RED pointtype 6, \
       infile u 1:19 t "HashMap Sorted Keys" w linespoints lw 3 lc rgb GREEN pointtype 6, \
       infile u 1:20 t "BSTMap Sorted Keys" w linespoints lw 3 lc rgb YELLOW pointtype 6, \
-      infile u 1:21 t "AVLMap Sorted Keys" w linespoints lw 3 lc rgb BLUE pointtype 6; 
+      infile u 1:21 t "AVLMap Sorted Keys" w linespoints lw 3 lc rgb BLUE pointtype 6, \
+      infile u 1:29 t "RBTreeMap Sorted Keys" w linespoints lw 3 lc rgb ORANGE pointtype 6; 
 
 # Save the graph
 set output outfile6
 
 set ylabel "Tree Height"
 
-set title "BSTMap Tree Height vs AVLMap Tree Height vs lg Growth";
+set title "BSTMap vs AVLMap vs RBTreeMap Tree Height vs lg Growth";
 plot  infile u 1:22 t "BST Height" w linespoints lw 3 lc rgb BLUE pointtype 6, \
       infile u 1:23 t "AVL Height" w linespoints lw 3 lc rgb GREEN pointtype 6, \
+      infile u 1:30 t "RB Height" w linespoints lw 3 lc rgb ORANGE pointtype 6, \
       infile u 1:24 t "lg n" w linespoints lw 3 lc rgb RED pointtype 6;
 
 
@@ -0,0 +1,952 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: rbtreemap.h
+// DATE: Fall 2021
+// DESC: A red-black tree implementation of the Map interface. Insert
+//       and erase walk down the tree iteratively and restore the
+//       red-black properties bottom up, doing at most two rotations
+//       per insert and three per erase (AVLMap may rotate and update
+//       heights at every level). Each node's color is packed into the
+//       low bit of its parent pointer, so nodes are no larger than
+//       AVLMap nodes.
+//---------------------------------------------------------------------------
+
+#ifndef RBTREEMAP_H
+#define RBTREEMAP_H
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include "map.h"
+#include "arrayseq.h"
+
+template <typename K, typename V>
+class RBTreeMap : public Map<K, V>
+{
+public:
+    // default constructor
+    RBTreeMap();
+
+    // copy constructor
+    RBTreeMap(const RBTreeMap &rhs);
+
+    // move constructor
+    RBTreeMap(RBTreeMap &&rhs);
+
+    // copy assignment
+    RBTreeMap &operator=(const RBTreeMap &rhs);
+
+    // move assignment
+    RBTreeMap &operator=(RBTreeMap &&rhs);
+
+    // destructor
+    ~RBTreeMap();
+
+    // Returns the number of key-value pairs in the map
+    int size() const;
+
+    // Tests if the map is empty
+    bool empty() const;
+
+    // Allows values associated with a key to be updated. Throws
+    // out_of_range if the given key is not in the collection.
+    V &operator[](const K &key);
+
+    // Returns the value for a given key. Throws out_of_range if the
+    // given key is not in the collection.
+    const V &operator[](const K &key) const;
+
+    // Returns a pointer to the value for a given key, or nullptr if
+    // the key is not in the collection.
+    V *find(const K &key);
+    const V *find(const K &key) const;
+
+    // Extends the collection by adding the given key-value
+    // pair. Assumes the key being added is not present in the
+    // collection. Insert does not check if the key is present.
+    void insert(const K &key, const V &value);
+
+    // Same as insert, but moves the key and value into the
+    // collection instead of copying them.
+    void insert(K &&key, V &&value);
+
+    // Extends the collection by adding the key with a value
+    // constructed in place from args. Like insert, assumes the key is
+    // not present in the collection.
+    template <typename KK, typename... Args>
+    void emplace(KK &&key, Args &&...args);
+
+    // Adds the key with a value constructed in place from args if the
+    // key is not in the collection. Returns true if it was added; if
+    // not, the key and args are left untouched.
+    template <typename KK, typename... Args>
+    bool try_emplace(KK &&key, Args &&...args);
+
+    // Adds the key-value pair if the key is not in the collection, and
+    // otherwise assigns value to the key's value. Returns true if the
+    // pair was added.
+    bool insert_or_assign(const K &key, const V &value);
+
+    // Returns the value for a given key, first adding the key with a
+    // default-constructed value if it is not in the collection.
+    V &get_or_insert_default(const K &key);
+
+    // Shrinks the collection by removing the key-value pair with the
+    // given key. Does not modify the collection if the collection does
+    // not contain the key. Throws out_of_range if the given key is not
+    // in the collection.
+    void erase(const K &key);
+
+    // Same as erase, but returns false instead of throwing if the key
+    // is not in the collection, and true if the pair was removed.
+    bool try_erase(const K &key);
+
+    // Returns true if the key is in the collection, and false otherwise.
+    bool contains(const K &key) const;
+
+    // Heterogeneous lookup: operator[] and contains for a key of a
+    // transparent type Q (see is_transparent_key in map.h), such as
+    // std::string_view for std::string keys, without building a K.
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    V &operator[](const Q &key);
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    const V &operator[](const Q &key) const;
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    bool contains(const Q &key) const;
+
+    // Returns the keys k in the collection such that k1 <= k <= k2
+    ArraySeq<K> find_keys(const K &k1, const K &k2) const;
+
+    // Appends the keys k in the collection such that k1 <= k <= k2 to
+    // keys, which may be any sequence (such as a SmallArraySeq that
+    // holds small results without allocating)
+    template <typename Seq>
+    void find_keys(const K &k1, const K &k2, Seq &keys) const;
+
+    // Returns the keys in the collection in ascending sorted order
+    ArraySeq<K> sorted_keys() const;
+
+    // Returns the height of the tree
+    int height() const;
+
+    // Returns true if the tree satisfies the red-black properties
+    // (for testing)
+    bool valid() const;
+
+private:
+    // node for red-black tree, the parent pointer and color share a
+    // word (nodes are at least 2-byte aligned, so the low bit is free)
+    struct Node
+    {
+        K key;
+        V value;
+        Node *left;
+        Node *right;
+        std::uintptr_t parent_color;
+    };
+
+    // low bit of parent_color, set for red nodes
+    static const std::uintptr_t RED = 1;
+
+    // number of nodes
+    int count = 0;
+
+    // root node
+    Node *root = nullptr;
+
+    // packed parent and color accessors
+    static Node *parent(const Node *node);
+    static bool is_red(const Node *node);
+    static void set_parent(Node *node, Node *parent);
+    static void set_red(Node *node, bool red);
+
+    // returns the node with the given key, or nullptr
+    template <typename Q>
+    Node *find_node(const Q &key) const;
+
+    // returns the link (root or child pointer) that points to the
+    // node with the given key, or the null link where the key
+    // belongs, setting parent to the node holding that link
+    template <typename Q>
+    Node **find_link(const Q &key, Node *&parent);
+
+    // links the new node in at a null link below parent and restores
+    // the red-black properties
+    void add_node(Node **link, Node *parent, Node *node);
+
+    // clean up the tree given subtree root
+    void make_empty(Node *st_root);
+
+    // copy helper, copies the subtree below the given parent
+    Node *copy(const Node *rhs_st_root, Node *parent) const;
+
+    // rotations
+    void rotate_left(Node *x);
+    void rotate_right(Node *x);
+
+    // replaces the subtree rooted at u with the one rooted at v
+    void transplant(Node *u, Node *v);
+
+    // restores the red-black properties after inserting node
+    void insert_fixup(Node *node);
+
+    // restores the red-black properties after removing a black node,
+    // where node (possibly nullptr) is the child of parent that took
+    // its place
+    void erase_fixup(Node *node, Node *parent);
+
+    // find_keys helper
+    template <typename Seq>
+    void find_keys(const K &k1, const K &k2, const Node *st_root,
+                   Seq &keys) const;
+
+    // sorted_keys helper
+    void sorted_keys(const Node *st_root, ArraySeq<K> &keys) const;
+
+    // height helper
+    int height(const Node *st_root) const;
+
+    // valid helper, returns the black height of the subtree or -1 if
+    // the subtree breaks a red-black property
+    int black_height(const Node *st_root) const;
+};
+
+// default constructor
+template <typename K, typename V>
+RBTreeMap<K, V>::RBTreeMap()
+{
+    count = 0;
+    root = nullptr;
+}
+
+// copy constructor
+template <typename K, typename V>
+RBTreeMap<K, V>::RBTreeMap(const RBTreeMap &rhs)
+{
+    count = rhs.count;
+    root = copy(rhs.root, nullptr);
+}
+
+// move constructor
+template <typename K, typename V>
+RBTreeMap<K, V>::RBTreeMap(RBTreeMap &&rhs)
+{
+    *this = std::move(rhs);
+}
+
+// copy assignment
+template <typename K, typename V>
+RBTreeMap<K, V> &RBTreeMap<K, V>::operator=(const RBTreeMap &rhs)
+{
+    if (this != &rhs)
+    {
+        make_empty(root);
+        root = copy(rhs.root, nullptr);
+        count = rhs.count;
+    }
+    return *this;
+}
+
+// move assignment
+template <typename K, typename V>
+RBTreeMap<K, V> &RBTreeMap<K, V>::operator=(RBTreeMap &&rhs)
+{
+    if (this != &rhs)
+    {
+        make_empty(root);
+        root = rhs.root;
+        count = rhs.count;
+        rhs.root = nullptr;
+        rhs.count = 0;
+    }
+    return *this;
+}
+
+// destructor
+template <typename K, typename V>
+RBTreeMap<K, V>::~RBTreeMap()
+{
+    make_empty(root);
+    count = 0;
+}
+
+// Returns the number of key-value pairs in the map
+template <typename K, typename V>
+int RBTreeMap<K, V>::size() const
+{
+    return count;
+}
+
+// Tests if the map is empty
+template <typename K, typename V>
+bool RBTreeMap<K, V>::empty() const
+{
+    return count == 0;
+}
+
+// Allows values associated with a key to be updated. Throws
+// out_of_range if the given key is not in the collection.
+template <typename K, typename V>
+V &RBTreeMap<K, V>::operator[](const K &key)
+{
+    Node *node = find_node(key);
+    if (node == nullptr)
+    {
+        throw std::out_of_range("RBTreeMap<K, V>::operator[](key)");
+    }
+    return node->value;
+}
+
+// Returns the value for a given key. Throws out_of_range if the
+// given key is not in the collection.
+template <typename K, typename V>
+const V &RBTreeMap<K, V>::operator[](const K &key) const
+{
+    Node *node = find_node(key);
+    if (node == nullptr)
+    {
+        throw std::out_of_range("RBTreeMap<K, V>::operator[](key)");
+    }
+    return node->value;
+}
+
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V>
+V *RBTreeMap<K, V>::find(const K &key)
+{
+    Node *node = find_node(key);
+    return node != nullptr ? &node->value : nullptr;
+}
+
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V>
+const V *RBTreeMap<K, V>::find(const K &key) const
+{
+    Node *node = find_node(key);
+    return node != nullptr ? &node->value : nullptr;
+}
+
+// Allows values associated with a key of type Q to be updated
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+V &RBTreeMap<K, V>::operator[](const Q &key)
+{
+    Node *node = find_node(key);
+    if (node == nullptr)
+    {
+        throw std::out_of_range("RBTreeMap<K, V>::operator[](key)");
+    }
+    return node->value;
+}
+
+// Returns the value for a key of type Q
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+const V &RBTreeMap<K, V>::operator[](const Q &key) const
+{
+    Node *node = find_node(key);
+    if (node == nullptr)
+    {
+        throw std::out_of_range("RBTreeMap<K, V>::operator[](key)");
+    }
+    return node->value;
+}
+
+// Extends the collection by adding the given key-value pair
+template <typename K, typename V>
+void RBTreeMap<K, V>::insert(const K &key, const V &value)
+{
+    emplace(key, value);
+}
+
+// Extends the collection by moving in the given key-value pair
+template <typename K, typename V>
+void RBTreeMap<K, V>::insert(K &&key, V &&value)
+{
+    emplace(std::move(key), std::move(value));
+}
+
+// Extends the collection by adding the key with a value constructed
+// from args
+template <typename K, typename V>
+template <typename KK, typename... Args>
+void RBTreeMap<K, V>::emplace(KK &&key, Args &&...args)
+{
+    // the key and value are built directly in the node
+    Node *node = new Node{K(std::forward<KK>(key)),
+                          V(std::forward<Args>(args)...), nullptr, nullptr, 0};
+    // walk down to the empty link where the key belongs
+    Node *parent = nullptr;
+    Node **link = &root;
+    while (*link != nullptr)
+    {
+        parent = *link;
+        link = (node->key < parent->key) ? &parent->left : &parent->right;
+    }
+    add_node(link, parent, node);
+}
+
+// Adds the key with a value constructed from args if the key is not
+// in the collection
+template <typename K, typename V>
+template <typename KK, typename... Args>
+bool RBTreeMap<K, V>::try_emplace(KK &&key, Args &&...args)
+{
+    Node *parent = nullptr;
+    Node **link = find_link(key, parent);
+    if (*link != nullptr)
+    {
+        return false;
+    }
+    add_node(link, parent, new Node{K(std::forward<KK>(key)),
+                                    V(std::forward<Args>(args)...),
+                                    nullptr, nullptr, 0});
+    return true;
+}
+
+// Adds the key-value pair, or assigns the value if the key is present
+template <typename K, typename V>
+bool RBTreeMap<K, V>::insert_or_assign(const K &key, const V &value)
+{
+    Node *parent = nullptr;
+    Node **link = find_link(key, parent);
+    if (*link != nullptr)
+    {
+        (*link)->value = value;
+        return false;
+    }
+    add_node(link, parent, new Node{key, value, nullptr, nullptr, 0});
+    return true;
+}
+
+// Returns the value for a given key, adding a default value if needed
+template <typename K, typename V>
+V &RBTreeMap<K, V>::get_or_insert_default(const K &key)
+{
+    Node *parent = nullptr;
+    Node **link = find_link(key, parent);
+    if (*link != nullptr)
+    {
+        return (*link)->value;
+    }
+    // fixup rotations move nodes, so hold on to the new one
+    Node *node = new Node{key, V(), nullptr, nullptr, 0};
+    add_node(link, parent, node);
+    return node->value;
+}
+
+// Shrinks the collection by removing the key-value pair with the
+// given key. Throws out_of_range if the key is not in the collection.
+template <typename K, typename V>
+void RBTreeMap<K, V>::erase(const K &key)
+{
+    if (!try_erase(key))
+    {
+        throw std::out_of_range("RBTreeMap<K, V>::erase(key)");
+    }
+}
+
+// Removes the key-value pair if present, returning whether it was
+template <typename K, typename V>
+bool RBTreeMap<K, V>::try_erase(const K &key)
+{
+    Node *node = find_node(key);
+    if (node == nullptr)
+    {
+        return false;
+    }
+    // child is the node (possibly nullptr) that moves into the place
+    // of the node actually unlinked from the tree
+    Node *child = nullptr;
+    Node *child_parent = nullptr;
+    bool removed_red = is_red(node);
+    if (node->left == nullptr)
+    {
+        child = node->right;
+        child_parent = parent(node);
+        transplant(node, node->right);
+    }
+    else if (node->right == nullptr)
+    {
+        child = node->left;
+        child_parent = parent(node);
+        transplant(node, node->left);
+    }
+    else
+    {
+        // relink the in-order successor in the node's place
+        Node *succ = node->right;
+        while (succ->left != nullptr)
+        {
+            succ = succ->left;
+        }
+        removed_red = is_red(succ);
+        child = succ->right;
+        if (parent(succ) == node)
+        {
+            child_parent = succ;
+        }
+        else
+        {
+            child_parent = parent(succ);
+            transplant(succ, succ->right);
+            succ->right = node->right;
+            set_parent(succ->right, succ);
+        }
+        transplant(node, succ);
+        succ->left = node->left;
+        set_parent(succ->left, succ);
+        set_red(succ, is_red(node));
+    }
+    delete node;
+    --count;
+    if (!removed_red)
+    {
+        erase_fixup(child, child_parent);
+    }
+    return true;
+}
+
+// Returns true if the key is in the collection, and false otherwise.
+template <typename K, typename V>
+bool RBTreeMap<K, V>::contains(const K &key) const
+{
+    return find_node(key) != nullptr;
+}
+
+// Returns true if a key of type Q is in the collection
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+bool RBTreeMap<K, V>::contains(const Q &key) const
+{
+    return find_node(key) != nullptr;
+}
+
+// Returns the keys k in the collection such that k1 <= k <= k2
+template <typename K, typename V>
+ArraySeq<K> RBTreeMap<K, V>::find_keys(const K &k1, const K &k2) const
+{
+    ArraySeq<K> keys;
+    find_keys(k1, k2, root, keys);
+    return keys;
+}
+
+// Appends the keys k in the collection such that k1 <= k <= k2
+template <typename K, typename V>
+template <typename Seq>
+void RBTreeMap<K, V>::find_keys(const K &k1, const K &k2, Seq &keys) const
+{
+    find_keys(k1, k2, root, keys);
+}
+
+// Returns the keys in the collection in ascending sorted order
+template <typename K, typename V>
+ArraySeq<K> RBTreeMap<K, V>::sorted_keys() const
+{
+    ArraySeq<K> keys;
+    keys.reserve(count);
+    sorted_keys(root, keys);
+    return keys;
+}
+
+// Returns the height of the tree
+template <typename K, typename V>
+int RBTreeMap<K, V>::height() const
+{
+    return height(root);
+}
+
+// Returns true if the tree satisfies the red-black properties
+template <typename K, typename V>
+bool RBTreeMap<K, V>::valid() const
+{
+    if (is_red(root) || (root != nullptr && parent(root) != nullptr))
+    {
+        return false;
+    }
+    return black_height(root) >= 0;
+}
+
+// Private
+
+// returns the parent of the node
+template <typename K, typename V>
+typename RBTreeMap<K, V>::Node *RBTreeMap<K, V>::parent(const Node *node)
+{
+    return reinterpret_cast<Node *>(node->parent_color & ~RED);
+}
+
+// returns true if the node is red (nullptr leaves are black)
+template <typename K, typename V>
+bool RBTreeMap<K, V>::is_red(const Node *node)
+{
+    return node != nullptr && (node->parent_color & RED);
+}
+
+// sets the parent of the node, keeping its color
+template <typename K, typename V>
+void RBTreeMap<K, V>::set_parent(Node *node, Node *parent)
+{
+    node->parent_color = reinterpret_cast<std::uintptr_t>(parent) |
+                         (node->parent_color & RED);
+}
+
+// sets the color of the node, keeping its parent
+template <typename K, typename V>
+void RBTreeMap<K, V>::set_red(Node *node, bool red)
+{
+    node->parent_color = (node->parent_color & ~RED) | (red ? RED : 0);
+}
+
+// returns the node with the given key, or nullptr
+template <typename K, typename V>
+template <typename Q>
+typename RBTreeMap<K, V>::Node *RBTreeMap<K, V>::find_node(const Q &key) const
+{
+    Node *curr = root;
+    while (curr != nullptr)
+    {
+        if (curr->key == key)
+        {
+            return curr;
+        }
+        else if (curr->key < key)
+        {
+            curr = curr->right;
+        }
+        else
+        {
+            curr = curr->left;
+        }
+    }
+    return nullptr;
+}
+
+// returns the link to the node with the given key, or the null link
+// where the key belongs
+template <typename K, typename V>
+template <typename Q>
+typename RBTreeMap<K, V>::Node **RBTreeMap<K, V>::find_link(const Q &key, Node *&parent)
+{
+    parent = nullptr;
+    Node **link = &root;
+    while (*link != nullptr && !((*link)->key == key))
+    {
+        parent = *link;
+        link = (parent->key < key) ? &parent->right : &parent->left;
+    }
+    return link;
+}
+
+// links the new node in at a null link and rebalances
+template <typename K, typename V>
+void RBTreeMap<K, V>::add_node(Node **link, Node *parent, Node *node)
+{
+    set_parent(node, parent);
+    set_red(node, true);
+    *link = node;
+    insert_fixup(node);
+    ++count;
+}
+
+// clean up the tree given subtree root
+template <typename K, typename V>
+void RBTreeMap<K, V>::make_empty(Node *st_root)
+{
+    if (st_root != nullptr)
+    {
+        make_empty(st_root->left);
+        make_empty(st_root->right);
+        delete st_root;
+    }
+}
+
+// copy helper
+template <typename K, typename V>
+typename RBTreeMap<K, V>::Node *RBTreeMap<K, V>::copy(const Node *rhs_st_root,
+                                                      Node *parent) const
+{
+    if (rhs_st_root == nullptr)
+    {
+        return nullptr;
+    }
+    Node *new_node = new Node{rhs_st_root->key, rhs_st_root->value, nullptr,
+                              nullptr, 0};
+    set_parent(new_node, parent);
+    set_red(new_node, is_red(rhs_st_root));
+    new_node->left = copy(rhs_st_root->left, new_node);
+    new_node->right = copy(rhs_st_root->right, new_node);
+    return new_node;
+}
+
+// left rotation, x's right child takes its place
+template <typename K, typename V>
+void RBTreeMap<K, V>::rotate_left(Node *x)
+{
+    Node *y = x->right;
+    x->right = y->left;
+    if (y->left != nullptr)
+    {
+        set_parent(y->left, x);
+    }
+    transplant(x, y);
+    y->left = x;
+    set_parent(x, y);
+}
+
+// right rotation, x's left child takes its place
+template <typename K, typename V>
+void RBTreeMap<K, V>::rotate_right(Node *x)
+{
+    Node *y = x->left;
+    x->left = y->right;
+    if (y->right != nullptr)
+    {
+        set_parent(y->right, x);
+    }
+    transplant(x, y);
+    y->right = x;
+    set_parent(x, y);
+}
+
+// replaces the subtree rooted at u with the one rooted at v
+template <typename K, typename V>
+void RBTreeMap<K, V>::transplant(Node *u, Node *v)
+{
+    Node *p = parent(u);
+    if (p == nullptr)
+    {
+        root = v;
+    }
+    else if (u == p->left)
+    {
+        p->left = v;
+    }
+    else
+    {
+        p->right = v;
+    }
+    if (v != nullptr)
+    {
+        set_parent(v, p);
+    }
+}
+
+// restores the red-black properties after an insert
+template <typename K, typename V>
+void RBTreeMap<K, V>::insert_fixup(Node *node)
+{
+    // a red parent is never the root, so the grandparent exists
+    while (is_red(parent(node)))
+    {
+        Node *p = parent(node);
+        Node *g = parent(p);
+        if (p == g->left)
+        {
+            Node *uncle = g->right;
+            if (is_red(uncle))
+            {
+                // recolor and continue from the grandparent
+                set_red(p, false);
+                set_red(uncle, false);
+                set_red(g, true);
+                node = g;
+            }
+            else
+            {
+                if (node == p->right)
+                {
+                    rotate_left(p);
+                    node = p;
+                    p = parent(node);
+                }
+                set_red(p, false);
+                set_red(g, true);
+                rotate_right(g);
+            }
+        }
+        else
+        {
+            Node *uncle = g->left;
+            if (is_red(uncle))
+            {
+                set_red(p, false);
+                set_red(uncle, false);
+                set_red(g, true);
+                node = g;
+            }
+            else
+            {
+                if (node == p->left)
+                {
+                    rotate_right(p);
+                    node = p;
+                    p = parent(node);
+                }
+                set_red(p, false);
+                set_red(g, true);
+                rotate_left(g);
+            }
+        }
+    }
+    set_red(root, false);
+}
+
+// restores the red-black properties after removing a black node
+template <typename K, typename V>
+void RBTreeMap<K, V>::erase_fixup(Node *node, Node *parent)
+{
+    // node carries an extra black until it reaches a red node or the
+    // root, or a rotation absorbs it
+    while (node != root && !is_red(node))
+    {
+        if (node == parent->left)
+        {
+            Node *sibling = parent->right;
+            if (is_red(sibling))
+            {
+                set_red(sibling, false);
+                set_red(parent, true);
+                rotate_left(parent);
+                sibling = parent->right;
+            }
+            if (!is_red(sibling->left) && !is_red(sibling->right))
+            {
+                set_red(sibling, true);
+                node = parent;
+                parent = RBTreeMap::parent(node);
+            }
+            else
+            {
+                if (!is_red(sibling->right))
+                {
+                    set_red(sibling->left, false);
+                    set_red(sibling, true);
+                    rotate_right(sibling);
+                    sibling = parent->right;
+                }
+                set_red(sibling, is_red(parent));
+                set_red(parent, false);
+                set_red(sibling->right, false);
+                rotate_left(parent);
+                node = root;
+            }
+        }
+        else
+        {
+            Node *sibling = parent->left;
+            if (is_red(sibling))
+            {
+                set_red(sibling, false);
+                set_red(parent, true);
+                rotate_right(parent);
+                sibling = parent->left;
+            }
+            if (!is_red(sibling->left) && !is_red(sibling->right))
+            {
+                set_red(sibling, true);
+                node = parent;
+                parent = RBTreeMap::parent(node);
+            }
+            else
+            {
+                if (!is_red(sibling->left))
+                {
+                    set_red(sibling->right, false);
+                    set_red(sibling, true);
+                    rotate_left(sibling);
+                    sibling = parent->left;
+                }
+                set_red(sibling, is_red(parent));
+                set_red(parent, false);
+                set_red(sibling->left, false);
+                rotate_right(parent);
+                node = root;
+            }
+        }
+    }
+    if (node != nullptr)
+    {
+        set_red(node, false);
+    }
+}
+
+// find_keys helper
+template <typename K, typename V>
+template <typename Seq>
+void RBTreeMap<K, V>::find_keys(const K &k1, const K &k2, const Node *st_root,
+                                Seq &keys) const
+{
+    if (st_root == nullptr)
+    {
+        return;
+    }
+    if (k1 < st_root->key)
+    {
+        find_keys(k1, k2, st_root->left, keys);
+    }
+    if (k1 <= st_root->key && st_root->key <= k2)
+    {
+        keys.insert(st_root->key, keys.size());
+    }
+    if (st_root->key < k2)
+    {
+        find_keys(k1, k2, st_root->right, keys);
+    }
+}
+
+// sorted_keys helper
+template <typename K, typename V>
+void RBTreeMap<K, V>::sorted_keys(const Node *st_root, ArraySeq<K> &keys) const
+{
+    if (st_root != nullptr)
+    {
+        sorted_keys(st_root->left, keys);
+        keys.insert(st_root->key, keys.size());
+        sorted_keys(st_root->right, keys);
+    }
+}
+
+// height helper
+template <typename K, typename V>
+int RBTreeMap<K, V>::height(const Node *st_root) const
+{
+    if (st_root == nullptr)
+    {
+        return 0;
+    }
+    return 1 + std::max(height(st_root->left), height(st_root->right));
+}
+
+// valid helper
+template <typename K, typename V>
+int RBTreeMap<K, V>::black_height(const Node *st_root) const
+{
+    if (st_root == nullptr)
+    {
+        return 0;
+    }
+    const Node *children[] = {st_root->left, st_root->right};
+    for (const Node *child : children)
+    {
+        if (child != nullptr &&
+            (parent(child) != st_root || (is_red(st_root) && is_red(child))))
+        {
+            return -1;
+        }
+    }
+    if ((st_root->left != nullptr && !(st_root->left->key < st_root->key)) ||
+        (st_root->right != nullptr && !(st_root->key < st_root->right->key)))
+    {
+        return -1;
+    }
+    int left = black_height(st_root->left);
+    int right = black_height(st_root->right);
+    if (left < 0 || left != right)
+    {
+        return -1;
+    }
+    return left + (is_red(st_root) ? 0 : 1);
+}
+
+#endif
@@ -0,0 +1,351 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: smallarrayseq.h
+// DATE: Fall 2021
+// DESC: An array sequence with room for N elements inside the object
+//       itself. Up to N elements never touch the heap; past that the
+//       elements move to a heap array that doubles as it fills, as in
+//       ArraySeq. Moving a sequence steals its heap array if it has
+//       one and moves the elements one by one if they are inline.
+//       Like ArraySeq, T must be default constructible and
+//       assignable (the inline slots always hold constructed
+//       elements).
+//---------------------------------------------------------------------------
+
+#ifndef SMALLARRAYSEQ_H
+#define SMALLARRAYSEQ_H
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include "sequence.h"
+
+template <typename T, int N>
+class SmallArraySeq : public Sequence<T>
+{
+    static_assert(N > 0, "SmallArraySeq needs room for at least one element");
+
+public:
+    // Default constructor
+    SmallArraySeq();
+
+    // Copy constructor
+    SmallArraySeq(const SmallArraySeq &rhs);
+
+    // Move constructor
+    SmallArraySeq(SmallArraySeq &&rhs);
+
+    // Copy assignment operator
+    SmallArraySeq &operator=(const SmallArraySeq &rhs);
+
+    // Move assignment operator
+    SmallArraySeq &operator=(SmallArraySeq &&rhs);
+
+    // Destructor
+    ~SmallArraySeq();
+
+    // Returns the number of elements in the sequence
+    virtual int size() const;
+
+    // Tests if the sequence is empty
+    virtual bool empty() const;
+
+    // Returns a reference to the element at the index in the
+    // sequence. Throws out_of_range if index is invalid.
+    virtual T &operator[](int index);
+
+    // Returns a constant address to the element at the index in the
+    // sequence. Throws out_of_range if index is invalid.
+    virtual const T &operator[](int index) const;
+
+    // Extends the sequence by inserting the element at the given
+    // index. Throws out_of_range if the index is invalid.
+    virtual void insert(const T &elem, int index);
+
+    // Shrinks the sequence by removing the element at the index in the
+    // sequence. Throws out_of_range if index is invalid.
+    virtual void erase(int index);
+
+    // Returns true if the element is in the sequence, and false
+    // otherwise.
+    virtual bool contains(const T &elem) const;
+
+    // Sorts the elements in the sequence
+    virtual void sort();
+
+    // Grows the capacity of the sequence to hold at least n elements
+    // without resizing
+    void reserve(int n);
+
+    // Returns the number of elements the sequence can hold without
+    // resizing
+    int capacity() const;
+
+    // Returns true while the elements are stored inside the object
+    bool is_inline() const;
+
+    // Returns the underlying array for read-only bulk access. The
+    // pointer is invalidated by any insert, erase, or move.
+    const T *data() const;
+
+private:
+    // inline storage, used while the elements fit
+    T local[N];
+
+    // the elements: local, or a heap array of cap elements
+    T *array = local;
+
+    // number of elements
+    int count = 0;
+
+    // capacity of array
+    int cap = N;
+
+    // moves the elements to a heap array of new_cap elements
+    void grow(int new_cap);
+
+    // frees any heap array and returns to the empty inline state
+    void make_empty();
+
+    // takes rhs's elements, leaving rhs empty
+    void steal(SmallArraySeq &rhs);
+};
+
+// Default constructor
+template <typename T, int N>
+SmallArraySeq<T, N>::SmallArraySeq()
+{
+}
+
+// Copy constructor
+template <typename T, int N>
+SmallArraySeq<T, N>::SmallArraySeq(const SmallArraySeq &rhs)
+{
+    *this = rhs;
+}
+
+// Move constructor
+template <typename T, int N>
+SmallArraySeq<T, N>::SmallArraySeq(SmallArraySeq &&rhs)
+{
+    steal(rhs);
+}
+
+// Copy assignment operator
+template <typename T, int N>
+SmallArraySeq<T, N> &SmallArraySeq<T, N>::operator=(const SmallArraySeq &rhs)
+{
+    if (this != &rhs)
+    {
+        count = 0;
+        reserve(rhs.count);
+        for (int i = 0; i < rhs.count; ++i)
+        {
+            array[i] = rhs.array[i];
+        }
+        count = rhs.count;
+    }
+    return *this;
+}
+
+// Move assignment operator
+template <typename T, int N>
+SmallArraySeq<T, N> &SmallArraySeq<T, N>::operator=(SmallArraySeq &&rhs)
+{
+    if (this != &rhs)
+    {
+        make_empty();
+        steal(rhs);
+    }
+    return *this;
+}
+
+// Destructor
+template <typename T, int N>
+SmallArraySeq<T, N>::~SmallArraySeq()
+{
+    make_empty();
+}
+
+// Returns the number of elements in the sequence
+template <typename T, int N>
+int SmallArraySeq<T, N>::size() const
+{
+    return count;
+}
+
+// Tests if the sequence is empty
+template <typename T, int N>
+bool SmallArraySeq<T, N>::empty() const
+{
+    return count == 0;
+}
+
+// Returns a reference to the element at the index
+template <typename T, int N>
+T &SmallArraySeq<T, N>::operator[](int index)
+{
+    if (index >= count || index < 0)
+    {
+        throw std::out_of_range("SmallArraySeq<T, N>::operator[](index)");
+    }
+    return array[index];
+}
+
+// Returns a constant address to the element at the index
+template <typename T, int N>
+const T &SmallArraySeq<T, N>::operator[](int index) const
+{
+    if (index >= count || index < 0)
+    {
+        throw std::out_of_range("SmallArraySeq<T, N>::operator[](index)");
+    }
+    return array[index];
+}
+
+// Extends the sequence by inserting the element at the given index
+template <typename T, int N>
+void SmallArraySeq<T, N>::insert(const T &elem, int index)
+{
+    if (index > count || index < 0)
+    {
+        throw std::out_of_range("SmallArraySeq<T, N>::insert(elem, index)");
+    }
+    // copy first, since elem may be one of our own elements (which the
+    // grow or the shift below would move from)
+    T temp = elem;
+    if (count == cap)
+    {
+        grow(2 * cap);
+    }
+    for (int i = count; i > index; --i)
+    {
+        array[i] = std::move(array[i - 1]);
+    }
+    array[index] = std::move(temp);
+    ++count;
+}
+
+// Shrinks the sequence by removing the element at the index
+template <typename T, int N>
+void SmallArraySeq<T, N>::erase(int index)
+{
+    if (index >= count || index < 0)
+    {
+        throw std::out_of_range("SmallArraySeq<T, N>::erase(index)");
+    }
+    for (int i = index; i < count - 1; ++i)
+    {
+        array[i] = std::move(array[i + 1]);
+    }
+    --count;
+}
+
+// Returns true if the element is in the sequence
+template <typename T, int N>
+bool SmallArraySeq<T, N>::contains(const T &elem) const
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (array[i] == elem)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Sorts the elements in the sequence
+template <typename T, int N>
+void SmallArraySeq<T, N>::sort()
+{
+    std::sort(array, array + count);
+}
+
+// Grows the capacity to hold at least n elements
+template <typename T, int N>
+void SmallArraySeq<T, N>::reserve(int n)
+{
+    if (n > cap)
+    {
+        grow(n);
+    }
+}
+
+// Returns the capacity
+template <typename T, int N>
+int SmallArraySeq<T, N>::capacity() const
+{
+    return cap;
+}
+
+// Returns true while the elements are inline
+template <typename T, int N>
+bool SmallArraySeq<T, N>::is_inline() const
+{
+    return array == local;
+}
+
+// Returns the underlying array
+template <typename T, int N>
+const T *SmallArraySeq<T, N>::data() const
+{
+    return array;
+}
+
+// moves the elements to a heap array of new_cap elements
+template <typename T, int N>
+void SmallArraySeq<T, N>::grow(int new_cap)
+{
+    T *new_array = new T[new_cap];
+    for (int i = 0; i < count; ++i)
+    {
+        new_array[i] = std::move(array[i]);
+    }
+    if (array != local)
+    {
+        delete[] array;
+    }
+    array = new_array;
+    cap = new_cap;
+}
+
+// frees any heap array and returns to the empty inline state
+template <typename T, int N>
+void SmallArraySeq<T, N>::make_empty()
+{
+    if (array != local)
+    {
+        delete[] array;
+    }
+    array = local;
+    cap = N;
+    count = 0;
+}
+
+// takes rhs's elements, leaving rhs empty (assumes this is empty and
+// inline)
+template <typename T, int N>
+void SmallArraySeq<T, N>::steal(SmallArraySeq &rhs)
+{
+    if (rhs.array != rhs.local)
+    {
+        array = rhs.array;
+        cap = rhs.cap;
+        count = rhs.count;
+        rhs.array = rhs.local;
+        rhs.cap = N;
+        rhs.count = 0;
+    }
+    else
+    {
+        for (int i = 0; i < rhs.count; ++i)
+        {
+            local[i] = std::move(rhs.local[i]);
+        }
+        count = rhs.count;
+        rhs.count = 0;
+    }
+}
+
+#endif
@@ -0,0 +1,319 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: snapshot.h
+// DATE: Fall 2021
+// DESC: Helpers for the binary snapshot format used by the save and
+//       load functions of the sequence and map classes. A snapshot is
+//       a fixed-size header followed by count records. Each record is
+//       the raw bytes of a key (or sequence element) followed by the
+//       raw bytes of its value (maps only), so only trivially copyable
+//       keys and values are supported. Records are written in sorted
+//       order for the ordered maps and in bucket order for HashMap.
+//---------------------------------------------------------------------------
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// current snapshot format version
+const std::uint32_t SNAPSHOT_VERSION = 1;
+
+// the kind of collection stored in a snapshot
+enum SnapshotKind : std::uint32_t
+{
+    ARRAYSEQ_SNAPSHOT = 1,
+    BINSEARCHMAP_SNAPSHOT = 2,
+    HASHMAP_SNAPSHOT = 3,
+    BSTMAP_SNAPSHOT = 4,
+    AVLMAP_SNAPSHOT = 5
+};
+
+// snapshot file header
+struct SnapshotHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t kind;
+    std::uint32_t key_size;
+    std::uint32_t value_size;
+    std::uint32_t reserved;
+    std::uint64_t count;
+};
+
+// number of records moved per read or write call
+const int SNAPSHOT_BLOCK_RECORDS = 4096;
+
+//----------------------------------------------------------------------
+// Returns a snapshot header for count records of the given kind and
+// key/value sizes.
+//----------------------------------------------------------------------
+inline SnapshotHeader make_snapshot_header(SnapshotKind kind,
+                                           std::uint32_t key_size,
+                                           std::uint32_t value_size,
+                                           std::uint64_t count)
+{
+    SnapshotHeader header = {{'C', 'S', '2', '3'}, SNAPSHOT_VERSION, kind,
+                             key_size, value_size, 0, count};
+    return header;
+}
+
+//----------------------------------------------------------------------
+// Opens the file and writes a snapshot header. Throws runtime_error if
+// the file cannot be opened.
+//
+// Inputs:
+//   path       -- the snapshot file
+//   kind       -- the kind of collection being saved
+//   key_size   -- size in bytes of each key (or element)
+//   value_size -- size in bytes of each value (0 for sequences)
+//   count      -- the number of records that follow the header
+//
+// Outputs:
+//   out        -- the opened stream positioned after the header
+//----------------------------------------------------------------------
+inline void write_snapshot_header(std::ofstream &out, const std::string &path,
+                                  SnapshotKind kind, std::uint32_t key_size,
+                                  std::uint32_t value_size, std::uint64_t count)
+{
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        throw std::runtime_error("cannot open snapshot for writing: " + path);
+    }
+    SnapshotHeader header = make_snapshot_header(kind, key_size, value_size,
+                                                 count);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+//----------------------------------------------------------------------
+// Validates a snapshot header. Throws runtime_error if the header is
+// not a snapshot header or does not match the expected kind and
+// key/value sizes.
+//
+// Inputs:
+//   header     -- the header to check
+//   path       -- the snapshot file (for error messages)
+//   kind       -- the expected kind of collection
+//   key_size   -- expected size in bytes of each key (or element)
+//   value_size -- expected size in bytes of each value
+//----------------------------------------------------------------------
+inline void check_snapshot_header(const SnapshotHeader &header,
+                                  const std::string &path, SnapshotKind kind,
+                                  std::uint32_t key_size,
+                                  std::uint32_t value_size)
+{
+    if (std::memcmp(header.magic, "CS23", 4) != 0)
+    {
+        throw std::runtime_error("not a snapshot file: " + path);
+    }
+    if (header.version != SNAPSHOT_VERSION)
+    {
+        throw std::runtime_error("unsupported snapshot version: " + path);
+    }
+    if (header.kind != kind || header.key_size != key_size ||
+        header.value_size != value_size)
+    {
+        throw std::runtime_error("snapshot type mismatch: " + path);
+    }
+}
+
+//----------------------------------------------------------------------
+// Opens the file and reads and validates a snapshot header. Throws
+// runtime_error if the file cannot be opened, is not a snapshot, does
+// not match the expected kind and key/value sizes, or is too short to
+// hold the records its header counts (so a corrupt count is rejected
+// before anything is sized from it).
+//
+// Inputs:
+//   path       -- the snapshot file
+//   kind       -- the expected kind of collection
+//   key_size   -- expected size in bytes of each key (or element)
+//   value_size -- expected size in bytes of each value
+//
+// Outputs:
+//   in         -- the opened stream positioned after the header
+//   returns the number of records in the snapshot
+//----------------------------------------------------------------------
+inline std::uint64_t read_snapshot_header(std::ifstream &in,
+                                          const std::string &path,
+                                          SnapshotKind kind,
+                                          std::uint32_t key_size,
+                                          std::uint32_t value_size)
+{
+    in.open(path, std::ios::binary);
+    if (!in)
+    {
+        throw std::runtime_error("cannot open snapshot for reading: " + path);
+    }
+    SnapshotHeader header;
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)))
+    {
+        throw std::runtime_error("not a snapshot file: " + path);
+    }
+    check_snapshot_header(header, path, kind, key_size, value_size);
+    std::streampos start = in.tellg();
+    in.seekg(0, std::ios::end);
+    std::uint64_t bytes = (std::uint64_t)(in.tellg() - start);
+    in.seekg(start);
+    std::uint64_t record_size = (std::uint64_t)key_size + value_size;
+    if (!in || header.count > bytes / record_size)
+    {
+        throw std::runtime_error("snapshot is truncated: " + path);
+    }
+    return header.count;
+}
+
+//----------------------------------------------------------------------
+// Returns a snapshot's record count as an int, for loading into a
+// collection indexed by int. Throws runtime_error if it does not fit.
+//
+// Inputs:
+//   count -- the number of records in the snapshot
+//   path  -- the snapshot file (for error messages)
+//----------------------------------------------------------------------
+inline int snapshot_count_as_int(std::uint64_t count, const std::string &path)
+{
+    if (count > (std::uint64_t)std::numeric_limits<int>::max())
+    {
+        throw std::runtime_error("snapshot is too large to load: " + path);
+    }
+    return (int)count;
+}
+
+//----------------------------------------------------------------------
+// Buffered writer for key-value snapshot records.
+//----------------------------------------------------------------------
+template <typename K, typename V>
+class SnapshotWriter
+{
+public:
+    static_assert(std::is_trivially_copyable<K>::value &&
+                      std::is_trivially_copyable<V>::value,
+                  "snapshots require trivially copyable keys and values");
+
+    // Writes the header for count records to the file at path
+    SnapshotWriter(const std::string &path, SnapshotKind kind,
+                   std::uint64_t count)
+    {
+        write_snapshot_header(out, path, kind, sizeof(K), sizeof(V), count);
+        buffer = new char[buffer_size];
+    }
+
+    SnapshotWriter(const SnapshotWriter &rhs) = delete;
+    SnapshotWriter &operator=(const SnapshotWriter &rhs) = delete;
+
+    // destructor (call flush first, unflushed records are dropped)
+    ~SnapshotWriter()
+    {
+        delete[] buffer;
+    }
+
+    // Appends a record
+    void write(const K &key, const V &value)
+    {
+        std::memcpy(buffer + used, &key, sizeof(K));
+        std::memcpy(buffer + used + sizeof(K), &value, sizeof(V));
+        used += record_size;
+        if (used == buffer_size)
+        {
+            flush();
+        }
+    }
+
+    // Writes the buffered records to the file
+    void flush()
+    {
+        out.write(buffer, used);
+        used = 0;
+        if (!out)
+        {
+            throw std::runtime_error("snapshot write failed");
+        }
+    }
+
+private:
+    static const std::size_t record_size = sizeof(K) + sizeof(V);
+    static const std::size_t buffer_size = record_size * SNAPSHOT_BLOCK_RECORDS;
+    std::ofstream out;
+    char *buffer = nullptr;
+    std::size_t used = 0;
+};
+
+//----------------------------------------------------------------------
+// Buffered reader for key-value snapshot records.
+//----------------------------------------------------------------------
+template <typename K, typename V>
+class SnapshotReader
+{
+public:
+    static_assert(std::is_trivially_copyable<K>::value &&
+                      std::is_trivially_copyable<V>::value,
+                  "snapshots require trivially copyable keys and values");
+
+    // Reads and validates the header of the file at path
+    SnapshotReader(const std::string &path, SnapshotKind kind)
+    {
+        remaining = read_snapshot_header(in, path, kind, sizeof(K), sizeof(V));
+        buffer = new char[record_size * SNAPSHOT_BLOCK_RECORDS];
+    }
+
+    SnapshotReader(const SnapshotReader &rhs) = delete;
+    SnapshotReader &operator=(const SnapshotReader &rhs) = delete;
+
+    // destructor
+    ~SnapshotReader()
+    {
+        delete[] buffer;
+    }
+
+    // Returns the number of records in the snapshot
+    std::uint64_t count() const
+    {
+        return remaining + (available - next) / record_size;
+    }
+
+    // Reads the next record. Throws runtime_error if the file ends
+    // early.
+    void read(K &key, V &value)
+    {
+        if (next == available)
+        {
+            fill();
+        }
+        std::memcpy(&key, buffer + next, sizeof(K));
+        std::memcpy(&value, buffer + next + sizeof(K), sizeof(V));
+        next += record_size;
+    }
+
+private:
+    static const std::size_t record_size = sizeof(K) + sizeof(V);
+    std::ifstream in;
+    char *buffer = nullptr;
+    std::size_t next = 0;
+    std::size_t available = 0;
+    std::uint64_t remaining = 0;
+
+    // read the next block of records
+    void fill()
+    {
+        std::uint64_t records = remaining < SNAPSHOT_BLOCK_RECORDS
+                                    ? remaining
+                                    : SNAPSHOT_BLOCK_RECORDS;
+        if (records == 0 || !in.read(buffer, records * record_size))
+        {
+            throw std::runtime_error("snapshot is truncated");
+        }
+        remaining -= records;
+        available = records * record_size;
+        next = 0;
+    }
+};
+
+#endif
@@ -0,0 +1,689 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: splaymap.h
+// DATE: Fall 2021
+// DESC: A splay tree implementation of the Map interface. Every access
+//       (including contains and the const operator[]) splays the key
+//       to the root with top-down splaying, so recently used keys stay
+//       within a few nodes of the root and skewed (e.g., Zipfian)
+//       lookups are cheap. Splay trees can temporarily become very
+//       deep, so no operation recurses on the tree.
+//
+//       Because lookups restructure the tree, a const SplayMap is not
+//       safe to share between threads.
+//---------------------------------------------------------------------------
+
+#ifndef SPLAYMAP_H
+#define SPLAYMAP_H
+
+#include <stdexcept>
+#include <utility>
+#include "map.h"
+#include "arrayseq.h"
+
+template <typename K, typename V>
+class SplayMap : public Map<K, V>
+{
+public:
+    // default constructor
+    SplayMap();
+
+    // copy constructor
+    SplayMap(const SplayMap &rhs);
+
+    // move constructor
+    SplayMap(SplayMap &&rhs);
+
+    // copy assignment
+    SplayMap &operator=(const SplayMap &rhs);
+
+    // move assignment
+    SplayMap &operator=(SplayMap &&rhs);
+
+    // destructor
+    ~SplayMap();
+
+    // Returns the number of key-value pairs in the map
+    int size() const;
+
+    // Tests if the map is empty
+    bool empty() const;
+
+    // Allows values associated with a key to be updated. Throws
+    // out_of_range if the given key is not in the collection.
+    V &operator[](const K &key);
+
+    // Returns the value for a given key. Throws out_of_range if the
+    // given key is not in the collection.
+    const V &operator[](const K &key) const;
+
+    // Returns a pointer to the value for a given key, or nullptr if
+    // the key is not in the collection.
+    V *find(const K &key);
+    const V *find(const K &key) const;
+
+    // Extends the collection by adding the given key-value
+    // pair. Assumes the key being added is not present in the
+    // collection. Insert does not check if the key is present.
+    void insert(const K &key, const V &value);
+
+    // Same as insert, but moves the key and value into the
+    // collection instead of copying them.
+    void insert(K &&key, V &&value);
+
+    // Extends the collection by adding the key with a value
+    // constructed in place from args. Like insert, assumes the key is
+    // not present in the collection.
+    template <typename KK, typename... Args>
+    void emplace(KK &&key, Args &&...args);
+
+    // Adds the key with a value constructed in place from args if the
+    // key is not in the collection. Returns true if it was added; if
+    // not, the key and args are left untouched.
+    template <typename KK, typename... Args>
+    bool try_emplace(KK &&key, Args &&...args);
+
+    // Adds the key-value pair if the key is not in the collection, and
+    // otherwise assigns value to the key's value. Returns true if the
+    // pair was added.
+    bool insert_or_assign(const K &key, const V &value);
+
+    // Returns the value for a given key, first adding the key with a
+    // default-constructed value if it is not in the collection.
+    V &get_or_insert_default(const K &key);
+
+    // Shrinks the collection by removing the key-value pair with the
+    // given key. Does not modify the collection if the collection does
+    // not contain the key. Throws out_of_range if the given key is not
+    // in the collection.
+    void erase(const K &key);
+
+    // Same as erase, but returns false instead of throwing if the key
+    // is not in the collection, and true if the pair was removed.
+    bool try_erase(const K &key);
+
+    // Returns true if the key is in the collection, and false otherwise.
+    bool contains(const K &key) const;
+
+    // Heterogeneous lookup: operator[] and contains for a key of a
+    // transparent type Q (see is_transparent_key in map.h), such as
+    // std::string_view for std::string keys, without building a K.
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    V &operator[](const Q &key);
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    const V &operator[](const Q &key) const;
+    template <typename Q, enable_if_transparent<K, Q> = 0>
+    bool contains(const Q &key) const;
+
+    // Returns the keys k in the collection such that k1 <= k <= k2
+    ArraySeq<K> find_keys(const K &k1, const K &k2) const;
+
+    // Returns the keys in the collection in ascending sorted order
+    ArraySeq<K> sorted_keys() const;
+
+    // Returns the height of the tree
+    int height() const;
+
+    // Returns the number of nodes from the root to the node with the
+    // given key (1 for the root), or 0 if the key is not in the
+    // collection. Does not splay.
+    int depth(const K &key) const;
+
+private:
+    // node for splay tree
+    struct Node
+    {
+        K key;
+        V value;
+        Node *left;
+        Node *right;
+    };
+
+    // number of nodes
+    int count = 0;
+
+    // root node (lookups splay, so it changes in const functions)
+    mutable Node *root = nullptr;
+
+    // top-down splay of the subtree for the key: returns the new
+    // subtree root, which holds the key if it is in the subtree, and
+    // otherwise the last node on the key's search path (Q is K or a
+    // transparent key type)
+    template <typename Q>
+    static Node *splay(const Q &key, Node *st_root);
+
+    // makes the new node the root, splitting the tree around the
+    // current root, which must already be splayed for the node's key
+    // (so it is the key's neighbor)
+    void add_root(Node *node);
+
+    // clean up the tree given subtree root
+    static void make_empty(Node *st_root);
+
+    // copy helper
+    static Node *copy(const Node *rhs_st_root);
+};
+
+// default constructor
+template <typename K, typename V>
+SplayMap<K, V>::SplayMap()
+{
+    count = 0;
+    root = nullptr;
+}
+
+// copy constructor
+template <typename K, typename V>
+SplayMap<K, V>::SplayMap(const SplayMap &rhs)
+{
+    count = rhs.count;
+    root = copy(rhs.root);
+}
+
+// move constructor
+template <typename K, typename V>
+SplayMap<K, V>::SplayMap(SplayMap &&rhs)
+{
+    *this = std::move(rhs);
+}
+
+// copy assignment
+template <typename K, typename V>
+SplayMap<K, V> &SplayMap<K, V>::operator=(const SplayMap &rhs)
+{
+    if (this != &rhs)
+    {
+        make_empty(root);
+        root = copy(rhs.root);
+        count = rhs.count;
+    }
+    return *this;
+}
+
+// move assignment
+template <typename K, typename V>
+SplayMap<K, V> &SplayMap<K, V>::operator=(SplayMap &&rhs)
+{
+    if (this != &rhs)
+    {
+        make_empty(root);
+        root = rhs.root;
+        count = rhs.count;
+        rhs.root = nullptr;
+        rhs.count = 0;
+    }
+    return *this;
+}
+
+// destructor
+template <typename K, typename V>
+SplayMap<K, V>::~SplayMap()
+{
+    make_empty(root);
+    count = 0;
+}
+
+// Returns the number of key-value pairs in the map
+template <typename K, typename V>
+int SplayMap<K, V>::size() const
+{
+    return count;
+}
+
+// Tests if the map is empty
+template <typename K, typename V>
+bool SplayMap<K, V>::empty() const
+{
+    return count == 0;
+}
+
+// Allows values associated with a key to be updated. Throws
+// out_of_range if the given key is not in the collection.
+template <typename K, typename V>
+V &SplayMap<K, V>::operator[](const K &key)
+{
+    root = splay(key, root);
+    if (root == nullptr || !(root->key == key))
+    {
+        throw std::out_of_range("SplayMap<K, V>::operator[](key)");
+    }
+    return root->value;
+}
+
+// Returns the value for a given key. Throws out_of_range if the
+// given key is not in the collection.
+template <typename K, typename V>
+const V &SplayMap<K, V>::operator[](const K &key) const
+{
+    root = splay(key, root);
+    if (root == nullptr || !(root->key == key))
+    {
+        throw std::out_of_range("SplayMap<K, V>::operator[](key)");
+    }
+    return root->value;
+}
+
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V>
+V *SplayMap<K, V>::find(const K &key)
+{
+    root = splay(key, root);
+    return root != nullptr && root->key == key ? &root->value : nullptr;
+}
+
+// Returns a pointer to the value for a given key, or nullptr
+template <typename K, typename V>
+const V *SplayMap<K, V>::find(const K &key) const
+{
+    root = splay(key, root);
+    return root != nullptr && root->key == key ? &root->value : nullptr;
+}
+
+// Allows values associated with a key of type Q to be updated
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+V &SplayMap<K, V>::operator[](const Q &key)
+{
+    root = splay(key, root);
+    if (root == nullptr || !(root->key == key))
+    {
+        throw std::out_of_range("SplayMap<K, V>::operator[](key)");
+    }
+    return root->value;
+}
+
+// Returns the value for a key of type Q
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+const V &SplayMap<K, V>::operator[](const Q &key) const
+{
+    root = splay(key, root);
+    if (root == nullptr || !(root->key == key))
+    {
+        throw std::out_of_range("SplayMap<K, V>::operator[](key)");
+    }
+    return root->value;
+}
+
+// Extends the collection by adding the given key-value pair
+template <typename K, typename V>
+void SplayMap<K, V>::insert(const K &key, const V &value)
+{
+    emplace(key, value);
+}
+
+// Extends the collection by moving in the given key-value pair
+template <typename K, typename V>
+void SplayMap<K, V>::insert(K &&key, V &&value)
+{
+    emplace(std::move(key), std::move(value));
+}
+
+// Extends the collection by adding the key with a value constructed
+// from args
+template <typename K, typename V>
+template <typename KK, typename... Args>
+void SplayMap<K, V>::emplace(KK &&key, Args &&...args)
+{
+    // the key and value are built directly in the node
+    Node *node = new Node{K(std::forward<KK>(key)),
+                          V(std::forward<Args>(args)...), nullptr, nullptr};
+    root = splay(node->key, root);
+    add_root(node);
+}
+
+// Adds the key with a value constructed from args if the key is not
+// in the collection
+template <typename K, typename V>
+template <typename KK, typename... Args>
+bool SplayMap<K, V>::try_emplace(KK &&key, Args &&...args)
+{
+    // a failed splay leaves the key's neighbor at the root
+    root = splay(key, root);
+    if (root != nullptr && root->key == key)
+    {
+        return false;
+    }
+    add_root(new Node{K(std::forward<KK>(key)),
+                      V(std::forward<Args>(args)...), nullptr, nullptr});
+    return true;
+}
+
+// Adds the key-value pair, or assigns the value if the key is present
+template <typename K, typename V>
+bool SplayMap<K, V>::insert_or_assign(const K &key, const V &value)
+{
+    root = splay(key, root);
+    if (root != nullptr && root->key == key)
+    {
+        root->value = value;
+        return false;
+    }
+    add_root(new Node{key, value, nullptr, nullptr});
+    return true;
+}
+
+// Returns the value for a given key, adding a default value if needed
+template <typename K, typename V>
+V &SplayMap<K, V>::get_or_insert_default(const K &key)
+{
+    root = splay(key, root);
+    if (root == nullptr || !(root->key == key))
+    {
+        add_root(new Node{key, V(), nullptr, nullptr});
+    }
+    return root->value;
+}
+
+// Shrinks the collection by removing the key-value pair with the
+// given key. Throws out_of_range if the key is not in the collection.
+template <typename K, typename V>
+void SplayMap<K, V>::erase(const K &key)
+{
+    if (!try_erase(key))
+    {
+        throw std::out_of_range("SplayMap<K, V>::erase(key)");
+    }
+}
+
+// Removes the key-value pair if present, returning whether it was
+template <typename K, typename V>
+bool SplayMap<K, V>::try_erase(const K &key)
+{
+    root = splay(key, root);
+    if (root == nullptr || !(root->key == key))
+    {
+        return false;
+    }
+    Node *old_root = root;
+    if (root->left == nullptr)
+    {
+        root = root->right;
+    }
+    else
+    {
+        // splaying the left subtree for key brings its largest key to
+        // the top, which has no right child
+        root = splay(key, root->left);
+        root->right = old_root->right;
+    }
+    delete old_root;
+    --count;
+    return true;
+}
+
+// Returns true if the key is in the collection, and false otherwise.
+template <typename K, typename V>
+bool SplayMap<K, V>::contains(const K &key) const
+{
+    root = splay(key, root);
+    return root != nullptr && root->key == key;
+}
+
+// Returns true if a key of type Q is in the collection
+template <typename K, typename V>
+template <typename Q, enable_if_transparent<K, Q>>
+bool SplayMap<K, V>::contains(const Q &key) const
+{
+    root = splay(key, root);
+    return root != nullptr && root->key == key;
+}
+
+// Returns the keys k in the collection such that k1 <= k <= k2
+template <typename K, typename V>
+ArraySeq<K> SplayMap<K, V>::find_keys(const K &k1, const K &k2) const
+{
+    // in-order walk with an explicit stack, skipping subtrees that
+    // are out of range
+    ArraySeq<K> keys;
+    ArraySeq<const Node *> stack;
+    const Node *curr = root;
+    while (curr != nullptr || !stack.empty())
+    {
+        while (curr != nullptr)
+        {
+            stack.insert(curr, stack.size());
+            curr = (k1 < curr->key) ? curr->left : nullptr;
+        }
+        curr = stack[stack.size() - 1];
+        stack.erase(stack.size() - 1);
+        if (k1 <= curr->key && curr->key <= k2)
+        {
+            keys.insert(curr->key, keys.size());
+        }
+        curr = (curr->key < k2) ? curr->right : nullptr;
+    }
+    return keys;
+}
+
+// Returns the keys in the collection in ascending sorted order
+template <typename K, typename V>
+ArraySeq<K> SplayMap<K, V>::sorted_keys() const
+{
+    ArraySeq<K> keys;
+    keys.reserve(count);
+    ArraySeq<const Node *> stack;
+    const Node *curr = root;
+    while (curr != nullptr || !stack.empty())
+    {
+        while (curr != nullptr)
+        {
+            stack.insert(curr, stack.size());
+            curr = curr->left;
+        }
+        curr = stack[stack.size() - 1];
+        stack.erase(stack.size() - 1);
+        keys.insert(curr->key, keys.size());
+        curr = curr->right;
+    }
+    return keys;
+}
+
+// Returns the height of the tree
+template <typename K, typename V>
+int SplayMap<K, V>::height() const
+{
+    int max_depth = 0;
+    ArraySeq<std::pair<const Node *, int> > stack;
+    if (root != nullptr)
+    {
+        stack.insert({root, 1}, 0);
+    }
+    while (!stack.empty())
+    {
+        std::pair<const Node *, int> top = stack[stack.size() - 1];
+        stack.erase(stack.size() - 1);
+        if (top.second > max_depth)
+        {
+            max_depth = top.second;
+        }
+        if (top.first->left != nullptr)
+        {
+            stack.insert({top.first->left, top.second + 1}, stack.size());
+        }
+        if (top.first->right != nullptr)
+        {
+            stack.insert({top.first->right, top.second + 1}, stack.size());
+        }
+    }
+    return max_depth;
+}
+
+// Returns the depth of the node with the given key, without splaying
+template <typename K, typename V>
+int SplayMap<K, V>::depth(const K &key) const
+{
+    int d = 1;
+    const Node *curr = root;
+    while (curr != nullptr)
+    {
+        if (curr->key == key)
+        {
+            return d;
+        }
+        curr = (key < curr->key) ? curr->left : curr->right;
+        ++d;
+    }
+    return 0;
+}
+
+// Private
+
+// top-down splay
+template <typename K, typename V>
+template <typename Q>
+typename SplayMap<K, V>::Node *SplayMap<K, V>::splay(const Q &key,
+                                                     Node *st_root)
+{
+    if (st_root == nullptr)
+    {
+        return nullptr;
+    }
+    // nodes less than the key are hung off the right spine of the left
+    // tree, and nodes greater than the key off the left spine of the
+    // right tree; the hooks point at the next free link of each spine
+    Node *left_tree = nullptr;
+    Node *right_tree = nullptr;
+    Node **left_hook = &left_tree;
+    Node **right_hook = &right_tree;
+    Node *t = st_root;
+    while (true)
+    {
+        if (key < t->key)
+        {
+            if (t->left == nullptr)
+            {
+                break;
+            }
+            if (key < t->left->key)
+            {
+                // zig-zig: rotate right before linking
+                Node *y = t->left;
+                t->left = y->right;
+                y->right = t;
+                t = y;
+                if (t->left == nullptr)
+                {
+                    break;
+                }
+            }
+            // link t into the right tree
+            *right_hook = t;
+            right_hook = &t->left;
+            t = t->left;
+        }
+        else if (t->key < key)
+        {
+            if (t->right == nullptr)
+            {
+                break;
+            }
+            if (t->right->key < key)
+            {
+                // zig-zig: rotate left before linking
+                Node *y = t->right;
+                t->right = y->left;
+                y->left = t;
+                t = y;
+                if (t->right == nullptr)
+                {
+                    break;
+                }
+            }
+            // link t into the left tree
+            *left_hook = t;
+            left_hook = &t->right;
+            t = t->right;
+        }
+        else
+        {
+            break;
+        }
+    }
+    // reassemble around t
+    *left_hook = t->left;
+    *right_hook = t->right;
+    t->left = left_tree;
+    t->right = right_tree;
+    return t;
+}
+
+// makes the new node the root, splitting around the splayed root
+template <typename K, typename V>
+void SplayMap<K, V>::add_root(Node *node)
+{
+    if (root != nullptr)
+    {
+        // the splayed root is the key's neighbor, split around it
+        if (node->key < root->key)
+        {
+            node->left = root->left;
+            node->right = root;
+            root->left = nullptr;
+        }
+        else
+        {
+            node->right = root->right;
+            node->left = root;
+            root->right = nullptr;
+        }
+    }
+    root = node;
+    ++count;
+}
+
+// clean up the tree given subtree root
+template <typename K, typename V>
+void SplayMap<K, V>::make_empty(Node *st_root)
+{
+    // rotate left children up so each node is deleted once its left
+    // subtree is empty, without recursion or a stack
+    while (st_root != nullptr)
+    {
+        if (st_root->left != nullptr)
+        {
+            Node *left = st_root->left;
+            st_root->left = left->right;
+            left->right = st_root;
+            st_root = left;
+        }
+        else
+        {
+            Node *right = st_root->right;
+            delete st_root;
+            st_root = right;
+        }
+    }
+}
+
+// copy helper
+template <typename K, typename V>
+typename SplayMap<K, V>::Node *SplayMap<K, V>::copy(const Node *rhs_st_root)
+{
+    // each stack entry is a source node and the link to copy it into
+    Node *new_root = nullptr;
+    ArraySeq<std::pair<const Node *, Node **> > stack;
+    if (rhs_st_root != nullptr)
+    {
+        stack.insert({rhs_st_root, &new_root}, 0);
+    }
+    while (!stack.empty())
+    {
+        std::pair<const Node *, Node **> top = stack[stack.size() - 1];
+        stack.erase(stack.size() - 1);
+        Node *node = new Node{top.first->key, top.first->value, nullptr,
+                              nullptr};
+        *top.second = node;
+        if (top.first->left != nullptr)
+        {
+            stack.insert({top.first->left, &node->left}, stack.size());
+        }
+        if (top.first->right != nullptr)
+        {
+            stack.insert({top.first->right, &node->right}, stack.size());
+        }
+    }
+    return new_root;
+}
+
+#endif
@@ -7,6 +7,8 @@
 //---------------------------------------------------------------------------
 
 #include <iostream>
+#include <cmath>
+#include <random>
 #include "util.h"
 
 
@@ -67,4 +69,30 @@ void reset_shuffled(Sequence<int>& s, int shuffles)
   faro_shuffle(s, shuffles);
 }
 
-
+void load_zipfian(Sequence<int>& s, int n, int range, double skew)
+{
+  // cumulative distribution over the values 1 to range
+  double* cdf = new double[range];
+  double total = 0;
+  for (int k = 1; k <= range; ++k) {
+    total += 1.0 / pow(k, skew);
+    cdf[k-1] = total;
+  }
+  std::mt19937 gen(223);
+  std::uniform_real_distribution<double> dist(0, total);
+  for (int i = 0; i < n; ++i) {
+    // binary search for the first value whose cdf covers the draw
+    double u = dist(gen);
+    int lo = 0;
+    int hi = range - 1;
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      if (cdf[mid] < u)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    s.insert(lo + 1, s.size());
+  }
+  delete [] cdf;
+}
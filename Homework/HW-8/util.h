@@ -105,4 +105,23 @@ void reset_reversed(Sequence<int>& s);
 //----------------------------------------------------------------------
 void reset_shuffled(Sequence<int>& s, int shuffles);
 
+
+//----------------------------------------------------------------------
+// Initialize the sequence with n values from 1 to range drawn from a
+// Zipfian distribution, where value k is drawn with probability
+// proportional to 1/k^skew (so small values are the "hot" ones). The
+// values come from a fixed seed, so runs are repeatable. Assumes the
+// sequence is empty.
+//
+// Inputs:
+//   s     -- the sequence to add data to
+//   n     -- the number of values to add
+//   range -- the largest value to draw
+//   skew  -- the Zipf exponent (0 is uniform, around 1 is typical)
+//
+// Outputs:
+//   s     -- the sequence is loaded with data
+//----------------------------------------------------------------------
+void load_zipfian(Sequence<int>& s, int n, int range, double skew);
+
 #endif
@@ -0,0 +1,380 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: workload.h
+// DATE: Fall 2021
+// DESC: YCSB-style workloads for the maps. A workload works on
+//       records numbered 0 to count-1, where record r has key and
+//       value r (converted to K and V), so key order is record order
+//       and an insert adds the next record, like an auto-increment
+//       id. A KeyChooser picks which record each operation touches:
+//          uniform    -- every record equally likely
+//          zipfian    -- a few records very likely, Zipf(skew) ranks
+//                        hashed over the records so the hot ones are
+//                        spread out
+//          latest     -- Zipf(skew) over recency, so the newest
+//                        records are the hot ones
+//          hotspot    -- a fraction of the ops go to a fixed
+//                        contiguous block of records
+//          sequential -- records in ascending order with random gaps,
+//                        wrapping at the end
+//       An OperationMix gives the percent of reads (contains),
+//       updates (operator[] assignment), scans (find_keys over
+//       scan_length records), and inserts. run_workload runs a mix
+//       against any Map<K, V> for a fixed time and returns operations
+//       per second.
+//---------------------------------------------------------------------------
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "map.h"
+
+// record distributions for KeyChooser
+enum KeyDistribution
+{
+    UNIFORM_KEYS,
+    ZIPFIAN_KEYS,
+    LATEST_KEYS,
+    HOTSPOT_KEYS,
+    SEQUENTIAL_KEYS,
+    KEY_DISTRIBUTION_COUNT
+};
+
+// distribution names for data file headers
+const char *const key_distribution_names[KEY_DISTRIBUTION_COUNT] = {
+    "uniform", "zipfian", "latest", "hotspot", "sequential"};
+
+// an operation mix, in percent (adding up to 100)
+struct OperationMix
+{
+    const char *name;
+    int reads;
+    int updates;
+    int scans;
+    int inserts;
+};
+
+// the standard mixes (the first three follow YCSB workloads B, A, and
+// E)
+const OperationMix READ_HEAVY = {"read-heavy", 95, 5, 0, 0};
+const OperationMix UPDATE_HEAVY = {"update-heavy", 50, 50, 0, 0};
+const OperationMix SCAN_HEAVY = {"scan-heavy", 0, 0, 95, 5};
+const OperationMix INSERT_ONLY = {"insert-only", 0, 0, 0, 100};
+
+//----------------------------------------------------------------------
+// Draws Zipf(skew) ranks from 0 to n-1 (rank 0 the most likely) in
+// constant time, using the method of Gray et al., "Quickly
+// Generating Billion-Record Synthetic Databases" (as in YCSB). The
+// skew must be in (0, 1). The range can grow without starting over.
+//----------------------------------------------------------------------
+class ZipfianGenerator
+{
+public:
+    ZipfianGenerator(long n, double skew);
+
+    // Returns a rank from 0 to n-1
+    long next(std::mt19937_64 &gen);
+
+    // Extends the range to 0 to new_n-1
+    void grow(long new_n);
+
+private:
+    long n;
+    double theta;
+    double alpha;
+    double zeta2;
+    double zetan;
+    double eta;
+    std::uniform_real_distribution<double> unit{0, 1};
+
+    // recomputes eta after n or zetan change
+    void update_eta();
+};
+
+//----------------------------------------------------------------------
+// Picks record numbers from 0 to count-1 with one of the key
+// distributions. Throws invalid_argument if count is not positive or
+// the skew is not in (0, 1).
+//----------------------------------------------------------------------
+class KeyChooser
+{
+public:
+    KeyChooser(KeyDistribution dist, long count, std::uint64_t seed = 1,
+               double skew = 0.99);
+
+    // Returns the next record number
+    long next();
+
+    // Returns the number of records
+    long count() const;
+
+    // Adds a record (after an insert), returning its number
+    long add_record();
+
+    // Sends hot_ops of the hotspot operations to the first
+    // hot_fraction of the records (defaults 0.8 and 0.2)
+    void set_hotspot(double hot_fraction, double hot_ops);
+
+    // Makes the sequential distribution skip between 1 and max_gap
+    // records with probability gap_chance (defaults 0.1 and 16)
+    void set_gaps(double gap_chance, int max_gap);
+
+private:
+    KeyDistribution dist;
+    long records;
+    std::mt19937_64 gen;
+    ZipfianGenerator zipf;
+    double hot_fraction = 0.2;
+    double hot_ops = 0.8;
+    double gap_chance = 0.1;
+    int max_gap = 16;
+    long cursor = 0;
+
+    // a uniform draw in [0, 1)
+    double unit();
+
+    // a uniform draw from 0 to n-1
+    long below(long n);
+};
+
+//----------------------------------------------------------------------
+// Inserts records 0 to count-1 into the map in a shuffled order (so
+// the trees start out balanced). Assumes the map is empty.
+//----------------------------------------------------------------------
+template <typename K, typename V>
+void load_records(Map<K, V> &m, long count, std::uint64_t seed = 1);
+
+//----------------------------------------------------------------------
+// Runs the mix against the map for run_msec milliseconds, choosing
+// records with keys. Inserts add records to both the map and keys.
+// Assumes the map holds records 0 to keys.count()-1, and that K and
+// V can be built from a long.
+//
+// Inputs:
+//   m           -- the map to run against
+//   mix         -- the operation mix
+//   keys        -- chooses the record of each operation
+//   run_msec    -- how long to run
+//   scan_length -- the number of records each scan covers
+//   seed        -- seeds the choice of operations
+//
+// Outputs:
+//   m, keys     -- updated and extended by the mix
+//   returns     -- operations per second
+//----------------------------------------------------------------------
+template <typename K, typename V>
+double run_workload(Map<K, V> &m, const OperationMix &mix, KeyChooser &keys,
+                    int run_msec, int scan_length = 100, std::uint64_t seed = 1);
+
+// constructor
+inline ZipfianGenerator::ZipfianGenerator(long n, double skew)
+    : n(0), theta(skew), zetan(0)
+{
+    if (!(skew > 0 && skew < 1))
+    {
+        throw std::invalid_argument("ZipfianGenerator: skew must be in (0, 1)");
+    }
+    alpha = 1 / (1 - theta);
+    zeta2 = 1 + std::pow(0.5, theta);
+    grow(n);
+}
+
+// returns a rank from 0 to n-1
+inline long ZipfianGenerator::next(std::mt19937_64 &gen)
+{
+    double u = unit(gen);
+    double uz = u * zetan;
+    if (uz < 1)
+    {
+        return 0;
+    }
+    if (uz < zeta2)
+    {
+        return n > 1 ? 1 : 0;
+    }
+    long rank = long(n * std::pow(eta * u - eta + 1, alpha));
+    return std::min(rank, n - 1);
+}
+
+// extends the range, adding the new terms to zeta(n)
+inline void ZipfianGenerator::grow(long new_n)
+{
+    for (long i = n + 1; i <= new_n; ++i)
+    {
+        zetan += 1 / std::pow(double(i), theta);
+    }
+    n = std::max(n, new_n);
+    update_eta();
+}
+
+// recomputes eta
+inline void ZipfianGenerator::update_eta()
+{
+    eta = n < 2 ? 0 : (1 - std::pow(2.0 / n, 1 - theta)) / (1 - zeta2 / zetan);
+}
+
+// constructor
+inline KeyChooser::KeyChooser(KeyDistribution dist, long count,
+                              std::uint64_t seed, double skew)
+    : dist(dist), records(count), gen(seed), zipf(std::max(count, 1L), skew)
+{
+    if (count <= 0)
+    {
+        throw std::invalid_argument("KeyChooser: count must be positive");
+    }
+}
+
+// returns the next record number
+inline long KeyChooser::next()
+{
+    switch (dist)
+    {
+    case UNIFORM_KEYS:
+        return below(records);
+    case ZIPFIAN_KEYS:
+    {
+        // hash the rank so the hot records are spread out
+        std::uint64_t x = std::uint64_t(zipf.next(gen)) + 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return long(x % std::uint64_t(records));
+    }
+    case LATEST_KEYS:
+        return records - 1 - zipf.next(gen);
+    case HOTSPOT_KEYS:
+    {
+        long hot = std::max(1L, long(records * hot_fraction));
+        if (unit() < hot_ops || hot == records)
+        {
+            return below(hot);
+        }
+        return hot + below(records - hot);
+    }
+    case SEQUENTIAL_KEYS:
+    default:
+    {
+        long record = cursor;
+        cursor += 1;
+        if (unit() < gap_chance)
+        {
+            cursor += 1 + below(max_gap);
+        }
+        if (cursor >= records)
+        {
+            cursor = 0;
+        }
+        return record;
+    }
+    }
+}
+
+// number of records
+inline long KeyChooser::count() const
+{
+    return records;
+}
+
+// adds a record
+inline long KeyChooser::add_record()
+{
+    zipf.grow(records + 1);
+    return records++;
+}
+
+// sets the hotspot shape
+inline void KeyChooser::set_hotspot(double hot_fraction, double hot_ops)
+{
+    this->hot_fraction = hot_fraction;
+    this->hot_ops = hot_ops;
+}
+
+// sets the sequential gaps
+inline void KeyChooser::set_gaps(double gap_chance, int max_gap)
+{
+    this->gap_chance = gap_chance;
+    this->max_gap = max_gap;
+}
+
+// a uniform draw in [0, 1)
+inline double KeyChooser::unit()
+{
+    return std::uniform_real_distribution<double>(0, 1)(gen);
+}
+
+// a uniform draw from 0 to n-1
+inline long KeyChooser::below(long n)
+{
+    return std::uniform_int_distribution<long>(0, n - 1)(gen);
+}
+
+// inserts records 0 to count-1 in a shuffled order
+template <typename K, typename V>
+void load_records(Map<K, V> &m, long count, std::uint64_t seed)
+{
+    std::vector<long> order(count);
+    for (long r = 0; r < count; ++r)
+    {
+        order[r] = r;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(seed));
+    for (long r : order)
+    {
+        m.insert(K(r), V(r));
+    }
+}
+
+// runs the mix for run_msec
+template <typename K, typename V>
+double run_workload(Map<K, V> &m, const OperationMix &mix, KeyChooser &keys,
+                    int run_msec, int scan_length, std::uint64_t seed)
+{
+    using namespace std::chrono;
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<int> percent(0, 99);
+    long ops = 0;
+    long found = 0;
+    auto t0 = steady_clock::now();
+    auto stop = t0 + milliseconds(run_msec);
+    // check the clock every batch operations
+    const int batch = 64;
+    while (steady_clock::now() < stop)
+    {
+        for (int i = 0; i < batch; ++i)
+        {
+            int op = percent(gen);
+            if (op < mix.reads)
+            {
+                found += m.contains(K(keys.next()));
+            }
+            else if (op < mix.reads + mix.updates)
+            {
+                long r = keys.next();
+                m[K(r)] = V(r);
+            }
+            else if (op < mix.reads + mix.updates + mix.scans)
+            {
+                long r = keys.next();
+                found += m.find_keys(K(r), K(r + scan_length - 1)).size();
+            }
+            else
+            {
+                long r = keys.add_record();
+                m.insert(K(r), V(r));
+            }
+        }
+        ops += batch;
+    }
+    double secs = duration_cast<microseconds>(steady_clock::now() - t0).count() / 1e6;
+    // found keeps the reads from being optimized away
+    return (ops + (found < 0)) / secs;
+}
+
+#endif
@@ -1,557 +1,1171 @@
-
-//---------------------------------------------------------------------------
-// NAME: Ben Puryear
-// FILE: arrayseq.h
-// DATE: Fall 2021
-// DESC: This file defines all of the functions defined for HW-3, as well as the sorting functions for HW-4
-//----------------------------------------------------------------------
-
-#ifndef ARRAYLIST_H
-#define ARRAYLIST_H
-
-#include <stdexcept>
-#include <ostream>
-#include <iostream>
-#include <random>
-#include "sequence.h"
-
-template <typename T>
-class ArraySeq : public Sequence<T>
-{
-public:
-    // Default constructor
-    ArraySeq();
-
-    // Copy constructor
-    ArraySeq(const ArraySeq &rhs);
-
-    // Move constructor
-    ArraySeq(ArraySeq &&rhs);
-
-    // Copy assignment operator
-    ArraySeq &operator=(const ArraySeq &rhs);
-
-    // Move assignment operator
-    ArraySeq &operator=(ArraySeq &&rhs);
-
-    // Destructor
-    ~ArraySeq();
-
-    // Returns the number of elements in the sequence
-    virtual int size() const;
-
-    // Tests if the sequence is empty
-    virtual bool empty() const;
-
-    // Returns a reference to the element at the index in the
-    // sequence. Throws out_of_range if index is invalid.
-    virtual T &operator[](int index);
-
-    // Returns a constant address to the element at the index in the
-    // sequence. Throws out_of_range if index is invalid.
-    virtual const T &operator[](int index) const;
-
-    // Extends the sequence by inserting the element at the given
-    // index. Throws out_of_range if the index is invalid.
-    virtual void insert(const T &elem, int index);
-
-    // Shrinks the sequence by removing the element at the index in the
-    // sequence. Throws out_of_range if index is invalid.
-    virtual void erase(int index);
-
-    // Returns true if the element is in the sequence, and false
-    // otherwise.
-    virtual bool contains(const T &elem) const;
-
-    // Sorts the elements in the sequence using less than equal (<=)
-    // operator. (Not implemented in HW-3)
-    virtual void sort();
-
-    // MORE
-    // implements merge sort over current sequence
-    virtual void merge_sort();
-    // implements quick sort over current sequence
-    virtual void quick_sort();
-
-    virtual void quick_sort_rand_pivot();
-
-    virtual void cocktail_shaker_sort();
-
-    virtual void bubble_sort();
-
-    virtual void library_sort();
-
-private:
-    // resizable array
-    T *array = nullptr;
-
-    // size of list
-    int count = 0;
-
-    // max capacity of the array
-    int capacity = 0;
-
-    // helper to double the capacity of the array
-    void resize();
-
-    // helper to delete the array list (called by destructor and copy
-    // constructor)
-    void make_empty();
-
-    // MORE
-    // helper functions for merge and quick sort
-    void merge_sort(int start, int end);
-
-    void quick_sort(int start, int end);
-
-    void quick_sort_rand_pivot(int start, int end);
-};
-
-template <typename T>
-ArraySeq<T>::ArraySeq()
-{
-    array = nullptr;
-    count = 0;
-    capacity = 0;
-}
-
-// Copy constructor
-template <typename T>
-ArraySeq<T>::ArraySeq(const ArraySeq &rhs)
-{
-    for (int i = 0; i < rhs.size(); ++i)
-    {
-        insert(rhs[i], i);
-    }
-}
-
-// Move constructor
-template <typename T>
-ArraySeq<T>::ArraySeq(ArraySeq<T> &&rhs)
-{
-    *this = std::move(rhs);
-}
-
-// Copy assignment operator
-template <typename T>
-ArraySeq<T> &ArraySeq<T>::operator=(const ArraySeq &rhs)
-{
-    if (this != &rhs)
-    {
-        make_empty();
-        if (!rhs.empty())
-        {
-            for (int i = 0; i < rhs.size(); ++i)
-            {
-                insert(rhs[i], i);
-            }
-        }
-    }
-    return *this;
-}
-
-// Move assignment operator
-template <typename T>
-ArraySeq<T> &ArraySeq<T>::operator=(ArraySeq<T> &&rhs)
-{
-    if (this != &rhs)
-    {
-        // do the assignment
-        make_empty();
-
-        count = rhs.count;
-
-        capacity = rhs.capacity;
-
-        array = rhs.array;
-
-        rhs.make_empty();
-        rhs.array = nullptr;
-    }
-
-    return *this;
-}
-
-// Destructor
-template <typename T>
-ArraySeq<T>::~ArraySeq()
-{
-    make_empty();
-    delete[] array;
-}
-
-// Returns the number of elements in the sequence
-template <typename T>
-int ArraySeq<T>::size() const
-{
-    return count;
-}
-
-// Tests if the sequence is empty
-template <typename T>
-bool ArraySeq<T>::empty() const
-{
-    return (count == 0);
-}
-
-// Returns a reference to the element at the index in the
-// sequence. Throws out_of_range if index is invalid.
-
-template <typename T>
-T &ArraySeq<T>::operator[](int index)
-{
-    // check the index
-    if (index >= size() || index < 0)
-    {
-        throw std::out_of_range("Out of range in the [] nonconst");
-    }
-
-    return array[index];
-}
-
-// Returns a constant address to the element at the index in the
-// sequence. Throws out_of_range if index is invalid.
-template <typename T>
-const T &ArraySeq<T>::operator[](int index) const
-{
-    // check the index
-    if (index >= size() || index < 0)
-    {
-        throw std::out_of_range("Out of range in the [] nonconst");
-    }
-
-    return array[index];
-}
-
-// Extends the sequence by inserting the element at the given
-// index. Throws out_of_range if the index is invalid.
-
-template <typename T>
-void ArraySeq<T>::insert(const T &elem, int index)
-{
-    // check the index
-    if (index > size() || index < 0)
-    {
-        throw std::out_of_range("Out of range in the [] nonconst");
-    }
-    if (size() + 1 > capacity)
-    {
-        resize();
-    }
-    T temp1 = array[index];
-    for (int i = index; i < size(); ++i)
-    {
-        T temp2 = array[i + 1];
-        array[i + 1] = temp1;
-        temp1 = temp2;
-    }
-    array[index] = elem;
-    count++;
-}
-
-// Shrinks the sequence by removing the element at the index in the
-// sequence. Throws out_of_range if index is invalid.
-template <typename T>
-void ArraySeq<T>::erase(int index)
-{
-    // check the index
-    if (index >= size() || index < 0)
-    {
-        throw std::out_of_range("Out of range in the [] nonconst");
-    }
-    for (int i = index; i < count - 1; ++i)
-    {
-        array[i] = array[i + 1];
-    }
-    --count;
-}
-
-// Returns true if the element is in the sequence, and false
-// otherwise.
-template <typename T>
-bool ArraySeq<T>::contains(const T &elem) const
-{
-    for (int i = 0; i < size(); ++i)
-    {
-        if (array[i] == elem)
-        {
-            return true;
-        }
-    }
-    return false;
-}
-
-// helper to double the capacity of the array
-template <typename T>
-void ArraySeq<T>::resize()
-{
-    if (capacity == 0)
-    {
-        capacity = 1;
-    }
-    else
-    {
-        capacity *= 2;
-    }
-    T *new_array = new T[capacity];
-    for (int i = 0; i < capacity / 2; ++i)
-    {
-        new_array[i] = array[i];
-    }
-    delete[] array;
-    array = new_array;
-}
-
-// helper to delete the array list (called by destructor and copy
-// constructor)
-template <typename T>
-void ArraySeq<T>::make_empty()
-{
-    count = 0;
-    capacity = 0;
-}
-
-// TODO: Implement the above functions below using the approaches
-//       discussed in class and specified in the homework assignment.
-
-template <typename T>
-void ArraySeq<T>::sort()
-{
-    quick_sort_rand_pivot();
-}
-
-template <typename T>
-std::ostream &operator<<(std::ostream &stream, const ArraySeq<T> &array)
-{
-    for (int i = 0; i < array.size(); i++)
-    {
-        if (i != array.size() - 1)
-        {
-            stream << array[i] << ", ";
-        }
-        else
-        {
-            stream << array[i];
-        }
-    }
-    return stream;
-}
-
-// implements merge sort over current sequence
-template <typename T>
-void ArraySeq<T>::merge_sort()
-{
-    merge_sort(0, count - 1);
-}
-
-// helper functions for merge and quick sort
-template <typename T>
-void ArraySeq<T>::merge_sort(int start, int end)
-{
-    int mid = (start + end) / 2;
-    if (start < end)
-    {
-        merge_sort(start, mid);
-        merge_sort(mid + 1, end);
-    }
-    else
-    {
-        return;
-    }
-
-    T temp[(end - start) + 1];
-    int first1 = start;
-    int first2 = mid + 1;
-    int i = 0;
-    while (first1 <= mid && first2 <= end)
-    {
-        if (array[first1] < array[first2])
-        {
-            temp[i++] = array[first1++];
-        }
-        else
-        {
-            temp[i++] = array[first2++];
-        }
-    }
-    while (first1 <= mid)
-    {
-        temp[i++] = array[first1++];
-    }
-    while (first2 <= end)
-    {
-        temp[i++] = array[first2++];
-    }
-    for (i = 0; i <= (end - start); ++i)
-    {
-        array[start + i] = temp[i];
-    }
-}
-
-// implements quick sort over current sequence
-template <typename T>
-void ArraySeq<T>::quick_sort()
-{
-    quick_sort(0, count - 1);
-}
-
-template <typename T>
-void ArraySeq<T>::quick_sort(int start, int end)
-{
-    if (start < end)
-    {
-        int pivot_val = array[start];
-        int end_p1 = start;
-        for (int i = start + 1; i <= end; ++i)
-        {
-            if (array[i] < pivot_val)
-            {
-                end_p1++;
-                int temp = array[i];
-                array[i] = array[end_p1];
-                array[end_p1] = temp;
-            }
-        }
-        array[start] = array[end_p1];
-        array[end_p1] = pivot_val;
-        quick_sort(start, end_p1 - 1);
-        quick_sort(end_p1 + 1, end);
-    }
-}
-
-// HW9
-// implements quick sort over current sequence
-template <typename T>
-void ArraySeq<T>::quick_sort_rand_pivot()
-{
-    quick_sort_rand_pivot(0, count - 1);
-}
-
-template <typename T>
-void ArraySeq<T>::quick_sort_rand_pivot(int start, int end)
-{
-    if (start < end)
-    {
-        // pick a random pivot index, and its value
-        std::srand(std::time(nullptr));
-        int pivot = std::rand() % (end - start) + start;
-        int pivot_val = array[pivot];
-        array[pivot] = array[start];
-        // array[start] is a placeholder for pivot_val
-        int end_p1 = start;
-        for (int i = start + 1; i <= end; ++i)
-        {
-            if (array[i] < pivot_val)
-            {
-                end_p1++;
-                int temp = array[i];
-                array[i] = array[end_p1];
-                array[end_p1] = temp;
-            }
-        }
-        array[start] = array[end_p1];
-        array[end_p1] = pivot_val;
-        quick_sort_rand_pivot(start, end_p1 - 1);
-        quick_sort_rand_pivot(end_p1 + 1, end);
-    }
-}
-
-template <typename T>
-void ArraySeq<T>::cocktail_shaker_sort()
-{
-    int start = 0;
-    int end = count - 1;
-    while (start < end)
-    {
-        // up
-        for (int i = start; i < end; ++i)
-        {
-            if (array[i] > array[i + 1])
-            {
-                std::swap(array[i], array[i + 1]);
-            }
-        }
-        end--;
-
-        // down
-        for (int i = end; i > start; --i)
-        {
-            if (array[i] < array[i - 1])
-            {
-                std::swap(array[i], array[i - 1]);
-            }
-        }
-        start++;
-    }
-}
-
-template <typename T>
-void ArraySeq<T>::bubble_sort()
-{
-    int start = 0;
-    int end = count - 1;
-    while (start < end)
-    {
-        // up
-        for (int i = start; i < end; ++i)
-        {
-            if (array[i] > array[i + 1])
-            {
-                std::swap(array[i], array[i + 1]);
-            }
-        }
-        end--;
-    }
-}
-
-template <typename T>
-void ArraySeq<T>::library_sort()
-{
-    const float spacer_factor = 0.2;
-
-    ArraySeq<T> library = new ArraySeq<K>;
-
-    int consumed = 0;
-    if (count > 0)
-    {
-        library.insert(array[0], 0);
-        library.insert('\0', library.size());
-        consumed++;
-    }
-
-    while (consumed < count)
-    {
-        // for each pass
-        for (int idx = consumed; idx < consumed * 2 && idx < count; ++idx)
-        {
-            // binary search
-            int start = 0;
-            int end = library.size();
-            int mid;
-            int insertion_point;
-            while (start < end)
-            {
-                mid = (start + end) / 2;
-                if (library[mid] < array[idx])
-                {
-                    start = mid + 1;
-                    insertion_point = start;
-                }
-                else
-                {
-                    end = mid - 1;
-                    insertion_point = end;
-                }
-            }
-            //              stopped here @ 9:32 Friday Dec 17th 2021
-
-            // insertion
-            // move other values forward into the empty space to make room for this value
-        }
-
-        // rebalancing
-        // write this whole arraysequence into a new one, but after every n values, insert n values of space. size = 2n
-    }
-}
-
-#endif
+
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: arrayseq.h
+// DATE: Fall 2021
+// DESC: This file defines all of the functions defined for HW-3, as well as the sorting functions for HW-4
+//----------------------------------------------------------------------
+
+#ifndef ARRAYLIST_H
+#define ARRAYLIST_H
+
+#include <stdexcept>
+#include <ostream>
+#include <iostream>
+#include <random>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "sequence.h"
+#include "sortnet.h"
+
+template <typename T>
+class ArraySeq : public Sequence<T>
+{
+public:
+    // Default constructor
+    ArraySeq();
+
+    // Copy constructor
+    ArraySeq(const ArraySeq &rhs);
+
+    // Move constructor
+    ArraySeq(ArraySeq &&rhs);
+
+    // Copy assignment operator
+    ArraySeq &operator=(const ArraySeq &rhs);
+
+    // Move assignment operator
+    ArraySeq &operator=(ArraySeq &&rhs);
+
+    // Destructor
+    ~ArraySeq();
+
+    // Returns the number of elements in the sequence
+    virtual int size() const;
+
+    // Tests if the sequence is empty
+    virtual bool empty() const;
+
+    // Returns a reference to the element at the index in the
+    // sequence. Throws out_of_range if index is invalid.
+    virtual T &operator[](int index);
+
+    // Returns a constant address to the element at the index in the
+    // sequence. Throws out_of_range if index is invalid.
+    virtual const T &operator[](int index) const;
+
+    // Extends the sequence by inserting the element at the given
+    // index. Throws out_of_range if the index is invalid.
+    virtual void insert(const T &elem, int index);
+
+    // Shrinks the sequence by removing the element at the index in the
+    // sequence. Throws out_of_range if index is invalid.
+    virtual void erase(int index);
+
+    // Returns true if the element is in the sequence, and false
+    // otherwise.
+    virtual bool contains(const T &elem) const;
+
+    // Sorts the elements in the sequence using less than equal (<=)
+    // operator. (Not implemented in HW-3)
+    virtual void sort();
+
+    // MORE
+    // implements merge sort over current sequence
+    virtual void merge_sort();
+    // implements quick sort over current sequence
+    virtual void quick_sort();
+
+    virtual void quick_sort_rand_pivot();
+
+    virtual void cocktail_shaker_sort();
+
+    virtual void bubble_sort();
+
+    virtual void library_sort();
+
+    // Adaptive, stable merge sort (TimSort). Detects existing
+    // ascending and descending runs, extends short runs with binary
+    // insertion sort, and merges runs with galloping using a single
+    // scratch buffer. Already sorted (or reverse sorted) input takes
+    // linear time.
+    virtual void tim_sort();
+
+    // Sets the largest subarray that merge and quick sort hand to a
+    // sorting network (see sortnet.h) instead of recursing, for int
+    // and float sequences. 0 disables the networks, and the value is
+    // capped at SORTNET_MAX.
+    void set_network_cutoff(int n);
+
+    // Parallel, stable sample sort. Oversampled splitters divide the
+    // elements into buckets (with a separate bucket for the elements
+    // equal to each splitter, so heavy duplicates need no further
+    // work), each thread classifies a chunk and counts its buckets,
+    // the elements are scattered into a new array, and the buckets are
+    // sorted independently with tim sort. Small sequences, and a
+    // single thread, just use tim sort.
+    virtual void parallel_sample_sort();
+
+    // Sets the maximum number of threads used by parallel_sample_sort
+    // (0, the default, uses the hardware concurrency; at most 8191
+    // are used)
+    void set_threads(int n);
+
+private:
+    // resizable array
+    T *array = nullptr;
+
+    // size of list
+    int count = 0;
+
+    // max capacity of the array
+    int capacity = 0;
+
+    // helper to double the capacity of the array
+    void resize();
+
+    // helper to delete the array list (called by destructor and copy
+    // constructor)
+    void make_empty();
+
+    // subarrays of at most this many int or float elements are
+    // sorted with a sorting network
+    int network_cutoff = 32;
+
+    // max threads for parallel_sample_sort (0 = hardware)
+    int threads = 0;
+
+    // fewest elements per thread worth starting a thread for
+    static const int min_elems_per_thread = 65536;
+
+    // most threads a parallel sort uses, so that its 8p - 1 bucket
+    // ids fit in 16 bits
+    static const int max_sort_threads = 8191;
+
+    // sample elements taken per bucket when choosing splitters
+    static const int oversample = 32;
+
+    // number of threads to use for a parallel sort
+    int sort_threads() const;
+
+    // calls work(t) for t in [0, n), on n threads (the calling thread
+    // runs t = 0)
+    template <typename Work>
+    static void run_threads(int n, Work work);
+
+    // MORE
+    // sorts [start, end] with a sorting network if the type has one
+    // and the range is within the cutoff, returns false otherwise
+    bool network_base_case(int start, int end);
+
+    // helper functions for merge and quick sort
+    void merge_sort(int start, int end);
+
+    void quick_sort(int start, int end);
+
+    void quick_sort_rand_pivot(int start, int end);
+
+    // helper functions for tim sort
+
+    // tim sorts [first, last), using temp (of at least last - first
+    // elements) as the merge buffer
+    void tim_sort(int first, int last, T temp[]);
+
+    // returns the end (exclusive) of the run starting at start and
+    // ending by last, reversing the run first if it is strictly
+    // descending
+    int count_run(int start, int last);
+
+    // sorts [start, end) by binary insertion, given that [start,
+    // sorted_end) is already sorted
+    void binary_insertion_sort(int start, int end, int sorted_end);
+
+    // merges the adjacent sorted runs [start, mid) and [mid, end),
+    // switching to galloping when one run keeps winning
+    void gallop_merge(int start, int mid, int end, T temp[]);
+
+    // number of the n sorted elements of a that are less than key
+    static int gallop_left(const T &key, const T a[], int n);
+
+    // number of the n sorted elements of a that are less than or
+    // equal to key
+    static int gallop_right(const T &key, const T a[], int n);
+};
+
+template <typename T>
+ArraySeq<T>::ArraySeq()
+{
+    array = nullptr;
+    count = 0;
+    capacity = 0;
+}
+
+// Copy constructor
+template <typename T>
+ArraySeq<T>::ArraySeq(const ArraySeq &rhs)
+{
+    for (int i = 0; i < rhs.size(); ++i)
+    {
+        insert(rhs[i], i);
+    }
+}
+
+// Move constructor
+template <typename T>
+ArraySeq<T>::ArraySeq(ArraySeq<T> &&rhs)
+{
+    *this = std::move(rhs);
+}
+
+// Copy assignment operator
+template <typename T>
+ArraySeq<T> &ArraySeq<T>::operator=(const ArraySeq &rhs)
+{
+    if (this != &rhs)
+    {
+        make_empty();
+        if (!rhs.empty())
+        {
+            for (int i = 0; i < rhs.size(); ++i)
+            {
+                insert(rhs[i], i);
+            }
+        }
+    }
+    return *this;
+}
+
+// Move assignment operator
+template <typename T>
+ArraySeq<T> &ArraySeq<T>::operator=(ArraySeq<T> &&rhs)
+{
+    if (this != &rhs)
+    {
+        // do the assignment
+        make_empty();
+
+        count = rhs.count;
+
+        capacity = rhs.capacity;
+
+        array = rhs.array;
+
+        rhs.make_empty();
+        rhs.array = nullptr;
+    }
+
+    return *this;
+}
+
+// Destructor
+template <typename T>
+ArraySeq<T>::~ArraySeq()
+{
+    make_empty();
+    delete[] array;
+}
+
+// Returns the number of elements in the sequence
+template <typename T>
+int ArraySeq<T>::size() const
+{
+    return count;
+}
+
+// Tests if the sequence is empty
+template <typename T>
+bool ArraySeq<T>::empty() const
+{
+    return (count == 0);
+}
+
+// Returns a reference to the element at the index in the
+// sequence. Throws out_of_range if index is invalid.
+
+template <typename T>
+T &ArraySeq<T>::operator[](int index)
+{
+    // check the index
+    if (index >= size() || index < 0)
+    {
+        throw std::out_of_range("Out of range in the [] nonconst");
+    }
+
+    return array[index];
+}
+
+// Returns a constant address to the element at the index in the
+// sequence. Throws out_of_range if index is invalid.
+template <typename T>
+const T &ArraySeq<T>::operator[](int index) const
+{
+    // check the index
+    if (index >= size() || index < 0)
+    {
+        throw std::out_of_range("Out of range in the [] nonconst");
+    }
+
+    return array[index];
+}
+
+// Extends the sequence by inserting the element at the given
+// index. Throws out_of_range if the index is invalid.
+
+template <typename T>
+void ArraySeq<T>::insert(const T &elem, int index)
+{
+    // check the index
+    if (index > size() || index < 0)
+    {
+        throw std::out_of_range("Out of range in the [] nonconst");
+    }
+    if (size() + 1 > capacity)
+    {
+        resize();
+    }
+    T temp1 = array[index];
+    for (int i = index; i < size(); ++i)
+    {
+        T temp2 = array[i + 1];
+        array[i + 1] = temp1;
+        temp1 = temp2;
+    }
+    array[index] = elem;
+    count++;
+}
+
+// Shrinks the sequence by removing the element at the index in the
+// sequence. Throws out_of_range if index is invalid.
+template <typename T>
+void ArraySeq<T>::erase(int index)
+{
+    // check the index
+    if (index >= size() || index < 0)
+    {
+        throw std::out_of_range("Out of range in the [] nonconst");
+    }
+    for (int i = index; i < count - 1; ++i)
+    {
+        array[i] = array[i + 1];
+    }
+    --count;
+}
+
+// Returns true if the element is in the sequence, and false
+// otherwise.
+template <typename T>
+bool ArraySeq<T>::contains(const T &elem) const
+{
+    for (int i = 0; i < size(); ++i)
+    {
+        if (array[i] == elem)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// helper to double the capacity of the array
+template <typename T>
+void ArraySeq<T>::resize()
+{
+    if (capacity == 0)
+    {
+        capacity = 1;
+    }
+    else
+    {
+        capacity *= 2;
+    }
+    T *new_array = new T[capacity];
+    for (int i = 0; i < capacity / 2; ++i)
+    {
+        new_array[i] = array[i];
+    }
+    delete[] array;
+    array = new_array;
+}
+
+// helper to delete the array list (called by destructor and copy
+// constructor)
+template <typename T>
+void ArraySeq<T>::make_empty()
+{
+    count = 0;
+    capacity = 0;
+}
+
+// TODO: Implement the above functions below using the approaches
+//       discussed in class and specified in the homework assignment.
+
+template <typename T>
+void ArraySeq<T>::sort()
+{
+    quick_sort_rand_pivot();
+}
+
+template <typename T>
+std::ostream &operator<<(std::ostream &stream, const ArraySeq<T> &array)
+{
+    for (int i = 0; i < array.size(); i++)
+    {
+        if (i != array.size() - 1)
+        {
+            stream << array[i] << ", ";
+        }
+        else
+        {
+            stream << array[i];
+        }
+    }
+    return stream;
+}
+
+// implements merge sort over current sequence
+template <typename T>
+void ArraySeq<T>::merge_sort()
+{
+    merge_sort(0, count - 1);
+}
+
+// sets the largest subarray sorted with a sorting network
+template <typename T>
+void ArraySeq<T>::set_network_cutoff(int n)
+{
+    network_cutoff = n < SORTNET_MAX ? n : SORTNET_MAX;
+}
+
+// sorts [start, end] with a sorting network if the type has one
+template <typename T>
+bool ArraySeq<T>::network_base_case(int start, int end)
+{
+    if constexpr (has_sorting_network<T>::value)
+    {
+        int n = end - start + 1;
+        if (n > 1 && n <= network_cutoff)
+        {
+            sorting_network(array + start, n);
+            return true;
+        }
+    }
+    return false;
+}
+
+// helper functions for merge and quick sort
+template <typename T>
+void ArraySeq<T>::merge_sort(int start, int end)
+{
+    if (network_base_case(start, end))
+    {
+        return;
+    }
+    int mid = (start + end) / 2;
+    if (start < end)
+    {
+        merge_sort(start, mid);
+        merge_sort(mid + 1, end);
+    }
+    else
+    {
+        return;
+    }
+
+    T temp[(end - start) + 1];
+    int first1 = start;
+    int first2 = mid + 1;
+    int i = 0;
+    while (first1 <= mid && first2 <= end)
+    {
+        if (array[first1] < array[first2])
+        {
+            temp[i++] = array[first1++];
+        }
+        else
+        {
+            temp[i++] = array[first2++];
+        }
+    }
+    while (first1 <= mid)
+    {
+        temp[i++] = array[first1++];
+    }
+    while (first2 <= end)
+    {
+        temp[i++] = array[first2++];
+    }
+    for (i = 0; i <= (end - start); ++i)
+    {
+        array[start + i] = temp[i];
+    }
+}
+
+// implements quick sort over current sequence
+template <typename T>
+void ArraySeq<T>::quick_sort()
+{
+    quick_sort(0, count - 1);
+}
+
+template <typename T>
+void ArraySeq<T>::quick_sort(int start, int end)
+{
+    if (network_base_case(start, end))
+    {
+        return;
+    }
+    if (start < end)
+    {
+        T pivot_val = array[start];
+        int end_p1 = start;
+        for (int i = start + 1; i <= end; ++i)
+        {
+            if (array[i] < pivot_val)
+            {
+                end_p1++;
+                T temp = array[i];
+                array[i] = array[end_p1];
+                array[end_p1] = temp;
+            }
+        }
+        array[start] = array[end_p1];
+        array[end_p1] = pivot_val;
+        quick_sort(start, end_p1 - 1);
+        quick_sort(end_p1 + 1, end);
+    }
+}
+
+// HW9
+// implements quick sort over current sequence
+template <typename T>
+void ArraySeq<T>::quick_sort_rand_pivot()
+{
+    quick_sort_rand_pivot(0, count - 1);
+}
+
+template <typename T>
+void ArraySeq<T>::quick_sort_rand_pivot(int start, int end)
+{
+    if (network_base_case(start, end))
+    {
+        return;
+    }
+    if (start < end)
+    {
+        // pick a random pivot index, and its value
+        std::srand(std::time(nullptr));
+        int pivot = std::rand() % (end - start) + start;
+        T pivot_val = array[pivot];
+        array[pivot] = array[start];
+        // array[start] is a placeholder for pivot_val
+        int end_p1 = start;
+        for (int i = start + 1; i <= end; ++i)
+        {
+            if (array[i] < pivot_val)
+            {
+                end_p1++;
+                T temp = array[i];
+                array[i] = array[end_p1];
+                array[end_p1] = temp;
+            }
+        }
+        array[start] = array[end_p1];
+        array[end_p1] = pivot_val;
+        quick_sort_rand_pivot(start, end_p1 - 1);
+        quick_sort_rand_pivot(end_p1 + 1, end);
+    }
+}
+
+template <typename T>
+void ArraySeq<T>::cocktail_shaker_sort()
+{
+    int start = 0;
+    int end = count - 1;
+    while (start < end)
+    {
+        // up
+        for (int i = start; i < end; ++i)
+        {
+            if (array[i] > array[i + 1])
+            {
+                std::swap(array[i], array[i + 1]);
+            }
+        }
+        end--;
+
+        // down
+        for (int i = end; i > start; --i)
+        {
+            if (array[i] < array[i - 1])
+            {
+                std::swap(array[i], array[i - 1]);
+            }
+        }
+        start++;
+    }
+}
+
+template <typename T>
+void ArraySeq<T>::bubble_sort()
+{
+    int start = 0;
+    int end = count - 1;
+    while (start < end)
+    {
+        // up
+        for (int i = start; i < end; ++i)
+        {
+            if (array[i] > array[i + 1])
+            {
+                std::swap(array[i], array[i + 1]);
+            }
+        }
+        end--;
+    }
+}
+
+// library (gapped insertion) sort: elements are inserted into an
+// array with a gap after each element, so an insert only shifts
+// elements up to the next gap. The gaps are restored after each round
+// of insertions, which doubles the number of sorted elements.
+template <typename T>
+void ArraySeq<T>::library_sort()
+{
+    if (count < 2)
+    {
+        return;
+    }
+    // a round adds at most one slot per insert to the 2 * placed slots
+    // in use, so 3 * count slots never run out
+    int slots = 3 * count + 1;
+    T *library = new T[slots];
+    bool *used = new bool[slots]();
+    T *spread = new T[count];
+
+    library[1] = array[0];
+    used[1] = true;
+    int placed = 1;
+    int used_end = 2;
+    while (placed < count)
+    {
+        int round_end = std::min(2 * placed, count);
+        for (int idx = placed; idx < round_end; ++idx)
+        {
+            // binary search for the slot after the last element <= the
+            // new one, skipping over gaps
+            int start = 0;
+            int end = used_end;
+            while (start < end)
+            {
+                int mid = (start + end) / 2;
+                int filled = mid;
+                while (filled >= start && !used[filled])
+                {
+                    --filled;
+                }
+                if (filled < start || !(array[idx] < library[filled]))
+                {
+                    start = mid + 1;
+                }
+                else
+                {
+                    end = filled;
+                }
+            }
+            // shift right up to the next gap to make room
+            int gap = start;
+            while (used[gap])
+            {
+                ++gap;
+            }
+            for (int i = gap; i > start; --i)
+            {
+                library[i] = library[i - 1];
+            }
+            library[start] = array[idx];
+            used[gap] = true;
+            used_end = std::max(used_end, gap + 1);
+        }
+        placed = round_end;
+
+        // rebalancing: put a gap before every element again
+        int n = 0;
+        for (int i = 0; i < used_end; ++i)
+        {
+            if (used[i])
+            {
+                spread[n++] = library[i];
+                used[i] = false;
+            }
+        }
+        for (int i = 0; i < n; ++i)
+        {
+            library[2 * i + 1] = spread[i];
+            used[2 * i + 1] = true;
+        }
+        used_end = 2 * n;
+    }
+
+    int n = 0;
+    for (int i = 0; i < used_end; ++i)
+    {
+        if (used[i])
+        {
+            array[n++] = library[i];
+        }
+    }
+    delete[] library;
+    delete[] used;
+    delete[] spread;
+}
+
+// Adaptive, stable merge sort (TimSort)
+template <typename T>
+void ArraySeq<T>::tim_sort()
+{
+    if (count < 2)
+    {
+        return;
+    }
+    T *temp = new T[count];
+    tim_sort(0, count, temp);
+    delete[] temp;
+}
+
+// tim sorts [first, last)
+template <typename T>
+void ArraySeq<T>::tim_sort(int first, int last, T temp[])
+{
+    // minimum run length, between 32 and 64, chosen so that n /
+    // min_run is close to (but not more than) a power of two
+    int min_run = last - first;
+    int low_bits = 0;
+    while (min_run >= 64)
+    {
+        low_bits |= min_run & 1;
+        min_run >>= 1;
+    }
+    min_run += low_bits;
+
+    // stack of pending runs; the merge rules keep run lengths growing
+    // at least as fast as the Fibonacci numbers, so 85 entries cover
+    // any int-sized sequence
+    int run_start[85];
+    int run_length[85];
+    int runs = 0;
+
+    // merges pending runs i and i + 1
+    auto merge_at = [&](int i)
+    {
+        int start = run_start[i];
+        int mid = start + run_length[i];
+        int end = mid + run_length[i + 1];
+        gallop_merge(start, mid, end, temp);
+        run_length[i] += run_length[i + 1];
+        if (i == runs - 3)
+        {
+            run_start[i + 1] = run_start[i + 2];
+            run_length[i + 1] = run_length[i + 2];
+        }
+        --runs;
+    };
+
+    int start = first;
+    while (start < last)
+    {
+        int end = count_run(start, last);
+        if (end - start < min_run)
+        {
+            int forced_end = std::min(start + min_run, last);
+            binary_insertion_sort(start, forced_end, end);
+            end = forced_end;
+        }
+        run_start[runs] = start;
+        run_length[runs] = end - start;
+        ++runs;
+
+        // restore the invariants on the top three run lengths
+        // (A > B + C and B > C)
+        while (runs > 1)
+        {
+            int i = runs - 2;
+            if ((i > 0 && run_length[i - 1] <= run_length[i] + run_length[i + 1]) ||
+                (i > 1 && run_length[i - 2] <= run_length[i - 1] + run_length[i]))
+            {
+                if (run_length[i - 1] < run_length[i + 1])
+                {
+                    --i;
+                }
+            }
+            else if (run_length[i] > run_length[i + 1])
+            {
+                break;
+            }
+            merge_at(i);
+        }
+        start = end;
+    }
+
+    // merge whatever is left, smallest runs first
+    while (runs > 1)
+    {
+        int i = runs - 2;
+        if (i > 0 && run_length[i - 1] < run_length[i + 1])
+        {
+            --i;
+        }
+        merge_at(i);
+    }
+}
+
+// returns the end of the run starting at start
+template <typename T>
+int ArraySeq<T>::count_run(int start, int last)
+{
+    int end = start + 1;
+    if (end == last)
+    {
+        return end;
+    }
+    if (array[end] < array[start])
+    {
+        // strictly descending (so reversing keeps the sort stable)
+        while (end + 1 < last && array[end + 1] < array[end])
+        {
+            ++end;
+        }
+        ++end;
+        for (int lo = start, hi = end - 1; lo < hi; ++lo, --hi)
+        {
+            std::swap(array[lo], array[hi]);
+        }
+    }
+    else
+    {
+        while (end + 1 < last && !(array[end + 1] < array[end]))
+        {
+            ++end;
+        }
+        ++end;
+    }
+    return end;
+}
+
+// Parallel, stable sample sort
+template <typename T>
+void ArraySeq<T>::parallel_sample_sort()
+{
+    int p = sort_threads();
+    if (p == 1)
+    {
+        tim_sort();
+        return;
+    }
+
+    // choose splitters from a sorted random sample, dropping repeats
+    int buckets = 4 * p;
+    std::mt19937 gen(223);
+    std::uniform_int_distribution<int> pick(0, count - 1);
+    ArraySeq<T> sample;
+    for (int i = 0; i < oversample * buckets; ++i)
+    {
+        sample.insert(array[pick(gen)], i);
+    }
+    sample.tim_sort();
+    T *splitters = new T[buckets - 1];
+    int m = 0;
+    for (int i = 1; i < buckets; ++i)
+    {
+        const T &s = sample[i * oversample];
+        if (m == 0 || splitters[m - 1] < s)
+        {
+            splitters[m++] = s;
+        }
+    }
+
+    // element x goes to bucket 2j + 1 if it equals splitter j, and to
+    // bucket 2j if it lies between splitters j - 1 and j
+    int b_count = 2 * m + 1;
+    // at most 8p - 1 buckets, which max_sort_threads keeps in 16 bits
+    std::uint16_t *bucket_of = new std::uint16_t[count];
+    int *hist = new int[p * b_count]();
+    run_threads(p, [&](int t)
+                {
+                    int first = (int)((long long)count * t / p);
+                    int last = (int)((long long)count * (t + 1) / p);
+                    int *h = hist + t * b_count;
+                    for (int i = first; i < last; ++i)
+                    {
+                        // index of the first splitter not less than x
+                        const T &x = array[i];
+                        int lo = 0;
+                        int n = m;
+                        while (n > 0)
+                        {
+                            int half = n / 2;
+                            bool less = splitters[lo + half] < x;
+                            lo = less ? lo + half + 1 : lo;
+                            n = less ? n - half - 1 : half;
+                        }
+                        int b = 2 * lo + (lo < m && !(x < splitters[lo]));
+                        bucket_of[i] = b;
+                        ++h[b];
+                    }
+                });
+
+    // each thread's write position in each bucket, buckets in order
+    // and threads in order within a bucket (which keeps it stable)
+    int *bucket_start = new int[b_count + 1];
+    int total = 0;
+    for (int b = 0; b < b_count; ++b)
+    {
+        bucket_start[b] = total;
+        for (int t = 0; t < p; ++t)
+        {
+            int c = hist[t * b_count + b];
+            hist[t * b_count + b] = total;
+            total += c;
+        }
+    }
+    bucket_start[b_count] = total;
+
+    T *scattered = new T[capacity];
+    run_threads(p, [&](int t)
+                {
+                    int first = (int)((long long)count * t / p);
+                    int last = (int)((long long)count * (t + 1) / p);
+                    int *pos = hist + t * b_count;
+                    for (int i = first; i < last; ++i)
+                    {
+                        scattered[pos[bucket_of[i]]++] = array[i];
+                    }
+                });
+    delete[] array;
+    array = scattered;
+
+    // sort the between-splitter buckets; threads take the next
+    // unsorted bucket until none are left
+    std::atomic<int> next(0);
+    run_threads(p, [&](int)
+                {
+                    for (int j = next++; j <= m; j = next++)
+                    {
+                        int first = bucket_start[2 * j];
+                        int last = bucket_start[2 * j + 1];
+                        if (last - first > 1)
+                        {
+                            T *temp = new T[last - first];
+                            tim_sort(first, last, temp);
+                            delete[] temp;
+                        }
+                    }
+                });
+
+    delete[] bucket_start;
+    delete[] hist;
+    delete[] bucket_of;
+    delete[] splitters;
+}
+
+// Sets the maximum number of threads used by parallel_sample_sort
+template <typename T>
+void ArraySeq<T>::set_threads(int n)
+{
+    threads = n < 0 ? 0 : n;
+}
+
+// number of threads to use for a parallel sort
+template <typename T>
+int ArraySeq<T>::sort_threads() const
+{
+    int n = threads;
+    if (n == 0)
+    {
+        n = std::thread::hardware_concurrency();
+    }
+    int useful = count / min_elems_per_thread;
+    if (n > useful)
+    {
+        n = useful;
+    }
+    if (n > max_sort_threads)
+    {
+        n = max_sort_threads;
+    }
+    return n < 1 ? 1 : n;
+}
+
+// calls work(t) for each t in [0, n) on its own thread
+template <typename T>
+template <typename Work>
+void ArraySeq<T>::run_threads(int n, Work work)
+{
+    std::thread *workers = new std::thread[n];
+    for (int t = 1; t < n; ++t)
+    {
+        workers[t] = std::thread(work, t);
+    }
+    work(0);
+    for (int t = 1; t < n; ++t)
+    {
+        workers[t].join();
+    }
+    delete[] workers;
+}
+
+// sorts [start, end) by binary insertion
+template <typename T>
+void ArraySeq<T>::binary_insertion_sort(int start, int end, int sorted_end)
+{
+    for (int i = sorted_end; i < end; ++i)
+    {
+        T elem = array[i];
+        // insert after any equal elements to keep the sort stable
+        int pos = start + gallop_right(elem, array + start, i - start);
+        for (int j = i; j > pos; --j)
+        {
+            array[j] = array[j - 1];
+        }
+        array[pos] = elem;
+    }
+}
+
+// merges the adjacent sorted runs [start, mid) and [mid, end)
+template <typename T>
+void ArraySeq<T>::gallop_merge(int start, int mid, int end, T temp[])
+{
+    // elements of the left run <= the first right element, and of the
+    // right run >= the last left element, are already in place
+    start += gallop_right(array[mid], array + start, mid - start);
+    if (start == mid)
+    {
+        return;
+    }
+    end = mid + gallop_left(array[mid - 1], array + mid, end - mid);
+    if (end == mid)
+    {
+        return;
+    }
+
+    // the left run moves to the scratch buffer, and the merge fills
+    // the array from the left (never passing the right run's next
+    // element)
+    const int min_gallop = 7;
+    int left_length = mid - start;
+    for (int i = 0; i < left_length; ++i)
+    {
+        temp[i] = array[start + i];
+    }
+    int left = 0;
+    int right = mid;
+    int dest = start;
+    while (left < left_length && right < end)
+    {
+        // one element at a time until a run wins min_gallop in a row
+        int left_wins = 0;
+        int right_wins = 0;
+        while (left < left_length && right < end &&
+               left_wins < min_gallop && right_wins < min_gallop)
+        {
+            if (array[right] < temp[left])
+            {
+                array[dest++] = array[right++];
+                ++right_wins;
+                left_wins = 0;
+            }
+            else
+            {
+                array[dest++] = temp[left++];
+                ++left_wins;
+                right_wins = 0;
+            }
+        }
+        // galloping: copy whole blocks while they stay long
+        while (left < left_length && right < end)
+        {
+            int left_block = gallop_right(array[right], temp + left,
+                                          left_length - left);
+            for (int i = 0; i < left_block; ++i)
+            {
+                array[dest++] = temp[left++];
+            }
+            if (left == left_length)
+            {
+                break;
+            }
+            int right_block = gallop_left(temp[left], array + right,
+                                          end - right);
+            for (int i = 0; i < right_block; ++i)
+            {
+                array[dest++] = array[right++];
+            }
+            if (left_block < min_gallop && right_block < min_gallop)
+            {
+                break;
+            }
+        }
+    }
+    // the rest of the right run is already in place
+    while (left < left_length)
+    {
+        array[dest++] = temp[left++];
+    }
+}
+
+// number of the n sorted elements of a that are less than key
+template <typename T>
+int ArraySeq<T>::gallop_left(const T &key, const T a[], int n)
+{
+    // exponential search for a bound, then binary search below it
+    int bound = 1;
+    while (bound <= n && a[bound - 1] < key)
+    {
+        bound *= 2;
+    }
+    int lo = bound / 2;
+    int hi = std::min(bound, n);
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (a[mid] < key)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// number of the n sorted elements of a that are less than or equal to
+// key
+template <typename T>
+int ArraySeq<T>::gallop_right(const T &key, const T a[], int n)
+{
+    int bound = 1;
+    while (bound <= n && !(key < a[bound - 1]))
+    {
+        bound *= 2;
+    }
+    int lo = bound / 2;
+    int hi = std::min(bound, n);
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (key < a[mid])
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+#endif
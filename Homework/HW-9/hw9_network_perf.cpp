@@ -0,0 +1,103 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw9_network_perf.cpp
+// DATE: Fall 2021
+// DESC: Performance driver for the sorting network base case of the
+//       array quick and merge sorts. To run from the command line use:
+//          ./hw9_network_perf
+//       which sorts shuffled one million element int and float
+//       sequences with each network cutoff (0 turns the networks
+//       off). To save this data to a file, run the command:
+//          ./hw9_network_perf > output_network.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include "util.h"
+#include "arrayseq.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// test parameters
+const int elems = 1000000;
+const int runs = 3;
+const int shuffles = 5;
+const int cutoffs[] = {0, 8, 16, 32, 64};
+
+template <typename T>
+double timed_shuffled(int cutoff, function<void(ArraySeq<T> &)> f);
+
+template <typename T>
+void check_sorted(const ArraySeq<T> &s);
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    // output data header
+    cout << "# All times in milliseconds (msec), " << elems
+         << " shuffled elements" << endl;
+    cout << "# Column 1 = network cutoff (0 = no networks)" << endl;
+    cout << "# Column 2 = avg time int merge sort" << endl;
+    cout << "# Column 3 = avg time int quick sort" << endl;
+    cout << "# Column 4 = avg time int quick sort with rand pivot" << endl;
+    cout << "# Column 5 = avg time float merge sort" << endl;
+    cout << "# Column 6 = avg time float quick sort" << endl;
+    cout << "# Column 7 = avg time float quick sort with rand pivot" << endl;
+
+    for (int cutoff : cutoffs)
+    {
+        double c2 = timed_shuffled<int>(cutoff, [](ArraySeq<int> &s) { s.merge_sort(); });
+        double c3 = timed_shuffled<int>(cutoff, [](ArraySeq<int> &s) { s.quick_sort(); });
+        double c4 = timed_shuffled<int>(cutoff, [](ArraySeq<int> &s) { s.quick_sort_rand_pivot(); });
+        double c5 = timed_shuffled<float>(cutoff, [](ArraySeq<float> &s) { s.merge_sort(); });
+        double c6 = timed_shuffled<float>(cutoff, [](ArraySeq<float> &s) { s.quick_sort(); });
+        double c7 = timed_shuffled<float>(cutoff, [](ArraySeq<float> &s) { s.quick_sort_rand_pivot(); });
+        cout << cutoff << " " << c2 << " " << c3 << " " << c4 << " " << c5
+             << " " << c6 << " " << c7 << endl;
+    }
+}
+
+template <typename T>
+double timed_shuffled(int cutoff, function<void(ArraySeq<T> &)> f)
+{
+    ArraySeq<int> keys;
+    load_shuffled(keys, elems, shuffles);
+    double total = 0;
+    for (int r = 0; r < runs; ++r)
+    {
+        ArraySeq<T> s;
+        for (int i = 0; i < elems; ++i)
+        {
+            s.insert(T(keys[i]) / 2, i);
+        }
+        s.set_network_cutoff(cutoff);
+        auto t0 = high_resolution_clock::now();
+        f(s);
+        auto t1 = high_resolution_clock::now();
+        total += duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+        check_sorted(s);
+    }
+    return total / runs;
+}
+
+template <typename T>
+void check_sorted(const ArraySeq<T> &s)
+{
+    for (int i = 0; i < s.size() - 1; ++i)
+    {
+        if (s[i] > s[i + 1])
+        {
+            std::cerr << "Error: Sequence not sorted: s[" << i << "] = "
+                      << s[i] << " > "
+                      << "s[" << (i + 1) << "] = "
+                      << s[i + 1] << endl;
+            std::terminate();
+        }
+    }
+}
@@ -48,6 +48,11 @@ void array_quick_sort(ArraySeq<int> &s)
     s.quick_sort();
 }
 
+void array_tim_sort(ArraySeq<int> &s)
+{
+    s.tim_sort();
+}
+
 // helper functions: timed array
 double array_timed_sorted(int size, array_sort_fn f);
 double array_timed_reversed(int size, array_sort_fn f);
@@ -70,12 +75,16 @@ int main(int argc, char *argv[])
 
     // output data header
     cout << "# All times in milliseconds (msec)" << endl;
-    cout << "# Column 4 = avg time array quick sort with rand pivot, shuffled" << endl;
-    cout << "# Column 5 = avg time array quick sort with rand pivot, sorted" << endl;
-    cout << "# Column 6 = avg time array quick sort with rand pivot, reversed" << endl;
-    cout << "# Column 1 = avg time array quick sort, shuffled" << endl;
-    cout << "# Column 2 = avg time array quick sort, sorted" << endl;
-    cout << "# Column 3 = avg time array quick sort, reversed" << endl;
+    cout << "# Column 1 = input data size" << endl;
+    cout << "# Column 2 = avg time array quick sort, shuffled" << endl;
+    cout << "# Column 3 = avg time array quick sort, sorted" << endl;
+    cout << "# Column 4 = avg time array quick sort, reversed" << endl;
+    cout << "# Column 5 = avg time array quick sort with rand pivot, shuffled" << endl;
+    cout << "# Column 6 = avg time array quick sort with rand pivot, sorted" << endl;
+    cout << "# Column 7 = avg time array quick sort with rand pivot, reversed" << endl;
+    cout << "# Column 8 = avg time array tim sort, shuffled" << endl;
+    cout << "# Column 9 = avg time array tim sort, sorted" << endl;
+    cout << "# Column 10 = avg time array tim sort, reversed" << endl;
 
     // run tests and print test results
     for (int size = start; size <= stop; size += step)
@@ -91,8 +100,18 @@ int main(int argc, char *argv[])
         // double c3 = array_timed_reversed(size, array_quick_sort_rand_pivot);
 
         //cout << size << " " << c1 << " " << c2 << " " << c3 << endl;
-
-        cout << size << " " << c1 << " " << c2 << " " << c3 << " " << c4 << " " << c5 << " " << c6 << endl;
+        double c1 = array_timed_shuffled(size, array_quick_sort);
+        double c2 = array_timed_sorted(size, array_quick_sort);
+        double c3 = array_timed_reversed(size, array_quick_sort);
+        double c4 = array_timed_shuffled(size, array_quick_sort_rand_pivot);
+        double c5 = array_timed_sorted(size, array_quick_sort_rand_pivot);
+        double c6 = array_timed_reversed(size, array_quick_sort_rand_pivot);
+        double c7 = array_timed_shuffled(size, array_tim_sort);
+        double c8 = array_timed_sorted(size, array_tim_sort);
+        double c9 = array_timed_reversed(size, array_tim_sort);
+
+        cout << size << " " << c1 << " " << c2 << " " << c3 << " " << c4 << " " << c5 << " " << c6
+             << " " << c7 << " " << c8 << " " << c9 << endl;
     }
 }
 
@@ -0,0 +1,111 @@
+//---------------------------------------------------------------------------
+// NAME: Ben Puryear
+// FILE: hw9_sample_perf.cpp
+// DATE: Fall 2021
+// DESC: Performance driver for the array parallel sample sort. To run
+//       from the command line use:
+//          ./hw9_sample_perf
+//       which sorts random int sequences of each size with quick sort
+//       (random pivot), tim sort, and parallel sample sort using 1 to
+//       16 threads, plus sample sort over heavily duplicated values.
+//       To save this data to a file, run the command:
+//          ./hw9_sample_perf > output_sample.dat
+//---------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include <random>
+#include "arrayseq.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// test parameters
+const int sizes[] = {1000000, 10000000};
+const int thread_counts[] = {1, 2, 4, 8, 16};
+const int runs = 1;
+
+// values in [0, range) (range 0 for any int)
+double timed_random(int n, int range, function<void(ArraySeq<int> &)> f);
+void check_sorted(const ArraySeq<int> &s);
+
+int main(int argc, char *argv[])
+{
+    // configure output
+    cout << fixed << showpoint;
+    cout << setprecision(2);
+
+    // output data header
+    cout << "# All times in milliseconds (msec), random ints" << endl;
+    cout << "# Column 1 = input data size" << endl;
+    cout << "# Column 2 = avg time quick sort with rand pivot" << endl;
+    cout << "# Column 3 = avg time tim sort" << endl;
+    int column = 4;
+    for (int threads : thread_counts)
+    {
+        cout << "# Column " << column++ << " = avg time sample sort, "
+             << threads << " threads" << endl;
+    }
+    cout << "# Column " << column++
+         << " = avg time sample sort, 16 threads, values in [0, 16)" << endl;
+
+    for (int n : sizes)
+    {
+        cout << n << " "
+             << timed_random(n, 0, [](ArraySeq<int> &s) { s.quick_sort_rand_pivot(); })
+             << " "
+             << timed_random(n, 0, [](ArraySeq<int> &s) { s.tim_sort(); });
+        for (int threads : thread_counts)
+        {
+            cout << " " << timed_random(n, 0, [=](ArraySeq<int> &s)
+                                        {
+                                            s.set_threads(threads);
+                                            s.parallel_sample_sort();
+                                        });
+        }
+        cout << " " << timed_random(n, 16, [](ArraySeq<int> &s)
+                                    {
+                                        s.set_threads(16);
+                                        s.parallel_sample_sort();
+                                    })
+             << endl;
+    }
+}
+
+double timed_random(int n, int range, function<void(ArraySeq<int> &)> f)
+{
+    double total = 0;
+    mt19937 gen(223);
+    for (int r = 0; r < runs; ++r)
+    {
+        ArraySeq<int> s;
+        for (int i = 0; i < n; ++i)
+        {
+            unsigned int value = gen();
+            s.insert(range > 0 ? (int)(value % range) : (int)value, i);
+        }
+        auto t0 = high_resolution_clock::now();
+        f(s);
+        auto t1 = high_resolution_clock::now();
+        total += duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+        check_sorted(s);
+    }
+    return total / runs;
+}
+
+void check_sorted(const ArraySeq<int> &s)
+{
+    for (int i = 0; i < s.size() - 1; ++i)
+    {
+        if (s[i] > s[i + 1])
+        {
+            std::cerr << "Error: Sequence not sorted: s[" << i << "] = "
+                      << s[i] << " > "
+                      << "s[" << (i + 1) << "] = "
+                      << s[i + 1] << endl;
+            std::terminate();
+        }
+    }
+}
@@ -7,6 +7,9 @@
 
 #include <iostream>
 #include <string>
+#include <algorithm>
+#include <limits>
+#include <random>
 #include <gtest/gtest.h>
 #include "arrayseq.h"
 
@@ -185,12 +188,324 @@ TEST(BasicArraySeqTests, FiveElemReverseCocktail)
     }
 }
 
+//----------------------------------------------------------------------
+// ArraySeq Tim Sort Tests
+//----------------------------------------------------------------------
+
+// element with a sort key and its original position, compared by key
+// only (for checking stability)
+struct KeyedElem
+{
+    int key;
+    int pos;
+    bool operator<(const KeyedElem &rhs) const { return key < rhs.key; }
+    bool operator>(const KeyedElem &rhs) const { return key > rhs.key; }
+    bool operator==(const KeyedElem &rhs) const { return key == rhs.key; }
+};
+
+TEST(TimSortTests, SmallSeqTimSort)
+{
+    ArraySeq<int> seq;
+    seq.tim_sort();
+    ASSERT_EQ(0, seq.size());
+    seq.insert(10, 0);
+    seq.tim_sort();
+    ASSERT_EQ(10, seq[0]);
+    seq.insert(20, 0);
+    seq.insert(30, 1);
+    seq.tim_sort();
+    ASSERT_EQ(10, seq[0]);
+    ASSERT_EQ(20, seq[1]);
+    ASSERT_EQ(30, seq[2]);
+}
+
+TEST(TimSortTests, SortedAndReversedTimSort)
+{
+    ArraySeq<int> sorted, reversed;
+    for (int i = 0; i < 5000; ++i)
+    {
+        sorted.insert(i, i);
+        reversed.insert(i, 0);
+    }
+    sorted.tim_sort();
+    reversed.tim_sort();
+    for (int i = 0; i < 5000; ++i)
+    {
+        ASSERT_EQ(i, sorted[i]);
+        ASSERT_EQ(i, reversed[i]);
+    }
+}
+
+TEST(TimSortTests, ShuffledAndRunsTimSort)
+{
+    // pseudo-random values, then a mix of ascending and descending
+    // runs of varied lengths (to exercise merging and galloping)
+    ArraySeq<int> seq;
+    for (int i = 0; i < 10000; ++i)
+        seq.insert((i * 7919) % 10007, i);
+    for (int r = 0; r < 40; ++r)
+        for (int i = 0; i < 37 * r + 5; ++i)
+            seq.insert(r % 2 == 0 ? i : -i, seq.size());
+    int n = seq.size();
+    seq.tim_sort();
+    ASSERT_EQ(n, seq.size());
+    for (int i = 0; i < n - 1; ++i)
+        ASSERT_LE(seq[i], seq[i + 1]);
+}
+
+TEST(TimSortTests, StableTimSort)
+{
+    ArraySeq<KeyedElem> seq;
+    for (int i = 0; i < 3000; ++i)
+        seq.insert({(i * 31) % 7, i}, i);
+    seq.tim_sort();
+    for (int i = 0; i < seq.size() - 1; ++i)
+    {
+        ASSERT_LE(seq[i].key, seq[i + 1].key);
+        if (seq[i].key == seq[i + 1].key)
+            ASSERT_LT(seq[i].pos, seq[i + 1].pos);
+    }
+}
+
+TEST(TimSortTests, LibrarySortCases)
+{
+    ArraySeq<int> seq;
+    seq.library_sort();
+    ASSERT_EQ(0, seq.size());
+    for (int i = 0; i < 1000; ++i)
+        seq.insert((i * 7919) % 1009, i);
+    seq.insert(5, 0);
+    seq.insert(5, 500);
+    seq.library_sort();
+    ASSERT_EQ(1002, seq.size());
+    for (int i = 0; i < seq.size() - 1; ++i)
+        ASSERT_LE(seq[i], seq[i + 1]);
+}
+
+//----------------------------------------------------------------------
+// Sorting Network Tests
+//----------------------------------------------------------------------
+
+TEST(SortingNetworkTests, NetworkSortsEveryLength)
+{
+    for (int n = 0; n <= SORTNET_MAX; ++n)
+    {
+        int ints[SORTNET_MAX];
+        float floats[SORTNET_MAX];
+        for (int i = 0; i < n; ++i)
+        {
+            ints[i] = (i * 7919) % 61 - 30;
+            floats[i] = ints[i] / 4.0f;
+        }
+        sorting_network(ints, n);
+        sorting_network(floats, n);
+        for (int i = 0; i < n - 1; ++i)
+        {
+            ASSERT_LE(ints[i], ints[i + 1]);
+            ASSERT_LE(floats[i], floats[i + 1]);
+        }
+    }
+    int big[SORTNET_MAX + 1];
+    ASSERT_THROW(sorting_network(big, SORTNET_MAX + 1), std::invalid_argument);
+}
+
+TEST(SortingNetworkTests, LanesMatchBuild)
+{
+    // the hw9_test_avx2 and hw9_test_sse41 builds check the vector
+    // lanes, the default build the scalar ones
+#if defined(__AVX2__)
+    ASSERT_EQ(8, int(NetIntLanes::width));
+    ASSERT_EQ(8, int(NetFloatLanes::width));
+#elif defined(__SSE4_1__)
+    ASSERT_EQ(4, int(NetIntLanes::width));
+    ASSERT_EQ(4, int(NetFloatLanes::width));
+#else
+    ASSERT_EQ(1, int(NetIntLanes::width));
+    ASSERT_EQ(1, int(NetFloatLanes::width));
+#endif
+}
+
+TEST(SortingNetworkTests, NetworkMatchesStdSort)
+{
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> dist(-1000000, 1000000);
+    for (int trial = 0; trial < 200; ++trial)
+    {
+        int n = trial % (SORTNET_MAX + 1);
+        int ints[SORTNET_MAX], int_copy[SORTNET_MAX];
+        float floats[SORTNET_MAX], float_copy[SORTNET_MAX];
+        for (int i = 0; i < n; ++i)
+        {
+            ints[i] = trial % 3 == 0 ? dist(gen) % 4 : dist(gen);
+            floats[i] = ints[i] / 8.0f;
+            int_copy[i] = ints[i];
+            float_copy[i] = floats[i];
+        }
+        if (n > 0)
+            floats[0] = float_copy[0] = -std::numeric_limits<float>::infinity();
+        sorting_network(ints, n);
+        sorting_network(floats, n);
+        std::sort(int_copy, int_copy + n);
+        std::sort(float_copy, float_copy + n);
+        for (int i = 0; i < n; ++i)
+        {
+            ASSERT_EQ(int_copy[i], ints[i]);
+            ASSERT_EQ(float_copy[i], floats[i]);
+        }
+    }
+}
+
+TEST(SortingNetworkTests, BitonicMergeHalves)
+{
+    for (int n = 8; n <= SORTNET_MAX; n *= 2)
+    {
+        // evens in the first half, odds in the second
+        int a[SORTNET_MAX];
+        for (int i = 0; i < n / 2; ++i)
+        {
+            a[i] = 2 * i;
+            a[n / 2 + i] = 2 * i + 1;
+        }
+        bitonic_merge(a, n);
+        for (int i = 0; i < n; ++i)
+            ASSERT_EQ(i, a[i]);
+    }
+    int a[12] = {0};
+    ASSERT_THROW(bitonic_merge(a, 12), std::invalid_argument);
+    ASSERT_THROW(bitonic_merge(a, 4), std::invalid_argument);
+}
+
+TEST(SortingNetworkTests, NetworkBaseCaseSorts)
+{
+    // each cutoff, including 0 (networks off), on int and float
+    int cutoffs[] = {0, 8, 16, 32, 64};
+    for (int cutoff : cutoffs)
+    {
+        ArraySeq<int> merge, quick, rand_quick;
+        ArraySeq<float> fmerge, fquick;
+        for (int i = 0; i < 3000; ++i)
+        {
+            int v = (i * 7919) % 1009;
+            merge.insert(v, i);
+            quick.insert(v, i);
+            rand_quick.insert(v, i);
+            fmerge.insert(v - 500.5f, i);
+            fquick.insert(v - 500.5f, i);
+        }
+        merge.set_network_cutoff(cutoff);
+        quick.set_network_cutoff(cutoff);
+        rand_quick.set_network_cutoff(cutoff);
+        fmerge.set_network_cutoff(cutoff);
+        fquick.set_network_cutoff(cutoff);
+        merge.merge_sort();
+        quick.quick_sort();
+        rand_quick.quick_sort_rand_pivot();
+        fmerge.merge_sort();
+        fquick.quick_sort();
+        for (int i = 0; i < 2999; ++i)
+        {
+            ASSERT_LE(merge[i], merge[i + 1]);
+            ASSERT_LE(quick[i], quick[i + 1]);
+            ASSERT_LE(rand_quick[i], rand_quick[i + 1]);
+            ASSERT_LE(fmerge[i], fmerge[i + 1]);
+            ASSERT_LE(fquick[i], fquick[i + 1]);
+        }
+    }
+}
+
+//----------------------------------------------------------------------
+// Parallel Sample Sort Tests
+//----------------------------------------------------------------------
+
+// enough elements for four threads
+const int sample_sort_n = 4 * 65536 + 123;
+
+TEST(ParallelSampleSortTests, SmallSeqSampleSort)
+{
+    ArraySeq<int> seq;
+    seq.parallel_sample_sort();
+    ASSERT_EQ(0, seq.size());
+    for (int i = 0; i < 100; ++i)
+        seq.insert(100 - i, i);
+    seq.set_threads(4);
+    seq.parallel_sample_sort();
+    for (int i = 0; i < 100; ++i)
+        ASSERT_EQ(i + 1, seq[i]);
+}
+
+TEST(ParallelSampleSortTests, ShuffledSampleSort)
+{
+    for (int threads = 1; threads <= 4; ++threads)
+    {
+        ArraySeq<int> seq;
+        for (int i = 0; i < sample_sort_n; ++i)
+            seq.insert((int)((i * 7919LL) % sample_sort_n), i);
+        seq.set_threads(threads);
+        seq.parallel_sample_sort();
+        ASSERT_EQ(sample_sort_n, seq.size());
+        for (int i = 0; i < sample_sort_n; ++i)
+            ASSERT_EQ(i, seq[i]);
+    }
+}
+
+TEST(ParallelSampleSortTests, DuplicatesSampleSort)
+{
+    // a few values (all splitters repeat), and one value taking most
+    // of the sequence
+    ArraySeq<int> few, skewed;
+    for (int i = 0; i < sample_sort_n; ++i)
+    {
+        few.insert((i * 31) % 3, i);
+        skewed.insert(i % 10 == 0 ? i : 42, i);
+    }
+    few.set_threads(4);
+    skewed.set_threads(4);
+    few.parallel_sample_sort();
+    skewed.parallel_sample_sort();
+    for (int i = 0; i < sample_sort_n - 1; ++i)
+    {
+        ASSERT_LE(few[i], few[i + 1]);
+        ASSERT_LE(skewed[i], skewed[i + 1]);
+    }
+    ASSERT_EQ(0, few[0]);
+    ASSERT_EQ(2, few[sample_sort_n - 1]);
+}
+
+TEST(ParallelSampleSortTests, StableSampleSort)
+{
+    ArraySeq<KeyedElem> seq;
+    for (int i = 0; i < sample_sort_n; ++i)
+        seq.insert({(i * 7919) % 1000, i}, i);
+    seq.set_threads(4);
+    seq.parallel_sample_sort();
+    for (int i = 0; i < seq.size() - 1; ++i)
+    {
+        ASSERT_LE(seq[i].key, seq[i + 1].key);
+        if (seq[i].key == seq[i + 1].key)
+            ASSERT_LT(seq[i].pos, seq[i + 1].pos);
+    }
+}
+
 //----------------------------------------------------------------------
 // Main
 //----------------------------------------------------------------------
 
 int main(int argc, char *argv[])
 {
+    // a vector build can only run where the CPU has the instructions
+#if defined(__AVX2__)
+    if (!__builtin_cpu_supports("avx2"))
+    {
+        std::cout << "AVX2 not supported, skipping tests" << std::endl;
+        return 0;
+    }
+#elif defined(__SSE4_1__)
+    if (!__builtin_cpu_supports("sse4.1"))
+    {
+        std::cout << "SSE4.1 not supported, skipping tests" << std::endl;
+        return 0;
+    }
+#endif
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }